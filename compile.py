@@ -187,7 +187,7 @@ root.mainloop()
 TCL=/mingw64
 export PATH=$TCL/bin:$PATH
 cd htmlwidget
-tclsh src/cssprop.tcl && tclsh src/tokenlist.txt && tclsh src/mkdefaultstyle.tcl > htmldefaultstyle.c
+tclsh src/cssprop.tcl && tclsh src/tokenlist.txt && tclsh src/entitylist.txt && tclsh src/mkdefaultstyle.tcl > htmldefaultstyle.c
 mv *.c src && mv *.h src
 mkdir build && cd build
 ../configure CC="gcc -static-libgcc" --with-tcl=$TCL/lib --with-tk=$TCL/lib --with-tclinclude=$TCL/include --with-tkinclude=$TCL/include
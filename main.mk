@@ -26,7 +26,7 @@ SRC = htmlparse.c htmldraw.c htmltcl.c htmlimage.c htmltree.c htmltagdb.c \
       htmlutil.c cssparser.c
 
 SRCHDR = $(TOP)/src/html.h $(TOP)/src/cssInt.h $(TOP)/src/css.h
-GENHDR = cssprop.h htmltokens.h
+GENHDR = cssprop.h htmltokens.h htmlentities.c
 
 HDR = $(GENHDR) $(SRCHDR)
 
@@ -75,7 +75,11 @@ htmldefaultstyle.c: $(TOP)/src/tkhtml.tcl  $(TOP)/src/html.css $(TOP)/src/mkdefa
 	@echo '$$(TCLSH) $(TOP)/src/mkdefaultstyle.tcl > htmldefaultstyle.c'
 	@$(TCLSH) $(TOP)/src/mkdefaultstyle.tcl > htmldefaultstyle.c
 
-htmltokens.h:	$(TOP)/src/tokenlist.txt
+htmltokens.h:	$(TOP)/src/tokenlist.txt $(TOP)/src/mkperfecthash.tcl
+	@echo '$$(TCLSH) $<'
+	@$(TCLSH) $<
+
+htmlentities.c:	$(TOP)/src/entitylist.txt $(TOP)/src/mkperfecthash.tcl
 	@echo '$$(TCLSH) $<'
 	@$(TCLSH) $<
 
@@ -84,6 +84,17 @@ static const char rcsid[] = "$Id: css.c,v 1.139 2007/12/16 11:57:43 danielk1977
 
 static int cssParse(HtmlTree*,int,CONST char*,int,int,Tcl_Obj*,Tcl_Obj*,Tcl_Obj*,Tcl_Obj*,CssStyleSheet**);
 
+static CssRuleSet *ruleSetFind(CssParse *, CssCompiled *);
+static CssRuleSet *ruleSetNew(CssParse *, CssCompiled *);
+static void ruleSetInstantiate(CssParse *, CssRuleSet *);
+static void ruleSetRegister(CssParse *, CssRuleSet *);
+static void ruleSetRelease(CssRuleSet *);
+
+static void ruleAncestorHashes(CssRule *);
+static void matchCacheFree(CssStyleSheet *);
+static void invalidationFree(CssInvalidation **);
+static void attrIndexFree(CssStyleSheet *);
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -628,12 +639,14 @@ tokenToProperty (CssParse *pParse, const CssToken *pToken)
                         int nAlloc = sizeof(CssProperty) + 7 + 1;
                         pProp = (CssProperty *)HtmlAlloc("CssProperty", nAlloc);
                         pProp->eType = CSS_TYPE_RAW;
+                        pProp->nRef = 0;
                         pProp->v.zVal = (char *)&pProp[1];
                         rgbToColor(pProp->v.zVal, zArg, nArg);
                     } else {
                         int nAlloc = sizeof(CssProperty) + nArg + 1;
                         pProp = (CssProperty *)HtmlAlloc("CssProperty", nAlloc);
                         pProp->eType = functions[i].type;
+                        pProp->nRef = 0;
                         pProp->v.zVal = (char *)&pProp[1];
                         strncpy(pProp->v.zVal, zArg, nArg);
                         pProp->v.zVal[nArg] = '\0';
@@ -669,6 +682,7 @@ tokenToProperty (CssParse *pParse, const CssToken *pToken)
         int eType;
         int nAlloc = sizeof(CssProperty) + n + 1;
         pProp = (CssProperty *)HtmlAlloc("CssProperty", nAlloc);
+        pProp->nRef = 0;
         pProp->v.zVal = (char *)&pProp[1];
         memcpy(pProp->v.zVal, z, n);
         pProp->v.zVal[n] = '\0';
@@ -873,8 +887,214 @@ propertySetAdd (
 }
 
 
+/*
+ * Interned property values.
+ *
+ * Many declarations, in stylesheets and in the style attributes of 
+ * elements, have identical values ("0px", "none", "bold" etc.). Once the
+ * properties for a declaration have been added to a property set, 
+ * propertySetIntern() replaces each of them with a reference counted copy
+ * from a process-wide hash table keyed by the type and value of the 
+ * property, so that each distinct value is stored once. propertyFree()
+ * releases a reference to an interned property. Properties of type 
+ * CSS_TYPE_LIST, and those HtmlCssStringToProperty() returns to other 
+ * modules, are not interned (CssProperty.nRef is 0).
+ *
+ * The style attributes of elements are often identical too. The property
+ * sets parsed by HtmlCssInlineParse() are stored in a second table, keyed
+ * by widget, parse mode and attribute text, and shared by all elements 
+ * with the same style attribute. HtmlCssInlineFree() releases a 
+ * reference to a shared set.
+ *
+ * The number of bytes that would have been used by the duplicate copies
+ * of properties and inline property sets is reported by the 
+ * [::tkhtml::stylecache] command.
+ */
+TCL_DECLARE_MUTEX(cssInternMutex)
+
+static struct CssInternTable {
+    int isInit;
+    Tcl_HashTable aProperty;     /* Map from key to interned CssProperty */
+    Tcl_HashTable aInline;       /* Map from key to shared CssPropertySet */
+
+    /* Statistics returned by [::tkhtml::stylecache]. */
+    int nPropertyRef;            /* References to interned properties */
+    int nInlineRef;              /* References to shared inline sets */
+    int nByteSaved;              /* Bytes used by duplicates, if any */
+} cssIntern;
+
+static void
+cssInternInit (void)
+{
+    if (!cssIntern.isInit) {
+        Tcl_InitHashTable(&cssIntern.aProperty, TCL_STRING_KEYS);
+        Tcl_InitHashTable(&cssIntern.aInline, TCL_STRING_KEYS);
+        cssIntern.isInit = 1;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * propertyKey --
+ *
+ *     Append the intern table key for property pProp to *pKey.
+ *
+ * Results:
+ *     The number of bytes of memory used by pProp, or 0 if the property 
+ *     may not be interned.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+propertyKey (CssProperty *pProp, Tcl_DString *pKey)
+{
+    char zBuf[64];
+
+    switch (pProp->eType) {
+        case CSS_TYPE_LIST:
+            return 0;
+
+        case CSS_TYPE_EM:
+        case CSS_TYPE_PX:
+        case CSS_TYPE_PT:
+        case CSS_TYPE_PC:
+        case CSS_TYPE_EX:
+        case CSS_TYPE_CENTIMETER:
+        case CSS_TYPE_INCH:
+        case CSS_TYPE_MILLIMETER:
+        case CSS_TYPE_PERCENT:
+        case CSS_TYPE_FLOAT:
+            sprintf(zBuf, "%d:%.17g", pProp->eType, pProp->v.rVal);
+            Tcl_DStringAppend(pKey, zBuf, -1);
+            return sizeof(CssProperty);
+
+        default:
+            if (!pProp->v.zVal) return 0;
+            sprintf(zBuf, "%d:", pProp->eType);
+            Tcl_DStringAppend(pKey, zBuf, -1);
+            Tcl_DStringAppend(pKey, pProp->v.zVal, -1);
+            return sizeof(CssProperty) + strlen(pProp->v.zVal) + 1;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * propertySetIntern --
+ *
+ *     Replace the properties in entries iFirst and greater of property 
+ *     set p with interned copies.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     May free properties in p and modify the intern table.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+propertySetIntern (CssPropertySet *p, int iFirst)
+{
+    int ii;
+
+    Tcl_MutexLock(&cssInternMutex);
+    cssInternInit();
+    for (ii = iFirst; ii < p->n; ii++) {
+        CssProperty *pProp = p->a[ii].pProp;
+        Tcl_HashEntry *pEntry;
+        Tcl_DString key;
+        int nByte;
+        int isNew;
+
+        if (!pProp) continue;
+        assert(pProp->nRef == 0);
+
+        Tcl_DStringInit(&key);
+        nByte = propertyKey(pProp, &key);
+        if (nByte) {
+            pEntry = Tcl_CreateHashEntry(
+                &cssIntern.aProperty, Tcl_DStringValue(&key), &isNew
+            );
+            if (isNew) {
+                Tcl_SetHashValue(pEntry, pProp);
+            } else {
+                HtmlFree(pProp);
+                pProp = (CssProperty *)Tcl_GetHashValue(pEntry);
+                p->a[ii].pProp = pProp;
+                cssIntern.nByteSaved += nByte;
+            }
+            pProp->nRef++;
+            cssIntern.nPropertyRef++;
+        }
+        Tcl_DStringFree(&key);
+    }
+    Tcl_MutexUnlock(&cssInternMutex);
+}
+
+/*
+ * Release a reference to the interned property pProp. If this is the 
+ * last reference, remove it from the intern table and free it.
+ */
+static void
+propertyRelease (CssProperty *pProp)
+{
+    Tcl_DString key;
+    int nByte;
+
+    assert(pProp->nRef > 0);
+    Tcl_DStringInit(&key);
+    nByte = propertyKey(pProp, &key);
+
+    Tcl_MutexLock(&cssInternMutex);
+    cssIntern.nPropertyRef--;
+    pProp->nRef--;
+    if (pProp->nRef > 0) {
+        cssIntern.nByteSaved -= nByte;
+    } else {
+        Tcl_HashEntry *pEntry;
+        pEntry = Tcl_FindHashEntry(&cssIntern.aProperty,Tcl_DStringValue(&key));
+        assert(pEntry && Tcl_GetHashValue(pEntry) == (ClientData)pProp);
+        Tcl_DeleteHashEntry(pEntry);
+        HtmlFree(pProp);
+    }
+    Tcl_MutexUnlock(&cssInternMutex);
+
+    Tcl_DStringFree(&key);
+}
+
+/*
+ * Return the approximate number of bytes of memory used by property set
+ * p, including the properties it contains.
+ */
+static int
+propertySetSize (CssPropertySet *p)
+{
+    int nByte = sizeof(CssPropertySet) + p->n * sizeof(p->a[0]);
+    int ii;
+    for (ii = 0; ii < p->n; ii++) {
+        if (p->a[ii].pProp) {
+            Tcl_DString key;
+            int nProp;
+            Tcl_DStringInit(&key);
+            nProp = propertyKey(p->a[ii].pProp, &key);
+            Tcl_DStringFree(&key);
+            nByte += (nProp ? nProp : sizeof(CssProperty));
+        }
+    }
+    return nByte;
+}
+
 static void 
 propertyFree(CssProperty *p){
+  if (p && p->nRef > 0) {
+    propertyRelease(p);
+    return;
+  }
   if (p && p->eType == CSS_TYPE_LIST) {
     int ii;
     CssProperty **apProp = (CssProperty **)p->v.p;
@@ -933,6 +1153,7 @@ propertyDup (CssProperty *pProp)
     if (z) n += (strlen(z) + 1);
     pRet = (CssProperty *)HtmlAlloc("CssProperty", n);
     memcpy(pRet, pProp, sizeof(CssProperty));
+    pRet->nRef = 0;
     if (z) {
         pRet->v.zVal = (char *)(&pRet[1]);
         strcpy(pRet->v.zVal, z);
@@ -1432,6 +1653,7 @@ propertySetAddList (
     pProp = (CssProperty *)HtmlAlloc("CssProperty", nAlloc);
     pProp->v.p = &(pProp[1]);
     pProp->eType = CSS_TYPE_LIST;
+    pProp->nRef = 0;
     apProp = (CssProperty **)(pProp->v.p);
     apProp[nElem] = 0;
 
@@ -1604,7 +1826,7 @@ propertySetAddShortcutFont (
     CONST char *z= v->z;
     CONST char *zEnd = z + v->n;
 
-    static const CssToken normal = { "normal", CSS_CONST_NORMAL };
+    static const CssToken normal = { "normal", 6 };
 
     CssProperty *pStyle = 0;
     CssProperty *pVariant = 0;
@@ -2072,6 +2294,8 @@ static CssPriority *
 newCssPriority(CssStyleSheet *pStyle, int origin, Tcl_Obj *pIdTail, int important)
 {
     CssPriority *pNew;      /* New list entry */
+    CssPriority *p1;
+    CssPriority *p2;
 
     pNew = HtmlNew(CssPriority);
     pNew->origin = origin;
@@ -2104,307 +2328,830 @@ newCssPriority(CssStyleSheet *pStyle, int origin, Tcl_Obj *pIdTail, int importan
     pNew->pNext = pStyle->pPriority;
     pStyle->pPriority = pNew;
 
+    /* Recalculate the CssPriority.iIdRank values. The rank of each 
+     * entry is the number of entries with a smaller id-tail, so that
+     * ruleCompare() can compare ids without calling strcmp(). Adding an
+     * entry does not change the relative order of existing ranks, so 
+     * rules already in the stylesheet lists remain correctly ordered.
+     */
+    for (p1 = pStyle->pPriority; p1; p1 = p1->pNext) {
+        const char *z1 = Tcl_GetString(p1->pIdTail);
+        p1->iIdRank = 0;
+        for (p2 = pStyle->pPriority; p2; p2 = p2->pNext) {
+            if (strcmp(Tcl_GetString(p2->pIdTail), z1) < 0) {
+                p1->iIdRank++;
+            }
+        }
+    }
+
     return pNew;
 }
 
+/*
+ * Compiled stylesheet cache.
+ *
+ * Parsing the default stylesheet is a noticeable part of the cost of
+ * creating a widget or calling [$html reset], and applications that create
+ * many widgets (or reload the same document) tend to parse the same author
+ * stylesheets over and over again. To avoid this, each time a stylesheet
+ * document is parsed the sequence of callbacks made by the parser is
+ * recorded in a CssCompiled structure (see cssInt.h). The next time the
+ * same text is parsed, by any widget in the process, the recorded
+ * callbacks are replayed instead of running the tokenizer.
+ *
+ * It is the callbacks, not the CssStyleSheet structures they build, that
+ * are cached because the rules created depend on the widget (quirks mode,
+ * the -urlcmd and -importcmd scripts, the stylesheet origin and id). 
+ *
+ * Compiled sheets are stored in a process-wide hash table keyed by a
+ * hash of the stylesheet text. Sheets that have been used as "agent" 
+ * stylesheets (i.e. the -defaultstyle text) are kept for the life of the
+ * process. Other sheets are discarded in least-recently-used order once 
+ * there are more than cssCompiledCache.nLimit of them.
+ *
+ * If a directory has been configured with [::tkhtml::stylecache
+ * -directory], compiled sheets are also written to and read from files in
+ * that directory, so that they survive between processes. Each file
+ * contains a copy of the stylesheet text, which is compared against the
+ * text being parsed before the file is used.
+ */
+#define CSS_COMPILED_LIMIT 64
+#define CSS_COMPILED_MAGIC "TKHTMLC1"
+
+TCL_DECLARE_MUTEX(cssCompiledMutex)
+
+static struct CssCompiledCache {
+    int isInit;
+    Tcl_HashTable aSheet;        /* Map from text hash to CssCompiled list */
+    CssCompiled *pFirst;         /* Most recently used sheet */
+    CssCompiled *pLast;          /* Least recently used sheet */
+    int nSheet;                  /* Number of sheets in cache */
+    int nEvictable;              /* Number of non-agent sheets in cache */
+    int nLimit;                  /* Maximum value of nEvictable */
+    char *zDirectory;            /* Directory for on-disk cache (or NULL) */
+
+    /* Statistics returned by [::tkhtml::stylecache]. */
+    int nHit;
+    int nMiss;
+    int nDiskRead;
+    int nDiskWrite;
+} cssCompiledCache;
+
+/*
+ * The compiled program is stored in the same allocation as the copy of 
+ * the stylesheet text, after the CssCompiled structure itself. The hash
+ * table maps from the value returned by cssCompiledHash() to a list of
+ * sheets linked by CssCompiled.pHashNext.
+ */
+#define cssCompiledText(p) ((char *)&(p)[1])
+
+static unsigned int
+cssCompiledHash (const char *z, int n)
+{
+    unsigned int h = 2166136261U;
+    int ii;
+    for (ii = 0; ii < n; ii++) {
+        h = (h ^ (unsigned char)z[ii]) * 16777619U;
+    }
+    return h;
+}
+
+static CssCompiled *
+cssCompiledNew (const char *z, int n, unsigned int iHash)
+{
+    CssCompiled *p;
+    p = (CssCompiled *)HtmlAlloc("CssCompiled", sizeof(CssCompiled) + n + 1);
+    memset(p, 0, sizeof(CssCompiled));
+    memcpy(cssCompiledText(p), z, n);
+    cssCompiledText(p)[n] = '\0';
+    p->zText = cssCompiledText(p);
+    p->nText = n;
+    p->iHash = iHash;
+    return p;
+}
+
+static void
+cssCompiledFree (CssCompiled *p)
+{
+    if (p) {
+        HtmlFree(p->aOp);
+        HtmlFree(p);
+    }
+}
+
 /*
  *---------------------------------------------------------------------------
  *
- * cssParse --
- *
- *     This routine does the work of parsing stylesheets or style
- *     attributes on behalf of HtmlCssParse() and HtmlCssInlineParse()
- *     respectively. 
- * 
- *     The first two argument identify the length of, and the text to be
- *     parsed.
+ * cssCompiledRecord --
  *
- *     The third argument is true if z points to the text of a style
- *     attribute, i.e: "color:red ; margin:0.4em". If false, then z points
- *     to a complete stylesheet document, i.e. "H1 {text-size: 1.2em}". 
- *     The stylesheet produced when parsing a style is the same as 
- *     "* {<style text>}".
+ *     Append an op to the program being recorded in pParse->pCompile.
+ *     Token arguments are converted to offsets within the stylesheet
+ *     text (which is what the parser is running against).
  *
  * Results:
  *     None.
  *
  * Side effects:
+ *     May reallocate pParse->pCompile->aOp.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+cssCompiledRecord (
+    CssParse *pParse,
+    int eOp,
+    int eArg,
+    CssToken *p1,
+    CssToken *p2
+)
+{
+    CssCompiled *p = pParse->pCompile;
+    CssCompiledOp *pOp;
+
+    if (p->nOp == p->nOpAlloc) {
+        int nNew = (p->nOpAlloc ? p->nOpAlloc * 2 : 64);
+        p->aOp = (CssCompiledOp *)HtmlRealloc(
+            "CssCompiled.aOp", (char *)p->aOp, nNew * sizeof(CssCompiledOp)
+        );
+        p->nOpAlloc = nNew;
+    }
+    pOp = &p->aOp[p->nOp++];
+    pOp->eOp = eOp;
+    pOp->eArg = eArg;
+    pOp->i1 = (p1 ? p1->z - p->zText : -1);
+    pOp->n1 = (p1 ? p1->n : 0);
+    pOp->i2 = (p2 ? p2->z - p->zText : -1);
+    pOp->n2 = (p2 ? p2->n : 0);
+    assert(pOp->i1 + pOp->n1 <= p->nText && pOp->i2 + pOp->n2 <= p->nText);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * cssCompiledReplay --
+ *
+ *     Replay the callbacks recorded in compiled stylesheet p against
+ *     parse context pParse. If the isSideEffectsOnly flag is set, only
+ *     the @import directives and syntax errors are replayed. This is used
+ *     when the rules themselves are taken from a shared CssRuleSet.
+ *
+ * Results:
  *     None.
  *
+ * Side effects:
+ *     Same as parsing the text of p with HtmlCssRunParser().
+ *
  *---------------------------------------------------------------------------
  */
-static int 
-cssParse(
-    HtmlTree *pTree,
-    int n,                       /* Size of z in bytes */
-    CONST char *z,               /* Text of attribute/document */
-    int isStyle,                 /* True if this is a style attribute */
-    int origin,                  /* CSS_ORIGIN_* value */
-    Tcl_Obj *pStyleId,           /* Second and later parts of stylesheet id */
-    Tcl_Obj *pImportCmd,         /* Command to invoke to process @import */
-    Tcl_Obj *pUrlCmd,            /* Command to invoke to translate url() */
-    Tcl_Obj *pErrorVar,          /* Name of error-log variable */
-    CssStyleSheet **ppStyle      /* IN/OUT: Stylesheet to append to   */
-    )
+static void
+cssCompiledReplay (
+    CssParse *pParse, 
+    CssCompiled *p, 
+    int isSideEffectsOnly     /* True to replay only @import and errors */
+)
 {
-    CssParse sParse;
     int ii;
+    for (ii = 0; ii < p->nOp; ii++) {
+        CssCompiledOp *pOp = &p->aOp[ii];
+        CssToken t1;
+        CssToken t2;
+        CssToken *p1 = 0;
+        CssToken *p2 = 0;
+
+        if (isSideEffectsOnly && 
+            pOp->eOp != CSS_OP_IMPORT && pOp->eOp != CSS_OP_ERROR
+        ) {
+            continue;
+        }
 
-    memset(&sParse, 0, sizeof(CssParse));
-    sParse.origin = origin;
-    sParse.pStyleId = pStyleId;
-    sParse.pImportCmd = pImportCmd;
-    sParse.pUrlCmd = pUrlCmd;
-    sParse.interp = (pTree ? pTree->interp : 0);
-    sParse.pTree = pTree;
-    if (pErrorVar) {
-        sParse.pErrorLog = Tcl_NewObj();
-        Tcl_IncrRefCount(sParse.pErrorLog);
-    }
+        if (pOp->i1 >= 0) {
+            t1.z = &p->zText[pOp->i1];
+            t1.n = pOp->n1;
+            p1 = &t1;
+        }
+        if (pOp->i2 >= 0) {
+            t2.z = &p->zText[pOp->i2];
+            t2.n = pOp->n2;
+            p2 = &t2;
+        }
 
-    if( n<0 ){
-        n = strlen(z);
+        switch (pOp->eOp) {
+            case CSS_OP_SELECTOR:
+                HtmlCssSelector(pParse, pOp->eArg, p1, p2);
+                break;
+            case CSS_OP_COMMA:
+                HtmlCssSelectorComma(pParse);
+                break;
+            case CSS_OP_DECLARATION:
+                HtmlCssDeclaration(pParse, p1, p2, pOp->eArg);
+                break;
+            case CSS_OP_RULE:
+                HtmlCssRule(pParse, pOp->eArg);
+                break;
+            case CSS_OP_IMPORT:
+                HtmlCssImport(pParse, p1);
+                break;
+            case CSS_OP_ERROR:
+                HtmlCssSyntaxError(pParse, pOp->i1, pOp->n1);
+                break;
+            default:
+                assert(!"Impossible");
+        }
     }
+}
 
-    /* If *ppStyle is NULL, then create a new CssStyleSheet object. If it
-     * is not zero, then append the rules from the new stylesheet document
-     * to the existing object.
-     */
-    if (0==*ppStyle) {
-        sParse.pStyle = HtmlNew(CssStyleSheet);
-        
-        /* If pStyleId is not NULL, then initialise the hash-tables */
-        if (pStyleId) {
-            Tcl_InitHashTable(&sParse.pStyle->aByTag, TCL_STRING_KEYS);
-            Tcl_InitHashTable(&sParse.pStyle->aByClass, TCL_STRING_KEYS);
-            Tcl_InitHashTable(&sParse.pStyle->aById, TCL_STRING_KEYS);
+static void
+cssCompiledExit (ClientData clientData)
+{
+    Tcl_MutexLock(&cssCompiledMutex);
+    while (cssCompiledCache.pFirst) {
+        CssCompiled *p = cssCompiledCache.pFirst;
+        cssCompiledCache.pFirst = p->pNext;
+        p->isEvicted = 1;
+        if (p->nRef == 0) {
+            cssCompiledFree(p);
         }
-    } else {
-        sParse.pStyle = *ppStyle;
     }
+    if (cssCompiledCache.isInit) {
+        Tcl_DeleteHashTable(&cssCompiledCache.aSheet);
+    }
+    HtmlFree(cssCompiledCache.zDirectory);
+    memset(&cssCompiledCache, 0, sizeof(cssCompiledCache));
+    Tcl_MutexUnlock(&cssCompiledMutex);
+}
 
-    /* If this is a stylesheet, not a style attribute, add the priority
-     * entries for both regular and "!important" properties for this
-     * stylesheet to the priority list.
-     *
-     * TODO: Sometimes people specify "!important" inside of style 
-     * attributes. Tkhtml currently ignores this. Not sure if that's 
-     * right or not...
-     */
-    if (pStyleId) {
-        sParse.pPriority1 = newCssPriority(sParse.pStyle, origin, pStyleId, 0);
-        sParse.pPriority2 = newCssPriority(sParse.pStyle, origin, pStyleId, 1);
+/*
+ * The following functions manipulate cssCompiledCache. The caller must
+ * hold cssCompiledMutex.
+ */
+static void
+cssCompiledInit (void)
+{
+    if (!cssCompiledCache.isInit) {
+        Tcl_InitHashTable(&cssCompiledCache.aSheet, TCL_ONE_WORD_KEYS);
+        cssCompiledCache.nLimit = CSS_COMPILED_LIMIT;
+        cssCompiledCache.isInit = 1;
+        Tcl_CreateExitHandler(cssCompiledExit, 0);
     }
+}
 
-    if (isStyle) {
-        HtmlCssRunStyleParser(z, n, &sParse);
+static void
+cssCompiledUnlink (CssCompiled *p)
+{
+    if (p->pPrev) {
+        p->pPrev->pNext = p->pNext;
     } else {
-        HtmlCssRunParser(z, n, &sParse);
+        cssCompiledCache.pFirst = p->pNext;
     }
-
-    *ppStyle = sParse.pStyle;
-
-    /* Clean up anything left in sParse */
-    selectorFree(sParse.pSelector);
-    for (ii = 0; ii < sParse.nXtra; ii++) {
-        selectorFree(sParse.apXtraSelector[ii]);
+    if (p->pNext) {
+        p->pNext->pPrev = p->pPrev;
+    } else {
+        cssCompiledCache.pLast = p->pPrev;
     }
-    propertySetFree(sParse.pPropertySet);
-    propertySetFree(sParse.pImportant);
+    p->pPrev = 0;
+    p->pNext = 0;
+}
 
-    if (pErrorVar) {
-        Tcl_ObjSetVar2(pTree->interp, pErrorVar, 0, sParse.pErrorLog, 0);
-        Tcl_DecrRefCount(sParse.pErrorLog);
+static void
+cssCompiledLink (CssCompiled *p)
+{
+    p->pPrev = 0;
+    p->pNext = cssCompiledCache.pFirst;
+    if (p->pNext) {
+        p->pNext->pPrev = p;
+    } else {
+        cssCompiledCache.pLast = p;
     }
-
-    return 0;
+    cssCompiledCache.pFirst = p;
 }
 
-int 
-HtmlCssSelectorParse (HtmlTree *pTree, int n, const char *z, CssStyleSheet **ppStyle)
+static void
+cssCompiledEvict (CssCompiled *p)
 {
-    return cssParse(pTree, n, z, 0, 0, 0, 0, 0, 0, ppStyle);
-}
+    Tcl_HashEntry *pEntry;
+    CssCompiled **pp;
+
+    pEntry = Tcl_FindHashEntry(
+        &cssCompiledCache.aSheet, (char *)(size_t)p->iHash
+    );
+    assert(pEntry);
+    for (pp = (CssCompiled **)&pEntry->clientData; *pp != p; ) {
+        pp = &(*pp)->pHashNext;
+    }
+    *pp = p->pHashNext;
+    if (!Tcl_GetHashValue(pEntry)) {
+        Tcl_DeleteHashEntry(pEntry);
+    }
+
+    cssCompiledUnlink(p);
+    cssCompiledCache.nSheet--;
+    if (!p->isAgent) {
+        cssCompiledCache.nEvictable--;
+    }
+    p->isEvicted = 1;
+    if (p->nRef == 0) {
+        cssCompiledFree(p);
+    }
+}
+
+static void
+cssCompiledTrim (void)
+{
+    CssCompiled *p = cssCompiledCache.pLast;
+    while (p && cssCompiledCache.nEvictable > cssCompiledCache.nLimit) {
+        CssCompiled *pPrev = p->pPrev;
+        if (!p->isAgent) {
+            cssCompiledEvict(p);
+        }
+        p = pPrev;
+    }
+}
+
+static void
+cssCompiledInsert (CssCompiled *p)
+{
+    Tcl_HashEntry *pEntry;
+    int isNew;
+
+    pEntry = Tcl_CreateHashEntry(
+        &cssCompiledCache.aSheet, (char *)(size_t)p->iHash, &isNew
+    );
+    p->pHashNext = (isNew ? 0 : (CssCompiled *)Tcl_GetHashValue(pEntry));
+    Tcl_SetHashValue(pEntry, p);
+    cssCompiledLink(p);
+    cssCompiledCache.nSheet++;
+    if (!p->isAgent) {
+        cssCompiledCache.nEvictable++;
+        cssCompiledTrim();
+    }
+}
+
+static CssCompiled *
+cssCompiledFind (const char *z, int n, unsigned int iHash)
+{
+    Tcl_HashEntry *pEntry;
+    CssCompiled *p = 0;
+
+    pEntry = Tcl_FindHashEntry(&cssCompiledCache.aSheet, (char *)(size_t)iHash);
+    if (pEntry) {
+        p = (CssCompiled *)Tcl_GetHashValue(pEntry);
+        while (p && (p->nText != n || memcmp(p->zText, z, n))) {
+            p = p->pHashNext;
+        }
+    }
+    return p;
+}
+
+/*
+ * Release a reference to compiled stylesheet p, obtained by 
+ * cssCompiledParse(). This function obtains the mutex itself.
+ */
+static void
+cssCompiledRelease (CssCompiled *p)
+{
+    Tcl_MutexLock(&cssCompiledMutex);
+    p->nRef--;
+    if (p->isEvicted && p->nRef == 0) {
+        cssCompiledFree(p);
+    }
+    Tcl_MutexUnlock(&cssCompiledMutex);
+}
 
 /*
  *---------------------------------------------------------------------------
  *
- * HtmlStyleParse --
+ * cssCompiledPath --
  *
- *     Compile a stylesheet document from text and add it to the widget.
+ *     Return the name of the file used to store the compiled version of 
+ *     a stylesheet in the on-disk cache. The returned object has a 
+ *     ref-count of 0.
  *
  * Results:
- *     None.
+ *     Tcl_Obj containing a path.
  *
  * Side effects:
  *     None.
  *
  *---------------------------------------------------------------------------
  */
-int 
-HtmlStyleParse(
-    HtmlTree *pTree,
-    Tcl_Obj *pStyleText,
-    Tcl_Obj *pId,
-    Tcl_Obj *pImportCmd,
-    Tcl_Obj *pUrlCmd,
-    Tcl_Obj *pErrorVar
-    )
+static Tcl_Obj *
+cssCompiledPath (Tcl_Obj *pDirectory, unsigned int iHash, int nText)
 {
-    int origin = 0;
-    Tcl_Obj *pStyleId = 0;
-    CONST char *zId;
-    CONST char *zStyleText;
-    int nStyleText;
+    char zBuf[64];
+    Tcl_Obj *pRet;
+    sprintf(zBuf, "/%08x-%d.tkcss", iHash, nText);
+    pRet = Tcl_DuplicateObj(pDirectory);
+    Tcl_AppendToObj(pRet, zBuf, -1);
+    return pRet;
+}
 
-    /* Parse up the stylesheet id. It must begin with one of the strings
-     * "agent", "user" or "author". After that it may contain any text.
-     */
-    zId = Tcl_GetString(pId);
-    if (0==strncmp("agent", zId, 5)) {
-        origin = CSS_ORIGIN_AGENT;
-        pStyleId = Tcl_NewStringObj(&zId[5], -1);
-    }
-    else if (0==strncmp("user", zId, 4)) {
-        origin = CSS_ORIGIN_USER;
-        pStyleId = Tcl_NewStringObj(&zId[4], -1);
+/*
+ * The on-disk format is the 8 byte CSS_COMPILED_MAGIC string, followed by
+ * a header of four native integers (a byte-order check, the size of a
+ * CssCompiledOp structure, the size of the text in bytes and the number of
+ * ops), the stylesheet text and finally the array of ops. Files are only 
+ * expected to be portable between processes using the same build.
+ */
+#define CSS_COMPILED_BYTEORDER 0x01020304
+
+static CssCompiled *
+cssCompiledRead (Tcl_Obj *pDirectory, const char *z, int n, unsigned int iHash)
+{
+    Tcl_Obj *pPath;
+    Tcl_Channel chan;
+    CssCompiled *p = 0;
+    char zMagic[8];
+    int aHdr[4];
+    int nOp;
+    int ii;
+
+    pPath = cssCompiledPath(pDirectory, iHash, n);
+    Tcl_IncrRefCount(pPath);
+    chan = Tcl_FSOpenFileChannel(0, pPath, "r", 0);
+    Tcl_DecrRefCount(pPath);
+    if (!chan) return 0;
+    Tcl_SetChannelOption(0, chan, "-translation", "binary");
+
+    if (Tcl_Read(chan, zMagic, 8) != 8 || memcmp(zMagic, CSS_COMPILED_MAGIC, 8)
+     || Tcl_Read(chan, (char *)aHdr, sizeof(aHdr)) != sizeof(aHdr)
+     || aHdr[0] != CSS_COMPILED_BYTEORDER
+     || aHdr[1] != sizeof(CssCompiledOp)
+     || aHdr[2] != n || aHdr[3] < 0
+    ) {
+        goto read_out;
     }
-    else if (0==strncmp("author", zId, 5)) {
-        origin = CSS_ORIGIN_AUTHOR;
-        pStyleId = Tcl_NewStringObj(&zId[6], -1);
+
+    p = cssCompiledNew(z, n, iHash);
+    p->nOp = p->nOpAlloc = aHdr[3];
+    nOp = p->nOp * sizeof(CssCompiledOp);
+    p->aOp = (CssCompiledOp *)HtmlAlloc("CssCompiled.aOp", nOp);
+
+    /* Read the text into the space allocated for it and check that it 
+     * matches the text being parsed. Then read the ops and make sure
+     * none of them refer to text outside of the document.
+     */
+    if (Tcl_Read(chan, cssCompiledText(p), n) != n 
+     || memcmp(cssCompiledText(p), z, n)
+     || Tcl_Read(chan, (char *)p->aOp, nOp) != nOp
+    ) {
+        goto read_error;
     }
-    if (!pStyleId) {
-        Tcl_AppendResult(pTree->interp, "Bad style-sheet-id: ", zId, 0);
-        return TCL_ERROR;
+    for (ii = 0; ii < p->nOp; ii++) {
+        CssCompiledOp *pOp = &p->aOp[ii];
+        if (pOp->eOp < CSS_OP_SELECTOR || pOp->eOp > CSS_OP_ERROR
+         || pOp->i1 < -1 || pOp->n1 < 0 || pOp->i1 + pOp->n1 > n 
+         || pOp->i2 < -1 || pOp->n2 < 0 || pOp->i2 + pOp->n2 > n 
+        ) {
+            goto read_error;
+        }
     }
-    Tcl_IncrRefCount(pStyleId);
+    goto read_out;
 
-    /* If there is already a stylesheet in pTree->pStyle, then this call will
-     * parse the stylesheet text in pStyleText and append rules to the
-     * existing stylesheet. If pTree->pStyle is NULL, then a new stylesheet is
-     * created. Within Tkhtml, each document only ever has a single stylesheet
-     * object, possibly created by combining text from multiple stylesheet
-     * documents.
+  read_error:
+    cssCompiledFree(p);
+    p = 0;
+
+  read_out:
+    Tcl_Close(0, chan);
+    return p;
+}
+
+static int
+cssCompiledWrite (Tcl_Obj *pDirectory, CssCompiled *p)
+{
+    Tcl_Obj *pPath;
+    Tcl_Obj *pTmp;
+    Tcl_Channel chan;
+    int aHdr[4];
+    int nOp = p->nOp * sizeof(CssCompiledOp);
+    int rc = 0;
+
+    aHdr[0] = CSS_COMPILED_BYTEORDER;
+    aHdr[1] = sizeof(CssCompiledOp);
+    aHdr[2] = p->nText;
+    aHdr[3] = p->nOp;
+
+    /* Write to a temporary file and then rename it, so that other 
+     * processes never see a partially written file. 
      */
-    zStyleText = Tcl_GetStringFromObj(pStyleText, &nStyleText);
-    cssParse(
-        pTree,
-        nStyleText, zStyleText,            /* Stylesheet text */
-        0,                                 /* This is not a style attribute */
-        origin,                            /* Origin - CSS_ORIGIN_XXX */
-        pStyleId,                          /* Rest of -id option */
-        pImportCmd,                        /* How to handle @import */
-        pUrlCmd,                           /* How to handle url() */
-        pErrorVar,                         /* Variable to store errors in */
-        &pTree->pStyle                     /* CssStylesheet to update/create */
-    );
+    pPath = cssCompiledPath(pDirectory, p->iHash, p->nText);
+    Tcl_IncrRefCount(pPath);
+    pTmp = Tcl_DuplicateObj(pPath);
+    Tcl_IncrRefCount(pTmp);
+    Tcl_AppendToObj(pTmp, ".tmp", -1);
+
+    chan = Tcl_FSOpenFileChannel(0, pTmp, "w", 0644);
+    if (chan) {
+        Tcl_SetChannelOption(0, chan, "-translation", "binary");
+        if (Tcl_Write(chan, CSS_COMPILED_MAGIC, 8) == 8 
+         && Tcl_Write(chan, (char *)aHdr, sizeof(aHdr)) == sizeof(aHdr)
+         && Tcl_Write(chan, p->zText, p->nText) == p->nText
+         && Tcl_Write(chan, (char *)p->aOp, nOp) == nOp
+         && Tcl_Close(0, chan) == TCL_OK
+        ) {
+            rc = (Tcl_FSRenameFile(pTmp, pPath) == TCL_OK);
+        } else {
+            Tcl_Close(0, chan);
+        }
+        if (!rc) {
+            Tcl_FSDeleteFile(pTmp);
+        }
+    }
 
-    Tcl_DecrRefCount(pStyleId);
-    return TCL_OK;
+    Tcl_DecrRefCount(pTmp);
+    Tcl_DecrRefCount(pPath);
+    return rc;
 }
 
-/*--------------------------------------------------------------------------
+/*
+ *---------------------------------------------------------------------------
  *
- * HtmlCssInlineParse --
+ * cssCompiledParse --
  *
- *     Parse the style attribute value pointed to by z, length n bytes. See
- *     comments above cssParse() for more detail.
+ *     Parse the stylesheet document z (size n bytes) into parse context
+ *     pParse, using (and updating) the compiled stylesheet cache.
  *
  * Results:
- *
- *     Returns a CssStyleSheet pointer, written to *ppStyle.
+ *     None.
  *
  * Side effects:
+ *     Same as HtmlCssRunParser(). Also may add an entry to the cache
+ *     and write a file to the on-disk cache directory.
  *
- *--------------------------------------------------------------------------
+ *---------------------------------------------------------------------------
  */
-int 
-HtmlCssInlineParse(
-    HtmlTree *pTree,
-    int n,
-    const char *z,
-    CssPropertySet **ppPropertySet
-){
-    CssStyleSheet *pStyle = 0;
-    assert(ppPropertySet && !(*ppPropertySet));
-    cssParse(pTree, n, z, 1, 0, 0, 0, 0, 0, &pStyle);
+static void
+cssCompiledParse (const char *z, int n, CssParse *pParse)
+{
+    unsigned int iHash = cssCompiledHash(z, n);
+    int isAgent = (pParse->origin == CSS_ORIGIN_AGENT);
+    Tcl_Obj *pDirectory = 0;
+    CssCompiled *p;
+    CssRuleSet *pSet;
+
+    Tcl_MutexLock(&cssCompiledMutex);
+    cssCompiledInit();
+    p = cssCompiledFind(z, n, iHash);
+    if (cssCompiledCache.zDirectory) {
+        pDirectory = Tcl_NewStringObj(cssCompiledCache.zDirectory, -1);
+        Tcl_IncrRefCount(pDirectory);
+    }
+    if (p) {
+        cssCompiledCache.nHit++;
+        p->nRef++;
+        cssCompiledUnlink(p);
+        cssCompiledLink(p);
+        if (isAgent && !p->isAgent) {
+            p->isAgent = 1;
+            cssCompiledCache.nEvictable--;
+        }
+    }
+    Tcl_MutexUnlock(&cssCompiledMutex);
+
+    /* The cache does not contain this stylesheet. Try to load it from
+     * the on-disk cache. If that fails, run the parser and record the
+     * callbacks it makes, collecting the rules created in a new rule-set
+     * at the same time. The mutex is not held while the file is read or
+     * the parser runs, as the parser may invoke -importcmd scripts
+     * that parse other stylesheets.
+     */
+    if (!p) {
+        int isDisk = 0;
+        pSet = 0;
+        if (pDirectory) {
+            p = cssCompiledRead(pDirectory, z, n, iHash);
+            isDisk = (p != 0);
+        }
+        if (!p) {
+            p = cssCompiledNew(z, n, iHash);
+            pSet = ruleSetNew(pParse, p);
+            pParse->pCompile = p;
+            pParse->pRuleSet = pSet;
+            HtmlCssRunParser(p->zText, n, pParse);
+            pParse->pCompile = 0;
+            pParse->pRuleSet = 0;
+            if (p->nOp > 0 && p->nOp < p->nOpAlloc) {
+                p->aOp = (CssCompiledOp *)HtmlRealloc("CssCompiled.aOp", 
+                    (char *)p->aOp, p->nOp * sizeof(CssCompiledOp)
+                );
+                p->nOpAlloc = p->nOp;
+            }
+            if (pDirectory && cssCompiledWrite(pDirectory, p)) {
+                isDisk = -1;
+            }
+        }
 
-    if (pStyle) {
-        if (pStyle->pUniversalRules) {
-            assert(!pStyle->pUniversalRules->pNext);
-            *ppPropertySet = pStyle->pUniversalRules->pPropertySet;
-            pStyle->pUniversalRules->pPropertySet = 0;
+        Tcl_MutexLock(&cssCompiledMutex);
+        cssCompiledInit();
+        cssCompiledCache.nMiss++;
+        if (isDisk > 0) cssCompiledCache.nDiskRead++;
+        if (isDisk < 0) cssCompiledCache.nDiskWrite++;
+        p->isAgent = isAgent;
+        p->nRef = 1;
+        if (cssCompiledFind(z, n, iHash)) {
+            /* Another thread got there first. Object p will be deleted
+             * when the reference held by this function (or by pSet) is
+             * released. 
+             */
+            p->isEvicted = 1;
+        } else {
+            cssCompiledInsert(p);
+        }
+        Tcl_MutexUnlock(&cssCompiledMutex);
+
+        if (pSet) {
+            ruleSetRegister(pParse, pSet);
+            p = 0;
         }
-        assert(!pStyle->pPriority);
-        HtmlCssStyleSheetFree(pStyle);
     }
-    return 0;
+
+    /* If p is not NULL, the compiled stylesheet is available and this
+     * function holds a reference to it. If another widget in this
+     * interpreter has already built the rules for this document, share 
+     * them. In this case only the @import directives and syntax errors
+     * need to be replayed. Otherwise, replay the whole program and
+     * collect the rules created in a new shared rule set.
+     */
+    if (p) {
+        pSet = ruleSetFind(pParse, p);
+        if (pSet) {
+            ruleSetInstantiate(pParse, pSet);
+            cssCompiledReplay(pParse, p, 1);
+            cssCompiledRelease(p);
+        } else {
+            pSet = ruleSetNew(pParse, p);
+            pParse->pRuleSet = pSet;
+            cssCompiledReplay(pParse, p, 0);
+            pParse->pRuleSet = 0;
+            ruleSetRegister(pParse, pSet);
+        }
+    }
+
+    if (pDirectory) {
+        Tcl_DecrRefCount(pDirectory);
+    }
 }
 
 /*
  *---------------------------------------------------------------------------
  *
- * ruleFree --
+ * HtmlCssStyleCacheCmd --
  *
- *     Free the CssRule object pRule.
+ *     Implementation of the [::tkhtml::stylecache] command:
+ *
+ *         ::tkhtml::stylecache ?-clear? ?-directory DIR? ?-limit N?
+ *
+ *     The -clear option discards all compiled stylesheets held in memory.
+ *     Option -directory enables the on-disk cache (or disables it, if DIR
+ *     is an empty string). Option -limit sets the number of author and 
+ *     user stylesheets kept in memory.
  *
  * Results:
- *     None.
+ *     Returns a key-value list of statistics describing the cache.
  *
  * Side effects:
- *     None.
+ *     May modify the process-wide compiled stylesheet cache.
  *
  *---------------------------------------------------------------------------
  */
-static void 
-ruleFree (CssRule *pRule)
+int
+HtmlCssStyleCacheCmd (
+    ClientData clientData,             /* Unused */
+    Tcl_Interp *interp,                /* Current interpreter */
+    int objc,                          /* Number of arguments */
+    Tcl_Obj *CONST objv[]              /* Argument strings */
+)
 {
-    if (pRule) {
-        if (pRule->freeSelector) {
-            selectorFree(pRule->pSelector);
+    struct StyleCacheOption {
+        const char *zOption;
+        int hasArg;
+        Tcl_Obj *pArg;
+        int isSet;
+    } aOption[] = {
+        {"-clear",     0, 0, 0},
+        {"-directory", 1, 0, 0},
+        {"-limit",     1, 0, 0},
+        {0, 0, 0, 0}
+    };
+    CssCompiled *p;
+    Tcl_Obj *pRet;
+    int iLimit = 0;
+    int nByte = 0;
+    int ii;
+
+    for (ii = 1; ii < objc; ii++) {
+        int iChoice;
+        if (Tcl_GetIndexFromObjStruct(interp, objv[ii], aOption, 
+            sizeof(struct StyleCacheOption), "option", 0, &iChoice)
+        ){
+            return TCL_ERROR;
         }
-        if (pRule->freePropertySets) {
-            propertySetFree(pRule->pPropertySet);
+        if (aOption[iChoice].hasArg) {
+            ii++;
+            if (ii == objc) {
+                const char *z = Tcl_GetString(objv[ii - 1]);
+                Tcl_AppendResult(interp, "option requires an argument: ", z, 0);
+                return TCL_ERROR;
+            }
+            aOption[iChoice].pArg = objv[ii];
+        }
+        aOption[iChoice].isSet = 1;
+    }
+    if (aOption[2].isSet) {
+        if (Tcl_GetIntFromObj(interp, aOption[2].pArg, &iLimit)) {
+            return TCL_ERROR;
+        }
+        if (iLimit < 0) {
+            Tcl_AppendResult(interp, "bad -limit: ", 
+                Tcl_GetString(aOption[2].pArg), 0
+            );
+            return TCL_ERROR;
         }
-        HtmlFree(pRule);
     }
-}
 
-static void 
-freeRulesList (CssRule **ppList)
-{
-    CssRule *pRule = *ppList;
-    while (pRule) { 
-        CssRule *pNext = pRule->pNext;
-        ruleFree(pRule);
-        pRule = pNext;
+    Tcl_MutexLock(&cssCompiledMutex);
+    cssCompiledInit();
+    if (aOption[0].isSet) {
+        while (cssCompiledCache.pFirst) {
+            cssCompiledEvict(cssCompiledCache.pFirst);
+        }
+        cssCompiledCache.nHit = 0;
+        cssCompiledCache.nMiss = 0;
+        cssCompiledCache.nDiskRead = 0;
+        cssCompiledCache.nDiskWrite = 0;
+    }
+    if (aOption[1].isSet) {
+        /* Store the path as a string, as Tcl_Obj structures may not be
+         * shared between threads. 
+         */
+        int n;
+        const char *z = Tcl_GetStringFromObj(aOption[1].pArg, &n);
+        HtmlFree(cssCompiledCache.zDirectory);
+        cssCompiledCache.zDirectory = 0;
+        if (n > 0) {
+            cssCompiledCache.zDirectory = HtmlAlloc("stylecache", n + 1);
+            memcpy(cssCompiledCache.zDirectory, z, n + 1);
+        }
+    }
+    if (aOption[2].isSet) {
+        cssCompiledCache.nLimit = iLimit;
+        cssCompiledTrim();
     }
-    *ppList = 0;
-}
 
-static void
-freeRulesHash(Tcl_HashTable *pHash)
-{
-    Tcl_HashSearch search;
-    Tcl_HashEntry *pEntry;
-  
-    for (
-        pEntry = Tcl_FirstHashEntry(pHash, &search); 
-        pEntry; 
-        pEntry = Tcl_NextHashEntry(&search)
-    ) {
-        CssRule *pRule = (CssRule *)Tcl_GetHashValue(pEntry);
-        freeRulesList(&pRule);
+    for (p = cssCompiledCache.pFirst; p; p = p->pNext) {
+        nByte += sizeof(CssCompiled) + p->nText + 1;
+        nByte += p->nOpAlloc * sizeof(CssCompiledOp);
     }
-    Tcl_DeleteHashTable(pHash);
+
+    pRet = Tcl_NewObj();
+#define STAT(zName, iVal) \
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj(zName, -1)); \
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewIntObj(iVal));
+    STAT("sheets", cssCompiledCache.nSheet);
+    STAT("bytes", nByte);
+    STAT("limit", cssCompiledCache.nLimit);
+    STAT("hits", cssCompiledCache.nHit);
+    STAT("misses", cssCompiledCache.nMiss);
+    STAT("diskreads", cssCompiledCache.nDiskRead);
+    STAT("diskwrites", cssCompiledCache.nDiskWrite);
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj("directory", -1));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj(
+        cssCompiledCache.zDirectory ? cssCompiledCache.zDirectory : "", -1
+    ));
+    Tcl_MutexUnlock(&cssCompiledMutex);
+
+    /* Statistics for interned property values and inline style sets. */
+    Tcl_MutexLock(&cssInternMutex);
+    cssInternInit();
+    STAT("values", cssIntern.aProperty.numEntries);
+    STAT("valuerefs", cssIntern.nPropertyRef);
+    STAT("inlinestyles", cssIntern.aInline.numEntries);
+    STAT("inlinerefs", cssIntern.nInlineRef);
+    STAT("bytessaved", cssIntern.nByteSaved);
+    Tcl_MutexUnlock(&cssInternMutex);
+#undef STAT
+
+    Tcl_SetObjResult(interp, pRet);
+    return TCL_OK;
 }
 
 /*
  *---------------------------------------------------------------------------
  *
- * HtmlCssStyleSheetFree --
+ * cssParse --
  *
- *     Delete the internal representation of the stylesheet configuration.
+ *     This routine does the work of parsing stylesheets or style
+ *     attributes on behalf of HtmlCssParse() and HtmlCssInlineParse()
+ *     respectively. 
+ * 
+ *     The first two argument identify the length of, and the text to be
+ *     parsed.
+ *
+ *     The third argument is true if z points to the text of a style
+ *     attribute, i.e: "color:red ; margin:0.4em". If false, then z points
+ *     to a complete stylesheet document, i.e. "H1 {text-size: 1.2em}". 
+ *     The stylesheet produced when parsing a style is the same as 
+ *     "* {<style text>}".
  *
  * Results:
  *     None.
@@ -2414,999 +3161,3430 @@ freeRulesHash(Tcl_HashTable *pHash)
  *
  *---------------------------------------------------------------------------
  */
-void 
-HtmlCssStyleSheetFree (CssStyleSheet *pStyle)
+static int 
+cssParse(
+    HtmlTree *pTree,
+    int n,                       /* Size of z in bytes */
+    CONST char *z,               /* Text of attribute/document */
+    int isStyle,                 /* True if this is a style attribute */
+    int origin,                  /* CSS_ORIGIN_* value */
+    Tcl_Obj *pStyleId,           /* Second and later parts of stylesheet id */
+    Tcl_Obj *pImportCmd,         /* Command to invoke to process @import */
+    Tcl_Obj *pUrlCmd,            /* Command to invoke to translate url() */
+    Tcl_Obj *pErrorVar,          /* Name of error-log variable */
+    CssStyleSheet **ppStyle      /* IN/OUT: Stylesheet to append to   */
+    )
 {
+    CssParse sParse;
+    int ii;
+
+    memset(&sParse, 0, sizeof(CssParse));
+    sParse.origin = origin;
+    sParse.pStyleId = pStyleId;
+    sParse.pImportCmd = pImportCmd;
+    sParse.pUrlCmd = pUrlCmd;
+    sParse.interp = (pTree ? pTree->interp : 0);
+    sParse.pTree = pTree;
+    if (pErrorVar) {
+        sParse.pErrorLog = Tcl_NewObj();
+        Tcl_IncrRefCount(sParse.pErrorLog);
+    }
+
+    if( n<0 ){
+        n = strlen(z);
+    }
+
+    /* If *ppStyle is NULL, then create a new CssStyleSheet object. If it
+     * is not zero, then append the rules from the new stylesheet document
+     * to the existing object.
+     */
+    if (0==*ppStyle) {
+        sParse.pStyle = HtmlNew(CssStyleSheet);
+        
+        /* If pStyleId is not NULL, then initialise the hash-tables */
+        if (pStyleId) {
+            Tcl_InitHashTable(&sParse.pStyle->aByTag, TCL_STRING_KEYS);
+            Tcl_InitHashTable(&sParse.pStyle->aByClass, TCL_STRING_KEYS);
+            Tcl_InitHashTable(&sParse.pStyle->aById, TCL_STRING_KEYS);
+        }
+    } else {
+        sParse.pStyle = *ppStyle;
+        matchCacheFree(sParse.pStyle);
+        attrIndexFree(sParse.pStyle);
+
+        /* If rules are being added to the stylesheet of a document that 
+         * has already been styled, record the keys of the new rules so 
+         * that only the elements they may match need be restyled.
+         */
+        if (pStyleId && ppStyle == &pTree->pStyle && pTree->pRoot && 
+            !sParse.pStyle->pInvalid
+        ) {
+            CssInvalidation *pInvalid = HtmlNew(CssInvalidation);
+            Tcl_InitHashTable(&pInvalid->aTag, TCL_STRING_KEYS);
+            Tcl_InitHashTable(&pInvalid->aClass, TCL_STRING_KEYS);
+            Tcl_InitHashTable(&pInvalid->aId, TCL_STRING_KEYS);
+            sParse.pStyle->pInvalid = pInvalid;
+        }
+    }
+
+    /* If this is a stylesheet, not a style attribute, add the priority
+     * entries for both regular and "!important" properties for this
+     * stylesheet to the priority list.
+     *
+     * TODO: Sometimes people specify "!important" inside of style 
+     * attributes. Tkhtml currently ignores this. Not sure if that's 
+     * right or not...
+     */
+    if (pStyleId) {
+        sParse.pPriority1 = newCssPriority(sParse.pStyle, origin, pStyleId, 0);
+        sParse.pPriority2 = newCssPriority(sParse.pStyle, origin, pStyleId, 1);
+    }
+
+    /* Stylesheet documents go through the compiled stylesheet cache. Style
+     * attributes and selectors (pStyleId==0) are parsed directly.
+     */
+    if (isStyle) {
+        HtmlCssRunStyleParser(z, n, &sParse);
+    } else if (pStyleId) {
+        cssCompiledParse(z, n, &sParse);
+    } else {
+        HtmlCssRunParser(z, n, &sParse);
+    }
+
+    *ppStyle = sParse.pStyle;
+
+    /* Clean up anything left in sParse */
+    selectorFree(sParse.pSelector);
+    for (ii = 0; ii < sParse.nXtra; ii++) {
+        selectorFree(sParse.apXtraSelector[ii]);
+    }
+    propertySetFree(sParse.pPropertySet);
+    propertySetFree(sParse.pImportant);
+
+    if (pErrorVar) {
+        Tcl_ObjSetVar2(pTree->interp, pErrorVar, 0, sParse.pErrorLog, 0);
+        Tcl_DecrRefCount(sParse.pErrorLog);
+    }
+
+    return 0;
+}
+
+int 
+HtmlCssSelectorParse (HtmlTree *pTree, int n, const char *z, CssStyleSheet **ppStyle)
+{
+    return cssParse(pTree, n, z, 0, 0, 0, 0, 0, 0, ppStyle);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlStyleParse --
+ *
+ *     Compile a stylesheet document from text and add it to the widget.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+int 
+HtmlStyleParse(
+    HtmlTree *pTree,
+    Tcl_Obj *pStyleText,
+    Tcl_Obj *pId,
+    Tcl_Obj *pImportCmd,
+    Tcl_Obj *pUrlCmd,
+    Tcl_Obj *pErrorVar
+    )
+{
+    int origin = 0;
+    Tcl_Obj *pStyleId = 0;
+    CONST char *zId;
+    CONST char *zStyleText;
+    int nStyleText;
+
+    /* Parse up the stylesheet id. It must begin with one of the strings
+     * "agent", "user" or "author". After that it may contain any text.
+     */
+    zId = Tcl_GetString(pId);
+    if (0==strncmp("agent", zId, 5)) {
+        origin = CSS_ORIGIN_AGENT;
+        pStyleId = Tcl_NewStringObj(&zId[5], -1);
+    }
+    else if (0==strncmp("user", zId, 4)) {
+        origin = CSS_ORIGIN_USER;
+        pStyleId = Tcl_NewStringObj(&zId[4], -1);
+    }
+    else if (0==strncmp("author", zId, 5)) {
+        origin = CSS_ORIGIN_AUTHOR;
+        pStyleId = Tcl_NewStringObj(&zId[6], -1);
+    }
+    if (!pStyleId) {
+        Tcl_AppendResult(pTree->interp, "Bad style-sheet-id: ", zId, 0);
+        return TCL_ERROR;
+    }
+    Tcl_IncrRefCount(pStyleId);
+
+    /* If there is already a stylesheet in pTree->pStyle, then this call will
+     * parse the stylesheet text in pStyleText and append rules to the
+     * existing stylesheet. If pTree->pStyle is NULL, then a new stylesheet is
+     * created. Within Tkhtml, each document only ever has a single stylesheet
+     * object, possibly created by combining text from multiple stylesheet
+     * documents.
+     */
+    zStyleText = Tcl_GetStringFromObj(pStyleText, &nStyleText);
+    cssParse(
+        pTree,
+        nStyleText, zStyleText,            /* Stylesheet text */
+        0,                                 /* This is not a style attribute */
+        origin,                            /* Origin - CSS_ORIGIN_XXX */
+        pStyleId,                          /* Rest of -id option */
+        pImportCmd,                        /* How to handle @import */
+        pUrlCmd,                           /* How to handle url() */
+        pErrorVar,                         /* Variable to store errors in */
+        &pTree->pStyle                     /* CssStylesheet to update/create */
+    );
+
+    Tcl_DecrRefCount(pStyleId);
+    return TCL_OK;
+}
+
+/*--------------------------------------------------------------------------
+ *
+ * HtmlCssInlineParse --
+ *
+ *     Parse the style attribute value pointed to by z, length n bytes. See
+ *     comments above cssParse() for more detail.
+ *
+ * Results:
+ *
+ *     Returns a CssStyleSheet pointer, written to *ppStyle.
+ *
+ * Side effects:
+ *
+ *--------------------------------------------------------------------------
+ */
+int 
+HtmlCssInlineParse(
+    HtmlTree *pTree,
+    int n,
+    const char *z,
+    CssPropertySet **ppPropertySet
+){
+    CssStyleSheet *pStyle = 0;
+    CssPropertySet *pSet = 0;
+    Tcl_HashEntry *pEntry;
+    Tcl_DString key;
+    char zBuf[64];
+    int isNew;
+
+    assert(ppPropertySet && !(*ppPropertySet));
+
+    /* The result of parsing a style attribute depends on the parse mode
+     * (quirks or standards) and the font-family map of the widget as 
+     * well as the text of the attribute. If an identical attribute
+     * has already been parsed, share the property set.
+     */
+    Tcl_DStringInit(&key);
+    sprintf(zBuf, "%p %d ", (void *)pTree, pTree->options.mode);
+    Tcl_DStringAppend(&key, zBuf, -1);
+    Tcl_DStringAppend(&key, z, n);
+
+    Tcl_MutexLock(&cssInternMutex);
+    cssInternInit();
+    pEntry = Tcl_FindHashEntry(&cssIntern.aInline, Tcl_DStringValue(&key));
+    if (pEntry) {
+        pSet = (CssPropertySet *)Tcl_GetHashValue(pEntry);
+        pSet->nRef++;
+        cssIntern.nInlineRef++;
+        cssIntern.nByteSaved += propertySetSize(pSet);
+    }
+    Tcl_MutexUnlock(&cssInternMutex);
+
+    if (!pSet) {
+        cssParse(pTree, n, z, 1, 0, 0, 0, 0, 0, &pStyle);
+        if (pStyle) {
+            if (pStyle->pUniversalRules) {
+                assert(!pStyle->pUniversalRules->pNext);
+                pSet = pStyle->pUniversalRules->pPropertySet;
+                pStyle->pUniversalRules->pPropertySet = 0;
+            }
+            assert(!pStyle->pPriority);
+            HtmlCssStyleSheetFree(pStyle);
+        }
+
+        if (pSet) {
+            Tcl_MutexLock(&cssInternMutex);
+            pEntry = Tcl_CreateHashEntry(
+                &cssIntern.aInline, Tcl_DStringValue(&key), &isNew
+            );
+            assert(isNew);
+            Tcl_SetHashValue(pEntry, pSet);
+            pSet->pEntry = pEntry;
+            pSet->nRef = 1;
+            cssIntern.nInlineRef++;
+            Tcl_MutexUnlock(&cssInternMutex);
+        }
+    }
+
+    Tcl_DStringFree(&key);
+    *ppPropertySet = pSet;
+    return 0;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ruleFree --
+ *
+ *     Free the CssRule object pRule.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void 
+ruleFree (CssRule *pRule)
+{
+    if (pRule) {
+        if (pRule->freeSelector) {
+            selectorFree(pRule->pSelector);
+        }
+        if (pRule->freePropertySets) {
+            propertySetFree(pRule->pPropertySet);
+        }
+        HtmlFree(pRule);
+    }
+}
+
+static void 
+freeRulesList (CssRule **ppList)
+{
+    CssRule *pRule = *ppList;
+    while (pRule) { 
+        CssRule *pNext = pRule->pNext;
+        ruleFree(pRule);
+        pRule = pNext;
+    }
+    *ppList = 0;
+}
+
+static void
+freeRulesHash(Tcl_HashTable *pHash)
+{
+    Tcl_HashSearch search;
+    Tcl_HashEntry *pEntry;
+  
+    for (
+        pEntry = Tcl_FirstHashEntry(pHash, &search); 
+        pEntry; 
+        pEntry = Tcl_NextHashEntry(&search)
+    ) {
+        CssRule *pRule = (CssRule *)Tcl_GetHashValue(pEntry);
+        freeRulesList(&pRule);
+    }
+    Tcl_DeleteHashTable(pHash);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlCssStyleSheetFree --
+ *
+ *     Delete the internal representation of the stylesheet configuration.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+void 
+HtmlCssStyleSheetFree (CssStyleSheet *pStyle)
+{
+    if (pStyle) {
+        CssPriority *pPriority;
+        int ii;
+
+        matchCacheFree(pStyle);
+        attrIndexFree(pStyle);
+        invalidationFree(&pStyle->pInvalid);
+        invalidationFree(&pStyle->pInvalidApply);
+
+        /* Free the universal rules list */
+        freeRulesList(&pStyle->pUniversalRules); 
+        freeRulesList(&pStyle->pAfterRules); 
+        freeRulesList(&pStyle->pBeforeRules); 
+        freeRulesHash(&pStyle->aByTag); 
+        freeRulesHash(&pStyle->aByClass); 
+        freeRulesHash(&pStyle->aById); 
+
+        /* Release the shared rule-sets. This must be done after the rules
+         * themselves are freed. */
+        for (ii = 0; ii < pStyle->nRuleSet; ii++) {
+            ruleSetRelease(pStyle->apRuleSet[ii]);
+        }
+        HtmlFree(pStyle->apRuleSet);
+
+        /* Free the priorities list */
+        pPriority = pStyle->pPriority;
+        while (pPriority) {
+            CssPriority *pNext = pPriority->pNext;
+            Tcl_DecrRefCount(pPriority->pIdTail);
+            HtmlFree(pPriority);
+            pPriority = pNext;
+        }
+
+        HtmlFree(pStyle);
+    }
+}
+
+/*
+** Return the number of syntax errors that occured while parsing the
+** style-sheet.
+*/
+int HtmlCssStyleSheetSyntaxErrs(CssStyleSheet *pStyle){
+    return pStyle->nSyntaxErr;
+}
+
+/*--------------------------------------------------------------------------
+ *
+ * HtmlCssDeclaration --
+ *
+ *     This function is called by the CSS parser when it parses a property 
+ *     declaration (i.e "<property> : <expression>").
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *
+ *--------------------------------------------------------------------------
+ */
+void 
+HtmlCssDeclaration (
+    CssParse *pParse,
+    CssToken *pProp,
+    CssToken *pExpr,
+    int isImportant         /* True if the !IMPORTANT symbol was seen */
+)
+{
+    int prop; 
+    CssPropertySet **ppPropertySet;
+    char zBuf[128];
+    int nBefore;
+
+    /* Do nothing if the isIgnore flag is set */
+    if (pParse->isIgnore) return;
+    if (pParse->pCompile) {
+        cssCompiledRecord(pParse, CSS_OP_DECLARATION, isImportant, pProp, pExpr);
+    }
+
+#if TRACE_PARSER_CALLS
+    printf("HtmlCssDeclaration(%p, \"%.*s\", \"%.*s\", %d)\n", 
+        pParse,
+        pProp?pProp->n:0, pProp?pProp->z:"", 
+        pExpr?pExpr->n:0, pExpr?pExpr->z:"",
+        isImportant
+    );
+#endif
+
+    if (pParse->pStyleId == 0) {
+        isImportant = 0;
+    }
+
+    /* Resolve the property name. If we don't recognize it, then ignore the
+     * declaration (CSS2 spec says to do this - besides, what else could we
+     * do?).
+     */
+#if 0
+    prop = HtmlCssPropertyLookup(pProp->n, pProp->z);
+#else
+    if (pProp->n > 127) pProp->n = 127;
+    memcpy(zBuf, pProp->z, pProp->n);
+    zBuf[pProp->n] = '\0';
+    dequote(zBuf);
+    prop = HtmlCssPropertyLookup(-1, zBuf);
+#endif
+    if( prop<0 ) return;
+
+    if (isImportant) {
+        ppPropertySet = &pParse->pImportant;
+    } else {
+        ppPropertySet = &pParse->pPropertySet;
+    }
+    if( !*ppPropertySet ){
+        *ppPropertySet = propertySetNew();
+    }
+    nBefore = (*ppPropertySet)->n;
+
+    switch (prop) {
+        case CSS_SHORTCUTPROPERTY_BORDER:
+        case CSS_SHORTCUTPROPERTY_BORDER_LEFT:
+        case CSS_SHORTCUTPROPERTY_BORDER_RIGHT:
+        case CSS_SHORTCUTPROPERTY_BORDER_TOP:
+        case CSS_SHORTCUTPROPERTY_BORDER_BOTTOM:
+            propertySetAddShortcutBorder(pParse, *ppPropertySet, prop, pExpr);
+            break;
+        case CSS_SHORTCUTPROPERTY_BORDER_COLOR:
+        case CSS_SHORTCUTPROPERTY_BORDER_STYLE:
+        case CSS_SHORTCUTPROPERTY_BORDER_WIDTH:
+        case CSS_SHORTCUTPROPERTY_PADDING:
+        case CSS_SHORTCUTPROPERTY_MARGIN:
+            propertySetAddShortcutBorderColor(*ppPropertySet, prop, pExpr);
+            break;
+        case CSS_SHORTCUTPROPERTY_BACKGROUND:
+            shortcutBackground(pParse, *ppPropertySet, pExpr);
+            break;
+        case CSS_SHORTCUTPROPERTY_BACKGROUND_POSITION:
+            shortcutBackgroundPosition(pParse, *ppPropertySet, pExpr);
+            break;
+        case CSS_SHORTCUTPROPERTY_FONT:
+            propertySetAddShortcutFont(pParse, *ppPropertySet, pExpr);
+            break;
+        case CSS_PROPERTY_FONT_FAMILY:
+            propertySetAddFontFamily(pParse, *ppPropertySet, pExpr);
+            break;
+        case CSS_SHORTCUTPROPERTY_LIST_STYLE:
+            shortcutListStyle(pParse, *ppPropertySet, pExpr);
+            break;
+        case CSS_PROPERTY_CONTENT:
+        case CSS_PROPERTY_COUNTER_INCREMENT:
+        case CSS_PROPERTY_COUNTER_RESET:
+            propertySetAddList(pParse, prop, *ppPropertySet, pExpr);
+            break;
+        default:
+            propertySetAdd(*ppPropertySet, prop, tokenToProperty(pParse,pExpr));
+    }
+
+    /* Replace the values just added with interned copies. This is not
+     * done by propertySetAdd() as some of the shortcut property handlers
+     * duplicate values after adding them to the set. propertySetAdd()
+     * never replaces a value in place - a repeated property is appended
+     * as a new entry - so the values added by this declaration are
+     * exactly those at index nBefore and greater. Entries before nBefore
+     * were interned by earlier declarations.
+     */
+    propertySetIntern(*ppPropertySet, nBefore);
+}
+
+
+
+/*--------------------------------------------------------------------------
+ *
+ * HtmlCssSelector --
+ *
+ *     This is called whenever a simple selector is parsed. 
+ *     i.e. "H1" or ":before".
+ *
+ *     A CssSelector struct is allocated and added to the beginning of the
+ *     linked list at pParse->pSelector;
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *
+ *--------------------------------------------------------------------------
+ */
+void 
+HtmlCssSelector (
+    CssParse *pParse,
+    int stype,               /* One of the CSS_SELECTOR_TYPE_XXX values */
+    CssToken *pAttr,
+    CssToken *pValue
+)
+{
+    CssSelector *pSelector;
+
+    /* Do nothing if the isIgnore flag is set */
+    if (pParse->isIgnore) return;
+    if (pParse->pCompile) {
+        cssCompiledRecord(pParse, CSS_OP_SELECTOR, stype, pAttr, pValue);
+    }
+
+#if TRACE_PARSER_CALLS
+    /* I used this to make sure the parser was passing the components of
+     * selectors to this function in the correct order. Once this was 
+     * verified, it is not particularly useful trace output. But we'll leave
+     * it here for the time being in case something comes up.
+     */
+    printf("HtmlCssSelector(%p, %s, \"%.*s\", \"%.*s\")\n", 
+        pParse, constantToString(stype), 
+        pAttr?pAttr->n:0, pAttr?pAttr->z:"", 
+        pValue?pValue->n:0, pValue?pValue->z:""
+    );
+#endif
+
+    pSelector = HtmlNew(CssSelector);
+    pSelector->eSelector = stype;
+    pSelector->zValue = tokenToString(pValue);
+    pSelector->zAttr = tokenToString(pAttr);
+    pSelector->pNext = pParse->pSelector;
+    pSelector->isDynamic = (
+        (pSelector->pNext && pSelector->pNext->isDynamic) ||
+#if 0
+        (stype == CSS_PSEUDOCLASS_LINK)                   ||
+        (stype == CSS_PSEUDOCLASS_VISITED)                ||
+#endif
+        (stype == CSS_PSEUDOCLASS_HOVER)                  ||
+        (stype == CSS_PSEUDOCLASS_FOCUS)                  ||
+        (stype == CSS_PSEUDOCLASS_ACTIVE)
+    ) ? 1 : 0;
+    pParse->pSelector = pSelector;
+    dequote(pSelector->zValue);
+
+    /* Tag names are case-insensitive - fold to lower case */
+    if( stype==CSS_SELECTOR_TYPE ){
+        assert(pSelector->zValue);
+        Tcl_UtfToLower(pSelector->zValue);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ruleCompare --
+ *
+ *     Compare the priority of two rule objects. Return greater than zero
+ *     if the priority of pLeft is higher, zero if the two rules have the
+ *     same priority, and negative if pRight has higher priority. i.e.:
+ *
+ *         PRIORITY(pLeft) - PRIORITY(pRight)
+ *
+ *     This function is used to determine the order of rules in the
+ *     rules CssRule.pNext linked list.
+ *
+ * Results:
+ *     See above.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int 
+ruleCompare(CssRule *pLeft, CssRule *pRight) {
+    int res = 0;
+
+    assert(pLeft && pRight);
+    assert(
+        (pLeft->pPriority && pRight->pPriority) ||  
+        (!pLeft->pPriority && !pRight->pPriority)
+    );
+    if( !pLeft->pPriority ) return 0;
+
+    res = pLeft->pPriority->iPriority - pRight->pPriority->iPriority;
+    if (res == 0) {
+        /* But here we want (left - right), because specificity is higher
+         * for more specific rules.
+         */
+        res = pLeft->specificity - pRight->specificity;
+
+        if (res == 0) {
+            /* Compare the stylesheet ids. CssPriority.iIdRank is 
+             * maintained by newCssPriority() so that this is the same as
+             * comparing the CssPriority.pIdTail strings with strcmp().
+             */
+            res = pLeft->pPriority->iIdRank - pRight->pPriority->iIdRank;
+
+            if (res == 0) {
+                /* If we get here, the rules have the same specificity,
+                 * come from the same stylesheet and both either have the
+                 * !IMPORTANT flag set or cleared. In this case the higher
+                 * priority rule is the one that appeared later in the 
+                 * source stylesheet.
+                 */
+		res = pLeft->iRule - pRight->iRule;
+            }
+        }
+    }
+    return res;
+}
+
+static void 
+insertRule (CssRule **ppList, CssRule *pRule)
+{
+    if (!*ppList || ruleCompare(*ppList, pRule) <= 0) {
+        /* If the default list is currently empty, or the rule being
+         * added has higher priority than the first rule in the list,
+         * our rule becomes the new head of the list.
+         */
+        pRule->pNext = *ppList;
+        *ppList = pRule;
+    } else {
+        /* Otherwise insert the new rule into the list, ordered by
+         * priority. If there exists another rule with the same
+         * priority, then this rule is inserted into the list *before*
+         * it. This is because when rules are of equal priority, the
+         * latter specified wins.
+         */
+        CssRule *pR = *ppList;
+        while (pR->pNext && ruleCompare(pR->pNext, pRule)>0 ) {
+            pR = pR->pNext;
+        }
+        pRule->pNext = pR->pNext;
+        pR->pNext = pRule;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * invalidationAddRule --
+ *
+ *     Record the key of the elements that rule pRule may match in the
+ *     invalidation set pInvalid. An id is preferred over a class, and 
+ *     a class over a tag name, as the most selective key.
+ *
+ *     A rule that sets 'counter-increment' or 'counter-reset' may change
+ *     the values of counters used by elements that it does not match, 
+ *     so in this case the whole document must be restyled.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     May set pInvalid->isAll.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+invalidationAddRule (CssInvalidation *pInvalid, CssRule *pRule)
+{
+    CssPropertySet *pSet = pRule->pPropertySet;
+    CssSelector *p;
+    CssSelector *pKey = 0;
+    Tcl_HashTable *pTab = 0;
+    int isNew;
+    int ii;
+
+    for (ii = 0; pSet && ii < pSet->n; ii++) {
+        int eProp = pSet->a[ii].eProp;
+        if (eProp == CSS_PROPERTY_COUNTER_INCREMENT || 
+            eProp == CSS_PROPERTY_COUNTER_RESET
+        ) {
+            pInvalid->isAll = 1;
+            return;
+        }
+    }
+
+    for (p = pRule->pSelector; p; p = p->pNext) {
+        if (p->eSelector == CSS_SELECTORCHAIN_DESCENDANT ||
+            p->eSelector == CSS_SELECTORCHAIN_CHILD ||
+            p->eSelector == CSS_SELECTORCHAIN_ADJACENT
+        ) {
+            break;
+        }
+        if (p->eSelector == CSS_SELECTOR_ID) {
+            pKey = p;
+            pTab = &pInvalid->aId;
+        } else if (p->eSelector == CSS_SELECTOR_CLASS && 
+            pTab != &pInvalid->aId
+        ) {
+            pKey = p;
+            pTab = &pInvalid->aClass;
+        } else if (p->eSelector == CSS_SELECTOR_TYPE && !pKey) {
+            pKey = p;
+            pTab = &pInvalid->aTag;
+        }
+    }
+
+    if (pKey) {
+        Tcl_CreateHashEntry(pTab, pKey->zValue, &isNew);
+    } else {
+        pInvalid->isAll = 1;
+    }
+}
+
+static void
+invalidationFree (CssInvalidation **ppInvalid)
+{
+    CssInvalidation *pInvalid = *ppInvalid;
+    if (pInvalid) {
+        Tcl_DeleteHashTable(&pInvalid->aTag);
+        Tcl_DeleteHashTable(&pInvalid->aClass);
+        Tcl_DeleteHashTable(&pInvalid->aId);
+        HtmlFree(pInvalid);
+        *ppInvalid = 0;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlCssInvalidationIsPartial --
+ *
+ *     Return true if rules have been added to the stylesheet since the
+ *     document was last styled, and each of them has an id, class or
+ *     tag key. In this case only the elements that match one of the keys,
+ *     and their descendants, need be restyled.
+ *
+ * Results:
+ *     True or false.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+HtmlCssInvalidationIsPartial (HtmlTree *pTree)
+{
+    CssStyleSheet *pStyle = pTree->pStyle;
+    return (pStyle && pStyle->pInvalid && !pStyle->pInvalid->isAll);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlCssInvalidationBegin --
+ *
+ *     This is called by HtmlStyleApply() before it restyles the document.
+ *     The keys of the rules added since the document was last styled are
+ *     set aside to be tested by HtmlCssInvalidationTest() during the 
+ *     pass. Rules added while the pass is running (i.e. by a tcl() 
+ *     property script) record their keys in a new set, for the next pass.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+HtmlCssInvalidationBegin (HtmlTree *pTree)
+{
+    CssStyleSheet *pStyle = pTree->pStyle;
     if (pStyle) {
-        CssPriority *pPriority;
+        invalidationFree(&pStyle->pInvalidApply);
+        pStyle->pInvalidApply = pStyle->pInvalid;
+        pStyle->pInvalid = 0;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlCssInvalidationTest --
+ *
+ *     Test if node pNode may be matched by one of the rules whose keys
+ *     were set aside by HtmlCssInvalidationBegin().
+ *
+ * Results:
+ *     True if pNode must be restyled, otherwise false.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+HtmlCssInvalidationTest (HtmlTree *pTree, HtmlNode *pNode)
+{
+    CssStyleSheet *pStyle = pTree->pStyle;
+    CssInvalidation *pInvalid = pStyle ? pStyle->pInvalidApply : 0;
+    HtmlElementNode *pElem = HtmlNodeAsElement(pNode);
+    int ii;
+
+    if (!pInvalid || !pElem) return 0;
+    if (pInvalid->isAll) return 1;
+
+    if (Tcl_FindHashEntry(&pInvalid->aTag, pNode->zTag)) return 1;
+    if (pElem->zId && Tcl_FindHashEntry(&pInvalid->aId, pElem->zId)) return 1;
+    for (ii = 0; ii < pElem->nClass; ii++) {
+        if (Tcl_FindHashEntry(&pInvalid->aClass, pElem->azClass[ii])) return 1;
+    }
+    return 0;
+}
+
+/*
+ * Discard the keys set aside by HtmlCssInvalidationBegin() once the 
+ * document has been restyled. Keys recorded since then are kept.
+ */
+void
+HtmlCssInvalidationClear (HtmlTree *pTree)
+{
+    if (pTree->pStyle) {
+        invalidationFree(&pTree->pStyle->pInvalidApply);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * styleSheetInsertRule --
+ *
+ *     Insert rule pRule into the appropriate list of stylesheet pStyle.
+ *     If isStyleSheet is false (the rule was parsed from a style attribute
+ *     or selector), it always goes into the universal rules list. 
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     Populates pRule->aAncestorHash and pRule->mPositional.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+styleSheetInsertRule (CssStyleSheet *pStyle, CssRule *pRule, int isStyleSheet)
+{
+    CssSelector *p;
+    int isSubject = 1;
+
+    ruleAncestorHashes(pRule);
+    pRule->mPositional = 0;
+    for (p = pRule->pSelector; p; p = p->pNext) {
+        switch (p->eSelector) {
+            case CSS_PSEUDOCLASS_FIRSTCHILD:
+            case CSS_PSEUDOCLASS_LASTCHILD:
+            case CSS_SELECTORCHAIN_ADJACENT:
+                pRule->mPositional |= (isSubject ? 
+                    CSS_POSITIONAL_SUBJECT : CSS_POSITIONAL_ANCESTOR
+                );
+                if (p->eSelector == CSS_SELECTORCHAIN_ADJACENT) {
+                    isSubject = 0;
+                    if (pRule->pSelector->isDynamic) {
+                        pStyle->isDynamicAdjacent = 1;
+                    }
+                }
+                break;
+            case CSS_SELECTORCHAIN_DESCENDANT:
+            case CSS_SELECTORCHAIN_CHILD:
+                isSubject = 0;
+                break;
+        }
+    }
+
+    if (isStyleSheet && pStyle->pInvalid) {
+        invalidationAddRule(pStyle->pInvalid, pRule);
+    }
+
+    if (isStyleSheet) {
+        CssSelector *pS = pRule->pSelector;
+
+        while (pS->pNext && (
+                pS->eSelector == CSS_SELECTOR_ATTR ||
+                pS->eSelector == CSS_SELECTOR_ATTRVALUE ||
+                pS->eSelector == CSS_SELECTOR_ATTRLISTVALUE ||
+                pS->eSelector == CSS_SELECTOR_ATTRHYPHEN ||
+                pS->eSelector == CSS_PSEUDOCLASS_ACTIVE ||
+                pS->eSelector == CSS_PSEUDOCLASS_HOVER ||
+                pS->eSelector == CSS_PSEUDOCLASS_FOCUS ||
+                pS->eSelector == CSS_PSEUDOCLASS_LINK ||
+                pS->eSelector == CSS_PSEUDOCLASS_VISITED
+            )
+        ) {
+            pS = pS->pNext;
+        }
+
+        switch (pS->eSelector) {
+
+            case CSS_PSEUDOELEMENT_AFTER:
+                insertRule(&pStyle->pAfterRules, pRule);
+                break;
+
+            case CSS_PSEUDOELEMENT_BEFORE:
+                insertRule(&pStyle->pBeforeRules, pRule);
+                break;
+    
+            case CSS_SELECTOR_ID:
+            case CSS_SELECTOR_CLASS:
+            case CSS_SELECTOR_TYPE: {
+                int newentry;
+                Tcl_HashTable *pTab;
+                Tcl_HashEntry *p;
+                CssRule *pList = 0;
+
+                pTab = &pStyle->aByTag;
+                switch (pS->eSelector) {
+                    case CSS_SELECTOR_ID:    pTab = &pStyle->aById; break;
+                    case CSS_SELECTOR_CLASS: pTab = &pStyle->aByClass; break;
+                    case CSS_SELECTOR_TYPE:  pTab = &pStyle->aByTag; break;
+                }
+
+                p = Tcl_CreateHashEntry(pTab, pS->zValue, &newentry);
+                if (!newentry) { 
+                    pList = (CssRule *)Tcl_GetHashValue(p); 
+                }
+                insertRule(&pList, pRule);
+                Tcl_SetHashValue(p, pList);
+                break;
+            }
+    
+            default:
+                insertRule(&pStyle->pUniversalRules, pRule);
+                break;
+        }
+    } else {
+        insertRule(&pStyle->pUniversalRules, pRule);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * cssSelectorPropertySetPair --
+ *
+ *     A rule has just been parsed with selector pSelector and properties
+ *     pPropertySet. This function creates a CssRule object to link the two
+ *     together and inserts the new rule into the CssStyleSheet structure.
+ *
+ *     The caller should not free resources associated with pSelector or
+ *     pPropertySet after this function returns, they are now linked into
+ *     the stylesheet object.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+#define FREE_SELECTOR    0x00000001
+#define FREE_PROPERTYSET 0x00000002
+#define FREE_BOTH        0x00000003
+static void 
+cssSelectorPropertySetPair (CssParse *pParse, CssSelector *pSelector, CssPropertySet *pPropertySet, unsigned int freeWhat)
+{
+    int spec = 0;
+    CssSelector *pS = 0;
+    CssStyleSheet *pStyle = pParse->pStyle;
+    CssRule *pRule = HtmlNew(CssRule);
+
+    assert(pPropertySet && pPropertySet->n > 0);
+
+    if (freeWhat & FREE_PROPERTYSET) {
+        pRule->freePropertySets = 1;
+    }
+    if (freeWhat & FREE_SELECTOR) {
+        pRule->freeSelector = 1;
+    }
+
+    /* Calculate the specificity of the rules. We use the following
+     * formala:
+     *
+     *     Specificity = (number of id selectors)        * 10000 +
+     *                   (number of attribute selectors) * 100   +
+     *                   (number of pseudo classes)      * 100   +
+     *                   (number of type selectors)
+     *
+     * Todo: There are (at least) two bugs here:
+     *     1. A rule with 100 type selectors has greater specificity than a
+     *        rule with a single attribute selector. This probably isn't a
+     *        problem.
+     *     2. A selector of the form '[id="hello"]' has the same
+     *        specificity as the selector '.hello'. This is pretty obscure,
+     *        but could come up.
+     * 
+     * See section 6.4, "The cascade", of CSS2 documentation for details on
+     * selector specificity.
+     */
+    for (pS=pSelector; pS; pS = pS->pNext) {
+         switch (pS->eSelector) {
+             case CSS_SELECTOR_TYPE:
+                 spec += 1;
+                 break;
+
+             case CSS_SELECTOR_ID:
+                 spec += 10000;
+                 break;
+
+             case CSS_SELECTOR_ATTR:
+             case CSS_SELECTOR_ATTRVALUE:
+             case CSS_SELECTOR_ATTRLISTVALUE:
+             case CSS_SELECTOR_ATTRHYPHEN:
+                 spec += 100;
+                 break;
+
+             case CSS_SELECTOR_CLASS:
+             case CSS_PSEUDOCLASS_LANG:
+             case CSS_PSEUDOCLASS_FIRSTCHILD:
+             case CSS_PSEUDOCLASS_LINK:
+             case CSS_PSEUDOCLASS_VISITED:
+             case CSS_PSEUDOCLASS_ACTIVE:
+             case CSS_PSEUDOCLASS_HOVER:
+             case CSS_PSEUDOCLASS_FOCUS:
+                 spec += 100;
+                 break;
+         }
+    }
+    pRule->specificity = spec;
+    assert(
+        pPropertySet == pParse->pPropertySet || 
+        pPropertySet == pParse->pImportant
+    );
+    if (pParse->pPropertySet == pPropertySet) {
+        pRule->pPriority = pParse->pPriority1;
+    } else {
+        pRule->pPriority = pParse->pPriority2;
+    }
+    pRule->iRule = pParse->iNextRule++;
+    pRule->pSelector = pSelector;
+    pRule->pPropertySet = pPropertySet;
+
+    /* If a shared rule-set is being built, the rule-set takes ownership
+     * of the selector and property set. 
+     */
+    if (pParse->pRuleSet) {
+        CssRuleSet *pSet = pParse->pRuleSet;
+        CssRuleSetItem *pItem;
+        if (pSet->nItem == pSet->nItemAlloc) {
+            int nNew = (pSet->nItemAlloc ? pSet->nItemAlloc * 2 : 32);
+            pSet->aItem = (CssRuleSetItem *)HtmlRealloc("CssRuleSet.aItem", 
+                (char *)pSet->aItem, nNew * sizeof(CssRuleSetItem)
+            );
+            pSet->nItemAlloc = nNew;
+        }
+        pItem = &pSet->aItem[pSet->nItem++];
+        pItem->pSelector = pSelector;
+        pItem->pPropertySet = pPropertySet;
+        pItem->isImportant = (pRule->pPriority == pParse->pPriority2);
+        pItem->specificity = pRule->specificity;
+        pItem->iRule = pRule->iRule;
+        pItem->freeWhat = freeWhat;
+        pRule->freeSelector = 0;
+        pRule->freePropertySets = 0;
+    }
+
+    styleSheetInsertRule(pStyle, pRule, pParse->pStyleId != 0);
+}
+
+/*--------------------------------------------------------------------------
+ *
+ * HtmlCssRule --
+ *
+ *     This is called when the parser has parsed an entire rule.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ * 
+ *     If the parse was successful, then add the rule to the stylesheet.
+ *     If unsuccessful, delete anything that was built up by calls to 
+ *     HtmlCssDeclaration() or HtmlCssSelector().
+ *
+ *--------------------------------------------------------------------------
+ */
+void 
+HtmlCssRule (CssParse *pParse, int success)
+{
+    CssSelector *pSelector = pParse->pSelector;
+    CssPropertySet *pPropertySet = pParse->pPropertySet;
+    CssPropertySet *pImportant = pParse->pImportant;
+    CssSelector **apXtraSelector = pParse->apXtraSelector;
+    int nXtra = pParse->nXtra;
+    int i;
+
+#if TRACE_PARSER_CALLS
+    printf("HtmlCssRule(%p, %d)\n", pParse, success);
+#endif
+
+    if (pParse->pCompile) {
+        cssCompiledRecord(pParse, CSS_OP_RULE, success, 0, 0);
+    }
+
+    if (pPropertySet && pPropertySet->n == 0) {
+        propertySetFree(pPropertySet);
+        pPropertySet = 0;
+    }
+    if (pImportant && pImportant->n == 0) {
+        propertySetFree(pImportant);
+        pImportant = 0;
+    }
+
+    if (
+        success && 
+        !pParse->isIgnore && 
+        pSelector && 
+        (pPropertySet || pImportant)
+    ) {
+
+        if (pPropertySet) {
+            unsigned int flags = FREE_BOTH;
+            cssSelectorPropertySetPair(pParse, pSelector, pPropertySet, flags);
+            for (i = 0; i < nXtra; i++){
+                unsigned int flags2 = FREE_SELECTOR;
+                CssSelector *pS = apXtraSelector[i];
+                cssSelectorPropertySetPair(pParse, pS, pPropertySet, flags2);
+            }
+        }
+
+        if (pImportant) {
+            unsigned int flags = (pPropertySet ? FREE_PROPERTYSET : FREE_BOTH);
+            cssSelectorPropertySetPair(pParse, pSelector, pImportant, flags);
+            for (i = 0; i < nXtra; i++){
+                unsigned int flags2 = (pPropertySet ? 0 : FREE_SELECTOR);
+                CssSelector *pS = apXtraSelector[i];
+                cssSelectorPropertySetPair(pParse, pS, pImportant, flags2);
+            }
+        }
+
+    } else {
+        /* Some sort of a parse error has occured. We won't be including
+         * this rule, so just free these structs so we don't leak memory.
+         */ 
+        selectorFree(pSelector);
+        propertySetFree(pPropertySet);
+        propertySetFree(pImportant);
+        for (i = 0; i < nXtra; i++){
+            selectorFree(apXtraSelector[i]);
+        }
+    }
+
+    pParse->pSelector = 0;
+    pParse->pPropertySet = 0;
+    pParse->pImportant = 0;
+    pParse->apXtraSelector = 0;
+    pParse->nXtra = 0;
+
+    if( apXtraSelector ){
+        HtmlFree(apXtraSelector);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ruleSetTable --
+ *
+ *     Return the hash table used to store shared CssRuleSet objects for
+ *     interpreter interp, creating it if required. Rule sets are shared
+ *     between the widgets in a single interpreter only. The table is 
+ *     keyed by the string built by ruleSetKey().
+ *
+ * Results:
+ *     Pointer to hash table.
+ *
+ * Side effects:
+ *     May allocate a new hash table and attach it to the interpreter.
+ *
+ *---------------------------------------------------------------------------
+ */
+#define RULESET_ASSOC_KEY "tkhtml_cssrulesets"
+
+static void
+ruleSetTableDelete (ClientData clientData, Tcl_Interp *interp)
+{
+    Tcl_HashTable *pTable = (Tcl_HashTable *)clientData;
+    Tcl_HashEntry *pEntry;
+    Tcl_HashSearch search;
+
+    /* Rule sets still in use by a stylesheet are orphaned. They are 
+     * deleted when the last stylesheet using them is. 
+     */
+    for (
+        pEntry = Tcl_FirstHashEntry(pTable, &search); 
+        pEntry; 
+        pEntry = Tcl_NextHashEntry(&search)
+    ) {
+        CssRuleSet *pSet = (CssRuleSet *)Tcl_GetHashValue(pEntry);
+        pSet->pEntry = 0;
+        pSet->isAgent = 0;
+        if (pSet->nRef == 0) {
+            pSet->nRef = 1;
+            ruleSetRelease(pSet);
+        }
+    }
+    Tcl_DeleteHashTable(pTable);
+    HtmlFree(pTable);
+}
+
+static Tcl_HashTable *
+ruleSetTable (Tcl_Interp *interp)
+{
+    Tcl_HashTable *pTable;
+    pTable = (Tcl_HashTable *)Tcl_GetAssocData(interp, RULESET_ASSOC_KEY, 0);
+    if (!pTable) {
+        pTable = (Tcl_HashTable *)HtmlAlloc("CssRuleSet table", 
+            sizeof(Tcl_HashTable)
+        );
+        Tcl_InitHashTable(pTable, TCL_STRING_KEYS);
+        Tcl_SetAssocData(interp, RULESET_ASSOC_KEY, ruleSetTableDelete, pTable);
+    }
+    return pTable;
+}
+
+/*
+ * Build the key used to find a shared rule set in the ruleSetTable() 
+ * table. As well as the compiled document, it contains everything that
+ * influences the values parsed: the origin, the quirks mode, the -urlcmd
+ * script and the widget's font-family map (HtmlTree.aFontFamilies, which
+ * is used to resolve 'font-family' values, see textToFontFamilyProperty()).
+ * The font-family map is represented by its checksum.
+ */
+static void 
+ruleSetKey (CssParse *pParse, CssCompiled *pCompiled, Tcl_DString *pKey)
+{
+    char zBuf[80];
+    sprintf(zBuf, "%p %d %d %x ", 
+        (void *)pCompiled, pParse->origin, pParse->pTree->options.mode,
+        pParse->pTree->iFontFamilies
+    );
+    Tcl_DStringInit(pKey);
+    Tcl_DStringAppend(pKey, zBuf, -1);
+    if (pParse->pUrlCmd) {
+        Tcl_DStringAppend(pKey, Tcl_GetString(pParse->pUrlCmd), -1);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ruleSetFind --
+ *
+ *     Search for a shared rule set created by parsing compiled document
+ *     pCompiled in the same context (interpreter, origin, quirks-mode, 
+ *     -urlcmd and font families) as pParse.
+ *
+ * Results:
+ *     Pointer to rule set, or NULL if there is no such rule set.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static CssRuleSet *
+ruleSetFind (CssParse *pParse, CssCompiled *pCompiled)
+{
+    Tcl_HashEntry *pEntry;
+    Tcl_DString key;
+
+    ruleSetKey(pParse, pCompiled, &key);
+    pEntry = Tcl_FindHashEntry(
+        ruleSetTable(pParse->interp), Tcl_DStringValue(&key)
+    );
+    Tcl_DStringFree(&key);
+    return (pEntry ? (CssRuleSet *)Tcl_GetHashValue(pEntry) : 0);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ruleSetNew --
+ *
+ *     Allocate a new, empty, rule set to collect the rules created by 
+ *     parsing pCompiled. The caller passes a reference to pCompiled to 
+ *     the new object.
+ *
+ * Results:
+ *     Pointer to new rule set.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static CssRuleSet *
+ruleSetNew (CssParse *pParse, CssCompiled *pCompiled)
+{
+    CssRuleSet *pSet = HtmlNew(CssRuleSet);
+    pSet->pCompiled = pCompiled;
+    pSet->isAgent = (pParse->origin == CSS_ORIGIN_AGENT);
+    return pSet;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ruleSetUse --
+ *
+ *     Add a reference to rule-set pSet to the stylesheet being built
+ *     by pParse.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+ruleSetUse (CssParse *pParse, CssRuleSet *pSet)
+{
+    CssStyleSheet *pStyle = pParse->pStyle;
+    int n = (pStyle->nRuleSet + 1) * sizeof(CssRuleSet *);
+    pStyle->apRuleSet = (CssRuleSet **)HtmlRealloc(
+        "CssStyleSheet.apRuleSet", (char *)pStyle->apRuleSet, n
+    );
+    pStyle->apRuleSet[pStyle->nRuleSet++] = pSet;
+    pSet->nRef++;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ruleSetRegister --
+ *
+ *     Called after the rules from a stylesheet document have been 
+ *     collected in pSet to make the rule set available to other widgets
+ *     (see ruleSetFind()).
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+ruleSetRegister (CssParse *pParse, CssRuleSet *pSet)
+{
+    Tcl_HashEntry *pEntry;
+    Tcl_DString key;
+    int isNew;
+
+    if (pSet->nItem > 0 && pSet->nItem < pSet->nItemAlloc) {
+        pSet->aItem = (CssRuleSetItem *)HtmlRealloc("CssRuleSet.aItem", 
+            (char *)pSet->aItem, pSet->nItem * sizeof(CssRuleSetItem)
+        );
+        pSet->nItemAlloc = pSet->nItem;
+    }
+
+    ruleSetKey(pParse, pSet->pCompiled, &key);
+    pEntry = Tcl_CreateHashEntry(
+        ruleSetTable(pParse->interp), Tcl_DStringValue(&key), &isNew
+    );
+    Tcl_DStringFree(&key);
+
+    /* If an entry already exists (this can happen if an -importcmd 
+     * script parses the same document recursively), leave pSet private
+     * to this stylesheet. 
+     */
+    if (isNew) {
+        Tcl_SetHashValue(pEntry, pSet);
+        pSet->pEntry = pEntry;
+    } else {
+        pSet->isAgent = 0;
+    }
+    ruleSetUse(pParse, pSet);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ruleSetInstantiate --
+ *
+ *     Add the rules in shared rule set pSet to the stylesheet being built
+ *     by pParse. A new CssRule structure is allocated for each rule, with
+ *     the priority and ordering information for this stylesheet.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+ruleSetInstantiate (CssParse *pParse, CssRuleSet *pSet)
+{
+    int ii;
+    for (ii = 0; ii < pSet->nItem; ii++) {
+        CssRuleSetItem *pItem = &pSet->aItem[ii];
+        CssRule *pRule = HtmlNew(CssRule);
+        pRule->pPriority = (
+            pItem->isImportant ? pParse->pPriority2 : pParse->pPriority1
+        );
+        pRule->specificity = pItem->specificity;
+        pRule->iRule = pItem->iRule;
+        pRule->pSelector = pItem->pSelector;
+        pRule->pPropertySet = pItem->pPropertySet;
+        styleSheetInsertRule(pParse->pStyle, pRule, 1);
+    }
+    pParse->iNextRule += pSet->nItem;
+    ruleSetUse(pParse, pSet);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ruleSetRelease --
+ *
+ *     Release a reference to rule set pSet.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     If this is the last reference, and the rule set is not a default
+ *     stylesheet that is kept for use by widgets created later, the 
+ *     rule set and the selectors and property sets it owns are deleted.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+ruleSetRelease (CssRuleSet *pSet)
+{
+    pSet->nRef--;
+    if (pSet->nRef == 0 && !(pSet->isAgent && pSet->pEntry)) {
+        int ii;
+        if (pSet->pEntry) {
+            Tcl_DeleteHashEntry(pSet->pEntry);
+        }
+        for (ii = 0; ii < pSet->nItem; ii++) {
+            CssRuleSetItem *pItem = &pSet->aItem[ii];
+            if (pItem->freeWhat & FREE_SELECTOR) {
+                selectorFree(pItem->pSelector);
+            }
+            if (pItem->freeWhat & FREE_PROPERTYSET) {
+                propertySetFree(pItem->pPropertySet);
+            }
+        }
+        cssCompiledRelease(pSet->pCompiled);
+        HtmlFree(pSet->aItem);
+        HtmlFree(pSet);
+    }
+}
+
+/*--------------------------------------------------------------------------
+ *
+ * attrTest --
+ *
+ *     Test if an attribute value matches a string. The three modes of 
+ *     comparing attribute values specified in CSS are supported.
+ *
+ * Results:
+ *     Non-zero is returned if the match is true.
+ *
+ * Side effects:
+ *     None.
+ *
+ *--------------------------------------------------------------------------
+ */
+static int 
+attrTest (int eType, const char *zString, const char *zAttr)
+{
+    if (!zAttr) {
+        return 0;
+    }
+
+    switch( eType ){
+        /* True if the specified attribute exists */
+        case CSS_SELECTOR_ATTR:
+            return (zAttr?1:0);
+
+        /* True if the specified attribute exists and the value matches
+         * the string exactly.
+         */
+        case CSS_SELECTOR_ATTRVALUE:
+            return ((zAttr && 0==stricmp(zAttr, zString))?1:0);
+
+	/* Treat the attribute value (if it exists) as a space seperated list.
+         * Return true if zString exists in the list.
+         */
+        case CSS_SELECTOR_ATTRLISTVALUE: {
+            const char *pAttr = zAttr;
+            int nAttr;
+            int nString = strlen(zString);
+            while ((pAttr=HtmlCssGetNextListItem(pAttr, strlen(pAttr), &nAttr))) {
+                if (nString==nAttr && 0==strnicmp(pAttr, zString, nAttr)) {
+                    return 1;
+                }
+                pAttr += nAttr;
+            }
+            return 0;
+        }
+
+        /* True if the attribute exists and matches zString up to the
+         * first '-' character in the attribute value.
+         */
+        case CSS_SELECTOR_ATTRHYPHEN: {
+            char *pHyphen = strchr(zAttr, '-');
+            if( pHyphen && 0==strnicmp(zAttr, zString, pHyphen-zAttr) ){
+                return 1;
+            }
+            return 0;
+        }
+    }
+
+    assert(!"Impossible");
+    return 0;
+}
+
+/*--------------------------------------------------------------------------
+ *
+ * HtmlCssSelectorTest --
+ *
+ *     Test if a selector matches a document node.
+ *
+ * Results:
+ *     Non-zero is returned if the Selector does match the node.
+ *
+ * Side effects:
+ *     None.
+ *
+ *--------------------------------------------------------------------------
+ */
+#define N_TYPE(x)        HtmlNodeTagName(x)
+#define N_ATTR(x,y)      HtmlNodeAttr(x,y)
+#define N_PARENT(x)      HtmlNodeParent(x)
+#define N_NUMCHILDREN(x) HtmlNodeNumChildren(x)
+#define N_CHILD(x,y)     HtmlNodeChild(x,y)
+int 
+HtmlCssSelectorTest (CssSelector *pSelector, HtmlNode *pNode, int dynamic_true)
+{
+    CssSelector *p = pSelector;
+    HtmlNode *x = pNode;
+
+    HtmlElementNode *pElem = HtmlNodeAsElement(pNode);
+    assert(pElem);
+
+    while( p && x ){
+        pElem = HtmlNodeAsElement(x);
+
+        switch( p->eSelector ){
+            case CSS_SELECTOR_UNIVERSAL:
+                break;
+
+            case CSS_SELECTOR_TYPE:
+                assert(x->zTag || HtmlNodeIsText(x));
+                if( HtmlNodeIsText(x) || strcmp(x->zTag, p->zValue) ) return 0;
+                break;
+
+            case CSS_SELECTOR_CLASS: {
+                /* Use the class names cached on the element node instead
+                 * of parsing the "class" attribute each time.
+                 */
+                const char *zClass = p->zValue;
+                int ii;
+                if( !pElem ) return 0;
+                for (ii = 0; ii < pElem->nClass; ii++) {
+                    if (0 == stricmp(pElem->azClass[ii], zClass)) break;
+                }
+                if( ii == pElem->nClass ) return 0;
+                break;
+            }
+
+            case CSS_SELECTOR_ID: {
+                const char *zId = (pElem ? pElem->zId : 0);
+                if( !attrTest(CSS_SELECTOR_ATTRVALUE, p->zValue, zId) ){
+                    return 0;
+                }
+                break;
+            }
+
+            case CSS_SELECTOR_ATTR:
+            case CSS_SELECTOR_ATTRVALUE:
+            case CSS_SELECTOR_ATTRLISTVALUE:
+            case CSS_SELECTOR_ATTRHYPHEN:
+                if( !attrTest(p->eSelector, p->zValue, N_ATTR(x,p->zAttr)) ){
+                    return 0;
+                }
+                break;
+
+            case CSS_SELECTORCHAIN_DESCENDANT: {
+                HtmlNode *pParent = N_PARENT(x);
+                CssSelector *pNext = p->pNext;
+                while (pParent) {
+                    if (HtmlCssSelectorTest(pNext, pParent, dynamic_true)) {
+                        return 1;
+                    }
+                    pParent = N_PARENT(pParent);
+                }
+                return 0;
+            }
+            case CSS_SELECTORCHAIN_CHILD:
+                x = N_PARENT(x);
+                break;
+            case CSS_SELECTORCHAIN_ADJACENT: {
+                HtmlNode *pParent = N_PARENT(x);
+                int i;
+
+                if (
+                    !pParent || 
+                    HtmlElemRare((HtmlElementNode *)pParent, pBefore) == x ||
+                    HtmlElemRare((HtmlElementNode *)pParent, pAfter) == x 
+                ) {
+                    return 0;
+                }
+
+                /* Search for the nearest left-hand sibling that is not
+                 * white-space. If no such sibling exists, set x==0 (this
+                 * will cause the selector-match to fail). If the sibling
+                 * does exist, set x to point at it.
+                 */
+                i = HtmlNodeIndexOfChild(pParent, x);
+                assert(i >= 0);
+                i--;
+                do {
+                    x = N_CHILD(pParent, i);
+                    i--;
+                } while (i >= 0 && HtmlNodeIsWhitespace(x));
+                if (i < 0) return 0;
+
+                break;
+            }
+
+            case CSS_PSEUDOCLASS_FIRSTCHILD: {
+                /* :first-child selector matches if x is the left-most child
+                 * of it's parent, not including white-space nodes. */
+                HtmlNode *pParent = N_PARENT(x);
+                int i;
+                if (!pParent) return 0;
+                for (i = 0; i < N_NUMCHILDREN(pParent); i++) {
+                    HtmlNode *pChild = N_CHILD(pParent, i);
+                    if (pChild == x) break;
+                    if (!HtmlNodeIsWhitespace(pChild)) return 0;
+                }
+                assert(i < N_NUMCHILDREN(pParent));
+                break;
+            }
+            case CSS_PSEUDOCLASS_LASTCHILD: {
+                /* :last-child selector matches if x is the right-most child
+                 * of it's parent, not including white-space nodes. */
+                HtmlNode *pParent = N_PARENT(x);
+                int i;
+                if (!pParent) return 0;
+                for (i = N_NUMCHILDREN(pParent) - 1; i >= 0; i--) {
+                    HtmlNode *pChild = N_CHILD(pParent, i);
+                    if (pChild == x) break;
+                    if (!HtmlNodeIsWhitespace(pChild)) return 0;
+                }
+                assert(i >= 0);
+                break;
+            }
+                
+            case CSS_PSEUDOCLASS_LANG:
+                return 0;
+
+
+            case CSS_PSEUDOELEMENT_FIRSTLINE:
+            case CSS_PSEUDOELEMENT_FIRSTLETTER:
+                return 0;
+
+            case CSS_PSEUDOELEMENT_BEFORE:
+            case CSS_PSEUDOELEMENT_AFTER:
+                break;
+
+            case CSS_PSEUDOCLASS_ACTIVE:
+                if (dynamic_true || (pElem->flags & HTML_DYNAMIC_ACTIVE)) break;
+                return 0;
+            case CSS_PSEUDOCLASS_HOVER:
+                if (dynamic_true || (pElem->flags & HTML_DYNAMIC_HOVER)) break;
+                return 0;
+            case CSS_PSEUDOCLASS_FOCUS:
+                if (dynamic_true || (pElem->flags & HTML_DYNAMIC_FOCUS)) break;
+                return 0;
+            case CSS_PSEUDOCLASS_LINK:
+                if (pElem->flags & HTML_DYNAMIC_LINK) break;
+                return 0;
+            case CSS_PSEUDOCLASS_VISITED:
+                if (pElem->flags & HTML_DYNAMIC_VISITED) break;
+                return 0;
+
+            case CSS_SELECTOR_NEVERMATCH:
+                return 0;
+
+            default:
+                assert(!"Impossible");
+        }
+        p = p->pNext;
+    }
+
+    return (x && !p)?1:0;
+}
+
+/*
+ * While the document tree is being styled, a CssAncestorFilter holds a
+ * counting Bloom filter of the tag names, ids and classes of the
+ * ancestors of the nodes being styled (HtmlTree.pAncestorFilter). Each
+ * rule stores hashes of the type, id and class selectors that must be
+ * matched by an ancestor (CssRule.aAncestorHash). If any of these is 
+ * definitely not present in the filter, the rule cannot match, and
+ * HtmlCssSelectorTest() need not walk the ancestor chain to find out.
+ *
+ * Each hash value is used as two 12-bit keys into the aCount[] array. 
+ * Counters that reach 255 are never decremented, so a saturated counter
+ * only causes false positives. The hashes added for each pushed node
+ * are stored in aHash[], so that HtmlCssAncestorFilterPop() removes 
+ * exactly the values that were added even if the node's attributes have
+ * been modified in the meantime.
+ */
+#define ANCESTOR_FILTER_BITS 12
+#define ANCESTOR_FILTER_MASK ((1 << ANCESTOR_FILTER_BITS) - 1)
+
+struct CssAncestorFilter {
+    unsigned char aCount[1 << ANCESTOR_FILTER_BITS];
+    HtmlNode *pTop;           /* Innermost pushed node (parent being styled) */
+
+    int nLevel;               /* Number of nodes pushed */
+    int nLevelAlloc;          /* Allocated size of aLevel[] */
+    struct CssAncestorLevel {
+        HtmlNode *pNode;      /* Node pushed */
+        int iHash;            /* Index in aHash[] of first hash for pNode */
+        int iSignature;       /* Match signature of pNode, or 0 */
+    } *aLevel;
+
+    int nHash;                /* Number of hashes in aHash[] */
+    int nHashAlloc;           /* Allocated size of aHash[] */
+    unsigned int *aHash;      /* Hashes added to the filter */
+};
+
+/*
+ * Values of the eKind argument to ancestorHash().
+ */
+#define ANCESTOR_TAG   1
+#define ANCESTOR_ID    2
+#define ANCESTOR_CLASS 3
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ancestorHash --
+ *
+ *     Return the hash value used by the ancestor filter for a tag name, id
+ *     or class (eKind is one of the ANCESTOR_XXX values). Ids and classes
+ *     are compared case-insensitively by HtmlCssSelectorTest(), so case
+ *     is folded for all three.
+ *
+ * Results:
+ *     Non-zero hash value.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static unsigned int
+ancestorHash (int eKind, const char *zValue)
+{
+    unsigned int h = 2166136261U ^ (unsigned int)eKind;
+    const unsigned char *z;
+    for (z = (const unsigned char *)zValue; *z; z++) {
+        h = (h ^ tolower(*z)) * 16777619U;
+    }
+    return h ? h : 1;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ruleAncestorHashes --
+ *
+ *     Populate the CssRule.aAncestorHash array of rule pRule. A simple 
+ *     selector must be matched by an ancestor of the node if the nearest
+ *     combinator to its right (i.e. preceding it in the CssSelector list)
+ *     is a descendant or child combinator. A compound selector that
+ *     follows an adjacent-sibling combinator is matched by a sibling of
+ *     the node or of one of its ancestors, so it is not used.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+ruleAncestorHashes (CssRule *pRule)
+{
+    CssSelector *p;
+    int isAncestor = 0;
+    int n = 0;
+
+    for (p = pRule->pSelector; p; p = p->pNext) {
+        int eKind = 0;
+        switch (p->eSelector) {
+            case CSS_SELECTORCHAIN_DESCENDANT:
+            case CSS_SELECTORCHAIN_CHILD:
+                isAncestor = 1;
+                break;
+            case CSS_SELECTORCHAIN_ADJACENT:
+                isAncestor = 0;
+                break;
+            case CSS_SELECTOR_TYPE:  eKind = ANCESTOR_TAG;   break;
+            case CSS_SELECTOR_ID:    eKind = ANCESTOR_ID;    break;
+            case CSS_SELECTOR_CLASS: eKind = ANCESTOR_CLASS; break;
+        }
+        if (isAncestor && eKind && p->zValue) {
+            pRule->aAncestorHash[n++] = ancestorHash(eKind, p->zValue);
+            if (n == CSS_RULE_ANCESTOR_HASHES) break;
+        }
+    }
+    if (n < CSS_RULE_ANCESTOR_HASHES) {
+        pRule->aAncestorHash[n] = 0;
+    }
+}
+
+static void
+ancestorFilterAdd (CssAncestorFilter *pFilter, unsigned int h)
+{
+    unsigned char *a = pFilter->aCount;
+    int k1 = h & ANCESTOR_FILTER_MASK;
+    int k2 = (h >> ANCESTOR_FILTER_BITS) & ANCESTOR_FILTER_MASK;
+
+    if (pFilter->nHash == pFilter->nHashAlloc) {
+        int nByte;
+        pFilter->nHashAlloc = pFilter->nHashAlloc * 2 + 64;
+        nByte = pFilter->nHashAlloc * sizeof(unsigned int);
+        pFilter->aHash = (unsigned int *)HtmlRealloc(
+            "CssAncestorFilter.aHash", pFilter->aHash, nByte
+        );
+    }
+    pFilter->aHash[pFilter->nHash++] = h;
+
+    if (a[k1] < 255) a[k1]++;
+    if (a[k2] < 255) a[k2]++;
+}
+
+static int
+ancestorFilterContains (CssAncestorFilter *pFilter, unsigned int h)
+{
+    unsigned char *a = pFilter->aCount;
+    return (
+        a[h & ANCESTOR_FILTER_MASK] && 
+        a[(h >> ANCESTOR_FILTER_BITS) & ANCESTOR_FILTER_MASK]
+    );
+}
+
+CssAncestorFilter *
+HtmlCssAncestorFilterNew (void)
+{
+    return HtmlNew(CssAncestorFilter);
+}
+
+void
+HtmlCssAncestorFilterFree (CssAncestorFilter *pFilter)
+{
+    if (pFilter) {
+        HtmlFree(pFilter->aLevel);
+        HtmlFree(pFilter->aHash);
+        HtmlFree(pFilter);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlCssAncestorFilterPush --
+ *
+ *     Add the tag name, id and classes of element pNode to the filter,
+ *     before the children of pNode are styled.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+HtmlCssAncestorFilterPush (CssAncestorFilter *pFilter, HtmlNode *pNode)
+{
+    HtmlElementNode *pElem = HtmlNodeAsElement(pNode);
+    int ii;
+
+    assert(pElem);
+    assert(HtmlNodeParent(pNode) == pFilter->pTop);
+
+    if (pFilter->nLevel == pFilter->nLevelAlloc) {
+        int nByte;
+        pFilter->nLevelAlloc = pFilter->nLevelAlloc * 2 + 16;
+        nByte = pFilter->nLevelAlloc * sizeof(struct CssAncestorLevel);
+        pFilter->aLevel = (struct CssAncestorLevel *)HtmlRealloc(
+            "CssAncestorFilter.aLevel", pFilter->aLevel, nByte
+        );
+    }
+    pFilter->aLevel[pFilter->nLevel].pNode = pNode;
+    pFilter->aLevel[pFilter->nLevel].iHash = pFilter->nHash;
+    pFilter->aLevel[pFilter->nLevel].iSignature = 0;
+    pFilter->nLevel++;
+    pFilter->pTop = pNode;
+
+    ancestorFilterAdd(pFilter, ancestorHash(ANCESTOR_TAG, pNode->zTag));
+    if (pElem->zId) {
+        ancestorFilterAdd(pFilter, ancestorHash(ANCESTOR_ID, pElem->zId));
+    }
+    for (ii = 0; ii < pElem->nClass; ii++) {
+        const char *zClass = pElem->azClass[ii];
+        ancestorFilterAdd(pFilter, ancestorHash(ANCESTOR_CLASS, zClass));
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlCssAncestorFilterPop --
+ *
+ *     Remove the most recently pushed node from the filter.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+HtmlCssAncestorFilterPop (CssAncestorFilter *pFilter)
+{
+    unsigned char *a = pFilter->aCount;
+    int iHash;
+
+    assert(pFilter->nLevel > 0);
+    pFilter->nLevel--;
+    iHash = pFilter->aLevel[pFilter->nLevel].iHash;
+    for ( ; pFilter->nHash > iHash; pFilter->nHash--) {
+        unsigned int h = pFilter->aHash[pFilter->nHash - 1];
+        int k1 = h & ANCESTOR_FILTER_MASK;
+        int k2 = (h >> ANCESTOR_FILTER_BITS) & ANCESTOR_FILTER_MASK;
+        if (a[k1] < 255) a[k1]--;
+        if (a[k2] < 255) a[k2]--;
+    }
+    pFilter->pTop = (pFilter->nLevel > 0) ? 
+        pFilter->aLevel[pFilter->nLevel - 1].pNode : 0;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ancestorFilterReject --
+ *
+ *     Check if the ancestor filter shows that rule pRule cannot match
+ *     node pNode. The filter is only used if it currently contains 
+ *     exactly the ancestors of pNode.
+ *
+ * Results:
+ *     True if the selector of pRule definitely does not match pNode. 
+ *     False if it might.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+ancestorFilterReject (
+    CssAncestorFilter *pFilter, 
+    HtmlNode *pNode, 
+    CssRule *pRule
+)
+{
+    unsigned int *aHash = pRule->aAncestorHash;
+    int ii;
+
+    if (!pFilter || pFilter->pTop != HtmlNodeParent(pNode)) return 0;
+    for (ii = 0; ii < CSS_RULE_ANCESTOR_HASHES && aHash[ii]; ii++) {
+        if (!ancestorFilterContains(pFilter, aHash[ii])) return 1;
+    }
+    return 0;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlCssInlineFree --
+ *
+ * Results:
+ *
+ * Side effects:
+ *
+ *---------------------------------------------------------------------------
+ */
+void 
+HtmlCssInlineFree (CssPropertySet *pPropertySet)
+{
+    if (pPropertySet && pPropertySet->nRef > 0) {
+        int isLast;
+        Tcl_MutexLock(&cssInternMutex);
+        cssIntern.nInlineRef--;
+        pPropertySet->nRef--;
+        isLast = (pPropertySet->nRef == 0);
+        if (isLast) {
+            Tcl_DeleteHashEntry(pPropertySet->pEntry);
+        } else {
+            cssIntern.nByteSaved -= propertySetSize(pPropertySet);
+        }
+        Tcl_MutexUnlock(&cssInternMutex);
+        if (!isLast) return;
+    }
+    propertySetFree(pPropertySet);
+}
 
-        /* Free the universal rules list */
-        freeRulesList(&pStyle->pUniversalRules); 
-        freeRulesList(&pStyle->pAfterRules); 
-        freeRulesList(&pStyle->pBeforeRules); 
-        freeRulesHash(&pStyle->aByTag); 
-        freeRulesHash(&pStyle->aByClass); 
-        freeRulesHash(&pStyle->aById); 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * propertySetToPropertyValues --
+ *
+ * Results:
+ *
+ * Side effects:
+ *
+ *---------------------------------------------------------------------------
+ */
+static void 
+propertySetToPropertyValues (HtmlComputedValuesCreator *p, int *aPropDone, CssPropertySet *pSet)
+{
+    int i;
+    assert(pSet);
 
-        /* Free the priorities list */
-        pPriority = pStyle->pPriority;
-        while (pPriority) {
-            CssPriority *pNext = pPriority->pNext;
-            Tcl_DecrRefCount(pPriority->pIdTail);
-            HtmlFree(pPriority);
-            pPriority = pNext;
+    for (i = pSet->n - 1; i >= 0; i--) {
+        int eProp = pSet->a[i].eProp;
+	/* eProp may be greater than MAX_PROPERTY if it stores a composite
+	 * property that Tkhtml doesn't handle. In this case just ignore it.
+         */
+	if (eProp <= CSS_PROPERTY_MAX_PROPERTY && 0 == aPropDone[eProp]) {
+            if (0 == HtmlComputedValuesSet(p, eProp, pSet->a[i].pProp)) {
+                aPropDone[eProp] = 1;
+            }
         }
-
-        HtmlFree(pStyle);
     }
 }
 
 /*
-** Return the number of syntax errors that occured while parsing the
-** style-sheet.
-*/
-int HtmlCssStyleSheetSyntaxErrs(CssStyleSheet *pStyle){
-    return pStyle->nSyntaxErr;
+ *---------------------------------------------------------------------------
+ *
+ * ruleToPropertyValues --
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void 
+ruleToPropertyValues (HtmlComputedValuesCreator *p, int *aPropDone, CssRule *pRule)
+{
+    propertySetToPropertyValues(p, aPropDone, pRule->pPropertySet);
 }
 
-/*--------------------------------------------------------------------------
- *
- * HtmlCssDeclaration --
+/*
+ *---------------------------------------------------------------------------
  *
- *     This function is called by the CSS parser when it parses a property 
- *     declaration (i.e "<property> : <expression>").
+ * ruleToPropertyValues --
  *
  * Results:
  *     None.
  *
  * Side effects:
+ *     None.
  *
- *--------------------------------------------------------------------------
+ *---------------------------------------------------------------------------
  */
-void 
-HtmlCssDeclaration (
-    CssParse *pParse,
-    CssToken *pProp,
-    CssToken *pExpr,
-    int isImportant         /* True if the !IMPORTANT symbol was seen */
-)
+static void 
+overrideToPropertyValues(
+    HtmlComputedValuesCreator *p,
+    int *aPropDone,
+    Tcl_Obj *pOverride
+    )
 {
-    int prop; 
-    CssPropertySet **ppPropertySet;
-    char zBuf[128];
+    Tcl_Obj **apObj = 0;
+    int nObj = 0;
+    int ii;
 
-    /* Do nothing if the isIgnore flag is set */
-    if (pParse->isIgnore) return;
+    if (!pOverride) return;
+    Tcl_ListObjGetElements(0, pOverride, &nObj, &apObj);
 
-#if TRACE_PARSER_CALLS
-    printf("HtmlCssDeclaration(%p, \"%.*s\", \"%.*s\", %d)\n", 
-        pParse,
-        pProp?pProp->n:0, pProp?pProp->z:"", 
-        pExpr?pExpr->n:0, pExpr?pExpr->z:"",
-        isImportant
-    );
-#endif
+    for (ii = 0; ii < (nObj - 1); ii += 2) { 
+        int eProp;
+        const char *zProp;
+        int nProp;
 
-    if (pParse->pStyleId == 0) {
-        isImportant = 0;
+        zProp = Tcl_GetStringFromObj(apObj[ii], &nProp);
+        eProp = HtmlCssPropertyLookup(nProp, zProp);
+
+	if (eProp <= CSS_PROPERTY_MAX_PROPERTY && 0 == aPropDone[eProp]) {
+            const char *zVal = Tcl_GetString(apObj[ii + 1]);
+            CssProperty *pProp = HtmlCssStringToProperty(zVal, -1);
+            if (0 == HtmlComputedValuesSet(p, eProp, pProp)) {
+                aPropDone[eProp] = 1;
+            }
+            HtmlComputedValuesFreeProperty(p, pProp);
+        }
     }
+}
 
-    /* Resolve the property name. If we don't recognize it, then ignore the
-     * declaration (CSS2 spec says to do this - besides, what else could we
-     * do?).
+/*--------------------------------------------------------------------------
+ *
+ * applyRule --
+ *
+ *     Test the selector of pRule against node pNode. If there is a match,
+ *     add the rules properties to the computed values being accumulated in
+ *     pCreator.
+ *
+ * Results:
+ *
+ *     The value returned is true if the selector matched, or false otherwise.
+ *
+ * Side effects:
+ *
+ *--------------------------------------------------------------------------
+ */
+static int 
+applyRule (HtmlTree *pTree, HtmlNode *pNode, CssRule *pRule, int *aPropDone, char **pzIfMatch, HtmlComputedValuesCreator *pCreator)
+{
+    /* Test if the selector matches the node. Variable isMatch is set to
+     * true if the selector matches, or false otherwise. 
      */
-#if 0
-    prop = HtmlCssPropertyLookup(pProp->n, pProp->z);
-#else
-    if (pProp->n > 127) pProp->n = 127;
-    memcpy(zBuf, pProp->z, pProp->n);
-    zBuf[pProp->n] = '\0';
-    dequote(zBuf);
-    prop = HtmlCssPropertyLookup(-1, zBuf);
-#endif
-    if( prop<0 ) return;
+    CssSelector *pSelector = pRule->pSelector;
+    int isMatch = 0;
+    if (!ancestorFilterReject(pTree->pAncestorFilter, pNode, pRule)) {
+        isMatch = HtmlCssSelectorTest(pSelector, pNode, 0);
+    }
 
-    if (isImportant) {
-        ppPropertySet = &pParse->pImportant;
-    } else {
-        ppPropertySet = &pParse->pPropertySet;
+    /* There is a match. Log some output for debugging. */
+    LOG {
+        CssPriority *pPriority = pRule->pPriority;
+        Tcl_Obj *pS = Tcl_NewObj();
+        Tcl_IncrRefCount(pS);
+        HtmlCssSelectorToString(pSelector, pS);
+        HtmlLog(pTree, "STYLEENGINE", "%s %s (%s)"
+            " from \"%s%s\"",
+            Tcl_GetString(HtmlNodeCommand(pTree, pNode)),
+            (isMatch ? "matches" : "nomatch"),
+            Tcl_GetString(pS),
+            pPriority->origin == CSS_ORIGIN_AUTHOR ? "author" :
+            pPriority->origin == CSS_ORIGIN_AGENT ? "agent" : "user",
+            Tcl_GetString(pPriority->pIdTail)
+        );
+        Tcl_DecrRefCount(pS);
     }
-    if( !*ppPropertySet ){
-        *ppPropertySet = propertySetNew();
+    if (isMatch) {
+
+        if (pzIfMatch) {
+            HtmlComputedValuesInit(pTree, pNode, pNode, pCreator);
+            pCreator->pzContent = pzIfMatch;
+        }
+  
+        /* Copy the properties from the rule into the computed values set. */
+        ruleToPropertyValues(pCreator, aPropDone, pRule);
     }
 
-    switch (prop) {
-        case CSS_SHORTCUTPROPERTY_BORDER:
-        case CSS_SHORTCUTPROPERTY_BORDER_LEFT:
-        case CSS_SHORTCUTPROPERTY_BORDER_RIGHT:
-        case CSS_SHORTCUTPROPERTY_BORDER_TOP:
-        case CSS_SHORTCUTPROPERTY_BORDER_BOTTOM:
-            propertySetAddShortcutBorder(pParse, *ppPropertySet, prop, pExpr);
-            break;
-        case CSS_SHORTCUTPROPERTY_BORDER_COLOR:
-        case CSS_SHORTCUTPROPERTY_BORDER_STYLE:
-        case CSS_SHORTCUTPROPERTY_BORDER_WIDTH:
-        case CSS_SHORTCUTPROPERTY_PADDING:
-        case CSS_SHORTCUTPROPERTY_MARGIN:
-            propertySetAddShortcutBorderColor(*ppPropertySet, prop, pExpr);
-            break;
-        case CSS_SHORTCUTPROPERTY_BACKGROUND:
-            shortcutBackground(pParse, *ppPropertySet, pExpr);
-            break;
-        case CSS_SHORTCUTPROPERTY_BACKGROUND_POSITION:
-            shortcutBackgroundPosition(pParse, *ppPropertySet, pExpr);
-            break;
-        case CSS_SHORTCUTPROPERTY_FONT:
-            propertySetAddShortcutFont(pParse, *ppPropertySet, pExpr);
-            break;
-        case CSS_PROPERTY_FONT_FAMILY:
-            propertySetAddFontFamily(pParse, *ppPropertySet, pExpr);
-            break;
-        case CSS_SHORTCUTPROPERTY_LIST_STYLE:
-            shortcutListStyle(pParse, *ppPropertySet, pExpr);
-            break;
-        case CSS_PROPERTY_CONTENT:
-        case CSS_PROPERTY_COUNTER_INCREMENT:
-        case CSS_PROPERTY_COUNTER_RESET:
-            propertySetAddList(pParse, prop, *ppPropertySet, pExpr);
-            break;
-        default:
-            propertySetAdd(*ppPropertySet, prop, tokenToProperty(pParse,pExpr));
+    assert(isMatch == 0 || isMatch == 1);
+    return isMatch;
+}
+
+/*
+ * HtmlCssStyleSheetApply() merges the rule lists that apply to a node 
+ * (universal, by-tag, by-id and one for each class) in priority order.
+ * The lists are kept in a binary heap of the following structures,
+ * ordered so that the list whose next rule has the highest priority is at
+ * the root. Each entry also stores the index of the list, so that rules 
+ * of equal priority are returned in list order.
+ */
+typedef struct RuleCursor RuleCursor;
+struct RuleCursor {
+    CssRule *pRule;           /* Next rule in this list */
+    int iList;                /* Index of list */
+};
+
+static int
+cursorCompare (RuleCursor *pLeft, RuleCursor *pRight)
+{
+    int res = ruleCompare(pLeft->pRule, pRight->pRule);
+    if (res == 0) {
+        res = pRight->iList - pLeft->iList;
     }
+    return res;
 }
 
+static void
+cursorSift (RuleCursor *aCursor, int nCursor, int iCursor)
+{
+    while (1) {
+        int iLeft = iCursor * 2 + 1;
+        int iBest = iCursor;
+        RuleCursor tmp;
+
+        if (iLeft < nCursor && 
+            cursorCompare(&aCursor[iLeft], &aCursor[iBest]) > 0
+        ) {
+            iBest = iLeft;
+        }
+        if (iLeft + 1 < nCursor && 
+            cursorCompare(&aCursor[iLeft + 1], &aCursor[iBest]) > 0
+        ) {
+            iBest = iLeft + 1;
+        }
+        if (iBest == iCursor) break;
 
+        tmp = aCursor[iCursor];
+        aCursor[iCursor] = aCursor[iBest];
+        aCursor[iBest] = tmp;
+        iCursor = iBest;
+    }
+}
 
 /*--------------------------------------------------------------------------
  *
- * HtmlCssSelector --
- *
- *     This is called whenever a simple selector is parsed. 
- *     i.e. "H1" or ":before".
+ * nextRule --
  *
- *     A CssSelector struct is allocated and added to the beginning of the
- *     linked list at pParse->pSelector;
+ *     Remove and return the highest priority rule from the heap of rule
+ *     lists aCursor (size *pnCursor entries).
  *
  * Results:
- *     None.
+ *     Pointer to rule, or NULL if the lists are all exhausted.
  *
  * Side effects:
+ *     Updates aCursor and *pnCursor.
  *
  *--------------------------------------------------------------------------
  */
-void 
-HtmlCssSelector (
-    CssParse *pParse,
-    int stype,               /* One of the CSS_SELECTOR_TYPE_XXX values */
-    CssToken *pAttr,
-    CssToken *pValue
-)
+static CssRule *
+nextRule (RuleCursor *aCursor, int *pnCursor)
 {
-    CssSelector *pSelector;
-
-    /* Do nothing if the isIgnore flag is set */
-    if (pParse->isIgnore) return;
+    CssRule *pRet = 0;
 
-#if TRACE_PARSER_CALLS
-    /* I used this to make sure the parser was passing the components of
-     * selectors to this function in the correct order. Once this was 
-     * verified, it is not particularly useful trace output. But we'll leave
-     * it here for the time being in case something comes up.
-     */
-    printf("HtmlCssSelector(%p, %s, \"%.*s\", \"%.*s\")\n", 
-        pParse, constantToString(stype), 
-        pAttr?pAttr->n:0, pAttr?pAttr->z:"", 
-        pValue?pValue->n:0, pValue?pValue->z:""
-    );
-#endif
+    if (*pnCursor > 0) {
+        pRet = aCursor[0].pRule;
+        aCursor[0].pRule = pRet->pNext;
+        if (!aCursor[0].pRule) {
+            (*pnCursor)--;
+            aCursor[0] = aCursor[*pnCursor];
+        }
+        cursorSift(aCursor, *pnCursor, 0);
+    }
 
-    pSelector = HtmlNew(CssSelector);
-    pSelector->eSelector = stype;
-    pSelector->zValue = tokenToString(pValue);
-    pSelector->zAttr = tokenToString(pAttr);
-    pSelector->pNext = pParse->pSelector;
-    pSelector->isDynamic = (
-        (pSelector->pNext && pSelector->pNext->isDynamic) ||
-#if 0
-        (stype == CSS_PSEUDOCLASS_LINK)                   ||
-        (stype == CSS_PSEUDOCLASS_VISITED)                ||
-#endif
-        (stype == CSS_PSEUDOCLASS_HOVER)                  ||
-        (stype == CSS_PSEUDOCLASS_FOCUS)                  ||
-        (stype == CSS_PSEUDOCLASS_ACTIVE)
-    ) ? 1 : 0;
-    pParse->pSelector = pSelector;
-    dequote(pSelector->zValue);
+    return pRet;
+}
 
-    /* Tag names are case-insensitive - fold to lower case */
-    if( stype==CSS_SELECTOR_TYPE ){
-        assert(pSelector->zValue);
-        Tcl_UtfToLower(pSelector->zValue);
+/*
+ * Add rule list pList to the heap of rule lists aCursor. The caller must
+ * call cursorSift() for each entry to build the heap after all lists have 
+ * been added.
+ */
+static void
+cursorAdd (RuleCursor *aCursor, int *pnCursor, int *piList, CssRule *pList)
+{
+    if (pList) {
+        aCursor[*pnCursor].pRule = pList;
+        aCursor[*pnCursor].iList = *piList;
+        (*pnCursor)++;
     }
+    (*piList)++;
 }
 
 /*
- *---------------------------------------------------------------------------
- *
- * ruleCompare --
- *
- *     Compare the priority of two rule objects. Return greater than zero
- *     if the priority of pLeft is higher, zero if the two rules have the
- *     same priority, and negative if pRight has higher priority. i.e.:
- *
- *         PRIORITY(pLeft) - PRIORITY(pRight)
- *
- *     This function is used to determine the order of rules in the
- *     rules CssRule.pNext linked list.
- *
- * Results:
- *     See above.
- *
- * Side effects:
- *     None.
- *
- *---------------------------------------------------------------------------
+ * Add the rule lists that apply to element pNode (universal, by-tag, 
+ * by-id and by-class) to aCursor and arrange them into a heap. Array 
+ * aCursor must have room for (nClass + 3) entries, where nClass is the
+ * number of classes the element belongs to. Return the number of lists
+ * added.
  */
-static int 
-ruleCompare(CssRule *pLeft, CssRule *pRight) {
-    int res = 0;
+static int
+cursorInit (CssStyleSheet *pStyle, HtmlNode *pNode, RuleCursor *aCursor)
+{
+    HtmlElementNode *pElem = HtmlNodeAsElement(pNode);
+    Tcl_HashEntry *pEntry;
+    int nCursor = 0;
+    int iList = 0;
+    int ii;
 
-    assert(pLeft && pRight);
-    assert(
-        (pLeft->pPriority && pRight->pPriority) ||  
-        (!pLeft->pPriority && !pRight->pPriority)
-    );
-    if( !pLeft->pPriority ) return 0;
+    /* The universal rules list applies to all nodes */
+    cursorAdd(aCursor, &nCursor, &iList, pStyle->pUniversalRules);
 
-    res = pLeft->pPriority->iPriority - pRight->pPriority->iPriority;
-    if (res == 0) {
-        /* But here we want (left - right), because specificity is higher
-         * for more specific rules.
-         */
-        res = pLeft->specificity - pRight->specificity;
+    /* Find the applicable "by-tag" rules list, if any. */
+    pEntry = Tcl_FindHashEntry(&pStyle->aByTag, pNode->zTag);
+    if (pEntry) {
+        cursorAdd(aCursor, &nCursor, &iList, Tcl_GetHashValue(pEntry));
+    }
 
-        if (res == 0) {
-            CONST char *zLeft = Tcl_GetString(pLeft->pPriority->pIdTail);
-            CONST char *zRight = Tcl_GetString(pRight->pPriority->pIdTail);
-            res = strcmp(zLeft, zRight);
+    /* Find a rules list for the element id, if any */
+    if (pElem->zId) {
+        pEntry = Tcl_FindHashEntry(&pStyle->aById, pElem->zId);
+        if (pEntry) {
+            cursorAdd(aCursor, &nCursor, &iList, Tcl_GetHashValue(pEntry));
+        }
+    }
 
-            if (res == 0) {
-                /* If we get here, the rules have the same specificity,
-                 * come from the same stylesheet and both either have the
-                 * !IMPORTANT flag set or cleared. In this case the higher
-                 * priority rule is the one that appeared later in the 
-                 * source stylesheet.
-                 */
-		res = pLeft->iRule - pRight->iRule;
-            }
+    /* Find a rules list for each class the element belongs to */
+    for (ii = 0; ii < pElem->nClass; ii++) {
+        pEntry = Tcl_FindHashEntry(&pStyle->aByClass, pElem->azClass[ii]);
+        if (pEntry) {
+            cursorAdd(aCursor, &nCursor, &iList, Tcl_GetHashValue(pEntry));
         }
     }
-    return res;
+
+    /* Arrange the lists into a heap */
+    for (ii = nCursor / 2 - 1; ii >= 0; ii--) {
+        cursorSift(aCursor, nCursor, ii);
+    }
+
+    return nCursor;
 }
 
-static void 
-insertRule (CssRule **ppList, CssRule *pRule)
+/*
+ * While the tree is being styled, a CssStyleShare structure holds a list
+ * of the elements most recently styled by matching stylesheet rules whose
+ * computed values may be shared (HtmlTree.pStyleShare). Before matching 
+ * the rules for an element, HtmlCssStyleSheetApply() searches this list 
+ * for an element with the same tag, attributes and dynamic flags and 
+ * either the same parent, or a parent similar in the same way with the 
+ * same computed values and the same grandparent. Such an element matches
+ * exactly the same rules, so its computed values can be reused.
+ *
+ * An element is only added to the list if none of the rules tested 
+ * against it depend on the position of the element among its siblings,
+ * none of them registered a dynamic condition (:hover etc.) and no 
+ * tcl() property values were used. If a rule depends on the position of
+ * an ancestor, the element may still share with siblings, but not with
+ * cousins. Elements with a style attribute or property overrides never
+ * share computed values.
+ */
+#define CSS_STYLE_SHARE_SIZE 8
+struct CssStyleShare {
+    int iNext;                          /* Next slot in aEntry[] to use */
+    struct CssStyleShareEntry {
+        HtmlNode *pNode;                /* Element styled */
+        int isCousinOk;                 /* True to allow sharing w/ cousins */
+    } aEntry[CSS_STYLE_SHARE_SIZE];
+};
+
+CssStyleShare *
+HtmlCssStyleShareNew (void)
 {
-    if (!*ppList || ruleCompare(*ppList, pRule) <= 0) {
-        /* If the default list is currently empty, or the rule being
-         * added has higher priority than the first rule in the list,
-         * our rule becomes the new head of the list.
-         */
-        pRule->pNext = *ppList;
-        *ppList = pRule;
-    } else {
-        /* Otherwise insert the new rule into the list, ordered by
-         * priority. If there exists another rule with the same
-         * priority, then this rule is inserted into the list *before*
-         * it. This is because when rules are of equal priority, the
-         * latter specified wins.
-         */
-        CssRule *pR = *ppList;
-        while (pR->pNext && ruleCompare(pR->pNext, pRule)>0 ) {
-            pR = pR->pNext;
+    return HtmlNew(CssStyleShare);
+}
+
+void
+HtmlCssStyleShareFree (CssStyleShare *pShare)
+{
+    HtmlFree(pShare);
+}
+
+static int
+styleShareAttrEqual (HtmlAttributes *p1, HtmlAttributes *p2)
+{
+    int ii;
+    if (!p1 || !p2) {
+        return (p1 == p2 || (p1 ? p1->nAttr : p2->nAttr) == 0);
+    }
+    if (p1->nAttr != p2->nAttr) return 0;
+    for (ii = 0; ii < p1->nAttr; ii++) {
+        const char *z1 = p1->a[ii].zValue;
+        const char *z2 = p2->a[ii].zValue;
+        if (p1->a[ii].zName != p2->a[ii].zName && 
+            strcmp(p1->a[ii].zName, p2->a[ii].zName)
+        ) {
+            return 0;
         }
-        pRule->pNext = pR->pNext;
-        pR->pNext = pRule;
+        if (z1 != z2 && (!z1 || !z2 || strcmp(z1, z2))) return 0;
     }
+    return 1;
+}
+
+/*
+ * Return true if elements p1 and p2 have the same tag, attributes and 
+ * dynamic flags.
+ */
+static int
+styleShareElemEqual (HtmlNode *p1, HtmlNode *p2)
+{
+    HtmlElementNode *pElem1 = HtmlNodeAsElement(p1);
+    HtmlElementNode *pElem2 = HtmlNodeAsElement(p2);
+    return (
+        pElem1 && pElem2 &&
+        pElem1->flags == pElem2->flags &&
+        0 == strcmp(p1->zTag, p2->zTag) &&
+        styleShareAttrEqual(pElem1->pAttributes, pElem2->pAttributes)
+    );
 }
 
 /*
  *---------------------------------------------------------------------------
  *
- * cssSelectorPropertySetPair --
- *
- *     A rule has just been parsed with selector pSelector and properties
- *     pPropertySet. This function creates a CssRule object to link the two
- *     together and inserts the new rule into the CssStyleSheet structure.
+ * styleShareFind --
  *
- *     The caller should not free resources associated with pSelector or
- *     pPropertySet after this function returns, they are now linked into
- *     the stylesheet object.
+ *     Search the style-sharing list of pTree for an element that pNode 
+ *     may share computed values with. 
  *
  * Results:
- *     None.
+ *     The element found, or NULL.
  *
  * Side effects:
  *     None.
  *
  *---------------------------------------------------------------------------
- */
-#define FREE_SELECTOR    0x00000001
-#define FREE_PROPERTYSET 0x00000002
-#define FREE_BOTH        0x00000003
-static void 
-cssSelectorPropertySetPair (CssParse *pParse, CssSelector *pSelector, CssPropertySet *pPropertySet, unsigned int freeWhat)
-{
-    int spec = 0;
-    CssSelector *pS = 0;
-    CssStyleSheet *pStyle = pParse->pStyle;
-    CssRule *pRule = HtmlNew(CssRule);
-
-    assert(pPropertySet && pPropertySet->n > 0);
-
-    if (freeWhat & FREE_PROPERTYSET) {
-        pRule->freePropertySets = 1;
-    }
-    if (freeWhat & FREE_SELECTOR) {
-        pRule->freeSelector = 1;
-    }
-
-    /* Calculate the specificity of the rules. We use the following
-     * formala:
-     *
-     *     Specificity = (number of id selectors)        * 10000 +
-     *                   (number of attribute selectors) * 100   +
-     *                   (number of pseudo classes)      * 100   +
-     *                   (number of type selectors)
-     *
-     * Todo: There are (at least) two bugs here:
-     *     1. A rule with 100 type selectors has greater specificity than a
-     *        rule with a single attribute selector. This probably isn't a
-     *        problem.
-     *     2. A selector of the form '[id="hello"]' has the same
-     *        specificity as the selector '.hello'. This is pretty obscure,
-     *        but could come up.
-     * 
-     * See section 6.4, "The cascade", of CSS2 documentation for details on
-     * selector specificity.
-     */
-    for (pS=pSelector; pS; pS = pS->pNext) {
-         switch (pS->eSelector) {
-             case CSS_SELECTOR_TYPE:
-                 spec += 1;
-                 break;
-
-             case CSS_SELECTOR_ID:
-                 spec += 10000;
-                 break;
-
-             case CSS_SELECTOR_ATTR:
-             case CSS_SELECTOR_ATTRVALUE:
-             case CSS_SELECTOR_ATTRLISTVALUE:
-             case CSS_SELECTOR_ATTRHYPHEN:
-                 spec += 100;
-                 break;
-
-             case CSS_SELECTOR_CLASS:
-             case CSS_PSEUDOCLASS_LANG:
-             case CSS_PSEUDOCLASS_FIRSTCHILD:
-             case CSS_PSEUDOCLASS_LINK:
-             case CSS_PSEUDOCLASS_VISITED:
-             case CSS_PSEUDOCLASS_ACTIVE:
-             case CSS_PSEUDOCLASS_HOVER:
-             case CSS_PSEUDOCLASS_FOCUS:
-                 spec += 100;
-                 break;
-         }
-    }
-    pRule->specificity = spec;
-    assert(
-        pPropertySet == pParse->pPropertySet || 
-        pPropertySet == pParse->pImportant
-    );
-    if (pParse->pPropertySet == pPropertySet) {
-        pRule->pPriority = pParse->pPriority1;
-    } else {
-        pRule->pPriority = pParse->pPriority2;
+ */
+static HtmlNode *
+styleShareFind (HtmlTree *pTree, HtmlNode *pNode)
+{
+    CssStyleShare *pShare = pTree->pStyleShare;
+    HtmlElementNode *pElem = HtmlNodeAsElement(pNode);
+    HtmlNode *pParent = HtmlNodeParent(pNode);
+    int ii;
+
+    if (!pShare || pElem->pStyle || HtmlElemRare(pElem, pOverride)) return 0;
+
+    for (ii = 1; ii <= CSS_STYLE_SHARE_SIZE; ii++) {
+        int iSlot = (pShare->iNext - ii) & (CSS_STYLE_SHARE_SIZE - 1);
+        HtmlNode *pCand = pShare->aEntry[iSlot].pNode;
+        HtmlNode *pCandParent;
+
+        if (!pCand || !styleShareElemEqual(pNode, pCand)) continue;
+        pCandParent = HtmlNodeParent(pCand);
+        if (pCandParent != pParent && (
+            !pShare->aEntry[iSlot].isCousinOk ||
+            !pParent || !pCandParent ||
+            HtmlNodeParent(pParent) != HtmlNodeParent(pCandParent) ||
+            HtmlNodeComputedValues(pParent) != 
+                HtmlNodeComputedValues(pCandParent) ||
+            !styleShareElemEqual(pParent, pCandParent)
+        )) {
+            continue;
+        }
+        return pCand;
     }
-    pRule->iRule = pParse->iNextRule++;
+    return 0;
+}
 
-    /* Insert the rule into it's list. */
-    if (pParse->pStyleId) {
-        pS = pSelector;
+static void
+styleShareAdd (HtmlTree *pTree, HtmlNode *pNode, int isCousinOk)
+{
+    CssStyleShare *pShare = pTree->pStyleShare;
+    if (pShare) {
+        pShare->aEntry[pShare->iNext].pNode = pNode;
+        pShare->aEntry[pShare->iNext].isCousinOk = isCousinOk;
+        pShare->iNext = (pShare->iNext + 1) & (CSS_STYLE_SHARE_SIZE - 1);
+    }
+}
 
-        while (pS->pNext && (
-                pS->eSelector == CSS_SELECTOR_ATTR ||
-                pS->eSelector == CSS_SELECTOR_ATTRVALUE ||
-                pS->eSelector == CSS_SELECTOR_ATTRLISTVALUE ||
-                pS->eSelector == CSS_SELECTOR_ATTRHYPHEN ||
-                pS->eSelector == CSS_PSEUDOCLASS_ACTIVE ||
-                pS->eSelector == CSS_PSEUDOCLASS_HOVER ||
-                pS->eSelector == CSS_PSEUDOCLASS_FOCUS ||
-                pS->eSelector == CSS_PSEUDOCLASS_LINK ||
-                pS->eSelector == CSS_PSEUDOCLASS_VISITED
-            )
-        ) {
-            pS = pS->pNext;
-        }
+/*
+ *---------------------------------------------------------------------------
+ *
+ * selectorSubjectTest --
+ *
+ *     Test the type, class, id and attribute selectors in the right-most
+ *     compound selector of pSelector (the one that applies to the node
+ *     itself) against element pNode. Pseudo-classes are ignored.
+ *
+ * Results:
+ *     Zero if pSelector definitely does not match pNode, non-zero if it
+ *     may.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+selectorSubjectTest (CssSelector *pSelector, HtmlNode *pNode)
+{
+    HtmlElementNode *pElem = HtmlNodeAsElement(pNode);
+    CssSelector *p;
 
-        switch (pS->eSelector) {
+    for (p = pSelector; p; p = p->pNext) {
+        switch (p->eSelector) {
+            case CSS_SELECTORCHAIN_DESCENDANT:
+            case CSS_SELECTORCHAIN_CHILD:
+            case CSS_SELECTORCHAIN_ADJACENT:
+                return 1;
 
-            case CSS_PSEUDOELEMENT_AFTER:
-                insertRule(&pStyle->pAfterRules, pRule);
+            case CSS_SELECTOR_TYPE:
+                if (strcmp(pNode->zTag, p->zValue)) return 0;
                 break;
 
-            case CSS_PSEUDOELEMENT_BEFORE:
-                insertRule(&pStyle->pBeforeRules, pRule);
+            case CSS_SELECTOR_CLASS: {
+                int ii;
+                for (ii = 0; ii < pElem->nClass; ii++) {
+                    if (0 == stricmp(pElem->azClass[ii], p->zValue)) break;
+                }
+                if (ii == pElem->nClass) return 0;
                 break;
-    
-            case CSS_SELECTOR_ID:
-            case CSS_SELECTOR_CLASS:
-            case CSS_SELECTOR_TYPE: {
-                int newentry;
-                Tcl_HashTable *pTab;
-                Tcl_HashEntry *p;
-                CssRule *pList = 0;
+            }
 
-                pTab = &pStyle->aByTag;
-                switch (pS->eSelector) {
-                    case CSS_SELECTOR_ID:    pTab = &pStyle->aById; break;
-                    case CSS_SELECTOR_CLASS: pTab = &pStyle->aByClass; break;
-                    case CSS_SELECTOR_TYPE:  pTab = &pStyle->aByTag; break;
+            case CSS_SELECTOR_ID:
+                if (!attrTest(CSS_SELECTOR_ATTRVALUE, p->zValue, pElem->zId)) {
+                    return 0;
                 }
+                break;
 
-                p = Tcl_CreateHashEntry(pTab, pS->zValue, &newentry);
-                if (!newentry) { 
-                    pList = (CssRule *)Tcl_GetHashValue(p); 
-                }
-                insertRule(&pList, pRule);
-                Tcl_SetHashValue(p, pList);
+            case CSS_SELECTOR_ATTR:
+            case CSS_SELECTOR_ATTRVALUE:
+            case CSS_SELECTOR_ATTRLISTVALUE:
+            case CSS_SELECTOR_ATTRHYPHEN: {
+                const char *zAttr = HtmlNodeAttr(pNode, p->zAttr);
+                if (!attrTest(p->eSelector, p->zValue, zAttr)) return 0;
                 break;
             }
-    
-            default:
-                insertRule(&pStyle->pUniversalRules, pRule);
-                break;
         }
-    } else {
-        insertRule(&pStyle->pUniversalRules, pRule);
     }
+    return 1;
+}
 
-    pRule->pSelector = pSelector;
-    pRule->pPropertySet = pPropertySet;
+/*
+ * Maximum number of entries in the matched-rule cache. If this is 
+ * exceeded the cache is emptied.
+ */
+#define CSS_MATCH_CACHE_MAX 20000
+
+static void
+matchCacheClear (CssMatchCache *pCache)
+{
+    Tcl_HashSearch search;
+    Tcl_HashEntry *pEntry;
+
+    for (
+        pEntry = Tcl_FirstHashEntry(&pCache->aEntry, &search); 
+        pEntry; 
+        pEntry = Tcl_NextHashEntry(&search)
+    ) {
+        CssMatchEntry *pMatch = (CssMatchEntry *)Tcl_GetHashValue(pEntry);
+        if (pMatch->apRule) HtmlFree(pMatch->apRule);
+        HtmlFree(pMatch);
+    }
+    Tcl_DeleteHashTable(&pCache->aEntry);
+    Tcl_InitHashTable(&pCache->aEntry, TCL_STRING_KEYS);
+    pCache->nEntry = 0;
+    pCache->nHit = 0;
+    pCache->nMiss = 0;
 }
 
-/*--------------------------------------------------------------------------
+/*
+ *---------------------------------------------------------------------------
  *
- * HtmlCssRule --
+ * matchCacheFree --
  *
- *     This is called when the parser has parsed an entire rule.
+ *     Free the matched-rule cache of stylesheet pStyle, if any. This is
+ *     called when the stylesheet is deleted and each time rules are added
+ *     to it.
  *
  * Results:
  *     None.
  *
  * Side effects:
- * 
- *     If the parse was successful, then add the rule to the stylesheet.
- *     If unsuccessful, delete anything that was built up by calls to 
- *     HtmlCssDeclaration() or HtmlCssSelector().
+ *     Sets pStyle->pMatchCache to NULL.
  *
- *--------------------------------------------------------------------------
+ *---------------------------------------------------------------------------
  */
-void 
-HtmlCssRule (CssParse *pParse, int success)
+static void
+matchCacheFree (CssStyleSheet *pStyle)
 {
-    CssSelector *pSelector = pParse->pSelector;
-    CssPropertySet *pPropertySet = pParse->pPropertySet;
-    CssPropertySet *pImportant = pParse->pImportant;
-    CssSelector **apXtraSelector = pParse->apXtraSelector;
-    int nXtra = pParse->nXtra;
-    int i;
-
-#if TRACE_PARSER_CALLS
-    printf("HtmlCssRule(%p, %d)\n", pParse, success);
-#endif
-
-    if (pPropertySet && pPropertySet->n == 0) {
-        propertySetFree(pPropertySet);
-        pPropertySet = 0;
-    }
-    if (pImportant && pImportant->n == 0) {
-        propertySetFree(pImportant);
-        pImportant = 0;
+    CssMatchCache *pCache = pStyle->pMatchCache;
+    if (pCache) {
+        matchCacheClear(pCache);
+        Tcl_DeleteHashTable(&pCache->aEntry);
+        HtmlFree(pCache);
+        pStyle->pMatchCache = 0;
     }
+}
 
-    if (
-        success && 
-        !pParse->isIgnore && 
-        pSelector && 
-        (pPropertySet || pImportant)
-    ) {
-
-        if (pPropertySet) {
-            unsigned int flags = FREE_BOTH;
-            cssSelectorPropertySetPair(pParse, pSelector, pPropertySet, flags);
-            for (i = 0; i < nXtra; i++){
-                unsigned int flags2 = FREE_SELECTOR;
-                CssSelector *pS = apXtraSelector[i];
-                cssSelectorPropertySetPair(pParse, pS, pPropertySet, flags2);
-            }
-        }
-
-        if (pImportant) {
-            unsigned int flags = (pPropertySet ? FREE_PROPERTYSET : FREE_BOTH);
-            cssSelectorPropertySetPair(pParse, pSelector, pImportant, flags);
-            for (i = 0; i < nXtra; i++){
-                unsigned int flags2 = (pPropertySet ? 0 : FREE_SELECTOR);
-                CssSelector *pS = apXtraSelector[i];
-                cssSelectorPropertySetPair(pParse, pS, pImportant, flags2);
-            }
+/*
+ * Add the attribute names read by attr() items of property value p,
+ * which may be a list, to attribute index pIndex. Return true if the
+ * value contains a tcl() item.
+ */
+static int
+attrIndexAddProperty (HtmlTree *pTree, CssAttrIndex *pIndex, CssProperty *p)
+{
+    int isTcl = 0;
+    int isNew;
+
+    if (!p) {
+        /* Empty slot. tokenToProperty() returns NULL for rejected values. */
+    } else if (p->eType == CSS_TYPE_TCL) {
+        isTcl = 1;
+    } else if (p->eType == CSS_TYPE_LIST) {
+        /* The 'content', 'counter-increment' and 'counter-reset' values
+         * are lists, which may include attr() or tcl() items. 
+         */
+        CssProperty **apProp = (CssProperty **)p->v.p;
+        int ii;
+        for (ii = 0; apProp[ii]; ii++) {
+            isTcl |= attrIndexAddProperty(pTree, pIndex, apProp[ii]);
         }
-
-    } else {
-        /* Some sort of a parse error has occured. We won't be including
-         * this rule, so just free these structs so we don't leak memory.
-         */ 
-        selectorFree(pSelector);
-        propertySetFree(pPropertySet);
-        propertySetFree(pImportant);
-        for (i = 0; i < nXtra; i++){
-            selectorFree(apXtraSelector[i]);
+    } else if (p->eType == CSS_TYPE_ATTR) {
+        const char *z = p->v.zVal;
+        int n;
+        z = HtmlCssGetNextListItem(z, strlen(z), &n);
+        if (z) {
+            char *zName = HtmlAlloc("tmp", n + 1);
+            memcpy(zName, z, n);
+            zName[n] = '\0';
+            Tcl_CreateHashEntry(
+                &pIndex->aAttr, HtmlTreeAtom(pTree, zName), &isNew
+            );
+            HtmlFree(zName);
         }
     }
-
-    pParse->pSelector = 0;
-    pParse->pPropertySet = 0;
-    pParse->pImportant = 0;
-    pParse->apXtraSelector = 0;
-    pParse->nXtra = 0;
-
-    if( apXtraSelector ){
-        HtmlFree(apXtraSelector);
-    }
+    return isTcl;
 }
 
-/*--------------------------------------------------------------------------
+/*
+ *---------------------------------------------------------------------------
  *
- * attrTest --
+ * attrIndexAddRules --
  *
- *     Test if an attribute value matches a string. The three modes of 
- *     comparing attribute values specified in CSS are supported.
+ *     Add the attribute names referenced by the rules in list pList to 
+ *     attribute index pIndex. These are the attributes tested by 
+ *     attribute selectors, and those read by attr() property values 
+ *     (including attr() items in the lists of the 'content' property).
+ *
+ *     A property value specified using tcl() may read any attribute of the
+ *     element it is calculated for. The tag of the element matched by the
+ *     rule is added to pIndex->aTclTag, or if the rule does not specify a 
+ *     tag, pIndex->isAll is set.
  *
  * Results:
- *     Non-zero is returned if the match is true.
+ *     None.
  *
  * Side effects:
- *     None.
+ *     Adds entries to the tables of pIndex. Creates atoms for attribute
+ *     names in pTree.
  *
- *--------------------------------------------------------------------------
+ *---------------------------------------------------------------------------
  */
-static int 
-attrTest (int eType, const char *zString, const char *zAttr)
+static void
+attrIndexAddRules (HtmlTree *pTree, CssAttrIndex *pIndex, CssRule *pList)
 {
-    if (!zAttr) {
-        return 0;
-    }
-
-    switch( eType ){
-        /* True if the specified attribute exists */
-        case CSS_SELECTOR_ATTR:
-            return (zAttr?1:0);
+    CssRule *pRule;
+    int isNew;
 
-        /* True if the specified attribute exists and the value matches
-         * the string exactly.
-         */
-        case CSS_SELECTOR_ATTRVALUE:
-            return ((zAttr && 0==stricmp(zAttr, zString))?1:0);
+    for (pRule = pList; pRule; pRule = pRule->pNext) {
+        CssPropertySet *pSet = pRule->pPropertySet;
+        CssSelector *p;
+        int isTcl = 0;
+        int ii;
 
-	/* Treat the attribute value (if it exists) as a space seperated list.
-         * Return true if zString exists in the list.
-         */
-        case CSS_SELECTOR_ATTRLISTVALUE: {
-            const char *pAttr = zAttr;
-            int nAttr;
-            int nString = strlen(zString);
-            while ((pAttr=HtmlCssGetNextListItem(pAttr, strlen(pAttr), &nAttr))) {
-                if (nString==nAttr && 0==strnicmp(pAttr, zString, nAttr)) {
-                    return 1;
-                }
-                pAttr += nAttr;
+        for (p = pRule->pSelector; p; p = p->pNext) {
+            if (p->zAttr && (
+                p->eSelector == CSS_SELECTOR_ATTR ||
+                p->eSelector == CSS_SELECTOR_ATTRVALUE ||
+                p->eSelector == CSS_SELECTOR_ATTRLISTVALUE ||
+                p->eSelector == CSS_SELECTOR_ATTRHYPHEN
+            )) {
+                const char *zAtom = HtmlTreeAtom(pTree, p->zAttr);
+                Tcl_CreateHashEntry(&pIndex->aAttr, zAtom, &isNew);
             }
-            return 0;
         }
 
-        /* True if the attribute exists and matches zString up to the
-         * first '-' character in the attribute value.
-         */
-        case CSS_SELECTOR_ATTRHYPHEN: {
-            char *pHyphen = strchr(zAttr, '-');
-            if( pHyphen && 0==strnicmp(zAttr, zString, pHyphen-zAttr) ){
-                return 1;
+        for (ii = 0; pSet && ii < pSet->n; ii++) {
+            isTcl |= attrIndexAddProperty(pTree, pIndex, pSet->a[ii].pProp);
+        }
+
+        if (isTcl) {
+            for (p = pRule->pSelector; p; p = p->pNext) {
+                if (p->eSelector == CSS_SELECTORCHAIN_DESCENDANT ||
+                    p->eSelector == CSS_SELECTORCHAIN_CHILD ||
+                    p->eSelector == CSS_SELECTORCHAIN_ADJACENT ||
+                    p->eSelector == CSS_SELECTOR_TYPE
+                ) {
+                    break;
+                }
+            }
+            if (p && p->eSelector == CSS_SELECTOR_TYPE) {
+                Tcl_CreateHashEntry(&pIndex->aTclTag, p->zValue, &isNew);
+            } else {
+                pIndex->isAll = 1;
             }
-            return 0;
         }
     }
+}
 
-    assert(!"Impossible");
-    return 0;
+static void
+attrIndexAddHash (HtmlTree *pTree, CssAttrIndex *pIndex, Tcl_HashTable *p)
+{
+    Tcl_HashSearch search;
+    Tcl_HashEntry *pEntry;
+    for (
+        pEntry = Tcl_FirstHashEntry(p, &search); 
+        pEntry; 
+        pEntry = Tcl_NextHashEntry(&search)
+    ) {
+        attrIndexAddRules(pTree, pIndex, (CssRule *)Tcl_GetHashValue(pEntry));
+    }
 }
 
-/*--------------------------------------------------------------------------
+/*
+ *---------------------------------------------------------------------------
  *
- * HtmlCssSelectorTest --
+ * attrIndexGet --
  *
- *     Test if a selector matches a document node.
+ *     Return the attribute index for the stylesheet configuration of
+ *     pTree, building it if necessary.
  *
  * Results:
- *     Non-zero is returned if the Selector does match the node.
+ *     Pointer to index.
  *
  * Side effects:
- *     None.
+ *     May allocate pTree->pStyle->pAttrIndex.
  *
- *--------------------------------------------------------------------------
+ *---------------------------------------------------------------------------
  */
-#define N_TYPE(x)        HtmlNodeTagName(x)
-#define N_ATTR(x,y)      HtmlNodeAttr(x,y)
-#define N_PARENT(x)      HtmlNodeParent(x)
-#define N_NUMCHILDREN(x) HtmlNodeNumChildren(x)
-#define N_CHILD(x,y)     HtmlNodeChild(x,y)
-int 
-HtmlCssSelectorTest (CssSelector *pSelector, HtmlNode *pNode, int dynamic_true)
+static CssAttrIndex *
+attrIndexGet (HtmlTree *pTree)
 {
-    CssSelector *p = pSelector;
-    HtmlNode *x = pNode;
-
-    HtmlElementNode *pElem = HtmlNodeAsElement(pNode);
-    assert(pElem);
-
-    while( p && x ){
-        pElem = HtmlNodeAsElement(x);
-
-        switch( p->eSelector ){
-            case CSS_SELECTOR_UNIVERSAL:
-                break;
-
-            case CSS_SELECTOR_TYPE:
-                assert(x->zTag || HtmlNodeIsText(x));
-                if( HtmlNodeIsText(x) || strcmp(x->zTag, p->zValue) ) return 0;
-                break;
-
-            case CSS_SELECTOR_CLASS: {
-                const char *zClass = p->zValue;
-                const char *zAttr = N_ATTR(x, "class");
-                if( !attrTest(CSS_SELECTOR_ATTRLISTVALUE, zClass, zAttr) ){
-                    return 0;
-                }
-                break;
-            }
-
-            case CSS_SELECTOR_ID: {
-                const char *zId = p->zValue;
-                const char *zAttr = N_ATTR(x, "id");
-                if( !attrTest(CSS_SELECTOR_ATTRVALUE, zId, zAttr) ){
-                    return 0;
-                }
-                break;
-            }
-
-            case CSS_SELECTOR_ATTR:
-            case CSS_SELECTOR_ATTRVALUE:
-            case CSS_SELECTOR_ATTRLISTVALUE:
-            case CSS_SELECTOR_ATTRHYPHEN:
-                if( !attrTest(p->eSelector, p->zValue, N_ATTR(x,p->zAttr)) ){
-                    return 0;
-                }
-                break;
-
-            case CSS_SELECTORCHAIN_DESCENDANT: {
-                HtmlNode *pParent = N_PARENT(x);
-                CssSelector *pNext = p->pNext;
-                while (pParent) {
-                    if (HtmlCssSelectorTest(pNext, pParent, dynamic_true)) {
-                        return 1;
-                    }
-                    pParent = N_PARENT(pParent);
-                }
-                return 0;
-            }
-            case CSS_SELECTORCHAIN_CHILD:
-                x = N_PARENT(x);
-                break;
-            case CSS_SELECTORCHAIN_ADJACENT: {
-                HtmlNode *pParent = N_PARENT(x);
-                int i;
-
-                if (
-                    !pParent || 
-                    ((HtmlElementNode *)pParent)->pBefore == x ||
-                    ((HtmlElementNode *)pParent)->pAfter == x 
-                ) {
-                    return 0;
-                }
-
-                /* Search for the nearest left-hand sibling that is not
-                 * white-space. If no such sibling exists, set x==0 (this
-                 * will cause the selector-match to fail). If the sibling
-                 * does exist, set x to point at it.
-                 */
-                for (i = 0; N_CHILD(pParent, i) != x; i++);
-                i--;
-                do {
-                    x = N_CHILD(pParent, i);
-                    i--;
-                } while (i >= 0 && HtmlNodeIsWhitespace(x));
-                if (i < 0) return 0;
-
-                break;
-            }
-
-            case CSS_PSEUDOCLASS_FIRSTCHILD: {
-                /* :first-child selector matches if x is the left-most child
-                 * of it's parent, not including white-space nodes. */
-                HtmlNode *pParent = N_PARENT(x);
-                int i;
-                if (!pParent) return 0;
-                for (i = 0; i < N_NUMCHILDREN(pParent); i++) {
-                    HtmlNode *pChild = N_CHILD(pParent, i);
-                    if (pChild == x) break;
-                    if (!HtmlNodeIsWhitespace(pChild)) return 0;
-                }
-                assert(i < N_NUMCHILDREN(pParent));
-                break;
-            }
-            case CSS_PSEUDOCLASS_LASTCHILD: {
-                /* :last-child selector matches if x is the right-most child
-                 * of it's parent, not including white-space nodes. */
-                HtmlNode *pParent = N_PARENT(x);
-                int i;
-                if (!pParent) return 0;
-                for (i = N_NUMCHILDREN(pParent) - 1; i >= 0; i--) {
-                    HtmlNode *pChild = N_CHILD(pParent, i);
-                    if (pChild == x) break;
-                    if (!HtmlNodeIsWhitespace(pChild)) return 0;
-                }
-                assert(i >= 0);
-                break;
-            }
-                
-            case CSS_PSEUDOCLASS_LANG:
-                return 0;
+    CssStyleSheet *pStyle = pTree->pStyle;
+    CssAttrIndex *pIndex = pStyle->pAttrIndex;
+    if (!pIndex) {
+        pIndex = HtmlNew(CssAttrIndex);
+        Tcl_InitHashTable(&pIndex->aAttr, TCL_ONE_WORD_KEYS);
+        Tcl_InitHashTable(&pIndex->aTclTag, TCL_STRING_KEYS);
+        attrIndexAddRules(pTree, pIndex, pStyle->pUniversalRules);
+        attrIndexAddRules(pTree, pIndex, pStyle->pBeforeRules);
+        attrIndexAddRules(pTree, pIndex, pStyle->pAfterRules);
+        attrIndexAddHash(pTree, pIndex, &pStyle->aByTag);
+        attrIndexAddHash(pTree, pIndex, &pStyle->aByClass);
+        attrIndexAddHash(pTree, pIndex, &pStyle->aById);
+        pStyle->pAttrIndex = pIndex;
+    }
+    return pIndex;
+}
 
+static void
+attrIndexFree (CssStyleSheet *pStyle)
+{
+    CssAttrIndex *pIndex = pStyle->pAttrIndex;
+    if (pIndex) {
+        Tcl_DeleteHashTable(&pIndex->aAttr);
+        Tcl_DeleteHashTable(&pIndex->aTclTag);
+        HtmlFree(pIndex);
+        pStyle->pAttrIndex = 0;
+    }
+}
 
-            case CSS_PSEUDOELEMENT_FIRSTLINE:
-            case CSS_PSEUDOELEMENT_FIRSTLETTER:
-                return 0;
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlCssAttrIsSignificant --
+ *
+ *     Test if modifying attribute zAttr of element pNode may change the 
+ *     computed style of any element in the document, i.e. if the attribute
+ *     is an id, class or style attribute, or is referenced by the 
+ *     stylesheet. It is assumed that tcl() property values depend only 
+ *     on the attributes of the element they are calculated for.
+ *
+ * Results:
+ *     True if the document must be restyled, otherwise false.
+ *
+ * Side effects:
+ *     May build the attribute index for the stylesheet configuration.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+HtmlCssAttrIsSignificant (HtmlTree *pTree, HtmlNode *pNode, const char *zAttr)
+{
+    const char *zAtom;
+    CssAttrIndex *pIndex;
 
-            case CSS_PSEUDOELEMENT_BEFORE:
-            case CSS_PSEUDOELEMENT_AFTER:
-                break;
+    /* Text nodes have no attributes. */
+    if (HtmlNodeIsText(pNode)) {
+        return 0;
+    }
 
-            case CSS_PSEUDOCLASS_ACTIVE:
-                if (dynamic_true || (pElem->flags & HTML_DYNAMIC_ACTIVE)) break;
-                return 0;
-            case CSS_PSEUDOCLASS_HOVER:
-                if (dynamic_true || (pElem->flags & HTML_DYNAMIC_HOVER)) break;
-                return 0;
-            case CSS_PSEUDOCLASS_FOCUS:
-                if (dynamic_true || (pElem->flags & HTML_DYNAMIC_FOCUS)) break;
-                return 0;
-            case CSS_PSEUDOCLASS_LINK:
-                if (pElem->flags & HTML_DYNAMIC_LINK) break;
-                return 0;
-            case CSS_PSEUDOCLASS_VISITED:
-                if (pElem->flags & HTML_DYNAMIC_VISITED) break;
-                return 0;
+    /* The "id" and "class" atoms always exist. Other attribute names in
+     * the index are atoms created when the index is built, so once it
+     * has been built there is no need to create an atom for zAttr.
+     */
+    zAtom = HtmlTreeAtomFind(pTree, zAttr);
+    if (!pTree->pStyle ||
+        (zAtom && (zAtom == pTree->zAtomId || zAtom == pTree->zAtomClass)) ||
+        0 == stricmp(zAttr, HTML_INLINE_STYLE_ATTR)
+    ) {
+        return 1;
+    }
 
-            case CSS_SELECTOR_NEVERMATCH:
-                return 0;
+    pIndex = attrIndexGet(pTree);
+    zAtom = HtmlTreeAtomFind(pTree, zAttr);
+    return (pIndex->isAll ||
+        (zAtom && Tcl_FindHashEntry(&pIndex->aAttr, zAtom)) ||
+        Tcl_FindHashEntry(&pIndex->aTclTag, pNode->zTag)
+    );
+}
 
-            default:
-                assert(!"Impossible");
-        }
-        p = p->pNext;
+/*
+ *---------------------------------------------------------------------------
+ *
+ * matchCacheGet --
+ *
+ *     Return the matched-rule cache for the stylesheet configuration of
+ *     pTree, creating it if necessary.
+ *
+ * Results:
+ *     Pointer to cache.
+ *
+ * Side effects:
+ *     May allocate pTree->pStyle->pMatchCache.
+ *
+ *---------------------------------------------------------------------------
+ */
+static CssMatchCache *
+matchCacheGet (HtmlTree *pTree)
+{
+    CssStyleSheet *pStyle = pTree->pStyle;
+    CssMatchCache *pCache = pStyle->pMatchCache;
+    if (!pCache) {
+        pCache = HtmlNew(CssMatchCache);
+        Tcl_InitHashTable(&pCache->aEntry, TCL_STRING_KEYS);
+        pStyle->pMatchCache = pCache;
     }
-
-    return (x && !p)?1:0;
+    return pCache;
 }
 
 /*
  *---------------------------------------------------------------------------
  *
- * HtmlCssInlineFree --
+ * matchCacheEntry --
+ *
+ *     Find or create the matched-rule cache entry for element pNode, 
+ *     the parent of which has match signature iParentSig (or 0 if pNode 
+ *     is the root element).
  *
  * Results:
+ *     Pointer to cache entry.
  *
  * Side effects:
+ *     May empty the cache if it has grown too large.
  *
  *---------------------------------------------------------------------------
  */
-void 
-HtmlCssInlineFree (CssPropertySet *pPropertySet)
+static CssMatchEntry *
+matchCacheEntry (HtmlTree *pTree, int iParentSig, HtmlNode *pNode)
 {
-    propertySetFree(pPropertySet);
+    CssMatchCache *pCache = matchCacheGet(pTree);
+    CssAttrIndex *pIndex = attrIndexGet(pTree);
+    HtmlElementNode *pElem = HtmlNodeAsElement(pNode);
+    HtmlAttributes *pAttr = pElem->pAttributes;
+    CssMatchEntry *pMatch;
+    Tcl_HashEntry *pEntry;
+    Tcl_DString key;
+    char zBuf[64];
+    int isNew;
+    int ii;
+
+    Tcl_DStringInit(&key);
+    sprintf(zBuf, "%d/%d/", iParentSig, (int)pElem->flags);
+    Tcl_DStringAppend(&key, zBuf, -1);
+    Tcl_DStringAppend(&key, pNode->zTag, -1);
+    for (ii = 0; pAttr && ii < pAttr->nAttr; ii++) {
+        const char *zName = pAttr->a[ii].zName;
+        if (zName == pTree->zAtomId || zName == pTree->zAtomClass ||
+            Tcl_FindHashEntry(&pIndex->aAttr, zName)
+        ) {
+            const char *zValue = pAttr->a[ii].zValue;
+            if (!zValue) zValue = "";
+            sprintf(zBuf, "/%p=%d:", (void *)zName, (int)strlen(zValue));
+            Tcl_DStringAppend(&key, zBuf, -1);
+            Tcl_DStringAppend(&key, zValue, -1);
+        }
+    }
+
+    pEntry = Tcl_FindHashEntry(&pCache->aEntry, Tcl_DStringValue(&key));
+    if (!pEntry) {
+        if (pCache->nEntry >= CSS_MATCH_CACHE_MAX) {
+            matchCacheClear(pCache);
+        }
+        pEntry = Tcl_CreateHashEntry(
+            &pCache->aEntry, Tcl_DStringValue(&key), &isNew
+        );
+        pMatch = HtmlNew(CssMatchEntry);
+        pMatch->iSignature = ++pTree->pStyle->iMatchSignature;
+        Tcl_SetHashValue(pEntry, pMatch);
+        pCache->nEntry++;
+    }
+    Tcl_DStringFree(&key);
+
+    return (CssMatchEntry *)Tcl_GetHashValue(pEntry);
 }
 
 /*
  *---------------------------------------------------------------------------
  *
- * propertySetToPropertyValues --
+ * matchCacheFind --
+ *
+ *     Return the matched-rule cache entry for element pNode, or NULL if
+ *     the ancestor filter is not available to supply the signature of 
+ *     its parent (i.e. if pNode is not being styled by HtmlStyleApply()).
+ *
+ *     The signatures of the ancestors of pNode are stored in the ancestor
+ *     filter levels, and calculated here as required.
  *
  * Results:
+ *     Pointer to cache entry, or NULL.
  *
  * Side effects:
+ *     None.
  *
  *---------------------------------------------------------------------------
  */
-static void 
-propertySetToPropertyValues (HtmlComputedValuesCreator *p, int *aPropDone, CssPropertySet *pSet)
+static CssMatchEntry *
+matchCacheFind (HtmlTree *pTree, HtmlNode *pNode)
+{
+    CssAncestorFilter *pFilter = pTree->pAncestorFilter;
+    int iSig = 0;
+    int ii;
+
+    if (!pFilter || pFilter->pTop != HtmlNodeParent(pNode)) return 0;
+
+    for (ii = pFilter->nLevel - 1; ii >= 0; ii--) {
+        if (pFilter->aLevel[ii].iSignature) {
+            iSig = pFilter->aLevel[ii].iSignature;
+            break;
+        }
+    }
+    for (ii++; ii < pFilter->nLevel; ii++) {
+        HtmlNode *pAncestor = pFilter->aLevel[ii].pNode;
+        iSig = matchCacheEntry(pTree, iSig, pAncestor)->iSignature;
+        pFilter->aLevel[ii].iSignature = iSig;
+    }
+
+    return matchCacheEntry(pTree, iSig, pNode);
+}
+
+/*
+ * Populate the empty matched-rule cache entry pMatch with the nMatch rules
+ * in apMatch[] and the nDynamic dynamic selectors in apDynamic[]. If a 
+ * rule tested against the element depends on the position of the element
+ * or an ancestor in the document (mPositional is not zero), which is not
+ * part of the match signature, the entry is marked as not cacheable 
+ * instead.
+ */
+static void
+matchCacheStore (
+    CssMatchEntry *pMatch,
+    int mPositional,
+    CssRule **apMatch, 
+    int nMatch,
+    CssSelector **apDynamic,
+    int nDynamic
+)
+{
+    assert(pMatch->eState == CSS_MATCH_EMPTY);
+    if (mPositional) {
+        pMatch->eState = CSS_MATCH_UNCACHEABLE;
+    } else {
+        int nByte = (nMatch + nDynamic) * sizeof(void *);
+        pMatch->apRule = (CssRule **)HtmlAlloc("CssMatchEntry", nByte);
+        pMatch->apDynamic = (CssSelector **)&pMatch->apRule[nMatch];
+        if (nMatch) {
+            memcpy(pMatch->apRule, apMatch, nMatch * sizeof(CssRule *));
+        }
+        if (nDynamic) {
+            memcpy(pMatch->apDynamic, apDynamic, 
+                nDynamic * sizeof(CssSelector *)
+            );
+        }
+        pMatch->nRule = nMatch;
+        pMatch->nDynamic = nDynamic;
+        pMatch->eState = CSS_MATCH_VALID;
+    }
+}
+
+/*
+ * The number of threads used to match stylesheet rules against the
+ * elements of a document when the whole document is restyled. This is
+ * set by the --with-style-threads option to the configure script. If it
+ * is greater than 1 (and Tcl is built with thread support), the rules 
+ * that match each element are found by a pool of threads before the 
+ * tree is walked to calculate computed values (see HtmlCssMatchBatchNew()).
+ *
+ * The resource tracking in restrack.c is not thread-safe, so the 
+ * parallel match phase is disabled in HTML_DEBUG builds.
+ */
+#ifndef TKHTML_STYLE_THREADS
+# define TKHTML_STYLE_THREADS 1
+#endif
+#if defined(TCL_THREADS) && !defined(HTML_DEBUG) && TKHTML_STYLE_THREADS > 1
+# define CSS_MATCH_THREADS TKHTML_STYLE_THREADS
+#else
+# define CSS_MATCH_THREADS 1
+#endif
+
+/*
+ * A CssMatchBatch holds the results of the parallel match phase. Array
+ * aResult[] contains an entry for each element in the document, in the
+ * order in which they are styled by HtmlStyleApply(). The threads claim
+ * chunks of CSS_MATCH_BATCH_CHUNK consecutive entries at a time. Since
+ * the entries are in document order, the ancestors of each element in a
+ * chunk are either ancestors of the first element of the chunk or earlier
+ * elements of the same chunk, so each thread maintains its own ancestor 
+ * filter as it works through a chunk.
+ *
+ * While the tree is styled, HtmlCssStyleSheetApply() consumes the entries
+ * in order (entries for elements that share computed values with a 
+ * sibling or cousin are skipped) and uses the matching rules in the same
+ * way as those found in the matched-rule cache. The selectors are only
+ * tested by the threads, so nothing in the widget is modified during 
+ * the parallel phase.
+ *
+ * Documents with fewer than CSS_MATCH_BATCH_MIN elements are styled
+ * without a parallel match phase.
+ */
+#define CSS_MATCH_BATCH_CHUNK 64
+#define CSS_MATCH_BATCH_MIN 1000
+
+typedef struct CssMatchResult CssMatchResult;
+struct CssMatchResult {
+    HtmlNode *pNode;           /* Element matched */
+    int mPositional;           /* Positional dependencies of tested rules */
+    int nRule;                 /* Size of apRule[] */
+    int nDynamic;              /* Size of apDynamic[] */
+    CssRule **apRule;          /* Matching rules, in priority order */
+    CssSelector **apDynamic;   /* Dynamic selectors for HtmlCssAddDynamic() */
+};
+
+struct CssMatchBatch {
+    CssStyleSheet *pStyle;     /* Stylesheet to match */
+    int nResult;               /* Size of aResult[] */
+    CssMatchResult *aResult;   /* One entry for each element */
+    int iNext;                 /* Next entry for HtmlCssStyleSheetApply() */
+    int iChunk;                /* First entry of next unclaimed chunk */
+};
+
+#if CSS_MATCH_THREADS > 1
+
+TCL_DECLARE_MUTEX(cssMatchBatchMutex)
+
+/*
+ * Append the elements in the sub-tree rooted at pNode to the aResult[]
+ * array of batch p, in document order. If p->aResult is NULL, just 
+ * count them.
+ */
+static void
+matchBatchCollect (CssMatchBatch *p, HtmlNode *pNode)
 {
-    int i;
-    assert(pSet);
-
-    for (i = pSet->n - 1; i >= 0; i--) {
-        int eProp = pSet->a[i].eProp;
-	/* eProp may be greater than MAX_PROPERTY if it stores a composite
-	 * property that Tkhtml doesn't handle. In this case just ignore it.
-         */
-	if (eProp <= CSS_PROPERTY_MAX_PROPERTY && 0 == aPropDone[eProp]) {
-            if (0 == HtmlComputedValuesSet(p, eProp, pSet->a[i].pProp)) {
-                aPropDone[eProp] = 1;
-            }
-        }
+    int ii;
+    if (HtmlNodeIsText(pNode)) return;
+    if (p->aResult) {
+        p->aResult[p->nResult].pNode = pNode;
+    }
+    p->nResult++;
+    for (ii = 0; ii < HtmlNodeNumChildren(pNode); ii++) {
+        matchBatchCollect(p, HtmlNodeChild(pNode, ii));
     }
 }
 
 /*
  *---------------------------------------------------------------------------
  *
- * ruleToPropertyValues --
+ * matchBatchElement --
+ *
+ *     Test the rules of stylesheet pStyle against the element 
+ *     pResult->pNode and store the matching rules and dynamic selectors
+ *     in pResult. This is the same as the rule matching done by 
+ *     HtmlCssStyleSheetApply(). Filter pFilter must contain the ancestors
+ *     of the element.
+ *
+ *     This function may be called by any thread.
  *
  * Results:
  *     None.
  *
  * Side effects:
- *     None.
+ *     Populates *pResult.
  *
  *---------------------------------------------------------------------------
  */
-static void 
-ruleToPropertyValues (HtmlComputedValuesCreator *p, int *aPropDone, CssRule *pRule)
+static void
+matchBatchElement (
+    CssStyleSheet *pStyle,
+    CssAncestorFilter *pFilter,
+    CssMatchResult *pResult
+)
 {
-    propertySetToPropertyValues(p, aPropDone, pRule->pPropertySet);
+    HtmlNode *pNode = pResult->pNode;
+    HtmlElementNode *pElem = HtmlNodeAsElement(pNode);
+
+    RuleCursor aCursorStatic[16];
+    RuleCursor *aCursor = aCursorStatic;
+    int nCursor;
+
+    CssRule *apMatchStatic[32];
+    CssSelector *apDynamicStatic[8];
+    CssRule **apMatch = apMatchStatic;
+    CssSelector **apDynamic = apDynamicStatic;
+    int nMatchAlloc = sizeof(apMatchStatic) / sizeof(CssRule *);
+    int nDynamicAlloc = sizeof(apDynamicStatic) / sizeof(CssSelector *);
+    int nMatch = 0;
+    int nDynamic = 0;
+    int mPositional = 0;
+
+    CssRule *pRule;
+    int nByte;
+
+    if (pElem->nClass + 3 > (int)(sizeof(aCursorStatic) / sizeof(RuleCursor))) {
+        nByte = (pElem->nClass + 3) * sizeof(RuleCursor);
+        aCursor = (RuleCursor *)HtmlAlloc("matchBatchElement", nByte);
+    }
+    nCursor = cursorInit(pStyle, pNode, aCursor);
+
+    for (
+        pRule = nextRule(aCursor, &nCursor); 
+        pRule; 
+        pRule = nextRule(aCursor, &nCursor)
+    ) {
+        CssSelector *pSelector = pRule->pSelector;
+        int isReject = ancestorFilterReject(pFilter, pNode, pRule);
+
+        if (pRule->mPositional && selectorSubjectTest(pSelector, pNode)) {
+            mPositional |= pRule->mPositional;
+        }
+
+        if (!isReject && HtmlCssSelectorTest(pSelector, pNode, 0)) {
+            if (nMatch == nMatchAlloc) {
+                nMatchAlloc *= 2;
+                nByte = nMatchAlloc * sizeof(CssRule *);
+                if (apMatch == apMatchStatic) {
+                    apMatch = (CssRule **)HtmlAlloc("matchBatchElement", nByte);
+                    memcpy(apMatch, apMatchStatic, sizeof(apMatchStatic));
+                } else {
+                    apMatch = (CssRule **)HtmlRealloc(
+                        "matchBatchElement", apMatch, nByte
+                    );
+                }
+            }
+            apMatch[nMatch++] = pRule;
+        }
+
+        if (pSelector->isDynamic && 
+            !isReject && HtmlCssSelectorTest(pSelector, pNode, 1)
+        ) {
+            if (nDynamic == nDynamicAlloc) {
+                nDynamicAlloc *= 2;
+                nByte = nDynamicAlloc * sizeof(CssSelector *);
+                if (apDynamic == apDynamicStatic) {
+                    apDynamic = (CssSelector **)HtmlAlloc(
+                        "matchBatchElement", nByte
+                    );
+                    memcpy(apDynamic, apDynamicStatic, sizeof(apDynamicStatic));
+                } else {
+                    apDynamic = (CssSelector **)HtmlRealloc(
+                        "matchBatchElement", apDynamic, nByte
+                    );
+                }
+            }
+            apDynamic[nDynamic++] = pSelector;
+        }
+    }
+
+    nByte = (nMatch + nDynamic) * sizeof(void *);
+    if (nByte > 0) {
+        pResult->apRule = (CssRule **)HtmlAlloc("CssMatchResult", nByte);
+        pResult->apDynamic = (CssSelector **)&pResult->apRule[nMatch];
+        memcpy(pResult->apRule, apMatch, nMatch * sizeof(CssRule *));
+        memcpy(pResult->apDynamic, apDynamic, nDynamic*sizeof(CssSelector *));
+    }
+    pResult->nRule = nMatch;
+    pResult->nDynamic = nDynamic;
+    pResult->mPositional = mPositional;
+
+    if (apMatch != apMatchStatic) HtmlFree(apMatch);
+    if (apDynamic != apDynamicStatic) HtmlFree(apDynamic);
+    if (aCursor != aCursorStatic) HtmlFree(aCursor);
 }
 
 /*
  *---------------------------------------------------------------------------
  *
- * ruleToPropertyValues --
+ * matchBatchRun --
+ *
+ *     Claim chunks of the aResult[] array of batch p and match the 
+ *     elements in them until there are no chunks left. This function is 
+ *     run by each thread in the pool, including the Tcl thread.
  *
  * Results:
  *     None.
  *
  * Side effects:
- *     None.
+ *     Populates entries of p->aResult[].
  *
  *---------------------------------------------------------------------------
  */
-static void 
-overrideToPropertyValues(
-    HtmlComputedValuesCreator *p,
-    int *aPropDone,
-    Tcl_Obj *pOverride
-    )
+static void
+matchBatchRun (CssMatchBatch *p)
 {
-    Tcl_Obj **apObj = 0;
-    int nObj = 0;
-    int ii;
-
-    if (!pOverride) return;
-    Tcl_ListObjGetElements(0, pOverride, &nObj, &apObj);
+    CssAncestorFilter *pFilter = HtmlCssAncestorFilterNew();
+    HtmlNode **apAncestor = 0;
+    int nAncestorAlloc = 0;
+
+    while (1) {
+        int iFirst;
+        int iLast;
+        int nAncestor;
+        int ii;
+        HtmlNode *pAncestor;
 
-    for (ii = 0; ii < (nObj - 1); ii += 2) { 
-        int eProp;
-        const char *zProp;
-        int nProp;
+        Tcl_MutexLock(&cssMatchBatchMutex);
+        iFirst = p->iChunk;
+        p->iChunk += CSS_MATCH_BATCH_CHUNK;
+        Tcl_MutexUnlock(&cssMatchBatchMutex);
+        if (iFirst >= p->nResult) break;
+        iLast = MIN(iFirst + CSS_MATCH_BATCH_CHUNK, p->nResult);
 
-        zProp = Tcl_GetStringFromObj(apObj[ii], &nProp);
-        eProp = HtmlCssPropertyLookup(nProp, zProp);
+        /* Load the ancestors of the first element of the chunk into 
+         * the filter, outermost first. 
+         */
+        while (pFilter->nLevel > 0) {
+            HtmlCssAncestorFilterPop(pFilter);
+        }
+        nAncestor = 0;
+        pAncestor = HtmlNodeParent(p->aResult[iFirst].pNode);
+        for ( ; pAncestor; pAncestor = HtmlNodeParent(pAncestor)) {
+            if (nAncestor == nAncestorAlloc) {
+                nAncestorAlloc = nAncestorAlloc * 2 + 16;
+                apAncestor = (HtmlNode **)HtmlRealloc("matchBatchRun",
+                    apAncestor, nAncestorAlloc * sizeof(HtmlNode *)
+                );
+            }
+            apAncestor[nAncestor++] = pAncestor;
+        }
+        for (ii = nAncestor - 1; ii >= 0; ii--) {
+            HtmlCssAncestorFilterPush(pFilter, apAncestor[ii]);
+        }
 
-	if (eProp <= CSS_PROPERTY_MAX_PROPERTY && 0 == aPropDone[eProp]) {
-            const char *zVal = Tcl_GetString(apObj[ii + 1]);
-            CssProperty *pProp = HtmlCssStringToProperty(zVal, -1);
-            if (0 == HtmlComputedValuesSet(p, eProp, pProp)) {
-                aPropDone[eProp] = 1;
+        for (ii = iFirst; ii < iLast; ii++) {
+            HtmlNode *pNode = p->aResult[ii].pNode;
+            while (pFilter->pTop != HtmlNodeParent(pNode)) {
+                HtmlCssAncestorFilterPop(pFilter);
             }
-            HtmlComputedValuesFreeProperty(p, pProp);
+            matchBatchElement(p->pStyle, pFilter, &p->aResult[ii]);
+            HtmlCssAncestorFilterPush(pFilter, pNode);
         }
     }
+
+    HtmlFree(apAncestor);
+    HtmlCssAncestorFilterFree(pFilter);
 }
 
-/*--------------------------------------------------------------------------
+static Tcl_ThreadCreateType
+matchBatchThread (ClientData clientData)
+{
+    matchBatchRun((CssMatchBatch *)clientData);
+    TCL_THREAD_CREATE_RETURN;
+}
+
+#endif /* CSS_MATCH_THREADS > 1 */
+
+/*
+ *---------------------------------------------------------------------------
  *
- * applyRule --
+ * HtmlCssMatchBatchNew --
  *
- *     Test the selector of pRule against node pNode. If there is a match,
- *     add the rules properties to the computed values being accumulated in
- *     pCreator.
+ *     Run the parallel match phase for the document of widget pTree. The
+ *     rules that match each element are found using CSS_MATCH_THREADS 
+ *     threads and stored in the returned CssMatchBatch, which should be
+ *     assigned to HtmlTree.pMatchBatch while the tree is styled.
  *
- * Results:
+ *     NULL is returned if parallel matching is not configured, or if it
+ *     is not worthwhile because the document is small or the matched-rule
+ *     cache already holds the rules for most elements.
  *
- *     The value returned is true if the selector matched, or false otherwise.
+ * Results:
+ *     Pointer to new CssMatchBatch, or NULL.
  *
  * Side effects:
+ *     None.
  *
- *--------------------------------------------------------------------------
+ *---------------------------------------------------------------------------
  */
-static int 
-applyRule (HtmlTree *pTree, HtmlNode *pNode, CssRule *pRule, int *aPropDone, char **pzIfMatch, HtmlComputedValuesCreator *pCreator)
+CssMatchBatch *
+HtmlCssMatchBatchNew (HtmlTree *pTree)
 {
-    /* Test if the selector matches the node. Variable isMatch is set to
-     * true if the selector matches, or false otherwise. 
+    CssMatchCache *pCache;
+    int isCached = 0;
+
+    if (!pTree->pRoot || !pTree->pStyle) return 0;
+
+    /* If most lookups in the matched-rule cache since the previous full
+     * restyle found a valid entry, most elements will be styled without 
+     * testing any selectors, so matching them in parallel would be wasted
+     * effort.
      */
-    CssSelector *pSelector = pRule->pSelector;
-    int isMatch = HtmlCssSelectorTest(pSelector, pNode, 0);
+    pCache = pTree->pStyle->pMatchCache;
+    if (pCache) {
+        isCached = (pCache->nHit > pCache->nMiss);
+        pCache->nHit = 0;
+        pCache->nMiss = 0;
+    }
+    if (isCached) return 0;
 
-    /* There is a match. Log some output for debugging. */
-    LOG {
-        CssPriority *pPriority = pRule->pPriority;
-        Tcl_Obj *pS = Tcl_NewObj();
-        Tcl_IncrRefCount(pS);
-        HtmlCssSelectorToString(pSelector, pS);
-        HtmlLog(pTree, "STYLEENGINE", "%s %s (%s)"
-            " from \"%s%s\"",
-            Tcl_GetString(HtmlNodeCommand(pTree, pNode)),
-            (isMatch ? "matches" : "nomatch"),
-            Tcl_GetString(pS),
-            pPriority->origin == CSS_ORIGIN_AUTHOR ? "author" :
-            pPriority->origin == CSS_ORIGIN_AGENT ? "agent" : "user",
-            Tcl_GetString(pPriority->pIdTail)
+#if CSS_MATCH_THREADS > 1
+    {
+        CssMatchBatch *p;
+        Tcl_ThreadId aThread[CSS_MATCH_THREADS - 1];
+        int nThread = 0;
+        int ii;
+
+        p = HtmlNew(CssMatchBatch);
+        p->pStyle = pTree->pStyle;
+        matchBatchCollect(p, pTree->pRoot);
+        if (p->nResult < CSS_MATCH_BATCH_MIN) {
+            HtmlFree(p);
+            return 0;
+        }
+        p->aResult = (CssMatchResult *)HtmlClearAlloc(
+            "CssMatchBatch.aResult", p->nResult * sizeof(CssMatchResult)
         );
-        Tcl_DecrRefCount(pS);
-    }
-    if (isMatch) {
+        p->nResult = 0;
+        matchBatchCollect(p, pTree->pRoot);
 
-        if (pzIfMatch) {
-            HtmlComputedValuesInit(pTree, pNode, pNode, pCreator);
-            pCreator->pzContent = pzIfMatch;
+        for (ii = 0; ii < CSS_MATCH_THREADS - 1; ii++) {
+            if (TCL_OK == Tcl_CreateThread(&aThread[nThread], 
+                    matchBatchThread, (ClientData)p, 
+                    TCL_THREAD_STACK_DEFAULT, TCL_THREAD_JOINABLE)
+            ) {
+                nThread++;
+            }
         }
-  
-        /* Copy the properties from the rule into the computed values set. */
-        ruleToPropertyValues(pCreator, aPropDone, pRule);
+        matchBatchRun(p);
+        for (ii = 0; ii < nThread; ii++) {
+            int rc;
+            Tcl_JoinThread(aThread[ii], &rc);
+        }
+
+        HtmlLog(pTree, "STYLEENGINE", "matched %d elements using %d threads",
+            p->nResult, nThread + 1
+        );
+        return p;
     }
+#endif
 
-    assert(isMatch == 0 || isMatch == 1);
-    return isMatch;
+    return 0;
 }
 
-/*--------------------------------------------------------------------------
- *
- * nextRule --
- *
- * Results:
- *
- * Side effects:
- *
- *--------------------------------------------------------------------------
- */
-static CssRule *
-nextRule (CssRule **apRule, int n)
+void
+HtmlCssMatchBatchFree (CssMatchBatch *p)
 {
-    CssRule **ppRule = 0;
-    CssRule *pRet = 0;
-    int i;
-
-    for (i = 0; i < n; i++) {
-        if (apRule[i] && (ppRule == 0 || ruleCompare(apRule[i], *ppRule) > 0)) {
-            ppRule = &apRule[i];
+    if (p) {
+        int ii;
+        for (ii = 0; ii < p->nResult; ii++) {
+            HtmlFree(p->aResult[ii].apRule);
         }
+        HtmlFree(p->aResult);
+        HtmlFree(p);
     }
+}
 
-    if (ppRule) {
-        pRet = *ppRule;
-        *ppRule = (*ppRule)->pNext;
+/*
+ * Return the result of the parallel match phase for element pNode, or 
+ * NULL if there is none.
+ */
+static CssMatchResult *
+matchBatchFind (HtmlTree *pTree, HtmlNode *pNode)
+{
+    CssMatchBatch *p = pTree->pMatchBatch;
+    if (p) {
+        while (p->iNext < p->nResult) {
+            CssMatchResult *pResult = &p->aResult[p->iNext++];
+            if (pResult->pNode == pNode) return pResult;
+        }
     }
-
-    return pRet;
+    return 0;
 }
 
 /*--------------------------------------------------------------------------
@@ -3418,9 +6596,9 @@ nextRule (CssRule **apRule, int n)
  *     returns, the HtmlNode.pPropertyValues variable points to the
  *     structure containing the computed values applied to the node.
  *
- *     NOTE: There are two hard-coded limits in this function:
- *         1) No element may be a member of more than 126 classes.  
- *         2) No class name may be longer than 128 bytes (includes null term).
+ *     The id and class attributes of the node are not parsed here. The
+ *     values cached by the tree module in HtmlElementNode.zId and 
+ *     HtmlElementNode.azClass are used instead.
  *
  * Results:
  *
@@ -3433,11 +6611,6 @@ nextRule (CssRule **apRule, int n)
 void 
 HtmlCssStyleSheetApply (HtmlTree *pTree, HtmlNode *pNode) 
 {
-
-    /* The two hard coded constants mentioned above */
-    #define MAX_CLASSES    126
-    #define MAX_CLASS_NAME 128
-
     CssStyleSheet *pStyle = pTree->pStyle;    /* Stylesheet config */
     CssRule *pRule;                           /* Iterator variable */
 
@@ -3453,60 +6626,137 @@ HtmlCssStyleSheetApply (HtmlTree *pTree, HtmlNode *pNode)
      */
     int aPropDone[CSS_PROPERTY_MAX_PROPERTY + 1];
 
-    Tcl_HashEntry *pEntry;
-    char const *zClassAttr;            /* Value of node "class" attribute */
-    char const *zIdAttr;               /* Value of node "id" attribute */
-
-    CssRule *apRule[MAX_CLASSES + 2];  /* Array of applicable rules lists. */
-    int npRule;
+    /* Heap of applicable rules lists. One for the universal rules, one
+     * for the tag, one for the id and one for each class. Unless the 
+     * node belongs to an unusually large number of classes the static 
+     * array is used.
+     */
+    RuleCursor aCursorStatic[16];
+    RuleCursor *aCursor = aCursorStatic;
+    int nCursor = 0;
+    int ii;
 
     int nSelectorMatch = 0;
     int nSelectorTest = 0;
 
+    /* Set to false if the computed values may not be shared */
+    int isShareable;
+    int mPositional = 0;
+    HtmlNode *pShared;
+
+    /* Matched-rule cache entry for this node, if any. If the entry is 
+     * empty, the rules and dynamic selectors that match are accumulated
+     * in apMatch and apDynamic so that the entry can be populated.
+     */
+    CssMatchEntry *pMatch;
+
+    /* Result of the parallel match phase for this node, if any, and the
+     * source of the rules applied without testing selectors (for logging).
+     */
+    CssMatchResult *pResult;
+    const char *zReplay = 0;
+    CssRule **apMatch = 0;
+    CssSelector **apDynamic = 0;
+    int nMatch = 0;
+    int nDynamic = 0;
+
     HtmlElementNode *pElem = HtmlNodeAsElement(pNode);
     assert(pElem);
 
-    /* The universal rules list applies to all nodes */
-    apRule[0] = pStyle->pUniversalRules;
-    npRule = 1;
-
-    /* Find the applicable "by-tag" rules list, if any. */
-    pEntry = Tcl_FindHashEntry(&pStyle->aByTag, pNode->zTag);
-    if (pEntry) {
-        apRule[npRule++] = Tcl_GetHashValue(pEntry);
+    /* If a similar element has just been styled, use its computed values */
+    pTree->styleStats.nStyled++;
+    pShared = styleShareFind(pTree, pNode);
+    if (pShared) {
+        pElem->pPropertyValues = HtmlNodeComputedValues(pShared);
+        HtmlComputedValuesReference(pElem->pPropertyValues);
+        pTree->styleStats.nShared++;
+        LOG {
+            HtmlLog(pTree, "STYLEENGINE", "%s shares style with %s",
+                Tcl_GetString(HtmlNodeCommand(pTree, pNode)),
+                Tcl_GetString(HtmlNodeCommand(pTree, pShared))
+            );
+        }
+        return;
     }
+    isShareable = (
+        pTree->pStyleShare && !pElem->pStyle && !HtmlElemRare(pElem, pOverride)
+    );
 
-    /* Find a rules list for the element id, if any */
-    zIdAttr = HtmlNodeAttr(pNode, "id");
-    if (zIdAttr) {
-        pEntry = Tcl_FindHashEntry(&pStyle->aById, zIdAttr);
-        if (pEntry) {
-            apRule[npRule++] = (CssRule *)Tcl_GetHashValue(pEntry);
+    /* If an element with the same match signature has already been
+     * styled, or if the matching rules were found by the parallel match
+     * phase, apply the rules without testing any selectors.
+     */
+    pMatch = matchCacheFind(pTree, pNode);
+    pResult = matchBatchFind(pTree, pNode);
+    if (pMatch) {
+        if (pMatch->eState == CSS_MATCH_VALID) {
+            pStyle->pMatchCache->nHit++;
+        } else {
+            pStyle->pMatchCache->nMiss++;
         }
     }
-
-    /* Find a rules list for each class the element belongs to */
-    zClassAttr = HtmlNodeAttr(pNode, "class");
-    if (zClassAttr) {
-        int nClass;
-        char const *zClass = zClassAttr;
-        char zTerm[MAX_CLASS_NAME];
-
-        while (
-            npRule < (MAX_CLASSES + 2) &&
-            (zClass = HtmlCssGetNextListItem(zClass, strlen(zClass), &nClass))
-        ) {
-            strncpy(zTerm, zClass, MIN(MAX_CLASS_NAME, nClass));
-            zTerm[MIN(MAX_CLASS_NAME - 1, nClass)] = '\0';
-            zClass += nClass;
-
-            pEntry = Tcl_FindHashEntry(&pStyle->aByClass, zTerm);
-            if (pEntry) {
-                apRule[npRule++] = (CssRule *)Tcl_GetHashValue(pEntry);
+    if (pMatch && pMatch->eState == CSS_MATCH_VALID) {
+        apMatch = pMatch->apRule;
+        apDynamic = pMatch->apDynamic;
+        nMatch = pMatch->nRule;
+        nDynamic = pMatch->nDynamic;
+        zReplay = "cache";
+        pTree->styleStats.nCached++;
+    } else if (pResult) {
+        apMatch = pResult->apRule;
+        apDynamic = pResult->apDynamic;
+        nMatch = pResult->nRule;
+        nDynamic = pResult->nDynamic;
+        mPositional = pResult->mPositional;
+        if (pMatch && pMatch->eState == CSS_MATCH_EMPTY) {
+            matchCacheStore(pMatch, mPositional, 
+                apMatch, nMatch, apDynamic, nDynamic
+            );
+        }
+        zReplay = "parallel match phase";
+        pTree->styleStats.nBatched++;
+    }
+    if (zReplay) {
+        HtmlComputedValuesInit(pTree, pNode, 0, &sCreator);
+        memset(aPropDone, 0, sizeof(aPropDone));
+        overrideToPropertyValues(
+            &sCreator, aPropDone, HtmlElemRare(pElem, pOverride)
+        );
+        for (ii = 0; ii < nMatch; ii++) {
+            pRule = apMatch[ii];
+            if (!isStyleDone && !pRule->pPriority->important) {
+                isStyleDone = 1;
+                if (pElem->pStyle) {
+                    propertySetToPropertyValues(
+                        &sCreator, aPropDone, pElem->pStyle
+                    );
+                }
             }
+            ruleToPropertyValues(&sCreator, aPropDone, pRule);
+        }
+        if (!isStyleDone && pElem->pStyle) {
+            propertySetToPropertyValues(&sCreator, aPropDone, pElem->pStyle);
+        }
+        for (ii = 0; ii < nDynamic; ii++) {
+            HtmlCssAddDynamic(pElem, apDynamic[ii], 0);
         }
+        LOG {
+            HtmlLog(pTree, "STYLEENGINE", "%s matched %d rules from %s",
+                Tcl_GetString(HtmlNodeCommand(pTree, pNode)), nMatch, zReplay
+            );
+        }
+        goto apply_finish;
+    }
+    if (pMatch && pMatch->eState != CSS_MATCH_EMPTY) {
+        pMatch = 0;
     }
-    
+
+    if (pElem->nClass + 3 > (int)(sizeof(aCursorStatic) / sizeof(RuleCursor))) {
+        int nByte = (pElem->nClass + 3) * sizeof(RuleCursor);
+        aCursor = (RuleCursor *)HtmlAlloc("HtmlCssStyleSheetApply", nByte);
+    }
+
+    nCursor = cursorInit(pStyle, pNode, aCursor);
 
     /* Initialise aPropDone and sCreator */
     HtmlComputedValuesInit(pTree, pNode, 0, &sCreator);
@@ -3514,24 +6764,29 @@ HtmlCssStyleSheetApply (HtmlTree *pTree, HtmlNode *pNode)
     assert(sizeof(aPropDone) == sizeof(int) * (CSS_PROPERTY_MAX_PROPERTY+1));
 
     /* Before considering the stylesheet configure or any style attribute,
-     * parse the properties from the override list in HtmlNode.pOverride.
+     * parse the properties from the override list in HtmlElementRare.pOverride.
      * These properties were set directly by the script and have a higher
      * priority than anything else.
      */
-    overrideToPropertyValues(&sCreator, aPropDone, pElem->pOverride);
+    overrideToPropertyValues(&sCreator, aPropDone, HtmlElemRare(pElem,pOverride));
 
     /* Loop through the list of CSS rules in the stylesheet. Rules that occur
      * earlier in the list have a higher priority than those that occur later.
      */
     for (
-        pRule = nextRule(apRule, npRule); 
+        pRule = nextRule(aCursor, &nCursor); 
         pRule; 
-        pRule = nextRule(apRule, npRule)
+        pRule = nextRule(aCursor, &nCursor)
     ) {
         CssPriority *pPriority = pRule->pPriority;
         CssSelector *pSelector = pRule->pSelector;
 
         nSelectorTest++;
+        if ((isShareable || pMatch) && pRule->mPositional && 
+            selectorSubjectTest(pRule->pSelector, pNode)
+        ) {
+            mPositional |= pRule->mPositional;
+        }
 
         /* The contents of the "style" attribute, if one exists, are handled
          * after the important rules but before anything else. This is because:
@@ -3550,14 +6805,34 @@ HtmlCssStyleSheetApply (HtmlTree *pTree, HtmlNode *pNode)
         }
 
         /* If the selector is a match for our node, apply the rule properties */
-        nSelectorMatch += 
-                applyRule(pTree, pNode, pRule, aPropDone, (char **)0, &sCreator);
+        if (applyRule(pTree, pNode, pRule, aPropDone, (char **)0, &sCreator)) {
+            nSelectorMatch++;
+            if (pMatch) {
+                if ((nMatch % 16) == 0) {
+                    int nByte = (nMatch + 16) * sizeof(CssRule *);
+                    apMatch = (CssRule **)HtmlRealloc(
+                        "HtmlCssStyleSheetApply", apMatch, nByte
+                    );
+                }
+                apMatch[nMatch++] = pRule;
+            }
+        }
 
         if (
             pSelector->isDynamic &&
+            !ancestorFilterReject(pTree->pAncestorFilter, pNode, pRule) &&
             HtmlCssSelectorTest(pSelector, pNode, 1)
         ) {
             HtmlCssAddDynamic(pElem, pSelector, 0);
+            if (pMatch) {
+                if ((nDynamic % 16) == 0) {
+                    int nByte = (nDynamic + 16) * sizeof(CssSelector *);
+                    apDynamic = (CssSelector **)HtmlRealloc(
+                        "HtmlCssStyleSheetApply", apDynamic, nByte
+                    );
+                }
+                apDynamic[nDynamic++] = pSelector;
+            }
         }
     }
 
@@ -3565,6 +6840,10 @@ HtmlCssStyleSheetApply (HtmlTree *pTree, HtmlNode *pNode)
         propertySetToPropertyValues(&sCreator, aPropDone, pElem->pStyle);
     }
 
+    if (aCursor != aCursorStatic) {
+        HtmlFree(aCursor);
+    }
+
     LOG {
        HtmlLog(pTree, "STYLEENGINE", "%s matched %d/%d selectors",
            Tcl_GetString(HtmlNodeCommand(pTree, pNode)),
@@ -3572,6 +6851,24 @@ HtmlCssStyleSheetApply (HtmlTree *pTree, HtmlNode *pNode)
        );
     }
 
+    /* Populate the matched-rule cache entry */
+    if (pMatch) {
+        matchCacheStore(pMatch, mPositional, 
+            apMatch, nMatch, apDynamic, nDynamic
+        );
+        if (apMatch) HtmlFree(apMatch);
+        if (apDynamic) HtmlFree(apDynamic);
+    }
+
+apply_finish:
+    if (isShareable && 
+        !(mPositional & CSS_POSITIONAL_SUBJECT) &&
+        !sCreator.isNodeDependent && 
+        !HtmlElemRare(pElem, pDynamic)
+    ) {
+        styleShareAdd(pTree, pNode, !(mPositional&CSS_POSITIONAL_ANCESTOR));
+    }
+
     /* Call HtmlComputedValuesFinish() to finish creating the
      * HtmlComputedValues structure.
      */
@@ -3598,7 +6895,7 @@ HtmlCssStyleSheetApply (HtmlTree *pTree, HtmlNode *pNode)
 static HtmlTextNode *
 generateContentText (HtmlTree *pTree, const char *zContent)
 {
-    HtmlTextNode *pTextNode = HtmlTextNew(strlen(zContent), zContent, 0, 0);
+    HtmlTextNode *pTextNode = HtmlTextNew(0, strlen(zContent), zContent, 0, 0);
     return pTextNode;
 }
 
@@ -3678,10 +6975,13 @@ HtmlCssStyleGenerateContent (HtmlTree *pTree, HtmlElementNode *pElem, int isBefo
 {
     CssStyleSheet *pStyle = pTree->pStyle;    /* Stylesheet config */
     HtmlNode *pNode = (HtmlNode *)pElem;
+    HtmlNode *pGenerated = 0;
     if (isBefore) {
-        generatedContent(pTree, pNode, pStyle->pBeforeRules, &pElem->pBefore);
+        generatedContent(pTree, pNode, pStyle->pBeforeRules, &pGenerated);
+        if (pGenerated) HtmlElemRareGet(pElem)->pBefore = pGenerated;
     } else {
-        generatedContent(pTree, pNode, pStyle->pAfterRules, &pElem->pAfter);
+        generatedContent(pTree, pNode, pStyle->pAfterRules, &pGenerated);
+        if (pGenerated) HtmlElemRareGet(pElem)->pAfter = pGenerated;
     }
 }
 
@@ -3740,6 +7040,9 @@ HtmlCssSelectorComma (CssParse *pParse)
 
     /* Do nothing if the isIgnore flag is set */
     if (pParse->isIgnore) return;
+    if (pParse->pCompile) {
+        cssCompiledRecord(pParse, CSS_OP_COMMA, 0, 0, 0);
+    }
 
     pParse->apXtraSelector = (CssSelector **)HtmlRealloc(
            "CssParse.apXtraSelector", (char *)pParse->apXtraSelector, n
@@ -3772,6 +7075,9 @@ HtmlCssImport (CssParse *pParse, CssToken *pToken)
 
     /* Do nothing if the isIgnore or isBody flags are set */
     if (pParse->isBody) return;
+    if (pParse->pCompile) {
+        cssCompiledRecord(pParse, CSS_OP_IMPORT, 0, pToken, 0);
+    }
 
     if (pEval) {
         Tcl_Interp *interp = pParse->interp;
@@ -3801,6 +7107,39 @@ HtmlCssImport (CssParse *pParse, CssToken *pToken)
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlCssSyntaxError --
+ *
+ *     The parser calls this function when it skips over a syntax error.
+ *     The error starts at byte offset iStart of the stylesheet text and
+ *     is nLength bytes in size.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     Appends the error to the error-log, if there is one.
+ *
+ *---------------------------------------------------------------------------
+ */
+void 
+HtmlCssSyntaxError (CssParse *pParse, int iStart, int nLength)
+{
+    if (pParse->pCompile) {
+        CssToken t;
+        t.z = &pParse->pCompile->zText[iStart];
+        t.n = nLength;
+        cssCompiledRecord(pParse, CSS_OP_ERROR, 0, &t, 0);
+    }
+    if (pParse->pErrorLog) {
+        Tcl_Obj *pError = pParse->pErrorLog;
+        Tcl_ListObjAppendElement(0, pError, Tcl_NewIntObj(iStart));
+        Tcl_ListObjAppendElement(0, pError, Tcl_NewIntObj(nLength));
+    }
+}
+
 /*
  *---------------------------------------------------------------------------
  *
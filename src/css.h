@@ -64,6 +64,9 @@
 typedef struct CssStyleSheet CssStyleSheet;
 typedef struct CssProperty CssProperty;
 typedef struct CssDynamic CssDynamic;
+typedef struct CssAncestorFilter CssAncestorFilter;
+typedef struct CssStyleShare CssStyleShare;
+typedef struct CssMatchBatch CssMatchBatch;
 
 typedef struct CssPropertySet CssPropertySet;
 
@@ -106,9 +109,15 @@ typedef struct CssPropertySet CssPropertySet;
  * struct. The actual value is stored in one of the primitives inside
  * the union. The eType field is set to one of the CSS_TYPE_* constants
  * below. 
+ *
+ * Property values parsed from stylesheets and style attributes are 
+ * interned (see propertySetIntern() in css.c) and shared by all property 
+ * sets with the same value. Interned properties (nRef>0) must not be 
+ * modified.
  */
 struct CssProperty {
     int eType;
+    int nRef;          /* Number of references, or 0 if not interned */
     union {
         char *zVal;
         double rVal;
@@ -167,6 +176,54 @@ void HtmlCssStyleSheetApply(HtmlTree *, HtmlNode *);
 void HtmlCssStyleSheetGenerated(HtmlTree *, HtmlElementNode *);
 void HtmlCssStyleGenerateContent(HtmlTree *, HtmlElementNode *, int);
 
+/*
+ * Functions to maintain the filter of ancestor tags, ids and classes used
+ * to quickly reject selectors while the tree is being styled. Between
+ * calls to HtmlCssAncestorFilterPush() and HtmlCssAncestorFilterPop() for
+ * a node, HtmlTree.pAncestorFilter may be used to style its children.
+ */
+CssAncestorFilter *HtmlCssAncestorFilterNew(void);
+void HtmlCssAncestorFilterFree(CssAncestorFilter *);
+void HtmlCssAncestorFilterPush(CssAncestorFilter *, HtmlNode *);
+void HtmlCssAncestorFilterPop(CssAncestorFilter *);
+
+/*
+ * While HtmlTree.pStyleShare is set, HtmlCssStyleSheetApply() remembers
+ * recently styled elements and copies their computed values to similar
+ * sibling and cousin elements instead of matching the stylesheet rules.
+ */
+CssStyleShare *HtmlCssStyleShareNew(void);
+void HtmlCssStyleShareFree(CssStyleShare *);
+
+/*
+ * When the whole document is restyled, HtmlCssMatchBatchNew() may find
+ * the rules that match each element using a pool of threads. While 
+ * HtmlTree.pMatchBatch is set, HtmlCssStyleSheetApply() uses these 
+ * results instead of testing selectors.
+ */
+CssMatchBatch *HtmlCssMatchBatchNew(HtmlTree *);
+void HtmlCssMatchBatchFree(CssMatchBatch *);
+
+/*
+ * Return true if modifying the named attribute of an element may change
+ * the computed style of any element (see setNodeAttribute()).
+ */
+int HtmlCssAttrIsSignificant(HtmlTree *, HtmlNode *, const char *);
+
+/*
+ * When rules are appended to the stylesheet of a styled document, the
+ * tag, class and id keys of the elements they may match are recorded.
+ * HtmlCssInvalidationIsPartial() returns true if only elements matching 
+ * those keys (and their descendants) need to be restyled. 
+ * HtmlCssInvalidationBegin() sets the keys aside at the start of a style
+ * pass, HtmlCssInvalidationTest() tests a node against them, and 
+ * HtmlCssInvalidationClear() discards them once the document is restyled.
+ */
+int HtmlCssInvalidationIsPartial(HtmlTree *);
+void HtmlCssInvalidationBegin(HtmlTree *);
+int HtmlCssInvalidationTest(HtmlTree *, HtmlNode *);
+void HtmlCssInvalidationClear(HtmlTree *);
+
 /*
  * Functions to interface with inline style information (in HTML, 
  * the "style" attribute).
@@ -180,6 +237,7 @@ int HtmlCssInlineQuery(Tcl_Interp *, CssPropertySet *, Tcl_Obj *);
 */
 
 Tcl_ObjCmdProc HtmlCssStyleReport;
+Tcl_ObjCmdProc HtmlCssStyleCacheCmd;
 
 void HtmlCssCheckDynamic(HtmlTree *);
 void HtmlCssFreeDynamics(HtmlElementNode *);
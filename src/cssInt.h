@@ -48,6 +48,14 @@ typedef struct CssParse CssParse;
 typedef struct CssToken CssToken;
 typedef struct CssPriority CssPriority;
 typedef struct CssProperties CssProperties;
+typedef struct CssCompiled CssCompiled;
+typedef struct CssCompiledOp CssCompiledOp;
+typedef struct CssRuleSet CssRuleSet;
+typedef struct CssRuleSetItem CssRuleSetItem;
+typedef struct CssMatchCache CssMatchCache;
+typedef struct CssMatchEntry CssMatchEntry;
+typedef struct CssInvalidation CssInvalidation;
+typedef struct CssAttrIndex CssAttrIndex;
 
 typedef unsigned char u8;
 typedef unsigned int u32;
@@ -138,7 +146,9 @@ struct CssSelector {
 };
 
 /*
-** A collection of CSS2 properties and values.
+** A collection of CSS2 properties and values. A set parsed from a style
+** attribute may be shared by all elements with the same attribute value
+** (see HtmlCssInlineParse()), in which case nRef and pEntry are set.
 */
 struct CssPropertySet {
     int n;
@@ -146,6 +156,8 @@ struct CssPropertySet {
         int eProp;
         CssProperty *pProp;
     } *a;
+    int nRef;                  /* References to a shared inline style set */
+    Tcl_HashEntry *pEntry;     /* Entry in table of inline style sets */
 };
 
 struct CssProperties {
@@ -153,6 +165,9 @@ struct CssProperties {
     CssRule **apRule;
 };
 
+#define CSS_RULE_ANCESTOR_HASHES 4
+#define CSS_POSITIONAL_SUBJECT  0x01   /* Depends on position of node */
+#define CSS_POSITIONAL_ANCESTOR 0x02   /* Depends on position of ancestor */
 struct CssRule {
     CssPriority *pPriority;  /* Pointer to the priority of source stylesheet */
     int specificity;         /* Specificity of the selector */
@@ -162,6 +177,19 @@ struct CssRule {
     int freeSelector;              /* True to delete pSelector */
     CssPropertySet *pPropertySet;  /* Property values for the rule. */
     CssRule *pNext;                /* Next rule in this list. */
+
+    /* Mask of CSS_POSITIONAL_XXX flags. Set if the selector uses 
+     * :first-child, :last-child or the adjacent sibling combinator, which
+     * limit style sharing between similar elements (see 
+     * HtmlCssStyleSheetApply()).
+     */
+    int mPositional;
+
+    /* Hashes of type, class and id selectors that must match an ancestor
+     * of the node for the selector to match. Zero terminated unless all
+     * CSS_RULE_ANCESTOR_HASHES entries are used. See CssAncestorFilter.
+     */
+    unsigned int aAncestorHash[CSS_RULE_ANCESTOR_HASHES];
 };
 
 /*
@@ -190,6 +218,7 @@ struct CssPriority {
     int origin;              /* One of CSS_ORIGIN_AGENT, _AUTHOR or _USER */ 
     Tcl_Obj *pIdTail;        /* Tail of the stylesheet id */
     int iPriority;
+    int iIdRank;             /* Rank of pIdTail among all list entries */
     CssPriority *pNext;      /* Linked list pointer */
 };
 
@@ -215,6 +244,157 @@ struct CssStyleSheet {
     Tcl_HashTable aByTag;      /* Rule lists by tag (string keys) */
     Tcl_HashTable aByClass;    /* Rule lists by class (string keys) */
     Tcl_HashTable aById;       /* Rule lists by id (string keys) */
+
+    int nRuleSet;              /* Size of apRuleSet array */
+    CssRuleSet **apRuleSet;    /* Shared rule sets used by this stylesheet */
+
+    CssMatchCache *pMatchCache;  /* Matched-rule cache, or NULL */
+    int iMatchSignature;         /* Last signature id allocated */
+    CssAttrIndex *pAttrIndex;    /* Attributes referenced, or NULL */
+
+    CssInvalidation *pInvalid;   /* Keys of rules added, or NULL */
+    CssInvalidation *pInvalidApply;   /* Keys being applied, or NULL */
+
+    /* True if a dynamic selector uses the adjacent sibling combinator */
+    int isDynamicAdjacent;
+};
+
+/*
+ * The keys of the rules appended to a stylesheet since the document was 
+ * last styled. Each rule contributes the id, class or tag name from the 
+ * compound selector for the element it matches (the rightmost). If a rule 
+ * has no such key, isAll is set and the whole document must be restyled.
+ */
+struct CssInvalidation {
+    int isAll;                 /* True if all elements must be restyled */
+    Tcl_HashTable aTag;        /* Tag names (string keys) */
+    Tcl_HashTable aClass;      /* Class names (string keys) */
+    Tcl_HashTable aId;         /* Id values (string keys) */
+};
+
+/*
+ * The attribute names referenced by the rules of a stylesheet, either in
+ * attribute selectors or attr() property values. Built when first 
+ * required and discarded whenever rules are added. If a rule uses a tcl()
+ * property value, which may read any attribute, the tag of the element it
+ * applies to is stored in aTclTag (or isAll is set if there is no tag).
+ * See HtmlCssAttrIsSignificant().
+ */
+struct CssAttrIndex {
+    int isAll;                 /* True if any attribute may be referenced */
+    Tcl_HashTable aAttr;       /* Atoms for attribute names referenced */
+    Tcl_HashTable aTclTag;     /* Tags of elements with tcl() values */
+};
+
+/*
+ * The matched-rule cache. HtmlCssStyleSheetApply() stores the ordered
+ * list of rules that match an element in the CssMatchEntry for the 
+ * element's "match signature", so that elements with the same signature,
+ * and the same element when it is restyled, can skip rule matching.
+ *
+ * A signature is made up of the tag name and dynamic flags of the 
+ * element, the values of its id and class attributes and of any other 
+ * attributes referenced by the stylesheet (see CssAttrIndex), and the
+ * signature of its parent. Two elements with the same signature are matched by the
+ * same rules, unless a rule depends on the position of the element or 
+ * of an ancestor among its siblings. Entries for which this is the case
+ * are marked as not cacheable.
+ *
+ * Each entry has a unique integer id (CssMatchEntry.iSignature), which 
+ * is used in place of the parent's signature when creating the key for a
+ * child. The cache is emptied whenever a stylesheet is added.
+ */
+struct CssMatchCache {
+    Tcl_HashTable aEntry;      /* Map from signature key to CssMatchEntry */
+    int nEntry;                /* Number of entries in aEntry */
+    int nHit;                  /* Lookups that found a valid entry */
+    int nMiss;                 /* Lookups that did not */
+};
+
+#define CSS_MATCH_EMPTY       0    /* Rules not yet stored */
+#define CSS_MATCH_VALID       1    /* apRule and apDynamic are valid */
+#define CSS_MATCH_UNCACHEABLE 2    /* Match depends on element position */
+
+struct CssMatchEntry {
+    int iSignature;            /* Unique id for this signature */
+    int eState;                /* One of the CSS_MATCH_XXX values */
+    int nRule;                 /* Size of apRule[] */
+    int nDynamic;              /* Size of apDynamic[] */
+    CssRule **apRule;          /* Matching rules, in priority order */
+    CssSelector **apDynamic;   /* Dynamic selectors for HtmlCssAddDynamic() */
+};
+
+/*
+ * The selectors and property sets parsed from a single stylesheet 
+ * document are stored in a CssRuleSet. Rule sets are shared, read-only,
+ * by all widgets in an interpreter that load the same document text with
+ * the same origin, quirks-mode and -urlcmd script (the things that 
+ * influence the values parsed). 
+ *
+ * Each widget still allocates its own CssRule structures, which hold the
+ * priority and ordering information and link the rules into the 
+ * CssStyleSheet lists. The CssRule.freeSelector and freePropertySets
+ * flags of these rules are clear - the selectors and property sets are
+ * owned by the CssRuleSet. A CssStyleSheet holds a reference to each
+ * rule set it uses in CssStyleSheet.apRuleSet.
+ */
+struct CssRuleSetItem {
+    CssSelector *pSelector;
+    CssPropertySet *pPropertySet;
+    int isImportant;           /* True for an "!important" property set */
+    int specificity;           /* Value for CssRule.specificity */
+    int iRule;                 /* Value for CssRule.iRule */
+    int freeWhat;              /* Mask of FREE_SELECTOR, FREE_PROPERTYSET */
+};
+
+struct CssRuleSet {
+    int nRef;                  /* Number of CssStyleSheet objects using this */
+    int isAgent;               /* True to keep in table when nRef is 0 */
+    Tcl_HashEntry *pEntry;     /* Entry in per-interp table, or NULL */
+    CssCompiled *pCompiled;    /* Compiled document (holds a reference) */
+    int nItem;                 /* Number of valid entries in aItem */
+    int nItemAlloc;            /* Allocated size of aItem */
+    CssRuleSetItem *aItem;
+};
+
+/*
+ * A stylesheet document is "compiled" by recording the sequence of
+ * callbacks the parser makes into css.c (HtmlCssSelector(),
+ * HtmlCssDeclaration() etc.) while it parses the text. Each callback is
+ * stored as a CssCompiledOp. Token arguments are stored as byte offsets
+ * into the stylesheet text, or -1 for a NULL token. Replaying the program
+ * against a new CssParse produces exactly the same rules as running the
+ * parser again, but without the cost of tokenizing the document. See the
+ * "Compiled stylesheet cache" comment in css.c.
+ */
+#define CSS_OP_SELECTOR     1      /* HtmlCssSelector(eArg, t1, t2) */
+#define CSS_OP_COMMA        2      /* HtmlCssSelectorComma() */
+#define CSS_OP_DECLARATION  3      /* HtmlCssDeclaration(t1, t2, eArg) */
+#define CSS_OP_RULE         4      /* HtmlCssRule(eArg) */
+#define CSS_OP_IMPORT       5      /* HtmlCssImport(t1) */
+#define CSS_OP_ERROR        6      /* Syntax error at t1 */
+
+struct CssCompiledOp {
+    int eOp;                        /* One of the CSS_OP_XXX values */
+    int eArg;                       /* Selector type, isImportant or success */
+    int i1, n1;                     /* First token (offset and length) */
+    int i2, n2;                     /* Second token (offset and length) */
+};
+
+struct CssCompiled {
+    const char *zText;              /* Stylesheet text */
+    int nText;                      /* Size of zText in bytes */
+    int nOp;                        /* Number of valid entries in aOp */
+    int nOpAlloc;                   /* Allocated size of aOp */
+    CssCompiledOp *aOp;             /* Program */
+
+    unsigned int iHash;             /* Hash of zText */
+    CssCompiled *pHashNext;         /* Next sheet with the same iHash */
+    int isAgent;                    /* True if ever used as agent sheet */
+    int nRef;                       /* Number of replays in progress */
+    int isEvicted;                  /* True once removed from the cache */
+    CssCompiled *pPrev;             /* LRU list (most recently used first) */
+    CssCompiled *pNext;
 };
 
 /*
@@ -253,6 +433,8 @@ struct CssParse {
     Tcl_Obj *pErrorLog;             /* In non-zero, store syntax errors here */
     Tcl_Interp *interp;             /* Interpreter to invoke pImportCmd */
     HtmlTree *pTree;                /* Tree used to determine if quirks mode */
+    CssCompiled *pCompile;          /* If not NULL, record callbacks here */
+    CssRuleSet *pRuleSet;           /* If not NULL, collect new rules here */
 };
 
 /*
@@ -264,6 +446,7 @@ void HtmlCssSelector(CssParse *, int, CssToken *, CssToken *);
 void HtmlCssRule(CssParse *, int);
 void HtmlCssSelectorComma(CssParse *pParse);
 void HtmlCssImport(CssParse *pParse, CssToken *);
+void HtmlCssSyntaxError(CssParse *pParse, int, int);
 
 /* Test if a selector matches a node */
 int HtmlCssSelectorTest(CssSelector *, HtmlNode *, int);
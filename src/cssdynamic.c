@@ -26,28 +26,32 @@ void
 HtmlCssAddDynamic (HtmlElementNode *pElem, CssSelector *pSelector, int isSet)
 {
     CssDynamic *pNew;
-    for (pNew = pElem->pDynamic; pNew ; pNew = pNew->pNext) {
+    HtmlElementRare *pRare;
+    for (pNew = HtmlElemRare(pElem, pDynamic); pNew ; pNew = pNew->pNext) {
         if (pNew->pSelector == pSelector) return;
     }
     pNew = 0;
 
+    pRare = HtmlElemRareGet(pElem);
     pNew = HtmlNew(CssDynamic);
     pNew->isSet = (isSet ? 1 : 0);
     pNew->pSelector = pSelector;
-    pNew->pNext = pElem->pDynamic;
-    pElem->pDynamic = pNew;
+    pNew->pNext = pRare->pDynamic;
+    pRare->pDynamic = pNew;
 }
 
 void 
 HtmlCssFreeDynamics (HtmlElementNode *pElem)
 {
-    CssDynamic *p = pElem->pDynamic;
+    CssDynamic *p = HtmlElemRare(pElem, pDynamic);
     while (p) {
         CssDynamic *pTmp = p;
         p = p->pNext;
         HtmlFree(pTmp);
     }
-    pElem->pDynamic = 0;
+    if (pElem->pRare) {
+        pElem->pRare->pDynamic = 0;
+    }
 }
 
 
@@ -57,7 +61,7 @@ checkDynamicCb(HtmlTree *pTree, HtmlNode *pNode, ClientData clientData)
     if (!HtmlNodeIsText(pNode)) {
         HtmlElementNode *pElem = (HtmlElementNode *)pNode;
         CssDynamic *p;
-        for (p = pElem->pDynamic; p; p = p->pNext) {
+        for (p = HtmlElemRare(pElem, pDynamic); p; p = p->pNext) {
             int res = HtmlCssSelectorTest(p->pSelector, pNode, 0) ? 1 : 0; 
             if (res != p->isSet) {
                 HtmlCallbackRestyle(pTree, pNode);
@@ -68,23 +72,77 @@ checkDynamicCb(HtmlTree *pTree, HtmlNode *pNode, ClientData clientData)
     return HTML_WALK_DESCEND;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlCssCheckDynamic --
+ *
+ *     Recalculate the dynamic conditions that may depend on the nodes in
+ *     the HtmlTree.cb.apDynamic list (the nodes whose dynamic flags have 
+ *     been modified) and restyle any nodes for which a condition has 
+ *     changed.
+ *
+ *     A dynamic selector only tests the node it is attached to, its 
+ *     ancestors and, if it uses the adjacent sibling combinator, the
+ *     left-siblings of these. So only the conditions attached to nodes 
+ *     in the sub-tree rooted at each modified node need be checked, plus
+ *     those in the sub-trees rooted at its right-siblings if any dynamic
+ *     selector uses the adjacent sibling combinator. Modified nodes that
+ *     are descendants of other modified nodes are skipped.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     May call HtmlCallbackRestyle(). Empties HtmlTree.cb.apDynamic.
+ *
+ *---------------------------------------------------------------------------
+ */
 void 
 HtmlCssCheckDynamic (HtmlTree *pTree)
 {
-    if (pTree->cb.pDynamic) {
-        HtmlNode *pParent = HtmlNodeParent(pTree->cb.pDynamic);
-        if (pParent) {
-            int i;
+    HtmlCallback *p = &pTree->cb;
+    int isAdjacent = (pTree->pStyle && pTree->pStyle->isDynamicAdjacent);
+    int ii;
+
+    for (ii = 0; ii < p->nDynamic; ii++) {
+        HtmlNode *pNode = p->apDynamic[ii];
+        HtmlNode *pParent = HtmlNodeParent(pNode);
+        HtmlNode *pA;
+        int jj;
+
+        /* Skip this node if it is part of a sub-tree that is checked
+         * for another node in the list.  */
+        for (pA = pNode; pA; pA = HtmlNodeParent(pA)) {
+            for (jj = 0; jj < p->nDynamic; jj++) {
+                HtmlNode *pOther = p->apDynamic[jj];
+                if (pOther == pNode) continue;
+                if (pOther == pA) break;
+                if (isAdjacent && 
+                    HtmlNodeParent(pOther) == HtmlNodeParent(pA) &&
+                    HtmlNodeParent(pA) &&
+                    HtmlNodeIndexOfChild(HtmlNodeParent(pA), pOther) <
+                    HtmlNodeIndexOfChild(HtmlNodeParent(pA), pA)
+                ) {
+                    break;
+                }
+            }
+            if (jj < p->nDynamic) break;
+        }
+        if (pA) continue;
+
+        if (isAdjacent && pParent) {
             int nChild = HtmlNodeNumChildren(pParent);
-            for (i = 0; HtmlNodeChild(pParent, i) != pTree->cb.pDynamic; i++);
+            int i = HtmlNodeIndexOfChild(pParent, pNode);
+            assert(i >= 0);
             for ( ; i < nChild; i++) {
                 HtmlWalkTree(pTree,HtmlNodeChild(pParent,i),checkDynamicCb,0);
             }
         } else {
-            HtmlWalkTree(pTree, pTree->cb.pDynamic, checkDynamicCb, 0);
+            HtmlWalkTree(pTree, pNode, checkDynamicCb, 0);
         }
-        pTree->cb.pDynamic = 0;
     }
+    p->nDynamic = 0;
 }
 
 int
@@ -94,7 +152,7 @@ HtmlCssTclNodeDynamics(Tcl_Interp *interp, HtmlNode *pNode)
     if (!HtmlNodeIsText(pNode)) {
         CssDynamic *p;
         HtmlElementNode *pElem = (HtmlElementNode *)pNode;
-        for (p = pElem->pDynamic; p ; p = p->pNext) {
+        for (p = HtmlElemRare(pElem, pDynamic); p ; p = p->pNext) {
             Tcl_Obj *pOther = Tcl_NewObj();
             HtmlCssSelectorToString(p->pSelector, pOther);
             Tcl_ListObjAppendElement(0, pRet, pOther);
@@ -446,11 +446,7 @@ parseSyntaxError (
     }
     iErrorLength = pInput->iInput - iErrorStart;
 
-    if (pParse->pErrorLog) {
-        Tcl_Obj *pError = pParse->pErrorLog;
-        Tcl_ListObjAppendElement(0, pError, Tcl_NewIntObj(iErrorStart));
-        Tcl_ListObjAppendElement(0, pError, Tcl_NewIntObj(iErrorLength));
-    }
+    HtmlCssSyntaxError(pParse, iErrorStart, iErrorLength);
 }
 
 /*
@@ -497,11 +493,7 @@ parseDeclarationError (CssInput *pInput, CssParse *pParse)
     iErrorLength = pInput->iInput - iErrorStart;
     inputNextToken(pInput);
 
-    if (pParse->pErrorLog) {
-        Tcl_Obj *pError = pParse->pErrorLog;
-        Tcl_ListObjAppendElement(0, pError, Tcl_NewIntObj(iErrorStart));
-        Tcl_ListObjAppendElement(0, pError, Tcl_NewIntObj(iErrorLength));
-    }
+    HtmlCssSyntaxError(pParse, iErrorStart, iErrorLength);
 
     return ((eToken == CT_SEMICOLON) ? 0: 1);
 }
@@ -974,6 +966,7 @@ static int parseAtRule(CssInput *pInput, CssParse *pParse){
  *         HtmlCssSelector
  *         HtmlCssImport
  *         HtmlCssRule
+ *         HtmlCssSyntaxError
  *
  * Results:
  *
@@ -69,6 +69,33 @@
 #include "htmltokens.h"
 #include "htmlmacros.h"
 
+/*
+ * The document nodes, attributes and text created by the [$html parse]
+ * command are allocated from an arena owned by the widget (HtmlTree.arena)
+ * and released in bulk by HtmlTreeClear(). If the HtmlArena* argument
+ * passed to HtmlArenaAlloc() is NULL, the regular heap is used instead.
+ * HtmlArenaFree() may be passed any pointer allocated by HtmlArenaAlloc() 
+ * (from the same arena or the heap) or HtmlAlloc(). See htmltree.c.
+ */
+typedef struct HtmlArena HtmlArena;
+typedef struct HtmlArenaBlock HtmlArenaBlock;
+struct HtmlArena {
+    HtmlArenaBlock *pBlock;    /* List of allocated blocks, newest first */
+    HtmlArenaBlock **apBlock;  /* The same blocks, sorted by address */
+    int nBlock;                /* Number of entries in apBlock */
+    char *zFree;               /* First free byte in pBlock */
+    char *zEnd;                /* One byte past the end of pBlock */
+};
+char *HtmlArenaAlloc(HtmlArena *, const char *, int);
+void HtmlArenaFree(HtmlArena *, void *);
+void HtmlArenaRelease(HtmlArena *);
+Tcl_ObjCmdProc HtmlArenaAllocCmd;
+
+#define HtmlArenaClearAlloc(pArena, zTopic, x) \
+    ((char *)memset(HtmlArenaAlloc(pArena, zTopic, (x)), 0, (x)))
+#define HtmlArenaNew(pArena, x) \
+    ((x *)HtmlArenaClearAlloc(pArena, #x, sizeof(x)))
+
 /*
  * Version information for the package mechanism.
  */
@@ -112,6 +139,9 @@ typedef struct HtmlNodeStack HtmlNodeStack;
 typedef struct HtmlOptions HtmlOptions;
 typedef struct HtmlTree HtmlTree;
 typedef struct HtmlTreeState HtmlTreeState;
+typedef struct HtmlTokenizer HtmlTokenizer;
+typedef struct HtmlDocBuffer HtmlDocBuffer;
+typedef struct HtmlUtf8Index HtmlUtf8Index;
 typedef struct HtmlAttributes HtmlAttributes;
 typedef struct HtmlTokenMap HtmlTokenMap;
 typedef struct HtmlCanvas HtmlCanvas;
@@ -133,6 +163,7 @@ typedef struct HtmlText HtmlText;
 
 typedef struct HtmlNode HtmlNode;
 typedef struct HtmlElementNode HtmlElementNode;
+typedef struct HtmlElementRare HtmlElementRare;
 typedef struct HtmlTextNode HtmlTextNode;
 
 typedef struct HtmlTextToken HtmlTextToken;
@@ -141,7 +172,11 @@ typedef struct HtmlTextIter HtmlTextIter;
 typedef struct HtmlDamage HtmlDamage;
 
 typedef struct HtmlFragmentContext HtmlFragmentContext;
+typedef struct HtmlFragmentCache HtmlFragmentCache;
+typedef struct HtmlFragmentTemplate HtmlFragmentTemplate;
+typedef struct HtmlHandlerBatch HtmlHandlerBatch;
 typedef struct HtmlSearchCache HtmlSearchCache;
+typedef struct HtmlStyleStats HtmlStyleStats;
 
 #include "css.h"
 #include "htmlprop.h"
@@ -162,7 +197,6 @@ struct HtmlTokenMap {
   Html_16 type;                   /* Markup type code */
   Html_u8 flags;                  /* Combination of HTMLTAG values */
   HtmlContentTest xClose;         /* Function to identify close tag */
-  HtmlTokenMap *pCollide;         /* Hash table collision chain */
 };
 
 #define HTMLTAG_INLINE      0x02  /* Set for an HTML inline tag */
@@ -295,12 +329,13 @@ struct HtmlTaggedRegion {
 struct HtmlNode {
     ClientData clientData;
     HtmlNode *pParent;             /* Parent of this node */
-    int iNode;                     /* Node index */
+    int iNode;                     /* Document order label */
 
     Html_u8 eTag;                  /* Tag type (or 0) */
     const char *zTag;              /* Atom string for tag type */
 
     int iSnapshot;                 /* Last changed snapshot */
+    int iChild;                    /* Index in parent's apChildren[] */
     HtmlNodeCmd *pNodeCmd;         /* Tcl command for this node */
 
     /* Cache used for [$widget bbox] */
@@ -342,8 +377,17 @@ struct HtmlElementNode {
 
     HtmlAttributes *pAttributes;      /* Html attributes associated with node */
 
+    /* Cached copies of the "id" and "class" attributes, maintained along
+     * with pAttributes by the tree module. zId points into pAttributes.
+     * azClass is the class attribute split into individual class names.
+     */
+    const char *zId;               /* Value of "id" attribute, or NULL */
+    int nClass;                    /* Number of entries in azClass */
+    const char **azClass;          /* Class names (nul-terminated strings) */
+
     /* Children of this element node */
     int nChild;                    /* Number of child nodes */
+    int nChildAlloc;               /* Allocated size of apChildren[] */
     HtmlNode **apChildren;         /* Array of pointers to children nodes */
 
     CssPropertySet *pStyle;                /* Parsed inline style */
@@ -351,22 +395,40 @@ struct HtmlElementNode {
     /* Information generated by the style engine */
     HtmlComputedValues *pPropertyValues;   /* Current CSS property values */
     HtmlComputedValues *pPreviousValues;   /* Previous CSS property values */
-    CssDynamic *pDynamic;                  /* CSS dynamic conditions */
-    Tcl_Obj *pOverride;                    /* List of property overrides */
     HtmlNodeStack *pStack;                 /* Stacking context */
-    HtmlNode *pBefore;                     /* Generated :before content */
-    HtmlNode *pAfter;                      /* Generated :after content */
 
     /* Manipulated by the [nodeHandle dynamic] command */
     Html_u8 flags;                         /* HTML_DYNAMIC_XXX flags */
 
-    HtmlNodeReplacement *pReplacement;     /* Replaced object, if any */
     HtmlLayoutCache *pLayoutCache;         /* Cached layout, if any */
-    HtmlNodeScrollbars *pScrollbar;        /* Internal scrollbars, if any */
-
     HtmlCanvasItem *pBox;
+
+    HtmlElementRare *pRare;                /* Rarely used fields, or NULL */
 };
 
+/*
+ * Fields of HtmlElementNode that are NULL for all but a small fraction
+ * of the elements in a typical document. They are stored in a separate
+ * structure, allocated by HtmlElemRareGet() the first time one of them
+ * is set and freed along with the node. Read them using the 
+ * HtmlElemRare() macro, which returns 0 if the structure has not been
+ * allocated.
+ *
+ * Fields that are set for most elements once a document has been styled
+ * and laid out (pPreviousValues, pLayoutCache, pBox and the [bbox] cache
+ * in HtmlNode) are not rare, so they remain in the node itself. Moving
+ * them would allocate the structure for almost every element.
+ */
+struct HtmlElementRare {
+    CssDynamic *pDynamic;                  /* CSS dynamic conditions */
+    Tcl_Obj *pOverride;                    /* List of property overrides */
+    HtmlNode *pBefore;                     /* Generated :before content */
+    HtmlNode *pAfter;                      /* Generated :after content */
+    HtmlNodeReplacement *pReplacement;     /* Replaced object, if any */
+    HtmlNodeScrollbars *pScrollbar;        /* Internal scrollbars, if any */
+};
+#define HtmlElemRare(p, field) ((p)->pRare ? (p)->pRare->field : 0)
+
 /* Alias for HtmlNodeXXX() methods */
 #define HtmlElemParent(p) ((HtmlElementNode *)HtmlNodeParent(&(p)->node))
 
@@ -411,6 +473,7 @@ struct HtmlOptions {
     Tcl_Obj *fonttable;
     int      forcefontmetrics;
     int      forcewidth;
+    int      fragmentcache;             /* Max. cached [fragment] templates */
     Tcl_Obj *imagecmd;
     Tcl_Obj *drawcleanupcrashcmd;
     int      imagecache;
@@ -467,7 +530,9 @@ struct HtmlCallback {
     HtmlCanvasSnapshot *pSnapshot;
 
     /* HTML_DYNAMIC */
-    HtmlNode *pDynamic;         /* Recalculate dynamic CSS for this node */
+    HtmlNode **apDynamic;       /* Nodes with modified dynamic flags */
+    int nDynamic;               /* Number of entries in apDynamic */
+    int nDynamicAlloc;          /* Allocated size of apDynamic */
 
     /* HTML_DAMAGE */
     HtmlDamage *pDamage;
@@ -489,14 +554,20 @@ struct HtmlCallback {
 #define HTML_STACK      0x20
 #define HTML_NODESCROLL 0x40
 
+/* Maximum size of HtmlCallback.apDynamic before the whole document is
+ * checked for modified dynamic conditions instead. */
+#define HTML_MAX_DYNAMIC 64
+
 /* 
  * Functions used to schedule callbacks and set the HtmlCallback state. 
  */
 void HtmlCallbackForce(HtmlTree *);
 void HtmlCallbackDynamic(HtmlTree *, HtmlNode *);
+void HtmlCallbackDynamicCancel(HtmlTree *, HtmlNode *);
 void HtmlCallbackDamage(HtmlTree *, int, int, int, int);
 void HtmlCallbackLayout(HtmlTree *, HtmlNode *);
 void HtmlCallbackRestyle(HtmlTree *, HtmlNode *);
+void HtmlCallbackRestyleSheet(HtmlTree *);
 
 void HtmlCallbackScrollX(HtmlTree *, int);
 void HtmlCallbackScrollY(HtmlTree *, int);
@@ -517,6 +588,112 @@ struct HtmlTreeState {
     int isCdataInHead;      /* True if previous token was <title> */
 };
 
+/*
+ * An instance of the following structure stores the state of the 
+ * tokenizer between calls to HtmlTokenize(). If a [$html parse] chunk
+ * ends part way through a token, this is used to resume scanning the
+ * token when the next chunk arrives, instead of starting again from
+ * the first byte of the token (HtmlTree.nParsed).
+ *
+ * All offsets are relative to the first byte of the partial token.
+ */
+#define HTML_TOKEN_NONE    0
+#define HTML_TOKEN_TEXT    1
+#define HTML_TOKEN_COMMENT 2
+#define HTML_TOKEN_CDATA   3
+#define HTML_TOKEN_TAG     4
+#define HTML_TOKEN_SCRIPT  5
+struct HtmlTokenizer {
+    int eState;             /* One of the HTML_TOKEN_XXX values */
+    int iScan;              /* Bytes of the token already scanned */
+    int isTrimStart;        /* True to trim leading newline of next text */
+
+    /* Used in state HTML_TOKEN_TAG */
+    int eTagState;          /* Position within the tag (see scanTagEnd()) */
+    int cQuote;             /* Quote character, if within a quoted value */
+
+    /* Used in state HTML_TOKEN_SCRIPT */
+    int eType;              /* Tag type of the opening tag */
+    const char *zAtom;      /* Tag name of the opening tag */
+    HtmlAttributes *pAttr;  /* Attributes of the opening tag */
+    int iScript;            /* Offset of first byte of script content */
+};
+
+/*
+ * The text of the document being parsed is stored in an instance of the
+ * following structure (HtmlTree.document). It is a gap buffer, so that
+ * a script handler calling [$html write text] repeatedly (i.e. a
+ * document.write() loop) only copies the inserted text, not the entire
+ * document each time. 
+ *
+ * The document text is the nByte bytes of z[] with the nGap byte gap at 
+ * offset iGap removed. Before the tokenizer reads the text, the gap is 
+ * moved to the end of the buffer, so that the text is contiguous and
+ * nul-terminated. See HtmlTokenize().
+ */
+struct HtmlDocBuffer {
+    char *z;                /* Allocated buffer (or NULL) */
+    int nAlloc;             /* Allocated size of z[] in bytes */
+    int nByte;              /* Bytes of document text (excluding the gap) */
+    int iGap;               /* Offset of the gap in z[] */
+    int nGap;               /* Size of the gap in bytes */
+};
+
+/*
+ * Cache of parsed [$widget fragment] markup. Each distinct string of
+ * markup passed to [fragment] is parsed once into a private "template"
+ * sub-tree (or list of sub-trees). Subsequent calls with the same markup
+ * copy the template instead of running the tokenizer and tree builder
+ * again. Templates are stored in aTemplate, keyed by markup text, and
+ * linked into a list in most-recently-used order starting at pFirst. The
+ * number of templates is limited by the -fragmentcache option. See
+ * HtmlParseFragment() in htmltree.c.
+ */
+struct HtmlFragmentCache {
+    Tcl_HashTable aTemplate;        /* Map from markup to template */
+    HtmlFragmentTemplate *pFirst;   /* Most recently used template */
+    HtmlFragmentTemplate *pLast;    /* Least recently used template */
+    int nTemplate;                  /* Number of entries in aTemplate */
+    int nHit;                       /* Number of cache hits */
+    int nMiss;                      /* Number of cache misses */
+};
+
+/*
+ * Counters maintained by the style engine and reported by the 
+ * [$widget _stylestats] command. nStyled is the number of times the
+ * computed values of an element have been recalculated. nShared is the 
+ * number of those for which the values were copied from a similar 
+ * sibling or cousin element instead of matching stylesheet rules.
+ * nCached is the number for which the set of matching rules was found
+ * in the matched-rule cache (see CssMatchCache), and nBatched the number
+ * for which it was found by the parallel match phase (see CssMatchBatch).
+ */
+struct HtmlStyleStats {
+    int nStyled;                    /* Elements styled */
+    int nShared;                    /* Elements that shared computed values */
+    int nCached;                    /* Elements with cached matched rules */
+    int nBatched;                   /* Elements matched by parallel phase */
+};
+
+/*
+ * A sparse index used to convert between byte and character offsets
+ * within a UTF-8 string. Element i of aChar[] is the number of characters
+ * that begin before byte offset (i * HTML_UTF8_INDEX_STRIDE). The index
+ * is extended as required by HtmlUtf8CharOffset() and 
+ * HtmlUtf8ByteOffset(), so it always covers a prefix of the string. The
+ * string must not be modified within that prefix while the index is in
+ * use.
+ */
+#define HTML_UTF8_INDEX_STRIDE 1024
+struct HtmlUtf8Index {
+    int *aChar;             /* Character offset of each checkpoint */
+    int nCheck;             /* Number of valid entries in aChar[] */
+    int nAlloc;             /* Allocated size of aChar[] in entries */
+};
+int HtmlUtf8CharOffset(HtmlUtf8Index *, const char *, int, int);
+int HtmlUtf8ByteOffset(HtmlUtf8Index *, const char *, int, int);
+void HtmlUtf8IndexClear(HtmlUtf8Index *);
+
 struct HtmlTree {
 
     /*
@@ -552,24 +729,27 @@ struct HtmlTree {
     /* The following variables are used to stored the text of the current
      * document (i.e. the *.html file) as it is being parsed.
      *
-     * nParsed and nCharParsed are kept in sync. If the document consists
-     * entirely of 7-bit ASCII, then they are equal. The nCharParsed variable
-     * is required so that the offsets passed to parse-handler callbacks
-     * are in characters, not bytes. TODO! See ticket #126.
+     * The offsets passed to parse-handler callbacks are in characters, 
+     * not bytes. They are converted from byte offsets using documentIndex
+     * (see HtmlDocumentCharOffset()).
      */
-    Tcl_Obj *pDocument;             /* Text of the html document */
-    int nParsed;                    /* Bytes of pDocument tokenized */
-    int nCharParsed;                /* TODO: Characters parsed */
+    HtmlDocBuffer document;         /* Text of the html document */
+    HtmlUtf8Index documentIndex;    /* Byte to char offsets for document */
+    int nParsed;                    /* Bytes of document tokenized */
+    HtmlTokenizer tokenizer;        /* Partial token state at nParsed */
 
-    int iWriteInsert;               /* Byte offset in pDocument for [write] */
+    int iWriteInsert;               /* Byte offset in document for [write] */
     int eWriteState;                /* One of the HTML_WRITE_XXX values */
 
     int isIgnoreNewline;            /* True after an opening tag */
     int isParseFinished;            /* True if the html parse is finished */
 
     HtmlNode *pRoot;                /* The root-node of the document. */
+    HtmlArena arena;                /* Memory for nodes created by [parse] */
 
     Tcl_HashTable aAtom;            /* String atoms for this widget */
+    const char *zAtomId;            /* Atom for attribute name "id" */
+    const char *zAtomClass;         /* Atom for attribute name "class" */
 
     HtmlTreeState state;
 
@@ -586,6 +766,7 @@ struct HtmlTree {
      * the [$html fragment] command. See htmltree.c for details.
      */
     HtmlFragmentContext *pFragment;
+    HtmlFragmentCache fragmentCache;
 
     int isFixed;                    /* True if any "fixed" graphics */
 
@@ -600,16 +781,32 @@ struct HtmlTree {
      * decremented if it is removed from the hash table.
      *
      * The node-handler and parse-handler tables are similar.
+     *
+     * Node and parse handlers configured with the -batch option are
+     * stored in the aNodeBatch and aParseBatch tables instead. Each entry
+     * maps a tag-type to an HtmlHandlerBatch structure. Batches that have
+     * accumulated arguments since the last call to 
+     * HtmlFlushHandlerBatches() are linked together, in the order in 
+     * which they received their first argument, starting at 
+     * apBatchPending[0] (or apBatchPending[1] while a fragment is being
+     * parsed).
      */
     Tcl_HashTable aScriptHandler;     /* Script handler callbacks. */
     Tcl_HashTable aNodeHandler;       /* Node handler callbacks. */
     Tcl_HashTable aParseHandler;      /* Parse handler callbacks. */
     Tcl_HashTable aAttributeHandler;  /* Attribute handler callbacks. */
+    Tcl_HashTable aNodeBatch;         /* Batched node handler callbacks. */
+    Tcl_HashTable aParseBatch;        /* Batched parse handler callbacks. */
+    HtmlHandlerBatch *apBatchPending[2]; /* Batches with pending args */
 
     CssStyleSheet *pStyle;          /* Style sheet configuration */
 
     /* Used by code in HtmlStyleApply() */
     void *pStyleApply;
+    CssAncestorFilter *pAncestorFilter;
+    CssStyleShare *pStyleShare;
+    CssMatchBatch *pMatchBatch;
+    HtmlStyleStats styleStats;
 
     HtmlOptions options;            /* Configurable options */
     Tk_OptionTable optionTable;     /* Option table */
@@ -637,6 +834,7 @@ struct HtmlTree {
     HtmlFontCache fontcache;
     Tcl_HashTable aValues;
     Tcl_HashTable aFontFamilies;
+    unsigned int iFontFamilies;     /* Checksum of aFontFamilies contents */
     Tcl_HashTable aCounterLists;
     HtmlComputedValuesCreator *pPrototypeCreator;
 
@@ -649,12 +847,6 @@ struct HtmlTree {
     Tcl_HashTable aTag;
     Tk_OptionTable tagOptionTable;     /* Option table for tags*/
 
-    /* The isSequenceOk variable is true if the HtmlNode.iNode values for all
-     * nodes in the tree are currently in tree order.
-     */
-    int isSequenceOk;    
-    int iNextNode;       /* Next node index to allocate */
-
     /* True if the HtmlElementNode.iBboxX and HtmlElementNode.iBboxY values
      * for all elements in the tree are valid.
      */
@@ -687,6 +879,7 @@ struct HtmlTree {
 int HtmlWriteWait(HtmlTree *);
 int HtmlWriteText(HtmlTree *, Tcl_Obj *);
 int HtmlWriteContinue(HtmlTree *);
+int HtmlDocumentCharOffset(HtmlTree *, int);
 
 
 #define MAX(x,y)   ((x)>(y)?(x):(y))
@@ -695,10 +888,34 @@ int HtmlWriteContinue(HtmlTree *);
 
 void HtmlFinishNodeHandlers(HtmlTree *);
 
+/*
+ * A node or parse handler configured with [$widget handler -batch]. 
+ * Instead of evaluating the script once for each node, the arguments
+ * that would have been appended to it are accumulated in a list, and
+ * the script is evaluated once with the whole list appended by
+ * HtmlFlushHandlerBatches(). This happens once for each chunk of 
+ * document text passed to the tokenizer, at the end of the document and
+ * at the end of each [$widget fragment] command.
+ *
+ * Element 0 of the apArgs and apNext arrays is used for nodes of the 
+ * document and element 1 for nodes parsed by [$widget fragment]. A 
+ * fragment may be parsed by a handler script while arguments for the 
+ * document are still pending; they are not delivered with the fragment.
+ */
+struct HtmlHandlerBatch {
+    Tcl_Obj *pScript;               /* Handler script */
+    Tcl_Obj *apArgs[2];             /* Pending arguments, or NULL */
+    int isNodeHandler;              /* True for a node handler */
+    HtmlHandlerBatch *apNext[2];    /* Next in HtmlTree.apBatchPending list */
+};
+void HtmlFlushHandlerBatches(HtmlTree *);
+void HtmlHandlerBatchFree(HtmlTree *, HtmlHandlerBatch *);
+
 Tcl_ObjCmdProc HtmlTreeCollapseWhitespace;
 Tcl_ObjCmdProc HtmlStyleSyntaxErrs;
 Tcl_ObjCmdProc HtmlLayoutSize;
 Tcl_ObjCmdProc HtmlLayoutNode;
+Tcl_ObjCmdProc HtmlTreeDump;
 Tcl_ObjCmdProc HtmlLayoutImage;
 Tcl_ObjCmdProc HtmlLayoutPrimitives;
 Tcl_ObjCmdProc HtmlCssStyleConfigDump;
@@ -741,13 +958,16 @@ HtmlNode *  HtmlNodeBefore(HtmlNode *);
 HtmlNode *  HtmlNodeAfter(HtmlNode *);
 HtmlNode *  HtmlNodeRightSibling(HtmlNode *);
 HtmlNode *  HtmlNodeLeftSibling(HtmlNode *);
+int         HtmlNodeIndexOfChild(HtmlNode *, HtmlNode *);
 char CONST *HtmlNodeTagName(HtmlNode *);
 char CONST *HtmlNodeAttr(HtmlNode *, char CONST *);
+const char *HtmlTreeAtom(HtmlTree *, const char *);
+const char *HtmlTreeAtomFind(HtmlTree *, const char *);
 char *      HtmlNodeToString(HtmlNode *);
 HtmlNode *  HtmlNodeGetPointer(HtmlTree *, char CONST *);
 int         HtmlNodeIsOrphan(HtmlNode *);
 
-int HtmlNodeAddChild(HtmlElementNode *, int, const char *, HtmlAttributes *);
+int HtmlNodeAddChild(HtmlTree *, HtmlElementNode *, int, const char *, HtmlAttributes *);
 int HtmlNodeAddTextChild(HtmlNode *, HtmlTextNode *);
 
 Html_u8     HtmlNodeTagType(HtmlNode *);
@@ -855,9 +1075,11 @@ void HtmlWidgetRepair(HtmlTree *, int, int, int, int, int);
 
 int HtmlNodeClearStyle(HtmlTree *, HtmlElementNode *);
 int HtmlNodeClearGenerated(HtmlTree *, HtmlElementNode *);
+HtmlElementRare *HtmlElemRareGet(HtmlElementNode *);
 void HtmlNodeClearRecursive(HtmlTree *, HtmlNode *);
 
 void HtmlTranslateEscapes(char *);
+Tcl_ObjCmdProc HtmlLookupCmd;
 void HtmlRestackNodes(HtmlTree *pTree);
 void HtmlDelStackingInfo(HtmlTree *, HtmlElementNode *);
 
@@ -882,10 +1104,13 @@ int HtmlNodeScrollbarDoCallback(HtmlTree *, HtmlNode *);
 
 void HtmlDelScrollbars(HtmlTree *, HtmlNode *);
 
-HtmlAttributes * HtmlAttributesNew(int, char const **, int *, int);
+HtmlAttributes * HtmlAttributesNew(
+    HtmlTree *, HtmlArena *, int, char const **, int *, int
+);
+HtmlAttributes * HtmlAttributesCopy(HtmlArena *, HtmlAttributes *);
 
 void HtmlParseFragment(HtmlTree *, const char *);
-void HtmlSequenceNodes(HtmlTree *);
+void HtmlFragmentCacheTrim(HtmlTree *, int);
 
 void HtmlFontReference(HtmlFont *);
 void HtmlFontRelease(HtmlTree *, HtmlFont *);
@@ -897,6 +1122,14 @@ int HtmlTokenize(HtmlTree *, char const *, int,
     void (*)(HtmlTree *, int, const char *, int)
 );
 
+/* Fast byte scanning primitives used by the tokenizer (htmlparse.c). */
+int HtmlScanChar(const char *, int, int);
+int HtmlScanComment(const char *, int);
+int HtmlScanEscape(const char *, int);
+int HtmlScanWord(const char *, int);
+int HtmlScanSpaces(const char *, int);
+Tcl_ObjCmdProc HtmlScannerCmd;
+
 /* The following three HtmlTreeAddXXX() functions - defined in htmltree.c - 
  * are invoked by the tokenizer (function HtmlTokenize()) when it is invoked 
  * to parse the main document (not a fragment).
@@ -916,8 +1149,8 @@ void HtmlTreeAddClosingTag(HtmlTree *, int, const char *, int);
 
 void HtmlInitTree(HtmlTree *);
 
-void HtmlHashInit(void *, int);
 HtmlTokenMap * HtmlHashLookup(void *, const char *zType);
+unsigned int HtmlPerfectHash(unsigned int, const char *, int, int);
 
 /*******************************************************************
  * Interface to code in htmltext.c
@@ -926,9 +1159,10 @@ HtmlTokenMap * HtmlHashLookup(void *, const char *zType);
 /*
  * Creation, modification and deletion of HtmlTextNode objects.
  */
-HtmlTextNode * HtmlTextNew(int, const char *, int, int);
-void           HtmlTextSet(HtmlTextNode *, int, const char *, int, int);
+HtmlTextNode * HtmlTextNew(HtmlArena *, int, const char *, int, int);
+void           HtmlTextSet(HtmlArena *, HtmlTextNode *, int, const char *, int, int);
 void           HtmlTextFree(HtmlTextNode *);
+HtmlTextNode * HtmlTextClone(HtmlArena *, HtmlTextNode *);
 
 /* The details of this structure should be considered private to
  * htmltext.c. They are here because other code needs to know the
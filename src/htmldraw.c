@@ -1102,7 +1102,7 @@ itemToBox (HtmlCanvasItem *pItem, int origin_x, int origin_y, int *pX, int *pY,
             *pH = pItem->x.line.y_underline + 1;
             return pItem->x.line.pNode;
         case CANVAS_WINDOW: {
-            HtmlNodeReplacement *pR = pItem->x.w.pElem->pReplacement;
+            HtmlNodeReplacement *pR = HtmlElemRare(pItem->x.w.pElem, pReplacement);
             if (pR && pR->win) {
                 Tk_Window control = pR->win;
                 *pW = Tk_ReqWidth(control);
@@ -1455,7 +1455,7 @@ int HtmlLayoutPrimitives(
                 aObj[0] = Tcl_NewStringObj("draw_window", -1);
                 aObj[1] = Tcl_NewIntObj(pItem->x.w.x);
                 aObj[2] = Tcl_NewIntObj(pItem->x.w.y);
-                aObj[3] = pItem->x.w.pElem->pReplacement->pReplace;
+                aObj[3] = pItem->x.w.pElem->pRare->pReplacement->pReplace;
                 break;
             case CANVAS_BOX:
                 nObj = 6;
@@ -1849,8 +1849,8 @@ drawScrollbars (HtmlTree *pTree, HtmlCanvasItem *pItem, int origin_x, int origin
     HtmlElementNode *pElem = (HtmlElementNode *)pItem->x.generic.pNode;
     assert(!HtmlNodeIsText(pItem->x.generic.pNode));
 
-    if (pElem->pScrollbar) {
-        HtmlNodeReplacement *pRep = &pElem->pScrollbar->vertical;
+    if (HtmlElemRare(pElem, pScrollbar)) {
+        HtmlNodeReplacement *pRep = &pElem->pRare->pScrollbar->vertical;
         HtmlNodeReplacement *p;
         HtmlComputedValues *pV = HtmlNodeComputedValues(pItem->x.box.pNode);
 
@@ -1873,7 +1873,7 @@ drawScrollbars (HtmlTree *pTree, HtmlCanvasItem *pItem, int origin_x, int origin
         }
 
         /* Horizontal */
-        pRep = &pElem->pScrollbar->horizontal;
+        pRep = &pElem->pRare->pScrollbar->horizontal;
         if (pRep->win) {
             pRep->iCanvasY  = origin_y + pItem->x.box.y + pItem->x.box.h;
             pRep->iCanvasY -= pRep->iHeight;
@@ -2502,9 +2502,10 @@ searchCanvas(
                     /* Adjust the x and y coords for scrollable blocks: */
                     pOverflow->xscroll = 0;
                     pOverflow->yscroll = 0;
-                    if (pElem->pScrollbar) {
-                        pOverflow->xscroll = pElem->pScrollbar->iHorizontal;
-                        pOverflow->yscroll = pElem->pScrollbar->iVertical;
+                    if (HtmlElemRare(pElem, pScrollbar)) {
+                        HtmlNodeScrollbars *pScroll = pElem->pRare->pScrollbar;
+                        pOverflow->xscroll = pScroll->iHorizontal;
+                        pOverflow->yscroll = pScroll->iVertical;
                     }
                 }
            
@@ -2687,8 +2688,9 @@ damageSlot (HtmlTree *pTree, CanvasItemSorterSlot *pSlot, int *pX1, int *pY1, in
     }
 /* printf("%dx%d +%d+%d (%d)\n", w, h, x, y, pSlot->pItem->type); */
     if (pSlot->pItem->type == CANVAS_WINDOW) {
-        pSlot->pItem->x.w.pElem->pReplacement->iCanvasX = -10000;
-        pSlot->pItem->x.w.pElem->pReplacement->iCanvasY = -10000;
+        HtmlNodeReplacement *pRep = pSlot->pItem->x.w.pElem->pRare->pReplacement;
+        pRep->iCanvasX = -10000;
+        pRep->iCanvasY = -10000;
     }
     *pX1 = MIN(*pX1, x);
     *pY1 = MIN(*pY1, y);
@@ -3022,7 +3024,7 @@ pixmapQueryCb(
         case CANVAS_WINDOW: {
             if (pQuery->getwin) {
                 HtmlTree *pTree = pQuery->pTree;
-                HtmlNodeReplacement *pRep = pItem->x.w.pElem->pReplacement;
+                HtmlNodeReplacement *pRep = HtmlElemRare(pItem->x.w.pElem, pReplacement);
                 HtmlNodeReplacement *p;
 
                 pRep->iCanvasX = origin_x + pItem->x.w.x;
@@ -3945,7 +3947,6 @@ HtmlWidgetDamageText (
     int iNodeStart;
     int iNodeFin;
 
-    HtmlSequenceNodes(pTree);
     iNodeStart = pNodeStart->iNode;
     iNodeFin = pNodeFin->iNode;
 
@@ -3994,7 +3995,6 @@ HtmlWidgetBboxText (
     int iNodeStart;
     int iNodeFin;
 
-    HtmlSequenceNodes(pTree);
     iNodeStart = pNodeStart->iNode;
     iNodeFin = pNodeFin->iNode;
   
@@ -4095,8 +4095,9 @@ scrollToNodeCb(
  * Results:
  *     Pixels from the top of the canvas to the top of the content generated 
  *     by node iNode. Or, if node iNode does not generate content, then
- *     the content generated by node (iNode - 1). And so on. If no node
- *     with a node number less than iNode generated content, 0 is returned.
+ *     the content generated by the closest node that precedes it in 
+ *     document order (i.e. has a smaller HtmlNode.iNode label) and does.
+ *     If no such node generated content, 0 is returned.
  *
  * Side effects:
  *     None.
@@ -4108,7 +4109,6 @@ HtmlWidgetNodeTop (HtmlTree *pTree, HtmlNode *pNode)
 {
     ScrollToQuery sQuery;
 
-    HtmlSequenceNodes(pTree);
     HtmlCallbackForce(pTree);
 
     sQuery.iMaxNode = pNode->iNode;
@@ -0,0 +1,2355 @@
+
+/* 
+ * DO NOT EDIT!
+ *
+ * The code in this file was automatically generated. See the files
+ * src/entitylist.txt and src/mkperfecthash.tcl from the tkhtml source
+ * distribution.
+ */
+
+#define ESC_HASH_SIZE 2124
+
+/* Named character references, in perfect hash slot order. */
+static const struct sgEsc esc_sequences[] = {
+  {"GT",                              ">",                 1},
+  {"NotRightTriangle",                "\xE2\x8B\xAB",      0},
+  {"simgE",                           "\xE2\xAA\xA0",      0},
+  {"racute",                          "\xC5\x95",          0},
+  {"Pi",                              "\xCE\xA0",          1},
+  {"Union",                           "\xE2\x8B\x83",      0},
+  {"natural",                         "\xE2\x99\xAE",      0},
+  {"rect",                            "\xE2\x96\xAD",      0},
+  {"RightUpDownVector",               "\xE2\xA5\x8F",      0},
+  {"udblac",                          "\xC5\xB1",          0},
+  {"Iota",                            "\xCE\x99",          1},
+  {"CenterDot",                       "\xC2\xB7",          0},
+  {"leftthreetimes",                  "\xE2\x8B\x8B",      0},
+  {"mlcp",                            "\xE2\xAB\x9B",      0},
+  {"radic",                           "\xE2\x88\x9A",      1},
+  {"NotLessSlantEqual",               "\xE2\xA9\xBD\xCC\xB8", 0},
+  {"Ufr",                             "\xF0\x9D\x94\x98",  0},
+  {"rsquor",                          "\xE2\x80\x99",      0},
+  {"twoheadleftarrow",                "\xE2\x86\x9E",      0},
+  {"boxDr",                           "\xE2\x95\x93",      0},
+  {"NotGreaterSlantEqual",            "\xE2\xA9\xBE\xCC\xB8", 0},
+  {"tprime",                          "\xE2\x80\xB4",      0},
+  {"pfr",                             "\xF0\x9D\x94\xAD",  0},
+  {"Jopf",                            "\xF0\x9D\x95\x81",  0},
+  {"SupersetEqual",                   "\xE2\x8A\x87",      0},
+  {"Yscr",                            "\xF0\x9D\x92\xB4",  0},
+  {"RightTeeArrow",                   "\xE2\x86\xA6",      0},
+  {"xdtri",                           "\xE2\x96\xBD",      0},
+  {"ulcorner",                        "\xE2\x8C\x9C",      0},
+  {"dd",                              "\xE2\x85\x86",      0},
+  {"vsupnE",                          "\xE2\xAB\x8C\xEF\xB8\x80", 0},
+  {"blk12",                           "\xE2\x96\x92",      0},
+  {"larrfs",                          "\xE2\xA4\x9D",      0},
+  {"ohm",                             "\xCE\xA9",          0},
+  {"oscr",                            "\xE2\x84\xB4",      0},
+  {"Therefore",                       "\xE2\x88\xB4",      0},
+  {"escr",                            "\xE2\x84\xAF",      0},
+  {"trisb",                           "\xE2\xA7\x8D",      0},
+  {"ecolon",                          "\xE2\x89\x95",      0},
+  {"scedil",                          "\xC5\x9F",          0},
+  {"comma",                           ",",                 0},
+  {"intcal",                          "\xE2\x8A\xBA",      0},
+  {"solb",                            "\xE2\xA7\x84",      0},
+  {"cdot",                            "\xC4\x8B",          0},
+  {"circlearrowright",                "\xE2\x86\xBB",      0},
+  {"compfn",                          "\xE2\x88\x98",      0},
+  {"setminus",                        "\xE2\x88\x96",      0},
+  {"middot",                          "\xC2\xB7",          1},
+  {"nvrArr",                          "\xE2\xA4\x83",      0},
+  {"nwarr",                           "\xE2\x86\x96",      0},
+  {"Ucy",                             "\xD0\xA3",          0},
+  {"easter",                          "\xE2\xA9\xAE",      0},
+  {"angle",                           "\xE2\x88\xA0",      0},
+  {"nvge",                            "\xE2\x89\xA5\xE2\x83\x92", 0},
+  {"iopf",                            "\xF0\x9D\x95\x9A",  0},
+  {"Imacr",                           "\xC4\xAA",          0},
+  {"nges",                            "\xE2\xA9\xBE\xCC\xB8", 0},
+  {"DoubleRightTee",                  "\xE2\x8A\xA8",      0},
+  {"larrlp",                          "\xE2\x86\xAB",      0},
+  {"sube",                            "\xE2\x8A\x86",      1},
+  {"lessapprox",                      "\xE2\xAA\x85",      0},
+  {"nfr",                             "\xF0\x9D\x94\xAB",  0},
+  {"rlm",                             "\xE2\x80\x8F",      1},
+  {"rdca",                            "\xE2\xA4\xB7",      0},
+  {"rArr",                            "\xE2\x87\x92",      1},
+  {"LeftArrow",                       "\xE2\x86\x90",      0},
+  {"abreve",                          "\xC4\x83",          0},
+  {"parsl",                           "\xE2\xAB\xBD",      0},
+  {"nvle",                            "\xE2\x89\xA4\xE2\x83\x92", 0},
+  {"subedot",                         "\xE2\xAB\x83",      0},
+  {"dstrok",                          "\xC4\x91",          0},
+  {"sdotb",                           "\xE2\x8A\xA1",      0},
+  {"Mfr",                             "\xF0\x9D\x94\x90",  0},
+  {"lt",                              "<",                 1},
+  {"rdquor",                          "\xE2\x80\x9D",      0},
+  {"jscr",                            "\xF0\x9D\x92\xBF",  0},
+  {"lescc",                           "\xE2\xAA\xA8",      0},
+  {"vfr",                             "\xF0\x9D\x94\xB3",  0},
+  {"PrecedesEqual",                   "\xE2\xAA\xAF",      0},
+  {"imof",                            "\xE2\x8A\xB7",      0},
+  {"SquareUnion",                     "\xE2\x8A\x94",      0},
+  {"frac78",                          "\xE2\x85\x9E",      0},
+  {"boxdL",                           "\xE2\x95\x95",      0},
+  {"uogon",                           "\xC5\xB3",          0},
+  {"mapstodown",                      "\xE2\x86\xA7",      0},
+  {"CirclePlus",                      "\xE2\x8A\x95",      0},
+  {"Otilde",                          "\xC3\x95",          1},
+  {"SuchThat",                        "\xE2\x88\x8B",      0},
+  {"Ncaron",                          "\xC5\x87",          0},
+  {"nvsim",                           "\xE2\x88\xBC\xE2\x83\x92", 0},
+  {"egsdot",                          "\xE2\xAA\x98",      0},
+  {"cup",                             "\xE2\x88\xAA",      1},
+  {"Kcedil",                          "\xC4\xB6",          0},
+  {"nvgt",                            ">\xE2\x83\x92",     0},
+  {"DownTeeArrow",                    "\xE2\x86\xA7",      0},
+  {"lparlt",                          "\xE2\xA6\x93",      0},
+  {"YUcy",                            "\xD0\xAE",          0},
+  {"homtht",                          "\xE2\x88\xBB",      0},
+  {"sqsube",                          "\xE2\x8A\x91",      0},
+  {"sol",                             "/",                 0},
+  {"Phi",                             "\xCE\xA6",          1},
+  {"cuepr",                           "\xE2\x8B\x9E",      0},
+  {"harr",                            "\xE2\x86\x94",      1},
+  {"ordm",                            "\xC2\xBA",          1},
+  {"ReverseUpEquilibrium",            "\xE2\xA5\xAF",      0},
+  {"ShortRightArrow",                 "\xE2\x86\x92",      0},
+  {"mopf",                            "\xF0\x9D\x95\x9E",  0},
+  {"Aogon",                           "\xC4\x84",          0},
+  {"bigoplus",                        "\xE2\xA8\x81",      0},
+  {"Lt",                              "\xE2\x89\xAA",      0},
+  {"equiv",                           "\xE2\x89\xA1",      1},
+  {"NotSubset",                       "\xE2\x8A\x82\xE2\x83\x92", 0},
+  {"vArr",                            "\xE2\x87\x95",      0},
+  {"egrave",                          "\xC3\xA8",          1},
+  {"ominus",                          "\xE2\x8A\x96",      0},
+  {"Nscr",                            "\xF0\x9D\x92\xA9",  0},
+  {"boxDl",                           "\xE2\x95\x96",      0},
+  {"longmapsto",                      "\xE2\x9F\xBC",      0},
+  {"nlE",                             "\xE2\x89\xA6\xCC\xB8", 0},
+  {"star",                            "\xE2\x98\x86",      0},
+  {"smeparsl",                        "\xE2\xA7\xA4",      0},
+  {"iiota",                           "\xE2\x84\xA9",      0},
+  {"rpargt",                          "\xE2\xA6\x94",      0},
+  {"mcomma",                          "\xE2\xA8\xA9",      0},
+  {"dsol",                            "\xE2\xA7\xB6",      0},
+  {"sup",                             "\xE2\x8A\x83",      1},
+  {"gammad",                          "\xCF\x9D",          0},
+  {"frasl",                           "\xE2\x81\x84",      1},
+  {"phi",                             "\xCF\x86",          1},
+  {"nleqslant",                       "\xE2\xA9\xBD\xCC\xB8", 0},
+  {"rrarr",                           "\xE2\x87\x89",      0},
+  {"lotimes",                         "\xE2\xA8\xB4",      0},
+  {"Jukcy",                           "\xD0\x84",          0},
+  {"Lacute",                          "\xC4\xB9",          0},
+  {"hfr",                             "\xF0\x9D\x94\xA5",  0},
+  {"simdot",                          "\xE2\xA9\xAA",      0},
+  {"models",                          "\xE2\x8A\xA7",      0},
+  {"varr",                            "\xE2\x86\x95",      0},
+  {"kopf",                            "\xF0\x9D\x95\x9C",  0},
+  {"varnothing",                      "\xE2\x88\x85",      0},
+  {"ssmile",                          "\xE2\x8C\xA3",      0},
+  {"aogon",                           "\xC4\x85",          0},
+  {"Utilde",                          "\xC5\xA8",          0},
+  {"iecy",                            "\xD0\xB5",          0},
+  {"mdash",                           "\xE2\x80\x94",      1},
+  {"swarhk",                          "\xE2\xA4\xA6",      0},
+  {"wreath",                          "\xE2\x89\x80",      0},
+  {"nsucceq",                         "\xE2\xAA\xB0\xCC\xB8", 0},
+  {"ngt",                             "\xE2\x89\xAF",      0},
+  {"boxdl",                           "\xE2\x94\x90",      0},
+  {"trianglelefteq",                  "\xE2\x8A\xB4",      0},
+  {"cirfnint",                        "\xE2\xA8\x90",      0},
+  {"rbarr",                           "\xE2\xA4\x8D",      0},
+  {"Upsilon",                         "\xCE\xA5",          1},
+  {"Theta",                           "\xCE\x98",          1},
+  {"lrcorner",                        "\xE2\x8C\x9F",      0},
+  {"hercon",                          "\xE2\x8A\xB9",      0},
+  {"DownLeftTeeVector",               "\xE2\xA5\x9E",      0},
+  {"quaternions",                     "\xE2\x84\x8D",      0},
+  {"RightCeiling",                    "\xE2\x8C\x89",      0},
+  {"NotGreaterEqual",                 "\xE2\x89\xB1",      0},
+  {"nsubseteqq",                      "\xE2\xAB\x85\xCC\xB8", 0},
+  {"dzcy",                            "\xD1\x9F",          0},
+  {"And",                             "\xE2\xA9\x93",      0},
+  {"nsub",                            "\xE2\x8A\x84",      1},
+  {"supnE",                           "\xE2\xAB\x8C",      0},
+  {"therefore",                       "\xE2\x88\xB4",      0},
+  {"varsupsetneqq",                   "\xE2\xAB\x8C\xEF\xB8\x80", 0},
+  {"fcy",                             "\xD1\x84",          0},
+  {"LeftCeiling",                     "\xE2\x8C\x88",      0},
+  {"LeftTriangleBar",                 "\xE2\xA7\x8F",      0},
+  {"Vert",                            "\xE2\x80\x96",      0},
+  {"kcedil",                          "\xC4\xB7",          0},
+  {"crarr",                           "\xE2\x86\xB5",      1},
+  {"Eopf",                            "\xF0\x9D\x94\xBC",  0},
+  {"Lleftarrow",                      "\xE2\x87\x9A",      0},
+  {"Uacute",                          "\xC3\x9A",          1},
+  {"sim",                             "\xE2\x88\xBC",      1},
+  {"demptyv",                         "\xE2\xA6\xB1",      0},
+  {"ccupssm",                         "\xE2\xA9\x90",      0},
+  {"Sqrt",                            "\xE2\x88\x9A",      0},
+  {"NotPrecedesSlantEqual",           "\xE2\x8B\xA0",      0},
+  {"boxvl",                           "\xE2\x94\xA4",      0},
+  {"iquest",                          "\xC2\xBF",          1},
+  {"imped",                           "\xC6\xB5",          0},
+  {"NotGreaterLess",                  "\xE2\x89\xB9",      0},
+  {"dopf",                            "\xF0\x9D\x95\x95",  0},
+  {"Scedil",                          "\xC5\x9E",          0},
+  {"bscr",                            "\xF0\x9D\x92\xB7",  0},
+  {"Wcirc",                           "\xC5\xB4",          0},
+  {"nacute",                          "\xC5\x84",          0},
+  {"uplus",                           "\xE2\x8A\x8E",      0},
+  {"capand",                          "\xE2\xA9\x84",      0},
+  {"zeetrf",                          "\xE2\x84\xA8",      0},
+  {"awconint",                        "\xE2\x88\xB3",      0},
+  {"ddarr",                           "\xE2\x87\x8A",      0},
+  {"Assign",                          "\xE2\x89\x94",      0},
+  {"niv",                             "\xE2\x88\x8B",      0},
+  {"Dagger",                          "\xE2\x80\xA1",      1},
+  {"Gcirc",                           "\xC4\x9C",          0},
+  {"TSHcy",                           "\xD0\x8B",          0},
+  {"quatint",                         "\xE2\xA8\x96",      0},
+  {"Zdot",                            "\xC5\xBB",          0},
+  {"ogon",                            "\xCB\x9B",          0},
+  {"zcy",                             "\xD0\xB7",          0},
+  {"scirc",                           "\xC5\x9D",          0},
+  {"Vfr",                             "\xF0\x9D\x94\x99",  0},
+  {"apid",                            "\xE2\x89\x8B",      0},
+  {"ThickSpace",                      "\xE2\x81\x9F\xE2\x80\x8A", 0},
+  {"Gopf",                            "\xF0\x9D\x94\xBE",  0},
+  {"UnderBar",                        "_",                 0},
+  {"nLeftarrow",                      "\xE2\x87\x8D",      0},
+  {"lsimg",                           "\xE2\xAA\x8F",      0},
+  {"szlig",                           "\xC3\x9F",          1},
+  {"DoubleLeftArrow",                 "\xE2\x87\x90",      0},
+  {"Escr",                            "\xE2\x84\xB0",      0},
+  {"heartsuit",                       "\xE2\x99\xA5",      0},
+  {"backepsilon",                     "\xCF\xB6",          0},
+  {"lvnE",                            "\xE2\x89\xA8\xEF\xB8\x80", 0},
+  {"NotHumpDownHump",                 "\xE2\x89\x8E\xCC\xB8", 0},
+  {"ccirc",                           "\xC4\x89",          0},
+  {"solbar",                          "\xE2\x8C\xBF",      0},
+  {"trianglerighteq",                 "\xE2\x8A\xB5",      0},
+  {"ape",                             "\xE2\x89\x8A",      0},
+  {"Ccedil",                          "\xC3\x87",          1},
+  {"boxV",                            "\xE2\x95\x91",      0},
+  {"zacute",                          "\xC5\xBA",          0},
+  {"bigvee",                          "\xE2\x8B\x81",      0},
+  {"ubreve",                          "\xC5\xAD",          0},
+  {"eng",                             "\xC5\x8B",          0},
+  {"digamma",                         "\xCF\x9D",          0},
+  {"ReverseElement",                  "\xE2\x88\x8B",      0},
+  {"alefsym",                         "\xE2\x84\xB5",      1},
+  {"oacute",                          "\xC3\xB3",          1},
+  {"rarrc",                           "\xE2\xA4\xB3",      0},
+  {"jmath",                           "\xC8\xB7",          0},
+  {"ocir",                            "\xE2\x8A\x9A",      0},
+  {"RightFloor",                      "\xE2\x8C\x8B",      0},
+  {"lowbar",                          "_",                 0},
+  {"ShortDownArrow",                  "\xE2\x86\x93",      0},
+  {"FilledVerySmallSquare",           "\xE2\x96\xAA",      0},
+  {"ncong",                           "\xE2\x89\x87",      0},
+  {"plusmn",                          "\xC2\xB1",          1},
+  {"napid",                           "\xE2\x89\x8B\xCC\xB8", 0},
+  {"Wscr",                            "\xF0\x9D\x92\xB2",  0},
+  {"capdot",                          "\xE2\xA9\x80",      0},
+  {"boxUL",                           "\xE2\x95\x9D",      0},
+  {"frac56",                          "\xE2\x85\x9A",      0},
+  {"minusd",                          "\xE2\x88\xB8",      0},
+  {"IOcy",                            "\xD0\x81",          0},
+  {"Laplacetrf",                      "\xE2\x84\x92",      0},
+  {"rhov",                            "\xCF\xB1",          0},
+  {"suplarr",                         "\xE2\xA5\xBB",      0},
+  {"ensp",                            "\xE2\x80\x82",      1},
+  {"boxvr",                           "\xE2\x94\x9C",      0},
+  {"Scaron",                          "\xC5\xA0",          1},
+  {"Yopf",                            "\xF0\x9D\x95\x90",  0},
+  {"laquo",                           "\xC2\xAB",          1},
+  {"nmid",                            "\xE2\x88\xA4",      0},
+  {"nvDash",                          "\xE2\x8A\xAD",      0},
+  {"wp",                              "\xE2\x84\x98",      0},
+  {"reg",                             "\xC2\xAE",          1},
+  {"backsimeq",                       "\xE2\x8B\x8D",      0},
+  {"dagger",                          "\xE2\x80\xA0",      1},
+  {"Iukcy",                           "\xD0\x86",          0},
+  {"TildeTilde",                      "\xE2\x89\x88",      0},
+  {"lnE",                             "\xE2\x89\xA8",      0},
+  {"larrbfs",                         "\xE2\xA4\x9F",      0},
+  {"dcaron",                          "\xC4\x8F",          0},
+  {"FilledSmallSquare",               "\xE2\x97\xBC",      0},
+  {"nesim",                           "\xE2\x89\x82\xCC\xB8", 0},
+  {"DoubleLongLeftRightArrow",        "\xE2\x9F\xBA",      0},
+  {"Updownarrow",                     "\xE2\x87\x95",      0},
+  {"afr",                             "\xF0\x9D\x94\x9E",  0},
+  {"npr",                             "\xE2\x8A\x80",      0},
+  {"maltese",                         "\xE2\x9C\xA0",      0},
+  {"eqcirc",                          "\xE2\x89\x96",      0},
+  {"cupcup",                          "\xE2\xA9\x8A",      0},
+  {"kfr",                             "\xF0\x9D\x94\xA8",  0},
+  {"el",                              "\xE2\xAA\x99",      0},
+  {"boxDR",                           "\xE2\x95\x94",      0},
+  {"bfr",                             "\xF0\x9D\x94\x9F",  0},
+  {"Vee",                             "\xE2\x8B\x81",      0},
+  {"vzigzag",                         "\xE2\xA6\x9A",      0},
+  {"KHcy",                            "\xD0\xA5",          0},
+  {"yfr",                             "\xF0\x9D\x94\xB6",  0},
+  {"LeftAngleBracket",                "\xE2\x9F\xA8",      0},
+  {"lneqq",                           "\xE2\x89\xA8",      0},
+  {"LeftRightVector",                 "\xE2\xA5\x8E",      0},
+  {"prcue",                           "\xE2\x89\xBC",      0},
+  {"Oscr",                            "\xF0\x9D\x92\xAA",  0},
+  {"napE",                            "\xE2\xA9\xB0\xCC\xB8", 0},
+  {"bottom",                          "\xE2\x8A\xA5",      0},
+  {"Uopf",                            "\xF0\x9D\x95\x8C",  0},
+  {"sscr",                            "\xF0\x9D\x93\x88",  0},
+  {"ncup",                            "\xE2\xA9\x82",      0},
+  {"blacktriangleleft",               "\xE2\x97\x82",      0},
+  {"lesdotor",                        "\xE2\xAA\x83",      0},
+  {"varpi",                           "\xCF\x96",          0},
+  {"nspar",                           "\xE2\x88\xA6",      0},
+  {"rarrlp",                          "\xE2\x86\xAC",      0},
+  {"Darr",                            "\xE2\x86\xA1",      0},
+  {"angmsdae",                        "\xE2\xA6\xAC",      0},
+  {"Igrave",                          "\xC3\x8C",          1},
+  {"loang",                           "\xE2\x9F\xAC",      0},
+  {"theta",                           "\xCE\xB8",          1},
+  {"sqcups",                          "\xE2\x8A\x94\xEF\xB8\x80", 0},
+  {"gtlPar",                          "\xE2\xA6\x95",      0},
+  {"cedil",                           "\xC2\xB8",          1},
+  {"DiacriticalAcute",                "\xC2\xB4",          0},
+  {"uHar",                            "\xE2\xA5\xA3",      0},
+  {"quote",                           "\x22",              1},
+  {"gcy",                             "\xD0\xB3",          0},
+  {"Cayleys",                         "\xE2\x84\xAD",      0},
+  {"csupe",                           "\xE2\xAB\x92",      0},
+  {"nleqq",                           "\xE2\x89\xA6\xCC\xB8", 0},
+  {"EmptyVerySmallSquare",            "\xE2\x96\xAB",      0},
+  {"amacr",                           "\xC4\x81",          0},
+  {"Topf",                            "\xF0\x9D\x95\x8B",  0},
+  {"lesssim",                         "\xE2\x89\xB2",      0},
+  {"acute",                           "\xC2\xB4",          1},
+  {"leftarrowtail",                   "\xE2\x86\xA2",      0},
+  {"curlyeqsucc",                     "\xE2\x8B\x9F",      0},
+  {"yscr",                            "\xF0\x9D\x93\x8E",  0},
+  {"rmoustache",                      "\xE2\x8E\xB1",      0},
+  {"zcaron",                          "\xC5\xBE",          0},
+  {"gesdotol",                        "\xE2\xAA\x84",      0},
+  {"khcy",                            "\xD1\x85",          0},
+  {"rmoust",                          "\xE2\x8E\xB1",      0},
+  {"DownRightVectorBar",              "\xE2\xA5\x97",      0},
+  {"fflig",                           "\xEF\xAC\x80",      0},
+  {"cacute",                          "\xC4\x87",          0},
+  {"Zacute",                          "\xC5\xB9",          0},
+  {"suphsub",                         "\xE2\xAB\x97",      0},
+  {"yuml",                            "\xC3\xBF",          1},
+  {"nvdash",                          "\xE2\x8A\xAC",      0},
+  {"Xopf",                            "\xF0\x9D\x95\x8F",  0},
+  {"LongLeftRightArrow",              "\xE2\x9F\xB7",      0},
+  {"iota",                            "\xCE\xB9",          1},
+  {"cularrp",                         "\xE2\xA4\xBD",      0},
+  {"leftharpoonup",                   "\xE2\x86\xBC",      0},
+  {"LeftUpTeeVector",                 "\xE2\xA5\xA0",      0},
+  {"delta",                           "\xCE\xB4",          1},
+  {"Subset",                          "\xE2\x8B\x90",      0},
+  {"ratio",                           "\xE2\x88\xB6",      0},
+  {"napprox",                         "\xE2\x89\x89",      0},
+  {"succsim",                         "\xE2\x89\xBF",      0},
+  {"NotHumpEqual",                    "\xE2\x89\x8F\xCC\xB8", 0},
+  {"loplus",                          "\xE2\xA8\xAD",      0},
+  {"downdownarrows",                  "\xE2\x87\x8A",      0},
+  {"fallingdotseq",                   "\xE2\x89\x92",      0},
+  {"uml",                             "\xC2\xA8",          1},
+  {"plusb",                           "\xE2\x8A\x9E",      0},
+  {"vDash",                           "\xE2\x8A\xA8",      0},
+  {"gl",                              "\xE2\x89\xB7",      0},
+  {"SOFTcy",                          "\xD0\xAC",          0},
+  {"SucceedsEqual",                   "\xE2\xAA\xB0",      0},
+  {"Efr",                             "\xF0\x9D\x94\x88",  0},
+  {"nhpar",                           "\xE2\xAB\xB2",      0},
+  {"angzarr",                         "\xE2\x8D\xBC",      0},
+  {"cfr",                             "\xF0\x9D\x94\xA0",  0},
+  {"gscr",                            "\xE2\x84\x8A",      0},
+  {"inodot",                          "\xC4\xB1",          0},
+  {"geqslant",                        "\xE2\xA9\xBE",      0},
+  {"circledS",                        "\xE2\x93\x88",      0},
+  {"NotSucceedsEqual",                "\xE2\xAA\xB0\xCC\xB8", 0},
+  {"simne",                           "\xE2\x89\x86",      0},
+  {"num",                             "#",                 0},
+  {"lurdshar",                        "\xE2\xA5\x8A",      0},
+  {"nbumpe",                          "\xE2\x89\x8F\xCC\xB8", 0},
+  {"Ncedil",                          "\xC5\x85",          0},
+  {"cwconint",                        "\xE2\x88\xB2",      0},
+  {"NotGreaterTilde",                 "\xE2\x89\xB5",      0},
+  {"sup2",                            "\xC2\xB2",          1},
+  {"Superset",                        "\xE2\x8A\x83",      0},
+  {"prap",                            "\xE2\xAA\xB7",      0},
+  {"frac18",                          "\xE2\x85\x9B",      0},
+  {"rarrw",                           "\xE2\x86\x9D",      0},
+  {"vsupne",                          "\xE2\x8A\x8B\xEF\xB8\x80", 0},
+  {"yacy",                            "\xD1\x8F",          0},
+  {"Ugrave",                          "\xC3\x99",          1},
+  {"Rcedil",                          "\xC5\x96",          0},
+  {"lacute",                          "\xC4\xBA",          0},
+  {"Aacute",                          "\xC3\x81",          1},
+  {"ring",                            "\xCB\x9A",          0},
+  {"frac13",                          "\xE2\x85\x93",      0},
+  {"bsol",                            "\x5C",              0},
+  {"boxHU",                           "\xE2\x95\xA9",      0},
+  {"plussim",                         "\xE2\xA8\xA6",      0},
+  {"Jcirc",                           "\xC4\xB4",          0},
+  {"urcorner",                        "\xE2\x8C\x9D",      0},
+  {"shy",                             "\xC2\xAD",          1},
+  {"setmn",                           "\xE2\x88\x96",      0},
+  {"apos",                            "'",                 1},
+  {"Lambda",                          "\xCE\x9B",          1},
+  {"ecirc",                           "\xC3\xAA",          1},
+  {"cudarrr",                         "\xE2\xA4\xB5",      0},
+  {"starf",                           "\xE2\x98\x85",      0},
+  {"fscr",                            "\xF0\x9D\x92\xBB",  0},
+  {"backprime",                       "\xE2\x80\xB5",      0},
+  {"Succeeds",                        "\xE2\x89\xBB",      0},
+  {"drcorn",                          "\xE2\x8C\x9F",      0},
+  {"lceil",                           "\xE2\x8C\x88",      1},
+  {"circlearrowleft",                 "\xE2\x86\xBA",      0},
+  {"rightrightarrows",                "\xE2\x87\x89",      0},
+  {"Gammad",                          "\xCF\x9C",          0},
+  {"rarrhk",                          "\xE2\x86\xAA",      0},
+  {"infintie",                        "\xE2\xA7\x9D",      0},
+  {"QUOT",                            "\x22",              1},
+  {"lthree",                          "\xE2\x8B\x8B",      0},
+  {"rcy",                             "\xD1\x80",          0},
+  {"Dot",                             "\xC2\xA8",          0},
+  {"par",                             "\xE2\x88\xA5",      0},
+  {"smtes",                           "\xE2\xAA\xAC\xEF\xB8\x80", 0},
+  {"scnap",                           "\xE2\xAA\xBA",      0},
+  {"vnsup",                           "\xE2\x8A\x83\xE2\x83\x92", 0},
+  {"omid",                            "\xE2\xA6\xB6",      0},
+  {"lharu",                           "\xE2\x86\xBC",      0},
+  {"varkappa",                        "\xCF\xB0",          0},
+  {"cent",                            "\xC2\xA2",          1},
+  {"NegativeMediumSpace",             "\xE2\x80\x8B",      0},
+  {"lessdot",                         "\xE2\x8B\x96",      0},
+  {"varsupsetneq",                    "\xE2\x8A\x8B\xEF\xB8\x80", 0},
+  {"Hopf",                            "\xE2\x84\x8D",      0},
+  {"lfisht",                          "\xE2\xA5\xBC",      0},
+  {"Icirc",                           "\xC3\x8E",          1},
+  {"Hacek",                           "\xCB\x87",          0},
+  {"Equilibrium",                     "\xE2\x87\x8C",      0},
+  {"PlusMinus",                       "\xC2\xB1",          0},
+  {"Omega",                           "\xCE\xA9",          1},
+  {"swnwar",                          "\xE2\xA4\xAA",      0},
+  {"naturals",                        "\xE2\x84\x95",      0},
+  {"UpperRightArrow",                 "\xE2\x86\x97",      0},
+  {"boxHd",                           "\xE2\x95\xA4",      0},
+  {"AMP",                             "&",                 1},
+  {"ltcc",                            "\xE2\xAA\xA6",      0},
+  {"wfr",                             "\xF0\x9D\x94\xB4",  0},
+  {"nleftarrow",                      "\xE2\x86\x9A",      0},
+  {"marker",                          "\xE2\x96\xAE",      0},
+  {"sext",                            "\xE2\x9C\xB6",      0},
+  {"Ouml",                            "\xC3\x96",          1},
+  {"rtri",                            "\xE2\x96\xB9",      0},
+  {"uuml",                            "\xC3\xBC",          1},
+  {"LessLess",                        "\xE2\xAA\xA1",      0},
+  {"NotSquareSupersetEqual",          "\xE2\x8B\xA3",      0},
+  {"jukcy",                           "\xD1\x94",          0},
+  {"vangrt",                          "\xE2\xA6\x9C",      0},
+  {"toea",                            "\xE2\xA4\xA8",      0},
+  {"rtrif",                           "\xE2\x96\xB8",      0},
+  {"simplus",                         "\xE2\xA8\xA4",      0},
+  {"rightharpoondown",                "\xE2\x87\x81",      0},
+  {"NotSucceedsSlantEqual",           "\xE2\x8B\xA1",      0},
+  {"plankv",                          "\xE2\x84\x8F",      0},
+  {"DoubleUpDownArrow",               "\xE2\x87\x95",      0},
+  {"oopf",                            "\xF0\x9D\x95\xA0",  0},
+  {"ang",                             "\xE2\x88\xA0",      1},
+  {"twixt",                           "\xE2\x89\xAC",      0},
+  {"gesl",                            "\xE2\x8B\x9B\xEF\xB8\x80", 0},
+  {"angrtvbd",                        "\xE2\xA6\x9D",      0},
+  {"LeftDownVectorBar",               "\xE2\xA5\x99",      0},
+  {"NotReverseElement",               "\xE2\x88\x8C",      0},
+  {"preceq",                          "\xE2\xAA\xAF",      0},
+  {"nsccue",                          "\xE2\x8B\xA1",      0},
+  {"curvearrowright",                 "\xE2\x86\xB7",      0},
+  {"lozf",                            "\xE2\xA7\xAB",      0},
+  {"REG",                             "\xC2\xAE",          1},
+  {"seArr",                           "\xE2\x87\x98",      0},
+  {"duhar",                           "\xE2\xA5\xAF",      0},
+  {"amp",                             "&",                 1},
+  {"le",                              "\xE2\x89\xA4",      1},
+  {"DoubleLongRightArrow",            "\xE2\x9F\xB9",      0},
+  {"les",                             "\xE2\xA9\xBD",      0},
+  {"nexist",                          "\xE2\x88\x84",      0},
+  {"LeftVector",                      "\xE2\x86\xBC",      0},
+  {"filig",                           "\xEF\xAC\x81",      0},
+  {"eqslantless",                     "\xE2\xAA\x95",      0},
+  {"intlarhk",                        "\xE2\xA8\x97",      0},
+  {"midcir",                          "\xE2\xAB\xB0",      0},
+  {"vartriangleleft",                 "\xE2\x8A\xB2",      0},
+  {"Delta",                           "\xCE\x94",          1},
+  {"gacute",                          "\xC7\xB5",          0},
+  {"xvee",                            "\xE2\x8B\x81",      0},
+  {"Because",                         "\xE2\x88\xB5",      0},
+  {"rtimes",                          "\xE2\x8B\x8A",      0},
+  {"tint",                            "\xE2\x88\xAD",      0},
+  {"glE",                             "\xE2\xAA\x92",      0},
+  {"Lsh",                             "\xE2\x86\xB0",      0},
+  {"gtrless",                         "\xE2\x89\xB7",      0},
+  {"angmsdab",                        "\xE2\xA6\xA9",      0},
+  {"lang",                            "\xE2\x9F\xA8",      1},
+  {"intercal",                        "\xE2\x8A\xBA",      0},
+  {"between",                         "\xE2\x89\xAC",      0},
+  {"thetav",                          "\xCF\x91",          0},
+  {"or",                              "\xE2\x88\xA8",      1},
+  {"nvHarr",                          "\xE2\xA4\x84",      0},
+  {"DifferentialD",                   "\xE2\x85\x86",      0},
+  {"puncsp",                          "\xE2\x80\x88",      0},
+  {"agrave",                          "\xC3\xA0",          1},
+  {"range",                           "\xE2\xA6\xA5",      0},
+  {"Umacr",                           "\xC5\xAA",          0},
+  {"rarrap",                          "\xE2\xA5\xB5",      0},
+  {"leftrightharpoons",               "\xE2\x87\x8B",      0},
+  {"dHar",                            "\xE2\xA5\xA5",      0},
+  {"ngeqslant",                       "\xE2\xA9\xBE\xCC\xB8", 0},
+  {"late",                            "\xE2\xAA\xAD",      0},
+  {"xsqcup",                          "\xE2\xA8\x86",      0},
+  {"loz",                             "\xE2\x97\x8A",      1},
+  {"DoubleRightArrow",                "\xE2\x87\x92",      0},
+  {"bepsi",                           "\xCF\xB6",          0},
+  {"DD",                              "\xE2\x85\x85",      0},
+  {"Fouriertrf",                      "\xE2\x84\xB1",      0},
+  {"Ofr",                             "\xF0\x9D\x94\x92",  0},
+  {"sccue",                           "\xE2\x89\xBD",      0},
+  {"softcy",                          "\xD1\x8C",          0},
+  {"leftrightsquigarrow",             "\xE2\x86\xAD",      0},
+  {"nwarrow",                         "\xE2\x86\x96",      0},
+  {"Sigma",                           "\xCE\xA3",          1},
+  {"succ",                            "\xE2\x89\xBB",      0},
+  {"af",                              "\xE2\x81\xA1",      0},
+  {"Ucirc",                           "\xC3\x9B",          1},
+  {"blacktriangle",                   "\xE2\x96\xB4",      0},
+  {"leftharpoondown",                 "\xE2\x86\xBD",      0},
+  {"boxminus",                        "\xE2\x8A\x9F",      0},
+  {"boxVL",                           "\xE2\x95\xA3",      0},
+  {"Ncy",                             "\xD0\x9D",          0},
+  {"xutri",                           "\xE2\x96\xB3",      0},
+  {"Congruent",                       "\xE2\x89\xA1",      0},
+  {"Int",                             "\xE2\x88\xAC",      0},
+  {"Element",                         "\xE2\x88\x88",      0},
+  {"supedot",                         "\xE2\xAB\x84",      0},
+  {"Rightarrow",                      "\xE2\x87\x92",      0},
+  {"DoubleLeftTee",                   "\xE2\xAB\xA4",      0},
+  {"LJcy",                            "\xD0\x89",          0},
+  {"nlsim",                           "\xE2\x89\xB4",      0},
+  {"ruluhar",                         "\xE2\xA5\xA8",      0},
+  {"Bfr",                             "\xF0\x9D\x94\x85",  0},
+  {"capcap",                          "\xE2\xA9\x8B",      0},
+  {"angst",                           "\xC3\x85",          0},
+  {"tdot",                            "\xE2\x83\x9B",      0},
+  {"MinusPlus",                       "\xE2\x88\x93",      0},
+  {"wscr",                            "\xF0\x9D\x93\x8C",  0},
+  {"daleth",                          "\xE2\x84\xB8",      0},
+  {"iff",                             "\xE2\x87\x94",      0},
+  {"Mellintrf",                       "\xE2\x84\xB3",      0},
+  {"equals",                          "=",                 0},
+  {"lozenge",                         "\xE2\x97\x8A",      0},
+  {"phone",                           "\xE2\x98\x8E",      0},
+  {"notindot",                        "\xE2\x8B\xB5\xCC\xB8", 0},
+  {"uArr",                            "\xE2\x87\x91",      1},
+  {"shortparallel",                   "\xE2\x88\xA5",      0},
+  {"Or",                              "\xE2\xA9\x94",      0},
+  {"apE",                             "\xE2\xA9\xB0",      0},
+  {"nprec",                           "\xE2\x8A\x80",      0},
+  {"bnequiv",                         "\xE2\x89\xA1\xE2\x83\xA5", 0},
+  {"Lcaron",                          "\xC4\xBD",          0},
+  {"ucirc",                           "\xC3\xBB",          1},
+  {"xhArr",                           "\xE2\x9F\xBA",      0},
+  {"frac34",                          "\xC2\xBE",          1},
+  {"scnsim",                          "\xE2\x8B\xA9",      0},
+  {"IJlig",                           "\xC4\xB2",          0},
+  {"hkswarow",                        "\xE2\xA4\xA6",      0},
+  {"Auml",                            "\xC3\x84",          1},
+  {"CupCap",                          "\xE2\x89\x8D",      0},
+  {"isinv",                           "\xE2\x88\x88",      0},
+  {"supne",                           "\xE2\x8A\x8B",      0},
+  {"ngE",                             "\xE2\x89\xA7\xCC\xB8", 0},
+  {"Barv",                            "\xE2\xAB\xA7",      0},
+  {"colone",                          "\xE2\x89\x94",      0},
+  {"eparsl",                          "\xE2\xA7\xA3",      0},
+  {"leftarrow",                       "\xE2\x86\x90",      0},
+  {"dtdot",                           "\xE2\x8B\xB1",      0},
+  {"ge",                              "\xE2\x89\xA5",      1},
+  {"Rarrtl",                          "\xE2\xA4\x96",      0},
+  {"origof",                          "\xE2\x8A\xB6",      0},
+  {"DownRightTeeVector",              "\xE2\xA5\x9F",      0},
+  {"lfloor",                          "\xE2\x8C\x8A",      1},
+  {"divide",                          "\xC3\xB7",          1},
+  {"Acirc",                           "\xC3\x82",          1},
+  {"Racute",                          "\xC5\x94",          0},
+  {"ucy",                             "\xD1\x83",          0},
+  {"rsaquo",                          "\xE2\x80\xBA",      1},
+  {"SquareSuperset",                  "\xE2\x8A\x90",      0},
+  {"nrtri",                           "\xE2\x8B\xAB",      0},
+  {"rnmid",                           "\xE2\xAB\xAE",      0},
+  {"target",                          "\xE2\x8C\x96",      0},
+  {"Sscr",                            "\xF0\x9D\x92\xAE",  0},
+  {"prec",                            "\xE2\x89\xBA",      0},
+  {"subplus",                         "\xE2\xAA\xBF",      0},
+  {"Lopf",                            "\xF0\x9D\x95\x83",  0},
+  {"suphsol",                         "\xE2\x9F\x89",      0},
+  {"Euml",                            "\xC3\x8B",          1},
+  {"angmsdag",                        "\xE2\xA6\xAE",      0},
+  {"it",                              "\xE2\x81\xA2",      0},
+  {"sc",                              "\xE2\x89\xBB",      0},
+  {"cupcap",                          "\xE2\xA9\x86",      0},
+  {"xcirc",                           "\xE2\x97\xAF",      0},
+  {"bsemi",                           "\xE2\x81\x8F",      0},
+  {"nLeftrightarrow",                 "\xE2\x87\x8E",      0},
+  {"ocirc",                           "\xC3\xB4",          1},
+  {"emsp",                            "\xE2\x80\x83",      1},
+  {"rangd",                           "\xE2\xA6\x92",      0},
+  {"bbrktbrk",                        "\xE2\x8E\xB6",      0},
+  {"precnsim",                        "\xE2\x8B\xA8",      0},
+  {"emsp14",                          "\xE2\x80\x85",      0},
+  {"NotEqualTilde",                   "\xE2\x89\x82\xCC\xB8", 0},
+  {"npreceq",                         "\xE2\xAA\xAF\xCC\xB8", 0},
+  {"hairsp",                          "\xE2\x80\x8A",      0},
+  {"blacktriangleright",              "\xE2\x96\xB8",      0},
+  {"SquareSubsetEqual",               "\xE2\x8A\x91",      0},
+  {"NotSupersetEqual",                "\xE2\x8A\x89",      0},
+  {"rfr",                             "\xF0\x9D\x94\xAF",  0},
+  {"check",                           "\xE2\x9C\x93",      0},
+  {"xrarr",                           "\xE2\x9F\xB6",      0},
+  {"Larr",                            "\xE2\x86\x9E",      0},
+  {"conint",                          "\xE2\x88\xAE",      0},
+  {"TripleDot",                       "\xE2\x83\x9B",      0},
+  {"sum",                             "\xE2\x88\x91",      1},
+  {"capcup",                          "\xE2\xA9\x87",      0},
+  {"pitchfork",                       "\xE2\x8B\x94",      0},
+  {"csube",                           "\xE2\xAB\x91",      0},
+  {"yen",                             "\xC2\xA5",          1},
+  {"copysr",                          "\xE2\x84\x97",      0},
+  {"ropf",                            "\xF0\x9D\x95\xA3",  0},
+  {"Coproduct",                       "\xE2\x88\x90",      0},
+  {"NotGreater",                      "\xE2\x89\xAF",      0},
+  {"lobrk",                           "\xE2\x9F\xA6",      0},
+  {"nbump",                           "\xE2\x89\x8E\xCC\xB8", 0},
+  {"upharpoonright",                  "\xE2\x86\xBE",      0},
+  {"notniva",                         "\xE2\x88\x8C",      0},
+  {"xcup",                            "\xE2\x8B\x83",      0},
+  {"pertenk",                         "\xE2\x80\xB1",      0},
+  {"DDotrahd",                        "\xE2\xA4\x91",      0},
+  {"nles",                            "\xE2\xA9\xBD\xCC\xB8", 0},
+  {"blank",                           "\xE2\x90\xA3",      0},
+  {"NotElement",                      "\xE2\x88\x89",      0},
+  {"Iopf",                            "\xF0\x9D\x95\x80",  0},
+  {"ofcir",                           "\xE2\xA6\xBF",      0},
+  {"lbrack",                          "[",                 0},
+  {"malt",                            "\xE2\x9C\xA0",      0},
+  {"Omacr",                           "\xC5\x8C",          0},
+  {"osol",                            "\xE2\x8A\x98",      0},
+  {"scap",                            "\xE2\xAA\xB8",      0},
+  {"lvertneqq",                       "\xE2\x89\xA8\xEF\xB8\x80", 0},
+  {"ifr",                             "\xF0\x9D\x94\xA6",  0},
+  {"parsim",                          "\xE2\xAB\xB3",      0},
+  {"Sfr",                             "\xF0\x9D\x94\x96",  0},
+  {"NegativeThickSpace",              "\xE2\x80\x8B",      0},
+  {"dfr",                             "\xF0\x9D\x94\xA1",  0},
+  {"NJcy",                            "\xD0\x8A",          0},
+  {"utrif",                           "\xE2\x96\xB4",      0},
+  {"xfr",                             "\xF0\x9D\x94\xB5",  0},
+  {"Eta",                             "\xCE\x97",          1},
+  {"lmidot",                          "\xC5\x80",          0},
+  {"aelig",                           "\xC3\xA6",          1},
+  {"LessGreater",                     "\xE2\x89\xB6",      0},
+  {"xuplus",                          "\xE2\xA8\x84",      0},
+  {"nvap",                            "\xE2\x89\x8D\xE2\x83\x92", 0},
+  {"GJcy",                            "\xD0\x83",          0},
+  {"nwnear",                          "\xE2\xA4\xA7",      0},
+  {"Cup",                             "\xE2\x8B\x93",      0},
+  {"nsubseteq",                       "\xE2\x8A\x88",      0},
+  {"dblac",                           "\xCB\x9D",          0},
+  {"Sc",                              "\xE2\xAA\xBC",      0},
+  {"natur",                           "\xE2\x99\xAE",      0},
+  {"apacir",                          "\xE2\xA9\xAF",      0},
+  {"realine",                         "\xE2\x84\x9B",      0},
+  {"Breve",                           "\xCB\x98",          0},
+  {"clubs",                           "\xE2\x99\xA3",      1},
+  {"rbrack",                          "]",                 0},
+  {"nhArr",                           "\xE2\x87\x8E",      0},
+  {"xwedge",                          "\xE2\x8B\x80",      0},
+  {"mu",                              "\xCE\xBC",          1},
+  {"gg",                              "\xE2\x89\xAB",      0},
+  {"PrecedesSlantEqual",              "\xE2\x89\xBC",      0},
+  {"vopf",                            "\xF0\x9D\x95\xA7",  0},
+  {"varepsilon",                      "\xCF\xB5",          0},
+  {"SquareIntersection",              "\xE2\x8A\x93",      0},
+  {"circeq",                          "\xE2\x89\x97",      0},
+  {"DJcy",                            "\xD0\x82",          0},
+  {"eDDot",                           "\xE2\xA9\xB7",      0},
+  {"gsiml",                           "\xE2\xAA\x90",      0},
+  {"macr",                            "\xC2\xAF",          1},
+  {"ntlg",                            "\xE2\x89\xB8",      0},
+  {"supmult",                         "\xE2\xAB\x82",      0},
+  {"lowast",                          "\xE2\x88\x97",      1},
+  {"nlt",                             "\xE2\x89\xAE",      0},
+  {"sqcap",                           "\xE2\x8A\x93",      0},
+  {"vrtri",                           "\xE2\x8A\xB3",      0},
+  {"Tcedil",                          "\xC5\xA2",          0},
+  {"simg",                            "\xE2\xAA\x9E",      0},
+  {"nsime",                           "\xE2\x89\x84",      0},
+  {"lsh",                             "\xE2\x86\xB0",      0},
+  {"Qscr",                            "\xF0\x9D\x92\xAC",  0},
+  {"Itilde",                          "\xC4\xA8",          0},
+  {"NotLessEqual",                    "\xE2\x89\xB0",      0},
+  {"Integral",                        "\xE2\x88\xAB",      0},
+  {"otilde",                          "\xC3\xB5",          1},
+  {"Kopf",                            "\xF0\x9D\x95\x82",  0},
+  {"NotCupCap",                       "\xE2\x89\xAD",      0},
+  {"sstarf",                          "\xE2\x8B\x86",      0},
+  {"NegativeThinSpace",               "\xE2\x80\x8B",      0},
+  {"Rcy",                             "\xD0\xA0",          0},
+  {"Kfr",                             "\xF0\x9D\x94\x8E",  0},
+  {"njcy",                            "\xD1\x9A",          0},
+  {"CHcy",                            "\xD0\xA7",          0},
+  {"rotimes",                         "\xE2\xA8\xB5",      0},
+  {"trie",                            "\xE2\x89\x9C",      0},
+  {"LessFullEqual",                   "\xE2\x89\xA6",      0},
+  {"yacute",                          "\xC3\xBD",          1},
+  {"Rsh",                             "\xE2\x86\xB1",      0},
+  {"gopf",                            "\xF0\x9D\x95\x98",  0},
+  {"rfisht",                          "\xE2\xA5\xBD",      0},
+  {"csub",                            "\xE2\xAB\x8F",      0},
+  {"xopf",                            "\xF0\x9D\x95\xA9",  0},
+  {"LeftTee",                         "\xE2\x8A\xA3",      0},
+  {"bigwedge",                        "\xE2\x8B\x80",      0},
+  {"efDot",                           "\xE2\x89\x92",      0},
+  {"supsetneq",                       "\xE2\x8A\x8B",      0},
+  {"nis",                             "\xE2\x8B\xBC",      0},
+  {"UnderBracket",                    "\xE2\x8E\xB5",      0},
+  {"Ubrcy",                           "\xD0\x8E",          0},
+  {"supset",                          "\xE2\x8A\x83",      0},
+  {"dharl",                           "\xE2\x87\x83",      0},
+  {"bigcap",                          "\xE2\x8B\x82",      0},
+  {"GreaterSlantEqual",               "\xE2\xA9\xBE",      0},
+  {"chcy",                            "\xD1\x87",          0},
+  {"coprod",                          "\xE2\x88\x90",      0},
+  {"vee",                             "\xE2\x88\xA8",      0},
+  {"scy",                             "\xD1\x81",          0},
+  {"UpDownArrow",                     "\xE2\x86\x95",      0},
+  {"dtri",                            "\xE2\x96\xBF",      0},
+  {"precapprox",                      "\xE2\xAA\xB7",      0},
+  {"EqualTilde",                      "\xE2\x89\x82",      0},
+  {"hardcy",                          "\xD1\x8A",          0},
+  {"DownBreve",                       "\xCC\x91",          0},
+  {"ldquo",                           "\xE2\x80\x9C",      1},
+  {"frac58",                          "\xE2\x85\x9D",      0},
+  {"DownArrowUpArrow",                "\xE2\x87\xB5",      0},
+  {"ord",                             "\xE2\xA9\x9D",      0},
+  {"udhar",                           "\xE2\xA5\xAE",      0},
+  {"NotTilde",                        "\xE2\x89\x81",      0},
+  {"Nopf",                            "\xE2\x84\x95",      0},
+  {"succnsim",                        "\xE2\x8B\xA9",      0},
+  {"orv",                             "\xE2\xA9\x9B",      0},
+  {"cir",                             "\xE2\x97\x8B",      0},
+  {"ngeq",                            "\xE2\x89\xB1",      0},
+  {"Uscr",                            "\xF0\x9D\x92\xB0",  0},
+  {"sime",                            "\xE2\x89\x83",      0},
+  {"alpha",                           "\xCE\xB1",          1},
+  {"nRightarrow",                     "\xE2\x87\x8F",      0},
+  {"and",                             "\xE2\x88\xA7",      1},
+  {"dcy",                             "\xD0\xB4",          0},
+  {"nGtv",                            "\xE2\x89\xAB\xCC\xB8", 0},
+  {"triangleleft",                    "\xE2\x97\x83",      0},
+  {"emptyv",                          "\xE2\x88\x85",      0},
+  {"hearts",                          "\xE2\x99\xA5",      1},
+  {"CircleMinus",                     "\xE2\x8A\x96",      0},
+  {"Lang",                            "\xE2\x9F\xAA",      0},
+  {"Gg",                              "\xE2\x8B\x99",      0},
+  {"Kappa",                           "\xCE\x9A",          1},
+  {"bigsqcup",                        "\xE2\xA8\x86",      0},
+  {"RightArrowBar",                   "\xE2\x87\xA5",      0},
+  {"CircleTimes",                     "\xE2\x8A\x97",      0},
+  {"hscr",                            "\xF0\x9D\x92\xBD",  0},
+  {"ne",                              "\xE2\x89\xA0",      1},
+  {"larrsim",                         "\xE2\xA5\xB3",      0},
+  {"OverBrace",                       "\xE2\x8F\x9E",      0},
+  {"ExponentialE",                    "\xE2\x85\x87",      0},
+  {"UnionPlus",                       "\xE2\x8A\x8E",      0},
+  {"eacute",                          "\xC3\xA9",          1},
+  {"caret",                           "\xE2\x81\x81",      0},
+  {"searrow",                         "\xE2\x86\x98",      0},
+  {"DoubleDownArrow",                 "\xE2\x87\x93",      0},
+  {"Not",                             "\xE2\xAB\xAC",      0},
+  {"aacute",                          "\xC3\xA1",          1},
+  {"umacr",                           "\xC5\xAB",          0},
+  {"leftrightarrow",                  "\xE2\x86\x94",      0},
+  {"iukcy",                           "\xD1\x96",          0},
+  {"rightleftarrows",                 "\xE2\x87\x84",      0},
+  {"ee",                              "\xE2\x85\x87",      0},
+  {"KJcy",                            "\xD0\x8C",          0},
+  {"barwed",                          "\xE2\x8C\x85",      0},
+  {"spadesuit",                       "\xE2\x99\xA0",      0},
+  {"curarr",                          "\xE2\x86\xB7",      0},
+  {"zwj",                             "\xE2\x80\x8D",      1},
+  {"complement",                      "\xE2\x88\x81",      0},
+  {"Gcy",                             "\xD0\x93",          0},
+  {"ForAll",                          "\xE2\x88\x80",      0},
+  {"smid",                            "\xE2\x88\xA3",      0},
+  {"rightharpoonup",                  "\xE2\x87\x80",      0},
+  {"uuarr",                           "\xE2\x87\x88",      0},
+  {"lrm",                             "\xE2\x80\x8E",      1},
+  {"Xscr",                            "\xF0\x9D\x92\xB3",  0},
+  {"boxUR",                           "\xE2\x95\x9A",      0},
+  {"Kcy",                             "\xD0\x9A",          0},
+  {"divonx",                          "\xE2\x8B\x87",      0},
+  {"esdot",                           "\xE2\x89\x90",      0},
+  {"VerticalLine",                    "|",                 0},
+  {"period",                          ".",                 0},
+  {"precneqq",                        "\xE2\xAA\xB5",      0},
+  {"ggg",                             "\xE2\x8B\x99",      0},
+  {"ocy",                             "\xD0\xBE",          0},
+  {"bsime",                           "\xE2\x8B\x8D",      0},
+  {"frac14",                          "\xC2\xBC",          1},
+  {"half",                            "\xC2\xBD",          0},
+  {"bcong",                           "\xE2\x89\x8C",      0},
+  {"frac35",                          "\xE2\x85\x97",      0},
+  {"cuvee",                           "\xE2\x8B\x8E",      0},
+  {"lessgtr",                         "\xE2\x89\xB6",      0},
+  {"dharr",                           "\xE2\x87\x82",      0},
+  {"xmap",                            "\xE2\x9F\xBC",      0},
+  {"gtrarr",                          "\xE2\xA5\xB8",      0},
+  {"angmsdah",                        "\xE2\xA6\xAF",      0},
+  {"Hat",                             "^",                 0},
+  {"nexists",                         "\xE2\x88\x84",      0},
+  {"nsupseteq",                       "\xE2\x8A\x89",      0},
+  {"sdote",                           "\xE2\xA9\xA6",      0},
+  {"dbkarow",                         "\xE2\xA4\x8F",      0},
+  {"nsube",                           "\xE2\x8A\x88",      0},
+  {"nparallel",                       "\xE2\x88\xA6",      0},
+  {"Exists",                          "\xE2\x88\x83",      0},
+  {"Ffr",                             "\xF0\x9D\x94\x89",  0},
+  {"leg",                             "\xE2\x8B\x9A",      0},
+  {"nrtrie",                          "\xE2\x8B\xAD",      0},
+  {"DoubleLongLeftArrow",             "\xE2\x9F\xB8",      0},
+  {"Rcaron",                          "\xC5\x98",          0},
+  {"vellip",                          "\xE2\x8B\xAE",      0},
+  {"otimes",                          "\xE2\x8A\x97",      1},
+  {"operp",                           "\xE2\xA6\xB9",      0},
+  {"Poincareplane",                   "\xE2\x84\x8C",      0},
+  {"jopf",                            "\xF0\x9D\x95\x9B",  0},
+  {"auml",                            "\xC3\xA4",          1},
+  {"Dashv",                           "\xE2\xAB\xA4",      0},
+  {"NegativeVeryThinSpace",           "\xE2\x80\x8B",      0},
+  {"Gbreve",                          "\xC4\x9E",          0},
+  {"Longleftarrow",                   "\xE2\x9F\xB8",      0},
+  {"DoubleContourIntegral",           "\xE2\x88\xAF",      0},
+  {"pi",                              "\xCF\x80",          1},
+  {"lsaquo",                          "\xE2\x80\xB9",      1},
+  {"sqsupset",                        "\xE2\x8A\x90",      0},
+  {"Popf",                            "\xE2\x84\x99",      0},
+  {"fpartint",                        "\xE2\xA8\x8D",      0},
+  {"varsubsetneq",                    "\xE2\x8A\x8A\xEF\xB8\x80", 0},
+  {"eDot",                            "\xE2\x89\x91",      0},
+  {"Dstrok",                          "\xC4\x90",          0},
+  {"cemptyv",                         "\xE2\xA6\xB2",      0},
+  {"smashp",                          "\xE2\xA8\xB3",      0},
+  {"prod",                            "\xE2\x88\x8F",      1},
+  {"cire",                            "\xE2\x89\x97",      0},
+  {"leq",                             "\xE2\x89\xA4",      0},
+  {"lmoust",                          "\xE2\x8E\xB0",      0},
+  {"HumpEqual",                       "\xE2\x89\x8F",      0},
+  {"Leftrightarrow",                  "\xE2\x87\x94",      0},
+  {"ntriangleright",                  "\xE2\x8B\xAB",      0},
+  {"gfr",                             "\xF0\x9D\x94\xA4",  0},
+  {"cscr",                            "\xF0\x9D\x92\xB8",  0},
+  {"ufr",                             "\xF0\x9D\x94\xB2",  0},
+  {"blacklozenge",                    "\xE2\xA7\xAB",      0},
+  {"iexcl",                           "\xC2\xA1",          1},
+  {"DownLeftRightVector",             "\xE2\xA5\x90",      0},
+  {"vsubne",                          "\xE2\x8A\x8A\xEF\xB8\x80", 0},
+  {"iiiint",                          "\xE2\xA8\x8C",      0},
+  {"mldr",                            "\xE2\x80\xA6",      0},
+  {"RightVector",                     "\xE2\x87\x80",      0},
+  {"erDot",                           "\xE2\x89\x93",      0},
+  {"incare",                          "\xE2\x84\x85",      0},
+  {"Lscr",                            "\xE2\x84\x92",      0},
+  {"downharpoonright",                "\xE2\x87\x82",      0},
+  {"xharr",                           "\xE2\x9F\xB7",      0},
+  {"ecy",                             "\xD1\x8D",          0},
+  {"supplus",                         "\xE2\xAB\x80",      0},
+  {"Oopf",                            "\xF0\x9D\x95\x86",  0},
+  {"nprcue",                          "\xE2\x8B\xA0",      0},
+  {"Cap",                             "\xE2\x8B\x92",      0},
+  {"thicksim",                        "\xE2\x88\xBC",      0},
+  {"NestedGreaterGreater",            "\xE2\x89\xAB",      0},
+  {"sqcaps",                          "\xE2\x8A\x93\xEF\xB8\x80", 0},
+  {"exponentiale",                    "\xE2\x85\x87",      0},
+  {"tcedil",                          "\xC5\xA3",          0},
+  {"asympeq",                         "\xE2\x89\x8D",      0},
+  {"vBarv",                           "\xE2\xAB\xA9",      0},
+  {"ncap",                            "\xE2\xA9\x83",      0},
+  {"efr",                             "\xF0\x9D\x94\xA2",  0},
+  {"ldquor",                          "\xE2\x80\x9E",      0},
+  {"aring",                           "\xC3\xA5",          1},
+  {"NotLess",                         "\xE2\x89\xAE",      0},
+  {"rbrkslu",                         "\xE2\xA6\x90",      0},
+  {"asymp",                           "\xE2\x89\x88",      1},
+  {"hookrightarrow",                  "\xE2\x86\xAA",      0},
+  {"yopf",                            "\xF0\x9D\x95\xAA",  0},
+  {"hellip",                          "\xE2\x80\xA6",      1},
+  {"there4",                          "\xE2\x88\xB4",      1},
+  {"doteqdot",                        "\xE2\x89\x91",      0},
+  {"Vdash",                           "\xE2\x8A\xA9",      0},
+  {"utilde",                          "\xC5\xA9",          0},
+  {"eg",                              "\xE2\xAA\x9A",      0},
+  {"nang",                            "\xE2\x88\xA0\xE2\x83\x92", 0},
+  {"veeeq",                           "\xE2\x89\x9A",      0},
+  {"nlarr",                           "\xE2\x86\x9A",      0},
+  {"gE",                              "\xE2\x89\xA7",      0},
+  {"Wedge",                           "\xE2\x8B\x80",      0},
+  {"Bcy",                             "\xD0\x91",          0},
+  {"lsqb",                            "[",                 0},
+  {"in",                              "\xE2\x88\x88",      0},
+  {"vdash",                           "\xE2\x8A\xA2",      0},
+  {"smallsetminus",                   "\xE2\x88\x96",      0},
+  {"harrw",                           "\xE2\x86\xAD",      0},
+  {"DownLeftVectorBar",               "\xE2\xA5\x96",      0},
+  {"Product",                         "\xE2\x88\x8F",      0},
+  {"tshcy",                           "\xD1\x9B",          0},
+  {"cuesc",                           "\xE2\x8B\x9F",      0},
+  {"zscr",                            "\xF0\x9D\x93\x8F",  0},
+  {"Star",                            "\xE2\x8B\x86",      0},
+  {"gesdot",                          "\xE2\xAA\x80",      0},
+  {"notnivc",                         "\xE2\x8B\xBD",      0},
+  {"straightepsilon",                 "\xCF\xB5",          0},
+  {"wedbar",                          "\xE2\xA9\x9F",      0},
+  {"tau",                             "\xCF\x84",          1},
+  {"Pr",                              "\xE2\xAA\xBB",      0},
+  {"gel",                             "\xE2\x8B\x9B",      0},
+  {"circledast",                      "\xE2\x8A\x9B",      0},
+  {"RightTeeVector",                  "\xE2\xA5\x9B",      0},
+  {"InvisibleComma",                  "\xE2\x81\xA3",      0},
+  {"upuparrows",                      "\xE2\x87\x88",      0},
+  {"olarr",                           "\xE2\x86\xBA",      0},
+  {"subseteq",                        "\xE2\x8A\x86",      0},
+  {"Agrave",                          "\xC3\x80",          1},
+  {"lbrke",                           "\xE2\xA6\x8B",      0},
+  {"LeftUpVector",                    "\xE2\x86\xBF",      0},
+  {"lesseqgtr",                       "\xE2\x8B\x9A",      0},
+  {"MediumSpace",                     "\xE2\x81\x9F",      0},
+  {"wedge",                           "\xE2\x88\xA7",      0},
+  {"nsim",                            "\xE2\x89\x81",      0},
+  {"ffilig",                          "\xEF\xAC\x83",      0},
+  {"subsim",                          "\xE2\xAB\x87",      0},
+  {"wcirc",                           "\xC5\xB5",          0},
+  {"Longrightarrow",                  "\xE2\x9F\xB9",      0},
+  {"DiacriticalGrave",                "`",                 0},
+  {"not",                             "\xC2\xAC",          1},
+  {"ngtr",                            "\xE2\x89\xAF",      0},
+  {"bNot",                            "\xE2\xAB\xAD",      0},
+  {"Backslash",                       "\xE2\x88\x96",      0},
+  {"prop",                            "\xE2\x88\x9D",      1},
+  {"YIcy",                            "\xD0\x87",          0},
+  {"Tab",                             "\x09",              0},
+  {"quest",                           "?",                 0},
+  {"micro",                           "\xC2\xB5",          1},
+  {"kappa",                           "\xCE\xBA",          1},
+  {"plusdo",                          "\xE2\x88\x94",      0},
+  {"lnsim",                           "\xE2\x8B\xA6",      0},
+  {"pointint",                        "\xE2\xA8\x95",      0},
+  {"iacute",                          "\xC3\xAD",          1},
+  {"diam",                            "\xE2\x8B\x84",      0},
+  {"raemptyv",                        "\xE2\xA6\xB3",      0},
+  {"colon",                           ":",                 0},
+  {"gEl",                             "\xE2\xAA\x8C",      0},
+  {"eqvparsl",                        "\xE2\xA7\xA5",      0},
+  {"sbquo",                           "\xE2\x80\x9A",      1},
+  {"lnap",                            "\xE2\xAA\x89",      0},
+  {"bigtriangleup",                   "\xE2\x96\xB3",      0},
+  {"profsurf",                        "\xE2\x8C\x93",      0},
+  {"ddotseq",                         "\xE2\xA9\xB7",      0},
+  {"Beta",                            "\xCE\x92",          1},
+  {"kcy",                             "\xD0\xBA",          0},
+  {"larrtl",                          "\xE2\x86\xA2",      0},
+  {"SHcy",                            "\xD0\xA8",          0},
+  {"UpArrowDownArrow",                "\xE2\x87\x85",      0},
+  {"oslash",                          "\xC3\xB8",          1},
+  {"Edot",                            "\xC4\x96",          0},
+  {"notinva",                         "\xE2\x88\x89",      0},
+  {"lbrkslu",                         "\xE2\xA6\x8D",      0},
+  {"nsc",                             "\xE2\x8A\x81",      0},
+  {"imath",                           "\xC4\xB1",          0},
+  {"rarrb",                           "\xE2\x87\xA5",      0},
+  {"drbkarow",                        "\xE2\xA4\x90",      0},
+  {"Lstrok",                          "\xC5\x81",          0},
+  {"tosa",                            "\xE2\xA4\xA9",      0},
+  {"pluse",                           "\xE2\xA9\xB2",      0},
+  {"dArr",                            "\xE2\x87\x93",      1},
+  {"infin",                           "\xE2\x88\x9E",      1},
+  {"centerdot",                       "\xC2\xB7",          0},
+  {"Square",                          "\xE2\x96\xA1",      0},
+  {"ShortLeftArrow",                  "\xE2\x86\x90",      0},
+  {"map",                             "\xE2\x86\xA6",      0},
+  {"ccedil",                          "\xC3\xA7",          1},
+  {"HumpDownHump",                    "\xE2\x89\x8E",      0},
+  {"LeftTriangle",                    "\xE2\x8A\xB2",      0},
+  {"odot",                            "\xE2\x8A\x99",      0},
+  {"NotNestedLessLess",               "\xE2\xAA\xA1\xCC\xB8", 0},
+  {"risingdotseq",                    "\xE2\x89\x93",      0},
+  {"SquareSupersetEqual",             "\xE2\x8A\x92",      0},
+  {"rang",                            "\xE2\x9F\xA9",      1},
+  {"plusacir",                        "\xE2\xA8\xA3",      0},
+  {"upsi",                            "\xCF\x85",          0},
+  {"qfr",                             "\xF0\x9D\x94\xAE",  0},
+  {"bigcirc",                         "\xE2\x97\xAF",      0},
+  {"rbrksld",                         "\xE2\xA6\x8E",      0},
+  {"para",                            "\xC2\xB6",          1},
+  {"simrarr",                         "\xE2\xA5\xB2",      0},
+  {"UnderParenthesis",                "\xE2\x8F\x9D",      0},
+  {"squarf",                          "\xE2\x96\xAA",      0},
+  {"zeta",                            "\xCE\xB6",          1},
+  {"cupbrcap",                        "\xE2\xA9\x88",      0},
+  {"ell",                             "\xE2\x84\x93",      0},
+  {"Zfr",                             "\xE2\x84\xA8",      0},
+  {"hksearow",                        "\xE2\xA4\xA5",      0},
+  {"Omicron",                         "\xCE\x9F",          1},
+  {"bowtie",                          "\xE2\x8B\x88",      0},
+  {"epsi",                            "\xCE\xB5",          0},
+  {"Bopf",                            "\xF0\x9D\x94\xB9",  0},
+  {"gnap",                            "\xE2\xAA\x8A",      0},
+  {"percnt",                          "%",                 0},
+  {"eplus",                           "\xE2\xA9\xB1",      0},
+  {"vltri",                           "\xE2\x8A\xB2",      0},
+  {"lbarr",                           "\xE2\xA4\x8C",      0},
+  {"vnsub",                           "\xE2\x8A\x82\xE2\x83\x92", 0},
+  {"ltlarr",                          "\xE2\xA5\xB6",      0},
+  {"OpenCurlyQuote",                  "\xE2\x80\x98",      0},
+  {"gdot",                            "\xC4\xA1",          0},
+  {"bumpE",                           "\xE2\xAA\xAE",      0},
+  {"UpArrowBar",                      "\xE2\xA4\x92",      0},
+  {"circ",                            "\xCB\x86",          1},
+  {"RightVectorBar",                  "\xE2\xA5\x93",      0},
+  {"oelig",                           "\xC5\x93",          1},
+  {"bcy",                             "\xD0\xB1",          0},
+  {"jsercy",                          "\xD1\x98",          0},
+  {"nearhk",                          "\xE2\xA4\xA4",      0},
+  {"reals",                           "\xE2\x84\x9D",      0},
+  {"lbrksld",                         "\xE2\xA6\x8F",      0},
+  {"gap",                             "\xE2\xAA\x86",      0},
+  {"nsupe",                           "\xE2\x8A\x89",      0},
+  {"gescc",                           "\xE2\xAA\xA9",      0},
+  {"DownLeftVector",                  "\xE2\x86\xBD",      0},
+  {"sqsub",                           "\xE2\x8A\x8F",      0},
+  {"RightTriangleEqual",              "\xE2\x8A\xB5",      0},
+  {"dotsquare",                       "\xE2\x8A\xA1",      0},
+  {"Epsilon",                         "\xCE\x95",          1},
+  {"ntilde",                          "\xC3\xB1",          1},
+  {"amalg",                           "\xE2\xA8\xBF",      0},
+  {"Im",                              "\xE2\x84\x91",      0},
+  {"blacktriangledown",               "\xE2\x96\xBE",      0},
+  {"rdsh",                            "\xE2\x86\xB3",      0},
+  {"Fscr",                            "\xE2\x84\xB1",      0},
+  {"bsolhsub",                        "\xE2\x9F\x88",      0},
+  {"nsmid",                           "\xE2\x88\xA4",      0},
+  {"Ecy",                             "\xD0\xAD",          0},
+  {"emacr",                           "\xC4\x93",          0},
+  {"esim",                            "\xE2\x89\x82",      0},
+  {"nscr",                            "\xF0\x9D\x93\x83",  0},
+  {"frac12",                          "\xC2\xBD",          1},
+  {"langle",                          "\xE2\x9F\xA8",      0},
+  {"rightsquigarrow",                 "\xE2\x86\x9D",      0},
+  {"oline",                           "\xE2\x80\xBE",      1},
+  {"Gfr",                             "\xF0\x9D\x94\x8A",  0},
+  {"vartriangleright",                "\xE2\x8A\xB3",      0},
+  {"ofr",                             "\xF0\x9D\x94\xAC",  0},
+  {"subrarr",                         "\xE2\xA5\xB9",      0},
+  {"ngsim",                           "\xE2\x89\xB5",      0},
+  {"lpar",                            "(",                 0},
+  {"lesg",                            "\xE2\x8B\x9A\xEF\xB8\x80", 0},
+  {"rHar",                            "\xE2\xA5\xA4",      0},
+  {"epsilon",                         "\xCE\xB5",          1},
+  {"DScy",                            "\xD0\x85",          0},
+  {"andv",                            "\xE2\xA9\x9A",      0},
+  {"Cacute",                          "\xC4\x86",          0},
+  {"Ecirc",                           "\xC3\x8A",          1},
+  {"boxVh",                           "\xE2\x95\xAB",      0},
+  {"imagline",                        "\xE2\x84\x90",      0},
+  {"ETH",                             "\xC3\x90",          1},
+  {"hyphen",                          "\xE2\x80\x90",      0},
+  {"int",                             "\xE2\x88\xAB",      1},
+  {"profalar",                        "\xE2\x8C\xAE",      0},
+  {"rsqb",                            "]",                 0},
+  {"Re",                              "\xE2\x84\x9C",      0},
+  {"robrk",                           "\xE2\x9F\xA7",      0},
+  {"ast",                             "*",                 0},
+  {"dscy",                            "\xD1\x95",          0},
+  {"euro",                            "\xE2\x82\xAC",      1},
+  {"rightleftharpoons",               "\xE2\x87\x8C",      0},
+  {"dash",                            "\xE2\x80\x90",      0},
+  {"kjcy",                            "\xD1\x9C",          0},
+  {"ogt",                             "\xE2\xA7\x81",      0},
+  {"backcong",                        "\xE2\x89\x8C",      0},
+  {"lnapprox",                        "\xE2\xAA\x89",      0},
+  {"subE",                            "\xE2\xAB\x85",      0},
+  {"ndash",                           "\xE2\x80\x93",      1},
+  {"NotLeftTriangleEqual",            "\xE2\x8B\xAC",      0},
+  {"oror",                            "\xE2\xA9\x96",      0},
+  {"glj",                             "\xE2\xAA\xA4",      0},
+  {"cirmid",                          "\xE2\xAB\xAF",      0},
+  {"cudarrl",                         "\xE2\xA4\xB8",      0},
+  {"Ecaron",                          "\xC4\x9A",          0},
+  {"veebar",                          "\xE2\x8A\xBB",      0},
+  {"subset",                          "\xE2\x8A\x82",      0},
+  {"IEcy",                            "\xD0\x95",          0},
+  {"lesseqqgtr",                      "\xE2\xAA\x8B",      0},
+  {"ropar",                           "\xE2\xA6\x86",      0},
+  {"cong",                            "\xE2\x89\x85",      1},
+  {"Ccaron",                          "\xC4\x8C",          0},
+  {"gtrdot",                          "\xE2\x8B\x97",      0},
+  {"GreaterEqual",                    "\xE2\x89\xA5",      0},
+  {"tcaron",                          "\xC5\xA5",          0},
+  {"Vbar",                            "\xE2\xAB\xAB",      0},
+  {"iogon",                           "\xC4\xAF",          0},
+  {"GreaterFullEqual",                "\xE2\x89\xA7",      0},
+  {"nvrtrie",                         "\xE2\x8A\xB5\xE2\x83\x92", 0},
+  {"Xi",                              "\xCE\x9E",          1},
+  {"Tilde",                           "\xE2\x88\xBC",      0},
+  {"ll",                              "\xE2\x89\xAA",      0},
+  {"lrhard",                          "\xE2\xA5\xAD",      0},
+  {"Lfr",                             "\xF0\x9D\x94\x8F",  0},
+  {"uarr",                            "\xE2\x86\x91",      1},
+  {"boxvH",                           "\xE2\x95\xAA",      0},
+  {"permil",                          "\xE2\x80\xB0",      1},
+  {"lambda",                          "\xCE\xBB",          1},
+  {"divideontimes",                   "\xE2\x8B\x87",      0},
+  {"ccaps",                           "\xE2\xA9\x8D",      0},
+  {"dtrif",                           "\xE2\x96\xBE",      0},
+  {"varsubsetneqq",                   "\xE2\xAB\x8B\xEF\xB8\x80", 0},
+  {"eth",                             "\xC3\xB0",          1},
+  {"mapsto",                          "\xE2\x86\xA6",      0},
+  {"boxUr",                           "\xE2\x95\x99",      0},
+  {"ovbar",                           "\xE2\x8C\xBD",      0},
+  {"longleftarrow",                   "\xE2\x9F\xB5",      0},
+  {"dotminus",                        "\xE2\x88\xB8",      0},
+  {"neArr",                           "\xE2\x87\x97",      0},
+  {"laemptyv",                        "\xE2\xA6\xB4",      0},
+  {"Dopf",                            "\xF0\x9D\x94\xBB",  0},
+  {"Hcirc",                           "\xC4\xA4",          0},
+  {"swarrow",                         "\xE2\x86\x99",      0},
+  {"NotExists",                       "\xE2\x88\x84",      0},
+  {"fnof",                            "\xC6\x92",          1},
+  {"Gamma",                           "\xCE\x93",          1},
+  {"roplus",                          "\xE2\xA8\xAE",      0},
+  {"sigmaf",                          "\xCF\x82",          1},
+  {"Rscr",                            "\xE2\x84\x9B",      0},
+  {"commat",                          "@",                 0},
+  {"els",                             "\xE2\xAA\x95",      0},
+  {"itilde",                          "\xC4\xA9",          0},
+  {"Sup",                             "\xE2\x8B\x91",      0},
+  {"kappav",                          "\xCF\xB0",          0},
+  {"Ocy",                             "\xD0\x9E",          0},
+  {"minusdu",                         "\xE2\xA8\xAA",      0},
+  {"Vdashl",                          "\xE2\xAB\xA6",      0},
+  {"Upsi",                            "\xCF\x92",          0},
+  {"strns",                           "\xC2\xAF",          0},
+  {"TRADE",                           "\xE2\x84\xA2",      0},
+  {"lfr",                             "\xF0\x9D\x94\xA9",  0},
+  {"Eogon",                           "\xC4\x98",          0},
+  {"forkv",                           "\xE2\xAB\x99",      0},
+  {"qscr",                            "\xF0\x9D\x93\x86",  0},
+  {"supsim",                          "\xE2\xAB\x88",      0},
+  {"eqcolon",                         "\xE2\x89\x95",      0},
+  {"siml",                            "\xE2\xAA\x9D",      0},
+  {"ldsh",                            "\xE2\x86\xB2",      0},
+  {"Rang",                            "\xE2\x9F\xAB",      0},
+  {"LeftFloor",                       "\xE2\x8C\x8A",      0},
+  {"ENG",                             "\xC5\x8A",          0},
+  {"geqq",                            "\xE2\x89\xA7",      0},
+  {"nopf",                            "\xF0\x9D\x95\x9F",  0},
+  {"supE",                            "\xE2\xAB\x86",      0},
+  {"ffr",                             "\xF0\x9D\x94\xA3",  0},
+  {"csup",                            "\xE2\xAB\x90",      0},
+  {"RuleDelayed",                     "\xE2\xA7\xB4",      0},
+  {"Iogon",                           "\xC4\xAE",          0},
+  {"ImaginaryI",                      "\xE2\x85\x88",      0},
+  {"upharpoonleft",                   "\xE2\x86\xBF",      0},
+  {"acd",                             "\xE2\x88\xBF",      0},
+  {"tilde",                           "\xCB\x9C",          1},
+  {"Vcy",                             "\xD0\x92",          0},
+  {"sacute",                          "\xC5\x9B",          0},
+  {"Equal",                           "\xE2\xA9\xB5",      0},
+  {"Ccirc",                           "\xC4\x88",          0},
+  {"plusdu",                          "\xE2\xA8\xA5",      0},
+  {"NotSquareSuperset",               "\xE2\x8A\x90\xCC\xB8", 0},
+  {"ange",                            "\xE2\xA6\xA4",      0},
+  {"nshortmid",                       "\xE2\x88\xA4",      0},
+  {"tridot",                          "\xE2\x97\xAC",      0},
+  {"LeftUpDownVector",                "\xE2\xA5\x91",      0},
+  {"Proportion",                      "\xE2\x88\xB7",      0},
+  {"lstrok",                          "\xC5\x82",          0},
+  {"AElig",                           "\xC3\x86",          1},
+  {"thetasym",                        "\xCF\x91",          1},
+  {"Uparrow",                         "\xE2\x87\x91",      0},
+  {"luruhar",                         "\xE2\xA5\xA6",      0},
+  {"ssetmn",                          "\xE2\x88\x96",      0},
+  {"larr",                            "\xE2\x86\x90",      1},
+  {"orderof",                         "\xE2\x84\xB4",      0},
+  {"vsubnE",                          "\xE2\xAB\x8B\xEF\xB8\x80", 0},
+  {"LeftDownTeeVector",               "\xE2\xA5\xA1",      0},
+  {"ic",                              "\xE2\x81\xA3",      0},
+  {"ZHcy",                            "\xD0\x96",          0},
+  {"Zcaron",                          "\xC5\xBD",          0},
+  {"LowerLeftArrow",                  "\xE2\x86\x99",      0},
+  {"Jscr",                            "\xF0\x9D\x92\xA5",  0},
+  {"sup1",                            "\xC2\xB9",          1},
+  {"ZeroWidthSpace",                  "\xE2\x80\x8B",      0},
+  {"LessEqualGreater",                "\xE2\x8B\x9A",      0},
+  {"LeftDownVector",                  "\xE2\x87\x83",      0},
+  {"udarr",                           "\xE2\x87\x85",      0},
+  {"SucceedsSlantEqual",              "\xE2\x89\xBD",      0},
+  {"lmoustache",                      "\xE2\x8E\xB0",      0},
+  {"coloneq",                         "\xE2\x89\x94",      0},
+  {"tscr",                            "\xF0\x9D\x93\x89",  0},
+  {"varpropto",                       "\xE2\x88\x9D",      0},
+  {"clubsuit",                        "\xE2\x99\xA3",      0},
+  {"Gt",                              "\xE2\x89\xAB",      0},
+  {"orslope",                         "\xE2\xA9\x97",      0},
+  {"subne",                           "\xE2\x8A\x8A",      0},
+  {"copf",                            "\xF0\x9D\x95\x94",  0},
+  {"boxhu",                           "\xE2\x94\xB4",      0},
+  {"VerticalSeparator",               "\xE2\x9D\x98",      0},
+  {"bdquo",                           "\xE2\x80\x9E",      1},
+  {"OverBar",                         "\xE2\x80\xBE",      0},
+  {"equest",                          "\xE2\x89\x9F",      0},
+  {"submult",                         "\xE2\xAB\x81",      0},
+  {"Qopf",                            "\xE2\x84\x9A",      0},
+  {"Ropf",                            "\xE2\x84\x9D",      0},
+  {"NotLeftTriangleBar",              "\xE2\xA7\x8F\xCC\xB8", 0},
+  {"fjlig",                           "fj",                0},
+  {"olcir",                           "\xE2\xA6\xBE",      0},
+  {"subsetneq",                       "\xE2\x8A\x8A",      0},
+  {"eopf",                            "\xF0\x9D\x95\x96",  0},
+  {"angrtvb",                         "\xE2\x8A\xBE",      0},
+  {"female",                          "\xE2\x99\x80",      0},
+  {"isindot",                         "\xE2\x8B\xB5",      0},
+  {"ordf",                            "\xC2\xAA",          1},
+  {"Icy",                             "\xD0\x98",          0},
+  {"excl",                            "!",                 0},
+  {"lAarr",                           "\xE2\x87\x9A",      0},
+  {"nsqsupe",                         "\xE2\x8B\xA3",      0},
+  {"thkap",                           "\xE2\x89\x88",      0},
+  {"rightarrowtail",                  "\xE2\x86\xA3",      0},
+  {"varphi",                          "\xCF\x95",          0},
+  {"rightarrow",                      "\xE2\x86\x92",      0},
+  {"planck",                          "\xE2\x84\x8F",      0},
+  {"numsp",                           "\xE2\x80\x87",      0},
+  {"fork",                            "\xE2\x8B\x94",      0},
+  {"VerticalTilde",                   "\xE2\x89\x80",      0},
+  {"rarrtl",                          "\xE2\x86\xA3",      0},
+  {"looparrowright",                  "\xE2\x86\xAC",      0},
+  {"rfloor",                          "\xE2\x8C\x8B",      1},
+  {"dotplus",                         "\xE2\x88\x94",      0},
+  {"tfr",                             "\xF0\x9D\x94\xB1",  0},
+  {"nwArr",                           "\xE2\x87\x96",      0},
+  {"exist",                           "\xE2\x88\x83",      1},
+  {"Idot",                            "\xC4\xB0",          0},
+  {"top",                             "\xE2\x8A\xA4",      0},
+  {"NotDoubleVerticalBar",            "\xE2\x88\xA6",      0},
+  {"bernou",                          "\xE2\x84\xAC",      0},
+  {"aleph",                           "\xE2\x84\xB5",      0},
+  {"imacr",                           "\xC4\xAB",          0},
+  {"NotRightTriangleEqual",           "\xE2\x8B\xAD",      0},
+  {"gvnE",                            "\xE2\x89\xA9\xEF\xB8\x80", 0},
+  {"Bscr",                            "\xE2\x84\xAC",      0},
+  {"sopf",                            "\xF0\x9D\x95\xA4",  0},
+  {"gesles",                          "\xE2\xAA\x94",      0},
+  {"xotime",                          "\xE2\xA8\x82",      0},
+  {"nsqsube",                         "\xE2\x8B\xA2",      0},
+  {"scsim",                           "\xE2\x89\xBF",      0},
+  {"boxhD",                           "\xE2\x95\xA5",      0},
+  {"rsquo",                           "\xE2\x80\x99",      1},
+  {"blk34",                           "\xE2\x96\x93",      0},
+  {"bigcup",                          "\xE2\x8B\x83",      0},
+  {"DotEqual",                        "\xE2\x89\x90",      0},
+  {"lbbrk",                           "\xE2\x9D\xB2",      0},
+  {"ltrie",                           "\xE2\x8A\xB4",      0},
+  {"spades",                          "\xE2\x99\xA0",      1},
+  {"Otimes",                          "\xE2\xA8\xB7",      0},
+  {"disin",                           "\xE2\x8B\xB2",      0},
+  {"ldrdhar",                         "\xE2\xA5\xA7",      0},
+  {"utdot",                           "\xE2\x8B\xB0",      0},
+  {"sdot",                            "\xE2\x8B\x85",      1},
+  {"nLtv",                            "\xE2\x89\xAA\xCC\xB8", 0},
+  {"hamilt",                          "\xE2\x84\x8B",      0},
+  {"NotPrecedesEqual",                "\xE2\xAA\xAF\xCC\xB8", 0},
+  {"uring",                           "\xC5\xAF",          0},
+  {"rarrbfs",                         "\xE2\xA4\xA0",      0},
+  {"Sacute",                          "\xC5\x9A",          0},
+  {"spar",                            "\xE2\x88\xA5",      0},
+  {"Vopf",                            "\xF0\x9D\x95\x8D",  0},
+  {"Mu",                              "\xCE\x9C",          1},
+  {"supdsub",                         "\xE2\xAB\x98",      0},
+  {"LessTilde",                       "\xE2\x89\xB2",      0},
+  {"piv",                             "\xCF\x96",          1},
+  {"boxvh",                           "\xE2\x94\xBC",      0},
+  {"Oacute",                          "\xC3\x93",          1},
+  {"Pcy",                             "\xD0\x9F",          0},
+  {"midast",                          "*",                 0},
+  {"lltri",                           "\xE2\x97\xBA",      0},
+  {"Egrave",                          "\xC3\x88",          1},
+  {"ltcir",                           "\xE2\xA9\xB9",      0},
+  {"caps",                            "\xE2\x88\xA9\xEF\xB8\x80", 0},
+  {"rbrace",                          "}",                 0},
+  {"napos",                           "\xC5\x89",          0},
+  {"Bumpeq",                          "\xE2\x89\x8E",      0},
+  {"Tcy",                             "\xD0\xA2",          0},
+  {"Eacute",                          "\xC3\x89",          1},
+  {"gnsim",                           "\xE2\x8B\xA7",      0},
+  {"succnapprox",                     "\xE2\xAA\xBA",      0},
+  {"gsime",                           "\xE2\xAA\x8E",      0},
+  {"intprod",                         "\xE2\xA8\xBC",      0},
+  {"boxdR",                           "\xE2\x95\x92",      0},
+  {"lharul",                          "\xE2\xA5\xAA",      0},
+  {"andd",                            "\xE2\xA9\x9C",      0},
+  {"boxvR",                           "\xE2\x95\x9E",      0},
+  {"xodot",                           "\xE2\xA8\x80",      0},
+  {"nrarrc",                          "\xE2\xA4\xB3\xCC\xB8", 0},
+  {"Colone",                          "\xE2\xA9\xB4",      0},
+  {"numero",                          "\xE2\x84\x96",      0},
+  {"phmmat",                          "\xE2\x84\xB3",      0},
+  {"longrightarrow",                  "\xE2\x9F\xB6",      0},
+  {"triangleright",                   "\xE2\x96\xB9",      0},
+  {"hookleftarrow",                   "\xE2\x86\xA9",      0},
+  {"ubrcy",                           "\xD1\x9E",          0},
+  {"mumap",                           "\xE2\x8A\xB8",      0},
+  {"notni",                           "\xE2\x88\x8C",      0},
+  {"rharul",                          "\xE2\xA5\xAC",      0},
+  {"Wfr",                             "\xF0\x9D\x94\x9A",  0},
+  {"NotVerticalBar",                  "\xE2\x88\xA4",      0},
+  {"subseteqq",                       "\xE2\xAB\x85",      0},
+  {"bigodot",                         "\xE2\xA8\x80",      0},
+  {"UpTee",                           "\xE2\x8A\xA5",      0},
+  {"forall",                          "\xE2\x88\x80",      1},
+  {"shchcy",                          "\xD1\x89",          0},
+  {"curlyvee",                        "\xE2\x8B\x8E",      0},
+  {"DoubleUpArrow",                   "\xE2\x87\x91",      0},
+  {"sqcup",                           "\xE2\x8A\x94",      0},
+  {"nvinfin",                         "\xE2\xA7\x9E",      0},
+  {"NotSquareSubsetEqual",            "\xE2\x8B\xA2",      0},
+  {"Iscr",                            "\xE2\x84\x90",      0},
+  {"NotEqual",                        "\xE2\x89\xA0",      0},
+  {"iiint",                           "\xE2\x88\xAD",      0},
+  {"Chi",                             "\xCE\xA7",          1},
+  {"rx",                              "\xE2\x84\x9E",      0},
+  {"triangle",                        "\xE2\x96\xB5",      0},
+  {"gjcy",                            "\xD1\x93",          0},
+  {"vscr",                            "\xF0\x9D\x93\x8B",  0},
+  {"notnivb",                         "\xE2\x8B\xBE",      0},
+  {"odiv",                            "\xE2\xA8\xB8",      0},
+  {"isinsv",                          "\xE2\x8B\xB3",      0},
+  {"DoubleLeftRightArrow",            "\xE2\x87\x94",      0},
+  {"gvertneqq",                       "\xE2\x89\xA9\xEF\xB8\x80", 0},
+  {"nsup",                            "\xE2\x8A\x85",      0},
+  {"rhard",                           "\xE2\x87\x81",      0},
+  {"vprop",                           "\xE2\x88\x9D",      0},
+  {"acy",                             "\xD0\xB0",          0},
+  {"verbar",                          "|",                 0},
+  {"gt",                              ">",                 1},
+  {"ntrianglerighteq",                "\xE2\x8B\xAD",      0},
+  {"Rrightarrow",                     "\xE2\x87\x9B",      0},
+  {"ni",                              "\xE2\x88\x8B",      1},
+  {"LeftDoubleBracket",               "\xE2\x9F\xA6",      0},
+  {"LeftVectorBar",                   "\xE2\xA5\x92",      0},
+  {"subdot",                          "\xE2\xAA\xBD",      0},
+  {"Aopf",                            "\xF0\x9D\x94\xB8",  0},
+  {"ntrianglelefteq",                 "\xE2\x8B\xAC",      0},
+  {"pluscir",                         "\xE2\xA8\xA2",      0},
+  {"breve",                           "\xCB\x98",          0},
+  {"euml",                            "\xC3\xAB",          1},
+  {"geq",                             "\xE2\x89\xA5",      0},
+  {"circleddash",                     "\xE2\x8A\x9D",      0},
+  {"approx",                          "\xE2\x89\x88",      0},
+  {"nsubset",                         "\xE2\x8A\x82\xE2\x83\x92", 0},
+  {"profline",                        "\xE2\x8C\x92",      0},
+  {"Pfr",                             "\xF0\x9D\x94\x93",  0},
+  {"mscr",                            "\xF0\x9D\x93\x82",  0},
+  {"Cscr",                            "\xF0\x9D\x92\x9E",  0},
+  {"sup3",                            "\xC2\xB3",          1},
+  {"rho",                             "\xCF\x81",          1},
+  {"nsupE",                           "\xE2\xAB\x86\xCC\xB8", 0},
+  {"pr",                              "\xE2\x89\xBA",      0},
+  {"dot",                             "\xCB\x99",          0},
+  {"supsup",                          "\xE2\xAB\x96",      0},
+  {"topbot",                          "\xE2\x8C\xB6",      0},
+  {"semi",                            ";",                 0},
+  {"lesdot",                          "\xE2\xA9\xBF",      0},
+  {"jfr",                             "\xF0\x9D\x94\xA7",  0},
+  {"nbsp",                            "\xC2\xA0",          1},
+  {"qprime",                          "\xE2\x81\x97",      0},
+  {"leftrightarrows",                 "\xE2\x87\x86",      0},
+  {"subsup",                          "\xE2\xAB\x93",      0},
+  {"lat",                             "\xE2\xAA\xAB",      0},
+  {"scpolint",                        "\xE2\xA8\x93",      0},
+  {"circledcirc",                     "\xE2\x8A\x9A",      0},
+  {"larrb",                           "\xE2\x87\xA4",      0},
+  {"eqsim",                           "\xE2\x89\x82",      0},
+  {"ultri",                           "\xE2\x97\xB8",      0},
+  {"UnderBrace",                      "\xE2\x8F\x9F",      0},
+  {"LongRightArrow",                  "\xE2\x9F\xB6",      0},
+  {"rbbrk",                           "\xE2\x9D\xB3",      0},
+  {"nVDash",                          "\xE2\x8A\xAF",      0},
+  {"mnplus",                          "\xE2\x88\x93",      0},
+  {"nsimeq",                          "\xE2\x89\x84",      0},
+  {"sqsupe",                          "\xE2\x8A\x92",      0},
+  {"DiacriticalDot",                  "\xCB\x99",          0},
+  {"VeryThinSpace",                   "\xE2\x80\x8A",      0},
+  {"Atilde",                          "\xC3\x83",          1},
+  {"drcrop",                          "\xE2\x8C\x8C",      0},
+  {"Cross",                           "\xE2\xA8\xAF",      0},
+  {"olcross",                         "\xE2\xA6\xBB",      0},
+  {"varrho",                          "\xCF\xB1",          0},
+  {"vBar",                            "\xE2\xAB\xA8",      0},
+  {"NotLeftTriangle",                 "\xE2\x8B\xAA",      0},
+  {"zigrarr",                         "\xE2\x87\x9D",      0},
+  {"elsdot",                          "\xE2\xAA\x97",      0},
+  {"Hscr",                            "\xE2\x84\x8B",      0},
+  {"lEg",                             "\xE2\xAA\x8B",      0},
+  {"RBarr",                           "\xE2\xA4\x90",      0},
+  {"hArr",                            "\xE2\x87\x94",      1},
+  {"cross",                           "\xE2\x9C\x97",      0},
+  {"Zscr",                            "\xF0\x9D\x92\xB5",  0},
+  {"angrt",                           "\xE2\x88\x9F",      0},
+  {"boxuR",                           "\xE2\x95\x98",      0},
+  {"NestedLessLess",                  "\xE2\x89\xAA",      0},
+  {"angmsd",                          "\xE2\x88\xA1",      0},
+  {"DownTee",                         "\xE2\x8A\xA4",      0},
+  {"iocy",                            "\xD1\x91",          0},
+  {"primes",                          "\xE2\x84\x99",      0},
+  {"real",                            "\xE2\x84\x9C",      1},
+  {"TildeFullEqual",                  "\xE2\x89\x85",      0},
+  {"NotTildeEqual",                   "\xE2\x89\x84",      0},
+  {"harrcir",                         "\xE2\xA5\x88",      0},
+  {"upsilon",                         "\xCF\x85",          1},
+  {"rbrke",                           "\xE2\xA6\x8C",      0},
+  {"hbar",                            "\xE2\x84\x8F",      0},
+  {"Uuml",                            "\xC3\x9C",          1},
+  {"Emacr",                           "\xC4\x92",          0},
+  {"larrpl",                          "\xE2\xA4\xB9",      0},
+  {"ufisht",                          "\xE2\xA5\xBE",      0},
+  {"lgE",                             "\xE2\xAA\x91",      0},
+  {"SHCHcy",                          "\xD0\xA9",          0},
+  {"searhk",                          "\xE2\xA4\xA5",      0},
+  {"NotCongruent",                    "\xE2\x89\xA2",      0},
+  {"timesbar",                        "\xE2\xA8\xB1",      0},
+  {"beta",                            "\xCE\xB2",          1},
+  {"ltdot",                           "\xE2\x8B\x96",      0},
+  {"Fcy",                             "\xD0\xA4",          0},
+  {"gtreqless",                       "\xE2\x8B\x9B",      0},
+  {"rppolint",                        "\xE2\xA8\x92",      0},
+  {"comp",                            "\xE2\x88\x81",      0},
+  {"rpar",                            ")",                 0},
+  {"Mscr",                            "\xE2\x84\xB3",      0},
+  {"nparsl",                          "\xE2\xAB\xBD\xE2\x83\xA5", 0},
+  {"VDash",                           "\xE2\x8A\xAB",      0},
+  {"bprime",                          "\xE2\x80\xB5",      0},
+  {"swArr",                           "\xE2\x87\x99",      0},
+  {"triminus",                        "\xE2\xA8\xBA",      0},
+  {"qint",                            "\xE2\xA8\x8C",      0},
+  {"PrecedesTilde",                   "\xE2\x89\xBE",      0},
+  {"leqslant",                        "\xE2\xA9\xBD",      0},
+  {"sqsup",                           "\xE2\x8A\x90",      0},
+  {"Uarr",                            "\xE2\x86\x9F",      0},
+  {"cuwed",                           "\xE2\x8B\x8F",      0},
+  {"ltrif",                           "\xE2\x97\x82",      0},
+  {"nless",                           "\xE2\x89\xAE",      0},
+  {"SucceedsTilde",                   "\xE2\x89\xBF",      0},
+  {"ulcrop",                          "\xE2\x8C\x8F",      0},
+  {"boxvL",                           "\xE2\x95\xA1",      0},
+  {"varsigma",                        "\xCF\x82",          0},
+  {"urcorn",                          "\xE2\x8C\x9D",      0},
+  {"topf",                            "\xF0\x9D\x95\xA5",  0},
+  {"nvlArr",                          "\xE2\xA4\x82",      0},
+  {"gtrsim",                          "\xE2\x89\xB3",      0},
+  {"rcub",                            "}",                 0},
+  {"lhblk",                           "\xE2\x96\x84",      0},
+  {"nlArr",                           "\xE2\x87\x8D",      0},
+  {"COPY",                            "\xC2\xA9",          1},
+  {"dollar",                          "$",                 0},
+  {"iuml",                            "\xC3\xAF",          1},
+  {"NotTildeTilde",                   "\xE2\x89\x89",      0},
+  {"ngeqq",                           "\xE2\x89\xA7\xCC\xB8", 0},
+  {"Mcy",                             "\xD0\x9C",          0},
+  {"GreaterGreater",                  "\xE2\xAA\xA2",      0},
+  {"precnapprox",                     "\xE2\xAA\xB9",      0},
+  {"mDDot",                           "\xE2\x88\xBA",      0},
+  {"npart",                           "\xE2\x88\x82\xCC\xB8", 0},
+  {"bigstar",                         "\xE2\x98\x85",      0},
+  {"rsh",                             "\xE2\x86\xB1",      0},
+  {"tscy",                            "\xD1\x86",          0},
+  {"deg",                             "\xC2\xB0",          1},
+  {"GreaterTilde",                    "\xE2\x89\xB3",      0},
+  {"thorn",                           "\xC3\xBE",          1},
+  {"srarr",                           "\xE2\x86\x92",      0},
+  {"HARDcy",                          "\xD0\xAA",          0},
+  {"Dcaron",                          "\xC4\x8E",          0},
+  {"bkarow",                          "\xE2\xA4\x8D",      0},
+  {"Dcy",                             "\xD0\x94",          0},
+  {"langd",                           "\xE2\xA6\x91",      0},
+  {"ddagger",                         "\xE2\x80\xA1",      0},
+  {"notin",                           "\xE2\x88\x89",      1},
+  {"beth",                            "\xE2\x84\xB6",      0},
+  {"plus",                            "+",                 0},
+  {"Ntilde",                          "\xC3\x91",          1},
+  {"nle",                             "\xE2\x89\xB0",      0},
+  {"Psi",                             "\xCE\xA8",          1},
+  {"mcy",                             "\xD0\xBC",          0},
+  {"Amacr",                           "\xC4\x80",          0},
+  {"ascr",                            "\xF0\x9D\x92\xB6",  0},
+  {"mho",                             "\xE2\x84\xA7",      0},
+  {"nsce",                            "\xE2\xAA\xB0\xCC\xB8", 0},
+  {"Implies",                         "\xE2\x87\x92",      0},
+  {"prsim",                           "\xE2\x89\xBE",      0},
+  {"nsupset",                         "\xE2\x8A\x83\xE2\x83\x92", 0},
+  {"planckh",                         "\xE2\x84\x8E",      0},
+  {"dlcorn",                          "\xE2\x8C\x9E",      0},
+  {"yicy",                            "\xD1\x97",          0},
+  {"rarrfs",                          "\xE2\xA4\x9E",      0},
+  {"Fopf",                            "\xF0\x9D\x94\xBD",  0},
+  {"nu",                              "\xCE\xBD",          1},
+  {"nshortparallel",                  "\xE2\x88\xA6",      0},
+  {"boxtimes",                        "\xE2\x8A\xA0",      0},
+  {"nVdash",                          "\xE2\x8A\xAE",      0},
+  {"nesear",                          "\xE2\xA4\xA8",      0},
+  {"CloseCurlyDoubleQuote",           "\xE2\x80\x9D",      0},
+  {"blk14",                           "\xE2\x96\x91",      0},
+  {"tbrk",                            "\xE2\x8E\xB4",      0},
+  {"lap",                             "\xE2\xAA\x85",      0},
+  {"Zeta",                            "\xCE\x96",          1},
+  {"awint",                           "\xE2\xA8\x91",      0},
+  {"Xfr",                             "\xF0\x9D\x94\x9B",  0},
+  {"nearrow",                         "\xE2\x86\x97",      0},
+  {"DownArrow",                       "\xE2\x86\x93",      0},
+  {"HorizontalLine",                  "\xE2\x94\x80",      0},
+  {"supsub",                          "\xE2\xAB\x94",      0},
+  {"lopar",                           "\xE2\xA6\x85",      0},
+  {"prurel",                          "\xE2\x8A\xB0",      0},
+  {"LeftUpVectorBar",                 "\xE2\xA5\x98",      0},
+  {"Sum",                             "\xE2\x88\x91",      0},
+  {"ugrave",                          "\xC3\xB9",          1},
+  {"rangle",                          "\xE2\x9F\xA9",      0},
+  {"lscr",                            "\xF0\x9D\x93\x81",  0},
+  {"Iacute",                          "\xC3\x8D",          1},
+  {"frac23",                          "\xE2\x85\x94",      0},
+  {"qopf",                            "\xF0\x9D\x95\xA2",  0},
+  {"LeftRightArrow",                  "\xE2\x86\x94",      0},
+  {"subnE",                           "\xE2\xAB\x8B",      0},
+  {"ntriangleleft",                   "\xE2\x8B\xAA",      0},
+  {"bigotimes",                       "\xE2\xA8\x82",      0},
+  {"Tscr",                            "\xF0\x9D\x92\xAF",  0},
+  {"nharr",                           "\xE2\x86\xAE",      0},
+  {"RightTriangle",                   "\xE2\x8A\xB3",      0},
+  {"order",                           "\xE2\x84\xB4",      0},
+  {"ncongdot",                        "\xE2\xA9\xAD\xCC\xB8", 0},
+  {"uhblk",                           "\xE2\x96\x80",      0},
+  {"dashv",                           "\xE2\x8A\xA3",      0},
+  {"popf",                            "\xF0\x9D\x95\xA1",  0},
+  {"Gdot",                            "\xC4\xA0",          0},
+  {"fllig",                           "\xEF\xAC\x82",      0},
+  {"oplus",                           "\xE2\x8A\x95",      1},
+  {"gnE",                             "\xE2\x89\xA9",      0},
+  {"circledR",                        "\xC2\xAE",          0},
+  {"rationals",                       "\xE2\x84\x9A",      0},
+  {"shortmid",                        "\xE2\x88\xA3",      0},
+  {"Abreve",                          "\xC4\x82",          0},
+  {"uscr",                            "\xF0\x9D\x93\x8A",  0},
+  {"UpEquilibrium",                   "\xE2\xA5\xAE",      0},
+  {"gsim",                            "\xE2\x89\xB3",      0},
+  {"icirc",                           "\xC3\xAE",          1},
+  {"lates",                           "\xE2\xAA\xAD\xEF\xB8\x80", 0},
+  {"die",                             "\xC2\xA8",          0},
+  {"NotNestedGreaterGreater",         "\xE2\xAA\xA2\xCC\xB8", 0},
+  {"ncaron",                          "\xC5\x88",          0},
+  {"biguplus",                        "\xE2\xA8\x84",      0},
+  {"rAarr",                           "\xE2\x87\x9B",      0},
+  {"Jcy",                             "\xD0\x99",          0},
+  {"scE",                             "\xE2\xAA\xB4",      0},
+  {"rdldhar",                         "\xE2\xA5\xA9",      0},
+  {"weierp",                          "\xE2\x84\x98",      1},
+  {"frac45",                          "\xE2\x85\x98",      0},
+  {"RightArrow",                      "\xE2\x86\x92",      0},
+  {"caron",                           "\xCB\x87",          0},
+  {"Ocirc",                           "\xC3\x94",          1},
+  {"npre",                            "\xE2\xAA\xAF\xCC\xB8", 0},
+  {"dzigrarr",                        "\xE2\x9F\xBF",      0},
+  {"NotGreaterFullEqual",             "\xE2\x89\xA7\xCC\xB8", 0},
+  {"emsp13",                          "\xE2\x80\x84",      0},
+  {"looparrowleft",                   "\xE2\x86\xAB",      0},
+  {"NotLessLess",                     "\xE2\x89\xAA\xCC\xB8", 0},
+  {"RoundImplies",                    "\xE2\xA5\xB0",      0},
+  {"ouml",                            "\xC3\xB6",          1},
+  {"Mopf",                            "\xF0\x9D\x95\x84",  0},
+  {"Nfr",                             "\xF0\x9D\x94\x91",  0},
+  {"OverBracket",                     "\xE2\x8E\xB4",      0},
+  {"RightDownTeeVector",              "\xE2\xA5\x9D",      0},
+  {"Cdot",                            "\xC4\x8A",          0},
+  {"ltimes",                          "\xE2\x8B\x89",      0},
+  {"gnapprox",                        "\xE2\xAA\x8A",      0},
+  {"ratail",                          "\xE2\xA4\x9A",      0},
+  {"Sub",                             "\xE2\x8B\x90",      0},
+  {"ltrPar",                          "\xE2\xA6\x96",      0},
+  {"lcy",                             "\xD0\xBB",          0},
+  {"lagran",                          "\xE2\x84\x92",      0},
+  {"jcy",                             "\xD0\xB9",          0},
+  {"rscr",                            "\xF0\x9D\x93\x87",  0},
+  {"Leftarrow",                       "\xE2\x87\x90",      0},
+  {"npolint",                         "\xE2\xA8\x94",      0},
+  {"mstpos",                          "\xE2\x88\xBE",      0},
+  {"cularr",                          "\xE2\x86\xB6",      0},
+  {"lsquo",                           "\xE2\x80\x98",      1},
+  {"multimap",                        "\xE2\x8A\xB8",      0},
+  {"twoheadrightarrow",               "\xE2\x86\xA0",      0},
+  {"frown",                           "\xE2\x8C\xA2",      0},
+  {"ecir",                            "\xE2\x89\x96",      0},
+  {"mp",                              "\xE2\x88\x93",      0},
+  {"nrightarrow",                     "\xE2\x86\x9B",      0},
+  {"checkmark",                       "\xE2\x9C\x93",      0},
+  {"Uogon",                           "\xC5\xB2",          0},
+  {"complexes",                       "\xE2\x84\x82",      0},
+  {"Cfr",                             "\xE2\x84\xAD",      0},
+  {"nvltrie",                         "\xE2\x8A\xB4\xE2\x83\x92", 0},
+  {"dwangle",                         "\xE2\xA6\xA6",      0},
+  {"curvearrowleft",                  "\xE2\x86\xB6",      0},
+  {"edot",                            "\xC4\x97",          0},
+  {"Qfr",                             "\xF0\x9D\x94\x94",  0},
+  {"oint",                            "\xE2\x88\xAE",      0},
+  {"boxDL",                           "\xE2\x95\x97",      0},
+  {"sub",                             "\xE2\x8A\x82",      1},
+  {"bnot",                            "\xE2\x8C\x90",      0},
+  {"hcirc",                           "\xC4\xA5",          0},
+  {"xoplus",                          "\xE2\xA8\x81",      0},
+  {"NonBreakingSpace",                "\xC2\xA0",          0},
+  {"oast",                            "\xE2\x8A\x9B",      0},
+  {"Hfr",                             "\xE2\x84\x8C",      0},
+  {"bemptyv",                         "\xE2\xA6\xB0",      0},
+  {"ctdot",                           "\xE2\x8B\xAF",      0},
+  {"subsub",                          "\xE2\xAB\x95",      0},
+  {"succapprox",                      "\xE2\xAA\xB8",      0},
+  {"mfr",                             "\xF0\x9D\x94\xAA",  0},
+  {"Lcy",                             "\xD0\x9B",          0},
+  {"gtrapprox",                       "\xE2\xAA\x86",      0},
+  {"angmsdad",                        "\xE2\xA6\xAB",      0},
+  {"urtri",                           "\xE2\x97\xB9",      0},
+  {"rarrpl",                          "\xE2\xA5\x85",      0},
+  {"diamond",                         "\xE2\x8B\x84",      0},
+  {"minusb",                          "\xE2\x8A\x9F",      0},
+  {"Wopf",                            "\xF0\x9D\x95\x8E",  0},
+  {"trade",                           "\xE2\x84\xA2",      1},
+  {"Del",                             "\xE2\x88\x87",      0},
+  {"uacute",                          "\xC3\xBA",          1},
+  {"olt",                             "\xE2\xA7\x80",      0},
+  {"NotSucceedsTilde",                "\xE2\x89\xBF\xCC\xB8", 0},
+  {"prnE",                            "\xE2\xAA\xB5",      0},
+  {"LeftTeeArrow",                    "\xE2\x86\xA4",      0},
+  {"gtcir",                           "\xE2\xA9\xBA",      0},
+  {"LessSlantEqual",                  "\xE2\xA9\xBD",      0},
+  {"elinters",                        "\xE2\x8F\xA7",      0},
+  {"Cconint",                         "\xE2\x88\xB0",      0},
+  {"lesdoto",                         "\xE2\xAA\x81",      0},
+  {"notinE",                          "\xE2\x8B\xB9\xCC\xB8", 0},
+  {"RightUpVector",                   "\xE2\x86\xBE",      0},
+  {"rharu",                           "\xE2\x87\x80",      0},
+  {"nwarhk",                          "\xE2\xA4\xA3",      0},
+  {"dlcrop",                          "\xE2\x8C\x8D",      0},
+  {"notinvc",                         "\xE2\x8B\xB6",      0},
+  {"lhard",                           "\xE2\x86\xBD",      0},
+  {"boxuL",                           "\xE2\x95\x9B",      0},
+  {"mid",                             "\xE2\x88\xA3",      0},
+  {"rlhar",                           "\xE2\x87\x8C",      0},
+  {"sqsupseteq",                      "\xE2\x8A\x92",      0},
+  {"gtdot",                           "\xE2\x8B\x97",      0},
+  {"cups",                            "\xE2\x88\xAA\xEF\xB8\x80", 0},
+  {"supseteq",                        "\xE2\x8A\x87",      0},
+  {"lneq",                            "\xE2\xAA\x87",      0},
+  {"pscr",                            "\xF0\x9D\x93\x85",  0},
+  {"Jsercy",                          "\xD0\x88",          0},
+  {"Kscr",                            "\xF0\x9D\x92\xA6",  0},
+  {"smt",                             "\xE2\xAA\xAA",      0},
+  {"rlarr",                           "\xE2\x87\x84",      0},
+  {"ohbar",                           "\xE2\xA6\xB5",      0},
+  {"xlArr",                           "\xE2\x9F\xB8",      0},
+  {"swarr",                           "\xE2\x86\x99",      0},
+  {"rthree",                          "\xE2\x8B\x8C",      0},
+  {"Ograve",                          "\xC3\x92",          1},
+  {"Rho",                             "\xCE\xA1",          1},
+  {"nrarrw",                          "\xE2\x86\x9D\xCC\xB8", 0},
+  {"bne",                             "=\xE2\x83\xA5",     0},
+  {"timesb",                          "\xE2\x8A\xA0",      0},
+  {"curlyeqprec",                     "\xE2\x8B\x9E",      0},
+  {"angmsdaa",                        "\xE2\xA6\xA8",      0},
+  {"part",                            "\xE2\x88\x82",      1},
+  {"Yuml",                            "\xC5\xB8",          1},
+  {"erarr",                           "\xE2\xA5\xB1",      0},
+  {"hoarr",                           "\xE2\x87\xBF",      0},
+  {"becaus",                          "\xE2\x88\xB5",      0},
+  {"PartialD",                        "\xE2\x88\x82",      0},
+  {"bsim",                            "\xE2\x88\xBD",      0},
+  {"Ycirc",                           "\xC5\xB6",          0},
+  {"eta",                             "\xCE\xB7",          1},
+  {"nearr",                           "\xE2\x86\x97",      0},
+  {"NoBreak",                         "\xE2\x81\xA0",      0},
+  {"orarr",                           "\xE2\x86\xBB",      0},
+  {"supseteqq",                       "\xE2\xAB\x86",      0},
+  {"LeftTeeVector",                   "\xE2\xA5\x9A",      0},
+  {"precsim",                         "\xE2\x89\xBE",      0},
+  {"gtquest",                         "\xE2\xA9\xBC",      0},
+  {"CircleDot",                       "\xE2\x8A\x99",      0},
+  {"nvlt",                            "<\xE2\x83\x92",     0},
+  {"Scirc",                           "\xC5\x9C",          0},
+  {"LongLeftArrow",                   "\xE2\x9F\xB5",      0},
+  {"nabla",                           "\xE2\x88\x87",      1},
+  {"rarr",                            "\xE2\x86\x92",      1},
+  {"rAtail",                          "\xE2\xA4\x9C",      0},
+  {"boxv",                            "\xE2\x94\x82",      0},
+  {"andslope",                        "\xE2\xA9\x98",      0},
+  {"bull",                            "\xE2\x80\xA2",      1},
+  {"CloseCurlyQuote",                 "\xE2\x80\x99",      0},
+  {"larrhk",                          "\xE2\x86\xA9",      0},
+  {"rtrie",                           "\xE2\x8A\xB5",      0},
+  {"lcaron",                          "\xC4\xBE",          0},
+  {"topcir",                          "\xE2\xAB\xB1",      0},
+  {"odsold",                          "\xE2\xA6\xBC",      0},
+  {"lne",                             "\xE2\xAA\x87",      0},
+  {"times",                           "\xC3\x97",          1},
+  {"lrarr",                           "\xE2\x87\x86",      0},
+  {"DiacriticalDoubleAcute",          "\xCB\x9D",          0},
+  {"acirc",                           "\xC3\xA2",          1},
+  {"boxH",                            "\xE2\x95\x90",      0},
+  {"questeq",                         "\xE2\x89\x9F",      0},
+  {"boxbox",                          "\xE2\xA7\x89",      0},
+  {"nrArr",                           "\xE2\x87\x8F",      0},
+  {"bullet",                          "\xE2\x80\xA2",      0},
+  {"boxhd",                           "\xE2\x94\xAC",      0},
+  {"capbrcup",                        "\xE2\xA9\x89",      0},
+  {"CapitalDifferentialD",            "\xE2\x85\x85",      0},
+  {"nequiv",                          "\xE2\x89\xA2",      0},
+  {"NotSucceeds",                     "\xE2\x8A\x81",      0},
+  {"updownarrow",                     "\xE2\x86\x95",      0},
+  {"ycy",                             "\xD1\x8B",          0},
+  {"xscr",                            "\xF0\x9D\x93\x8D",  0},
+  {"Acy",                             "\xD0\x90",          0},
+  {"angmsdaf",                        "\xE2\xA6\xAD",      0},
+  {"diams",                           "\xE2\x99\xA6",      1},
+  {"triangledown",                    "\xE2\x96\xBF",      0},
+  {"Dscr",                            "\xF0\x9D\x92\x9F",  0},
+  {"barvee",                          "\xE2\x8A\xBD",      0},
+  {"Prime",                           "\xE2\x80\xB3",      1},
+  {"boxHu",                           "\xE2\x95\xA7",      0},
+  {"nsupseteqq",                      "\xE2\xAB\x86\xCC\xB8", 0},
+  {"hybull",                          "\xE2\x81\x83",      0},
+  {"succeq",                          "\xE2\xAA\xB0",      0},
+  {"omega",                           "\xCF\x89",          1},
+  {"perp",                            "\xE2\x8A\xA5",      1},
+  {"Vscr",                            "\xF0\x9D\x92\xB1",  0},
+  {"Colon",                           "\xE2\x88\xB7",      0},
+  {"nltri",                           "\xE2\x8B\xAA",      0},
+  {"mapstoup",                        "\xE2\x86\xA5",      0},
+  {"propto",                          "\xE2\x88\x9D",      0},
+  {"Tstrok",                          "\xC5\xA6",          0},
+  {"ReverseEquilibrium",              "\xE2\x87\x8B",      0},
+  {"lcedil",                          "\xC4\xBC",          0},
+  {"congdot",                         "\xE2\xA9\xAD",      0},
+  {"scnE",                            "\xE2\xAA\xB6",      0},
+  {"duarr",                           "\xE2\x87\xB5",      0},
+  {"lArr",                            "\xE2\x87\x90",      1},
+  {"ges",                             "\xE2\xA9\xBE",      0},
+  {"utri",                            "\xE2\x96\xB5",      0},
+  {"boxVH",                           "\xE2\x95\xAC",      0},
+  {"lHar",                            "\xE2\xA5\xA2",      0},
+  {"ltri",                            "\xE2\x97\x83",      0},
+  {"iscr",                            "\xF0\x9D\x92\xBE",  0},
+  {"Gcedil",                          "\xC4\xA2",          0},
+  {"gesdoto",                         "\xE2\xAA\x82",      0},
+  {"approxeq",                        "\xE2\x89\x8A",      0},
+  {"kgreen",                          "\xC4\xB8",          0},
+  {"bbrk",                            "\xE2\x8E\xB5",      0},
+  {"RightTriangleBar",                "\xE2\xA7\x90",      0},
+  {"Yacute",                          "\xC3\x9D",          1},
+  {"OElig",                           "\xC5\x92",          1},
+  {"Zcy",                             "\xD0\x97",          0},
+  {"ljcy",                            "\xD1\x99",          0},
+  {"ContourIntegral",                 "\xE2\x88\xAE",      0},
+  {"minus",                           "\xE2\x88\x92",      1},
+  {"Pscr",                            "\xF0\x9D\x92\xAB",  0},
+  {"Odblac",                          "\xC5\x90",          0},
+  {"Intersection",                    "\xE2\x8B\x82",      0},
+  {"lAtail",                          "\xE2\xA4\x9B",      0},
+  {"Hstrok",                          "\xC4\xA6",          0},
+  {"gamma",                           "\xCE\xB3",          1},
+  {"ccaron",                          "\xC4\x8D",          0},
+  {"ShortUpArrow",                    "\xE2\x86\x91",      0},
+  {"opar",                            "\xE2\xA6\xB7",      0},
+  {"Ubreve",                          "\xC5\xAC",          0},
+  {"thksim",                          "\xE2\x88\xBC",      0},
+  {"jcirc",                           "\xC4\xB5",          0},
+  {"kscr",                            "\xF0\x9D\x93\x80",  0},
+  {"Oslash",                          "\xC3\x98",          1},
+  {"llcorner",                        "\xE2\x8C\x9E",      0},
+  {"boxur",                           "\xE2\x94\x94",      0},
+  {"succcurlyeq",                     "\xE2\x89\xBD",      0},
+  {"square",                          "\xE2\x96\xA1",      0},
+  {"Nacute",                          "\xC5\x83",          0},
+  {"LowerRightArrow",                 "\xE2\x86\x98",      0},
+  {"Cedilla",                         "\xC2\xB8",          0},
+  {"frac16",                          "\xE2\x85\x99",      0},
+  {"odash",                           "\xE2\x8A\x9D",      0},
+  {"iprod",                           "\xE2\xA8\xBC",      0},
+  {"notinvb",                         "\xE2\x8B\xB7",      0},
+  {"prE",                             "\xE2\xAA\xB3",      0},
+  {"DoubleVerticalBar",               "\xE2\x88\xA5",      0},
+  {"bump",                            "\xE2\x89\x8E",      0},
+  {"imagpart",                        "\xE2\x84\x91",      0},
+  {"Proportional",                    "\xE2\x88\x9D",      0},
+  {"wr",                              "\xE2\x89\x80",      0},
+  {"ii",                              "\xE2\x85\x88",      0},
+  {"lrhar",                           "\xE2\x87\x8B",      0},
+  {"NotPrecedes",                     "\xE2\x8A\x80",      0},
+  {"UpTeeArrow",                      "\xE2\x86\xA5",      0},
+  {"npar",                            "\xE2\x88\xA6",      0},
+  {"pm",                              "\xC2\xB1",          0},
+  {"boxh",                            "\xE2\x94\x80",      0},
+  {"raquo",                           "\xC2\xBB",          1},
+  {"ncy",                             "\xD0\xBD",          0},
+  {"boxVr",                           "\xE2\x95\x9F",      0},
+  {"Aring",                           "\xC3\x85",          1},
+  {"uwangle",                         "\xE2\xA6\xA7",      0},
+  {"cylcty",                          "\xE2\x8C\xAD",      0},
+  {"gcirc",                           "\xC4\x9D",          0},
+  {"RightTee",                        "\xE2\x8A\xA2",      0},
+  {"frac25",                          "\xE2\x85\x96",      0},
+  {"Bernoullis",                      "\xE2\x84\xAC",      0},
+  {"Zopf",                            "\xE2\x84\xA4",      0},
+  {"eogon",                           "\xC4\x99",          0},
+  {"gtreqqless",                      "\xE2\xAA\x8C",      0},
+  {"yucy",                            "\xD1\x8E",          0},
+  {"Esim",                            "\xE2\xA9\xB3",      0},
+  {"loarr",                           "\xE2\x87\xBD",      0},
+  {"Conint",                          "\xE2\x88\xAF",      0},
+  {"prime",                           "\xE2\x80\xB2",      1},
+  {"NotSubsetEqual",                  "\xE2\x8A\x88",      0},
+  {"sfrown",                          "\xE2\x8C\xA2",      0},
+  {"vcy",                             "\xD0\xB2",          0},
+  {"Yfr",                             "\xF0\x9D\x94\x9C",  0},
+  {"longleftrightarrow",              "\xE2\x9F\xB7",      0},
+  {"gneq",                            "\xE2\xAA\x88",      0},
+  {"emptyset",                        "\xE2\x88\x85",      0},
+  {"fopf",                            "\xF0\x9D\x95\x97",  0},
+  {"seswar",                          "\xE2\xA4\xA9",      0},
+  {"nge",                             "\xE2\x89\xB1",      0},
+  {"fltns",                           "\xE2\x96\xB1",      0},
+  {"xnis",                            "\xE2\x8B\xBB",      0},
+  {"tritime",                         "\xE2\xA8\xBB",      0},
+  {"rcaron",                          "\xC5\x99",          0},
+  {"RightUpTeeVector",                "\xE2\xA5\x9C",      0},
+  {"cupor",                           "\xE2\xA9\x85",      0},
+  {"iinfin",                          "\xE2\xA7\x9C",      0},
+  {"curlywedge",                      "\xE2\x8B\x8F",      0},
+  {"leftleftarrows",                  "\xE2\x87\x87",      0},
+  {"RightDoubleBracket",              "\xE2\x9F\xA7",      0},
+  {"epar",                            "\xE2\x8B\x95",      0},
+  {"squf",                            "\xE2\x96\xAA",      0},
+  {"latail",                          "\xE2\xA4\x99",      0},
+  {"isinE",                           "\xE2\x8B\xB9",      0},
+  {"rBarr",                           "\xE2\xA4\x8F",      0},
+  {"Barwed",                          "\xE2\x8C\x86",      0},
+  {"NewLine",                         "\x0A",              0},
+  {"Iuml",                            "\xC3\x8F",          1},
+  {"nap",                             "\xE2\x89\x89",      0},
+  {"grave",                           "`",                 0},
+  {"NotTildeFullEqual",               "\xE2\x89\x87",      0},
+  {"gneqq",                           "\xE2\x89\xA9",      0},
+  {"smile",                           "\xE2\x8C\xA3",      0},
+  {"prnsim",                          "\xE2\x8B\xA8",      0},
+  {"curarrm",                         "\xE2\xA4\xBC",      0},
+  {"ffllig",                          "\xEF\xAC\x84",      0},
+  {"hstrok",                          "\xC4\xA7",          0},
+  {"Rfr",                             "\xE2\x84\x9C",      0},
+  {"TildeEqual",                      "\xE2\x89\x83",      0},
+  {"rceil",                           "\xE2\x8C\x89",      1},
+  {"bumpe",                           "\xE2\x89\x8F",      0},
+  {"ycirc",                           "\xC5\xB7",          0},
+  {"diamondsuit",                     "\xE2\x99\xA6",      0},
+  {"RightUpVectorBar",                "\xE2\xA5\x94",      0},
+  {"lesges",                          "\xE2\xAA\x93",      0},
+  {"lsim",                            "\xE2\x89\xB2",      0},
+  {"realpart",                        "\xE2\x84\x9C",      0},
+  {"omicron",                         "\xCE\xBF",          1},
+  {"UpArrow",                         "\xE2\x86\x91",      0},
+  {"hslash",                          "\xE2\x84\x8F",      0},
+  {"ldca",                            "\xE2\xA4\xB6",      0},
+  {"doublebarwedge",                  "\xE2\x8C\x86",      0},
+  {"uharl",                           "\xE2\x86\xBF",      0},
+  {"RightDownVector",                 "\xE2\x87\x82",      0},
+  {"telrec",                          "\xE2\x8C\x95",      0},
+  {"darr",                            "\xE2\x86\x93",      1},
+  {"Tcaron",                          "\xC5\xA4",          0},
+  {"prnap",                           "\xE2\xAA\xB9",      0},
+  {"sfr",                             "\xF0\x9D\x94\xB0",  0},
+  {"aopf",                            "\xF0\x9D\x95\x92",  0},
+  {"thinsp",                          "\xE2\x80\x89",      1},
+  {"lE",                              "\xE2\x89\xA6",      0},
+  {"Ll",                              "\xE2\x8B\x98",      0},
+  {"frac38",                          "\xE2\x85\x9C",      0},
+  {"zfr",                             "\xF0\x9D\x94\xB7",  0},
+  {"sce",                             "\xE2\xAA\xB0",      0},
+  {"backsim",                         "\xE2\x88\xBD",      0},
+  {"sqsubseteq",                      "\xE2\x8A\x91",      0},
+  {"andand",                          "\xE2\xA9\x95",      0},
+  {"lBarr",                           "\xE2\xA4\x8E",      0},
+  {"Alpha",                           "\xCE\x91",          1},
+  {"expectation",                     "\xE2\x84\xB0",      0},
+  {"Verbar",                          "\xE2\x80\x96",      0},
+  {"male",                            "\xE2\x99\x82",      0},
+  {"urcrop",                          "\xE2\x8C\x8E",      0},
+  {"lsime",                           "\xE2\xAA\x8D",      0},
+  {"sect",                            "\xC2\xA7",          1},
+  {"cupdot",                          "\xE2\x8A\x8D",      0},
+  {"quot",                            "\x22",              1},
+  {"Tfr",                             "\xF0\x9D\x94\x97",  0},
+  {"tcy",                             "\xD1\x82",          0},
+  {"egs",                             "\xE2\xAA\x96",      0},
+  {"ograve",                          "\xC3\xB2",          1},
+  {"subsetneqq",                      "\xE2\xAB\x8B",      0},
+  {"simlE",                           "\xE2\xAA\x9F",      0},
+  {"otimesas",                        "\xE2\xA8\xB6",      0},
+  {"psi",                             "\xCF\x88",          1},
+  {"xlarr",                           "\xE2\x9F\xB5",      0},
+  {"roang",                           "\xE2\x9F\xAD",      0},
+  {"THORN",                           "\xC3\x9E",          1},
+  {"TScy",                            "\xD0\xA6",          0},
+  {"hopf",                            "\xF0\x9D\x95\x99",  0},
+  {"rtriltri",                        "\xE2\xA7\x8E",      0},
+  {"igrave",                          "\xC3\xAC",          1},
+  {"DotDot",                          "\xE2\x83\x9C",      0},
+  {"isins",                           "\xE2\x8B\xB4",      0},
+  {"OverParenthesis",                 "\xE2\x8F\x9C",      0},
+  {"ThinSpace",                       "\xE2\x80\x89",      0},
+  {"nldr",                            "\xE2\x80\xA5",      0},
+  {"cirE",                            "\xE2\xA7\x83",      0},
+  {"Vvdash",                          "\xE2\x8A\xAA",      0},
+  {"simeq",                           "\xE2\x89\x83",      0},
+  {"Precedes",                        "\xE2\x89\xBA",      0},
+  {"lg",                              "\xE2\x89\xB6",      0},
+  {"isin",                            "\xE2\x88\x88",      1},
+  {"HilbertSpace",                    "\xE2\x84\x8B",      0},
+  {"Rarr",                            "\xE2\x86\xA0",      0},
+  {"NotLessGreater",                  "\xE2\x89\xB8",      0},
+  {"YAcy",                            "\xD0\xAF",          0},
+  {"empty",                           "\xE2\x88\x85",      1},
+  {"Ifr",                             "\xE2\x84\x91",      0},
+  {"boxVR",                           "\xE2\x95\xA0",      0},
+  {"scaron",                          "\xC5\xA1",          1},
+  {"ncedil",                          "\xC5\x86",          0},
+  {"ac",                              "\xE2\x88\xBE",      0},
+  {"horbar",                          "\xE2\x80\x95",      0},
+  {"supe",                            "\xE2\x8A\x87",      1},
+  {"Copf",                            "\xE2\x84\x82",      0},
+  {"DoubleDot",                       "\xC2\xA8",          0},
+  {"ap",                              "\xE2\x89\x88",      0},
+  {"angsph",                          "\xE2\x88\xA2",      0},
+  {"nleq",                            "\xE2\x89\xB0",      0},
+  {"UpperLeftArrow",                  "\xE2\x86\x96",      0},
+  {"xcap",                            "\xE2\x8B\x82",      0},
+  {"ecaron",                          "\xC4\x9B",          0},
+  {"triangleq",                       "\xE2\x89\x9C",      0},
+  {"atilde",                          "\xC3\xA3",          1},
+  {"topfork",                         "\xE2\xAB\x9A",      0},
+  {"RightArrowLeftArrow",             "\xE2\x87\x84",      0},
+  {"leqq",                            "\xE2\x89\xA6",      0},
+  {"rarrsim",                         "\xE2\xA5\xB4",      0},
+  {"Ycy",                             "\xD0\xAB",          0},
+  {"nrarr",                           "\xE2\x86\x9B",      0},
+  {"smte",                            "\xE2\xAA\xAC",      0},
+  {"lopf",                            "\xF0\x9D\x95\x9D",  0},
+  {"squ",                             "\xE2\x96\xA1",      0},
+  {"angmsdac",                        "\xE2\xA6\xAA",      0},
+  {"flat",                            "\xE2\x99\xAD",      0},
+  {"rdquo",                           "\xE2\x80\x9D",      1},
+  {"ntgl",                            "\xE2\x89\xB9",      0},
+  {"nisd",                            "\xE2\x8B\xBA",      0},
+  {"nLl",                             "\xE2\x8B\x98\xCC\xB8", 0},
+  {"ApplyFunction",                   "\xE2\x81\xA1",      0},
+  {"bigtriangledown",                 "\xE2\x96\xBD",      0},
+  {"Longleftrightarrow",              "\xE2\x9F\xBA",      0},
+  {"bot",                             "\xE2\x8A\xA5",      0},
+  {"Supset",                          "\xE2\x8B\x91",      0},
+  {"gla",                             "\xE2\xAA\xA5",      0},
+  {"llarr",                           "\xE2\x87\x87",      0},
+  {"xi",                              "\xCE\xBE",          1},
+  {"Lcedil",                          "\xC4\xBB",          0},
+  {"uopf",                            "\xF0\x9D\x95\xA6",  0},
+  {"cwint",                           "\xE2\x88\xB1",      0},
+  {"boxhU",                           "\xE2\x95\xA8",      0},
+  {"nedot",                           "\xE2\x89\x90\xCC\xB8", 0},
+  {"pound",                           "\xC2\xA3",          1},
+  {"odblac",                          "\xC5\x91",          0},
+  {"brvbar",                          "\xC2\xA6",          1},
+  {"uparrow",                         "\xE2\x86\x91",      0},
+  {"ulcorn",                          "\xE2\x8C\x9C",      0},
+  {"lsquor",                          "\xE2\x80\x9A",      0},
+  {"doteq",                           "\xE2\x89\x90",      0},
+  {"mapstoleft",                      "\xE2\x86\xA4",      0},
+  {"barwedge",                        "\xE2\x8C\x85",      0},
+  {"race",                            "\xE2\x88\xBD\xCC\xB1", 0},
+  {"parallel",                        "\xE2\x88\xA5",      0},
+  {"sharp",                           "\xE2\x99\xAF",      0},
+  {"boxVl",                           "\xE2\x95\xA2",      0},
+  {"bopf",                            "\xF0\x9D\x95\x93",  0},
+  {"image",                           "\xE2\x84\x91",      1},
+  {"acE",                             "\xE2\x88\xBE\xCC\xB3", 0},
+  {"dscr",                            "\xF0\x9D\x92\xB9",  0},
+  {"Scy",                             "\xD0\xA1",          0},
+  {"vert",                            "|",                 0},
+  {"Sopf",                            "\xF0\x9D\x95\x8A",  0},
+  {"dfisht",                          "\xE2\xA5\xBF",      0},
+  {"plustwo",                         "\xE2\xA8\xA7",      0},
+  {"uharr",                           "\xE2\x86\xBE",      0},
+  {"Uarrocir",                        "\xE2\xA5\x89",      0},
+  {"SquareSubset",                    "\xE2\x8A\x8F",      0},
+  {"equivDD",                         "\xE2\xA9\xB8",      0},
+  {"ccups",                           "\xE2\xA9\x8C",      0},
+  {"thickapprox",                     "\xE2\x89\x88",      0},
+  {"SmallCircle",                     "\xE2\x88\x98",      0},
+  {"omacr",                           "\xC5\x8D",          0},
+  {"frac15",                          "\xE2\x85\x95",      0},
+  {"lcub",                            "{",                 0},
+  {"LeftTriangleEqual",               "\xE2\x8A\xB4",      0},
+  {"Nu",                              "\xCE\x9D",          1},
+  {"NotGreaterGreater",               "\xE2\x89\xAB\xCC\xB8", 0},
+  {"cap",                             "\xE2\x88\xA9",      1},
+  {"llhard",                          "\xE2\xA5\xAB",      0},
+  {"icy",                             "\xD0\xB8",          0},
+  {"nsucc",                           "\xE2\x8A\x81",      0},
+  {"SubsetEqual",                     "\xE2\x8A\x86",      0},
+  {"boxUl",                           "\xE2\x95\x9C",      0},
+  {"ltquest",                         "\xE2\xA9\xBB",      0},
+  {"searr",                           "\xE2\x86\x98",      0},
+  {"oS",                              "\xE2\x93\x88",      0},
+  {"measuredangle",                   "\xE2\x88\xA1",      0},
+  {"roarr",                           "\xE2\x87\xBE",      0},
+  {"lbrace",                          "{",                 0},
+  {"rcedil",                          "\xC5\x97",          0},
+  {"lrtri",                           "\xE2\x8A\xBF",      0},
+  {"GreaterLess",                     "\xE2\x89\xB7",      0},
+  {"supdot",                          "\xE2\xAA\xBE",      0},
+  {"div",                             "\xC3\xB7",          0},
+  {"copy",                            "\xC2\xA9",          1},
+  {"Uring",                           "\xC5\xAE",          0},
+  {"chi",                             "\xCF\x87",          1},
+  {"NotSuperset",                     "\xE2\x8A\x83\xE2\x83\x92", 0},
+  {"boxdr",                           "\xE2\x94\x8C",      0},
+  {"Diamond",                         "\xE2\x8B\x84",      0},
+  {"curren",                          "\xC2\xA4",          1},
+  {"DZcy",                            "\xD0\x8F",          0},
+  {"DownArrowBar",                    "\xE2\xA4\x93",      0},
+  {"NotRightTriangleBar",             "\xE2\xA7\x90\xCC\xB8", 0},
+  {"ijlig",                           "\xC4\xB3",          0},
+  {"gtcc",                            "\xE2\xAA\xA7",      0},
+  {"nsubE",                           "\xE2\xAB\x85\xCC\xB8", 0},
+  {"epsiv",                           "\xCF\xB5",          0},
+  {"djcy",                            "\xD1\x92",          0},
+  {"nleftrightarrow",                 "\xE2\x86\xAE",      0},
+  {"sigmav",                          "\xCF\x82",          0},
+  {"wedgeq",                          "\xE2\x89\x99",      0},
+  {"sqsubset",                        "\xE2\x8A\x8F",      0},
+  {"LT",                              "<",                 1},
+  {"sung",                            "\xE2\x99\xAA",      0},
+  {"boxplus",                         "\xE2\x8A\x9E",      0},
+  {"eqslantgtr",                      "\xE2\xAA\x96",      0},
+  {"bumpeq",                          "\xE2\x89\x8F",      0},
+  {"gne",                             "\xE2\xAA\x88",      0},
+  {"block",                           "\xE2\x96\x88",      0},
+  {"Udblac",                          "\xC5\xB0",          0},
+  {"vartheta",                        "\xCF\x91",          0},
+  {"ClockwiseContourIntegral",        "\xE2\x88\xB2",      0},
+  {"Jfr",                             "\xF0\x9D\x94\x8D",  0},
+  {"xrArr",                           "\xE2\x9F\xB9",      0},
+  {"Afr",                             "\xF0\x9D\x94\x84",  0},
+  {"DownRightVector",                 "\xE2\x87\x81",      0},
+  {"cirscir",                         "\xE2\xA7\x82",      0},
+  {"LeftArrowBar",                    "\xE2\x87\xA4",      0},
+  {"succneqq",                        "\xE2\xAA\xB6",      0},
+  {"gimel",                           "\xE2\x84\xB7",      0},
+  {"OpenCurlyDoubleQuote",            "\xE2\x80\x9C",      0},
+  {"pre",                             "\xE2\xAA\xAF",      0},
+  {"downharpoonleft",                 "\xE2\x87\x83",      0},
+  {"downarrow",                       "\xE2\x86\x93",      0},
+  {"triplus",                         "\xE2\xA8\xB9",      0},
+  {"EmptySmallSquare",                "\xE2\x97\xBB",      0},
+  {"shcy",                            "\xD1\x88",          0},
+  {"RightAngleBracket",               "\xE2\x9F\xA9",      0},
+  {"wopf",                            "\xF0\x9D\x95\xA8",  0},
+  {"integers",                        "\xE2\x84\xA4",      0},
+  {"Lmidot",                          "\xC4\xBF",          0},
+  {"Gscr",                            "\xF0\x9D\x92\xA2",  0},
+  {"NotLessTilde",                    "\xE2\x89\xB4",      0},
+  {"boxHD",                           "\xE2\x95\xA6",      0},
+  {"blacksquare",                     "\xE2\x96\xAA",      0},
+  {"Dfr",                             "\xF0\x9D\x94\x87",  0},
+  {"boxul",                           "\xE2\x94\x98",      0},
+  {"Map",                             "\xE2\xA4\x85",      0},
+  {"phiv",                            "\xCF\x95",          0},
+  {"DiacriticalTilde",                "\xCB\x9C",          0},
+  {"bsolb",                           "\xE2\xA7\x85",      0},
+  {"gbreve",                          "\xC4\x9F",          0},
+  {"zdot",                            "\xC5\xBC",          0},
+  {"timesd",                          "\xE2\xA8\xB0",      0},
+  {"slarr",                           "\xE2\x86\x90",      0},
+  {"InvisibleTimes",                  "\xE2\x81\xA2",      0},
+  {"rightthreetimes",                 "\xE2\x8B\x8C",      0},
+  {"ldrushar",                        "\xE2\xA5\x8B",      0},
+  {"trpezium",                        "\xE2\x8F\xA2",      0},
+  {"nGg",                             "\xE2\x8B\x99\xCC\xB8", 0},
+  {"LeftArrowRightArrow",             "\xE2\x87\x86",      0},
+  {"zwnj",                            "\xE2\x80\x8C",      1},
+  {"tstrok",                          "\xC5\xA7",          0},
+  {"upsih",                           "\xCF\x92",          1},
+  {"NotSquareSubset",                 "\xE2\x8A\x8F\xCC\xB8", 0},
+  {"VerticalBar",                     "\xE2\x88\xA3",      0},
+  {"Tau",                             "\xCE\xA4",          1},
+  {"because",                         "\xE2\x88\xB5",      0},
+  {"CounterClockwiseContourIntegral", "\xE2\x88\xB3",      0},
+  {"zopf",                            "\xF0\x9D\x95\xAB",  0},
+  {"supsetneqq",                      "\xE2\xAB\x8C",      0},
+  {"straightphi",                     "\xCF\x95",          0},
+  {"RightDownVectorBar",              "\xE2\xA5\x95",      0},
+  {"pcy",                             "\xD0\xBF",          0},
+  {"GreaterEqualLess",                "\xE2\x8B\x9B",      0},
+  {"preccurlyeq",                     "\xE2\x89\xBC",      0},
+  {"nltrie",                          "\xE2\x8B\xAC",      0},
+  {"sigma",                           "\xCF\x83",          1},
+  {"Ascr",                            "\xF0\x9D\x92\x9C",  0},
+  {"Downarrow",                       "\xE2\x87\x93",      0},
+  {"zhcy",                            "\xD0\xB6",          0},
+};
+
+/* Perfect hash displacements for esc_sequences. */
+static const int aEscHash[] = {
+      -45,   -47,   -57,     1,   -60,     0,     1,     0,     0,     0,
+     -682,     1,     0,     0,     1,     0,     1,     1,     1,  -708,
+     -706,     0,  -710,     0,     1,     0,     0,     3,  -721,  -722,
+        2,     0,  -731,     0,     2,     2,     0,     0,  -750,     0,
+     -754,     1,     0,  -768,     0,  -773,  -774,     0,     1,     0,
+        8,     0,  -813,     1,     0,  -823,  -826,     0,     0,     0,
+     -831,     1,  -838,     1,  -845,     3,     0,     1,     2,     5,
+        0,  -866,     0,  -872,  -876,     1,  -883,     1,     0,     1,
+     -887,  -889,     1,  -890,     0,  -896,     1,  -907,     6,  -913,
+        0,     1,     1,     2,     0,     2,     0,     0,     1,     2,
+        1,  -304,  -309,     1,     1,  -315,     3,     0,     0,     4,
+        0,  -322,  -324,  -334,     3,     0,     0,  -346,     0,     0,
+        1,  -356,     1,     1,     0,     0,  -361,     3,  -377,     0,
+        2,     0,     0,     0,     2,  -380,  -384,  -387,     0,     1,
+     -389,     0,     0,  -391,  -393,     0,     0,  -408,     0,  -435,
+     -415,     0,     1,  -440,     0,     0,     3,     0,  -458,  -459,
+     -460,  -462,  -463,  -474,  -475,  -488,     0,     0,  -494,     0,
+        0,     0,     0,     2,  -497,  -500,  -504,     0,  -507,  -508,
+        0,  -510,     4,  -522,  -524,     0,     0,  -529,     1,     0,
+        1,     5,     0,     0,  -541,     0,     1,  -570,     0,     2,
+        1,  -537,  -539,     0,  -551,     0,  -562,     0,  -571,  -574,
+     -575,  -576,  -577,     3,     0,  -579,     0,     0,     6,  -587,
+        0,     3,  -589,     2,  -593,     0,     3,     0,     0,  -601,
+     -603,     1,     5,     1,     5,  -612,  -616,     0,     0,  -633,
+     -631,     0,     0,     0,  -638,  -640,  -642,  -643,     0,     0,
+        0,  -665,     0,  -667,  -669,  -673,  -676,     0,     0,  -679,
+     -678,     0,     0,     4,     0,  -684,     0,  -691,  -692,  -701,
+     -699,     1,  -709,  -712,  -714,  -718,     6,     0,     0,     0,
+        0,  -725,     1,  -733,     0,     1,     1,     0,     0,     1,
+        1,  -759,  -760,  -766,  -767,     0,  -771,     3,  -792,  -809,
+        1,     0,     4,  -762,     0,     3,     0,     1,  -789,  -793,
+     -802,  -812,     1,     0,  -814,     0,  -819,     0,     0,     1,
+        0,     0,     3,     2,     1,  -840,     1,     1,     0,  -860,
+     -858,     0,     2,  -867,     1,     0,  -877,     0,  -884,     0,
+        0,  -888,     0,     0,     0,  -893,     1,  -903,     1,     1,
+        0,     2,  -917,  -918,     0,  -919,     0,     0,     0,     2,
+        0,     0,     0,  -932,     0,     1,     2,  -947,  -948,     2,
+        0,  -963,     0,     0,     3,     1,     0,     0,     1,  -981,
+     -987,  -988,     0,     0,     1,     2,     1,  -997,     1,  -999,
+        0,     0,     2,     0,     0,     2, -1020, -1029,     0, -1033,
+        3, -1003,     0,     0, -1007, -1019,     0, -1023,     0,     2,
+    -1031, -1035,     3, -1037,     0, -1047,     0,     4,     9,     4,
+    -1064,     0,     0,     0,     0,     1, -1065,     1, -1067, -1068,
+        5,     0, -1074, -1080,     1, -1083,     0,     1,     0, -1094,
+        0, -1099,     0, -1104,     0, -1109, -1114,     0, -1132,     1,
+    -1139,     0, -1143, -1147, -1153,     0, -1154,     0, -1157,     2,
+        2,     0, -1161, -1165,     0, -1166, -1167, -1168,     4,     0,
+        1,     0,     7, -1170, -1176,     0,     3, -1177,     0,     0,
+        0,     7,     0,     0,     0, -1184,     1, -1192,     0,     2,
+    -1198,     0, -1206,     0,     0,     0, -1219, -1224,     0,    12,
+        0,     0, -1202,     1,     6,     0,     1,     1, -1228,     0,
+        0, -1232, -1236, -1245,     0,     0, -1246,     1,     0,     2,
+        1,     1,     1, -1255, -1259,     6, -1271,     0, -1275, -1280,
+    -1277,     0,     0,     4,     0, -1282,     9, -1283,     0,     4,
+    -1294,     3, -1305, -1309, -1312, -1313,     2,     2,    20,     0,
+    -1327, -1328, -1333,     0,     0, -1339,     0,     0,     0,     4,
+        0,     0, -1349,     0, -1352,     9, -1360,     9, -1365,     0,
+    -1368,     0, -1373,     0,     0, -1382, -1386,     0,     8,     1,
+    -1390, -1392, -1395,     0,     0, -1399,    18,     6,     0,     0,
+    -1410,     0, -1423, -1424,    18,    56, -1426,     0,     1,     4,
+    -1406, -1413, -1415,    12,     0,     0, -1429,     0,     0,     4,
+        0, -1434,     0,     1, -1441,     1, -1446, -1449,     1, -1453,
+    -1456,     0, -1457,     0,     0, -1460, -1462, -1464,     2, -1465,
+        4,     0, -1466,     2,    11, -1481,     0,     0,     0,     0,
+        4, -1490,     0,     0,     1,     2,     0,     0, -1497,     5,
+       28, -1498, -1499,     1, -1501,     1, -1512, -1513, -1520, -1525,
+    -1529, -1532,     0, -1535,     3,     0,     1, -1536,     0,     0,
+        0,     4,     0, -1548, -1550,     0, -1557,     0,     4,     1,
+    -1564,     9,     4, -1565, -1580,     4,     0,     0,     0, -1596,
+        0, -1598, -1605,     0, -1610, -1614, -1615, -1627,     3, -1647,
+    -1591,     0, -1607,     0,     5,     0, -1617, -1630, -1631, -1637,
+    -1641, -1649, -1650,     0,     0, -1654, -1662,     0,     7,     0,
+        0, -1666, -1667,     2,    12,     0, -1669,     0,     0,     1,
+    -1679,     0,     6, -1683, -1686,     0,     2, -1705, -1710, -1717,
+        3,     1, -1718, -1720,     0, -1726, -1732,     0,     0, -1741,
+    -1747,     2, -1749,     0, -1753,     0, -1758,     0,     3,     1,
+    -1778, -1782, -1785,     8,     2, -1789, -1796,     0,     0, -1813,
+        0,     0,     2,     0,     0,     1, -1829,     0, -1836,     0,
+        3,    10,     0, -1841,    16,     0, -1847,     0,     4,     0,
+        7,     0,     0,     0,     5,     0, -1876, -1882, -1893,     2,
+        2, -1865,     0,     1, -1874,     0,     0,     9,     0,     1,
+        1,     0,     0, -1901, -1906, -1909,     1,     0, -1918,     0,
+    -1920, -1923,    24,     0,     0, -1935,     0, -1954, -1955, -1973,
+    -1963,     0, -1986, -1988,     0,     0,     0, -2001,     3,     0,
+        2, -2004, -2008,     3,     0, -2014,     1,     0, -2022, -2024,
+        2, -2025,     4,     0,     0,    11,     0, -2039, -2043,     0,
+        1,     0, -2050, -2051,     0,     0, -2058, -2060,     3,    15,
+    -2063,     0,    24,     3,     0,     0,     0, -2065, -2071,     0,
+        0, -2073, -2075,    41,     0, -2076, -2080, -2090,     0,     3,
+        2,     6,     4,     0,    65, -2097,     5,     0, -2099, -2102,
+        0, -2091, -2092,     0, -2095,    79,     1,     3, -2101,     2,
+        0,    48,     0,     4, -2105,     0, -2106,    10, -2114,     2,
+    -2122,    25,     0,     0,     1,     0,    -1,     0,    -2,   -18,
+        0,   -19,     0,     1,   -22,   -23,   -25,     0,     1,     2,
+        1,     1,     0,     1,   -26,   -29,   -31,     1,     4,     1,
+        0,   -32,     1,     0,     1,     1,     0,   -34,     0,     1,
+        2,     1,   -35,   -38,   -41,     0,   -42,     0,     0,   -43,
+        3,     1,     1,   -44,     1,     3,     1,     0,     1,   -52,
+      -49,   -54,   -59,     0,     0,     1,   -67,   -70,     3,     0,
+        0,     1,     1,   -72,     1,     2,     4,     1,   -82,   -85,
+        1,     0,     2,     0,     0,     0,     1,   -93,     6,     0,
+      -96,   -97,     1,     3,  -106,  -107,     0,  -111,     0,     3,
+        1,     0,     4,     1,  -113,     0,     0,     1,     0,     0,
+     -115,     1,     0,     0,  -117,     0,     1,  -118,     0,  -122,
+     -121,     0,     0,  -124,     1,     4,  -127,  -130,     0,     1,
+     -132,     0,  -138,     0,     0,  -140,     1,     1,  -143,     1,
+        0,     2,     0,  -144,  -145,     0,  -149,     0,     0,     0,
+     -150,     0,     0,     1,  -152,     2,     0,     0,     0,     0,
+        0,     1,     0,     0,     0,     0,     0,     0,     1,  -154,
+     -156,     0,  -160,  -165,     0,     0,  -178,     1,  -187,  -189,
+        1,  -158,  -164,     1,     0,     0,  -172,  -181,  -183,     1,
+        0,  -191,  -197,     0,  -198,     0,     0,     6,     1,  -199,
+        0,     0,     0,     0,     0,     2,  -204,     1,     4,  -205,
+        0,     0,     3,  -206,     2,     3,     1,  -207,     1,     1,
+        0,  -208,     1,     0,  -209,  -212,     0,  -213,     0,     2,
+        1,     2,  -216,     5,  -217,     0,  -218,     0,  -222,  -223,
+        1,     0,     6,  -230,  -237,  -238,     1,     1,     0,     0,
+     -240,  -241,  -242,  -244,     0,     1,     0,     1,  -245,  -247,
+        1,     0,     0,     1,     0,     2,  -248,     1,     2,     0,
+        3,  -251,  -253,     0,     1,     2,     1,  -266,     9,  -270,
+        0,     0,     0,     0,     0,  -256,     0,     3,     1,     1,
+        1,     0,  -274,     1,  -276,     0,     0,     0,     0,     0,
+        1,     0,  -279,  -283,  -286,  -289,  -290,     1,     0,     3,
+     -291,  -294,     0,     2,     1,  -298,     3,     4,     1,     1,
+        0,  -300,     3,     0,     1,     0,  -313,  -314,  -316,     0,
+        0,  -318,     0,     2,     0,  -333,     3,     0,  -337,  -350,
+        8,  -352,     0,     1,  -358,     0,  -360,     3,  -365,  -367,
+     -372,     0,     0,     0,  -379,     0,     0,  -381,  -382,     1,
+        0,  -388,  -390,     0,     2,     0,     0,  -399,     0,  -400,
+     -406,  -414,  -430,     0,     0,     0,     0,  -447,  -448,  -456,
+        3,     1,  -434,  -439,     0,     0,  -442,     1,  -450,  -455,
+        0,  -457,     0,     0,     3,     0,  -477,  -486,  -489,  -491,
+        4,     0,  -495,     4,  -496,     0,     0,     0,     2,  -505,
+        0,     0,     0,  -511,  -513,     0,    13,  -525,     1,     0,
+        0,  -530,  -534,     1,     0,     0,  -550,     0,  -564,     1,
+     -565,     3,     1,     0,     1,  -578,     1,     1,     0,  -582,
+        1,     0,  -586,     0,     0,     0,     0,  -594,  -596,  -599,
+        2,     0,  -605,     1,  -608,     0,  -609,  -611,  -613,  -621,
+     -623,     1,     0,     1,     0,     0,  -637,     1,     1,     0,
+        0,  -647,  -659,     0,     1,     4,     4,  -671,     5,     3,
+     -644,  -654,  -656,  -663,     2,     1,  -670,  -672,  -675,     2,
+        0,     1,     1,     0,     0,     0,     0,     0,     0,  -687,
+        0,  -698,  -705,     0,     2,     0,  -715,     3,     1,     0,
+        1,  -720,     0,     2,  -727,     2,  -738,     0,  -744,  -749,
+        0,     0,  -751,  -757,     4,  -764,     2,     0,     0,  -786,
+        1,     1,  -799,     0,     0,     1,     1,     0,  -820,     0,
+        0,     1,     0,  -829,     0,     3,  -839,     1,     5,  -852,
+        5,     0,     0,  -865,     0,     0,     0,     1,     0,  -880,
+     -879,     0,     0,     0,     0,     0,     0,     1,     0,     0,
+     -904,     1,     1,     1,     0,     0,     0,  -921,  -922,     1,
+        1,     0,  -911,     0,     4,     0,     6,     2,     0,  -925,
+     -929,     0,  -931,     6,     0,     2,  -934,  -946,     0,     0,
+        0,     1,  -950,     1,     2,     4,  -965,  -969,  -970,     0,
+     -974,     0,  -978,     1,     0,  -992,  -995,     3,  -996,     0,
+        0,     0,     1, -1002, -1004,     1, -1017,     0,     0, -1025,
+    -1021,     2,     0,     0,     0, -1043, -1046,     0, -1050,     2,
+    -1061, -1062,     0,     0,     0,     1,     0,     1,     0,     0,
+        7,     5,     0, -1073,     2,    12,     0,     0,     1,     1,
+        0, -1087,     1,     3,     2,     3,     1,     0,     0, -1116,
+    -1118, -1126, -1137,     0, -1142, -1144, -1151,     0,     8,     0,
+    -1120, -1123, -1134,     0,     1,     2,     2,     0,     6,     1,
+    -1155, -1156, -1160,     0,     2, -1164,     0,     0,     0,     0,
+        0, -1169,     0,     2,     0, -1173, -1174,     0,     0,     0,
+        0, -1180,     0, -1182, -1183,     0,     0,     0, -1188, -1195,
+        0, -1197,     1, -1199,     6, -1211,     0, -1217, -1218, -1225,
+        5,     0,     0,    10, -1241, -1244,     0,     1,     0,     0,
+    -1248,     0, -1249,     0,     0,     3, -1261, -1263, -1266,     2,
+        0,     6,     3,     4,     0,     0, -1281,     0,     1,     0,
+    -1286, -1292, -1295, -1302, -1303,     0,     0,     2, -1315, -1322,
+    -1319,     2,     4,     1, -1332,     4, -1337,     0, -1342,     0,
+    -1321,     1, -1326,     0,     2, -1336,     0, -1338,     2,     0,
+        3,     1, -1347,    18,    13,     0, -1354,     0, -1357,     0,
+    -1361,     1,     2,     0, -1369,     0, -1377,     0, -1385, -1388,
+        0,     0,     0,     0,     3, -1396,     0,     0, -1401, -1404,
+        0,     0,     0,     8,     9, -1425,     0,     0,     0, -1432,
+    -1430, -1433,     7,     1,     0,     1,     0,     0,     0, -1451,
+    -1450,     4,     0,     0,     0,     0, -1458,     0, -1461,     0,
+        0,     5,     2,     0, -1470, -1475, -1477,     2,     0, -1484,
+    -1485,     0, -1486, -1487, -1492, -1493, -1495, -1496,     0,     1,
+        0,     3,     0,     0,     2,     0,     0, -1504, -1511, -1514,
+        1,     0,     1,     0,     1, -1500, -1502,     0,     0, -1516,
+    -1518, -1519,     3,     7,     1,     1,     6,     0,     0,     0,
+        0,     0,     1,     0, -1538, -1540, -1555,     4, -1556,     0,
+    -1560,     0, -1563,     0,     0,     3,     0, -1583,     0, -1587,
+       12,     0, -1589, -1603,     2,     1,     0,     7, -1625,     0,
+        0,     0, -1646,     1,     2, -1651, -1653,     0, -1656, -1663,
+        1, -1664,     0,     0,     0,     9,     8,     3,     1, -1676,
+        0,     0,     0,     0, -1682,     0, -1687, -1691, -1693, -1708,
+    -1706,     0, -1713,     1,     0, -1724,     7,     0, -1729,     0,
+    -1736, -1740, -1742,     0,     0, -1752,     0, -1757,     0, -1762,
+        0,     1,     0,     0, -1751,     0,     0,     0,     0, -1765,
+        1, -1769,     0, -1781,     0,     3, -1788,     0,     0, -1805,
+        0, -1807,     0,     9,     0,     0,     0, -1825, -1830,     8,
+    -1835,     2,     0,     0,     4, -1842, -1843,     0,     0, -1850,
+        5, -1853, -1855,     0,     0, -1867, -1872,     0, -1879,     0,
+    -1886,     5,     4, -1897,     0,     1,     0,     1,    16, -1912,
+        7,     0, -1921, -1922, -1927,     0, -1934,     3, -1940, -1947,
+        2,     0, -1982, -1983,     0, -1990,     0,     0,     0,     0,
+    -1997,    67, -2002,     0,     1,     2,     0, -2015, -2018,     3,
+        2,     3,     1,    20,     0,     0, -2027,     1, -2032, -2042,
+       40,     0,     3,    16,     0,     0, -1756,     0, -1761,     0,
+        8, -1773,     0,     0, -1786, -1787,     0,     7, -1790,     0,
+        0,     0, -1814, -1823,     3,     0,     0, -1827,     8, -1832,
+        7,     0, -1838,     5, -1840,     0,     2, -1844, -1845,     0,
+    -1849,     2, -1857, -1864, -1866,    11,     0,     1,     0,     0,
+    -1888,     0,    15,     0,     0, -1900,     0,     1,     0,    10,
+       30,     0,     8, -1925,     0, -1928, -1932,     0,     0, -1944,
+        0,     0,     0,     0,     1,     0,     1,     0, -1991, -1996,
+    -1998,     3,     0,     0,     5,     6,     0,     0,     0,     0,
+    -2019,    12,     0,     1,     0,     2,     3,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,    15, -2028, -2037,     0,
+        0, -2045, -2049,     0,     9,     4,     1, -2056, -2057, -2061,
+       12,     0,     0,    12,
+};
@@ -472,7 +472,7 @@ nodeIsReplaced (HtmlNode *pNode)
     assert(!pElem || pElem->pPropertyValues);
     return ((
         pElem && (
-            (pElem->pReplacement && pElem->pReplacement->win) ||
+            (HtmlElemRare(pElem, pReplacement) && pElem->pRare->pReplacement->win) ||
             (pElem->pPropertyValues->imReplacementImage != 0)
         )
     ) ? 1 : 0);
@@ -702,8 +702,8 @@ createScrollbars (HtmlTree *pTree, HtmlNode *pNode, int iWidth, int iHeight, int
 {
     HtmlElementNode *pElem = (HtmlElementNode *)pNode;
     HtmlNodeScrollbars *p;
-    if (HtmlNodeIsText(pNode) || !pElem->pScrollbar) return;
-    p = pElem->pScrollbar;
+    if (HtmlNodeIsText(pNode) || !HtmlElemRare(pElem, pScrollbar)) return;
+    p = pElem->pRare->pScrollbar;
 
     p->iWidth = iWidth;
     p->iHeight = iHeight;
@@ -902,8 +902,9 @@ normalFlowLayoutOverflow (LayoutContext *pLayout, BoxContext *pBox, HtmlNode *pN
             (pV->eOverflow == CSS_CONST_AUTO && (useHorizontal || useVertical)
     ))) {
         HtmlElementNode *pElem = (HtmlElementNode *)pNode;
-        if (pElem->pScrollbar == 0) {
-            pElem->pScrollbar = HtmlNew(HtmlNodeScrollbars);
+        HtmlElementRare *pRare = HtmlElemRareGet(pElem);
+        if (pRare->pScrollbar == 0) {
+            pRare->pScrollbar = HtmlNew(HtmlNodeScrollbars);
         }
         createScrollbars(pLayout->pTree, pNode, 
             sContent.width, sContent.height,
@@ -1593,6 +1594,7 @@ drawReplacementContent (LayoutContext *pLayout, BoxContext *pBox, HtmlNode *pNod
 
     HtmlComputedValues *pV= HtmlNodeComputedValues(pNode);
     HtmlElementNode *pElem = HtmlNodeAsElement(pNode);
+    HtmlNodeReplacement *pReplace = HtmlElemRare(pElem, pReplacement);
 
     assert(pNode && pElem);
     assert(nodeIsReplaced(pNode));
@@ -1610,9 +1612,9 @@ drawReplacementContent (LayoutContext *pLayout, BoxContext *pBox, HtmlNode *pNod
     if (iWidth != PIXELVAL_AUTO) iWidth = MAX(iWidth, 1);
     assert(iWidth != 0);
 
-    if (pElem->pReplacement && pElem->pReplacement->win) {
-        CONST char *zReplace = Tcl_GetString(pElem->pReplacement->pReplace);
-        Tk_Window win = pElem->pReplacement->win;
+    if (pReplace && pReplace->win) {
+        CONST char *zReplace = Tcl_GetString(pReplace->pReplace);
+        Tk_Window win = pReplace->win;
         if (win) {
             Tcl_Obj *pWin = 0;
             int iOffset;
@@ -1652,7 +1654,7 @@ drawReplacementContent (LayoutContext *pLayout, BoxContext *pBox, HtmlNode *pNod
                 pWin = Tcl_NewStringObj(zReplace, -1);
             }
 
-            iOffset = pElem->pReplacement->iOffset;
+            iOffset = pElem->pRare->pReplacement->iOffset;
             DRAW_WINDOW(&pBox->vc, pNode, 0, 0, iWidth, height);
         }
     } else {
@@ -1679,7 +1681,8 @@ drawReplacementContent (LayoutContext *pLayout, BoxContext *pBox, HtmlNode *pNod
             (pLayout->minmaxTest == MINMAX_TEST_MIN ? "mintest" : 
              pLayout->minmaxTest == MINMAX_TEST_MAX ? "maxtest" : "regular"),
              iWidth, height, 
-             (pElem->pReplacement ? pElem->pReplacement->iOffset : 0)
+             (HtmlElemRare(pElem, pReplacement) ? 
+                 pElem->pRare->pReplacement->iOffset : 0)
 		, NULL);
     }
 
@@ -2745,7 +2748,7 @@ normalFlowLayoutInlineReplaced (LayoutContext *pLayout, BoxContext *pBox, HtmlNo
 
     MarginProperties margin;
     BoxProperties box;
-    HtmlNodeReplacement *pReplace = HtmlNodeAsElement(pNode)->pReplacement;
+    HtmlNodeReplacement *pReplace = HtmlElemRare(HtmlNodeAsElement(pNode), pReplacement);
 
     memset(&sBox, 0, sizeof(BoxContext));
     sBox.iContaining = pBox->iContaining;
@@ -3677,10 +3680,12 @@ static void
 doConfigureCmd (HtmlTree *pTree, HtmlElementNode *pElem, int iContaining)
 {
     Tcl_Obj *pConfigure;                           /* -configurecmd script */
+    HtmlNodeReplacement *pReplace;
 
-    assert(pElem && pElem->pReplacement);
-    pConfigure = pElem->pReplacement->pConfigureCmd;
-    pElem->pReplacement->iOffset = 0;
+    assert(pElem && HtmlElemRare(pElem, pReplacement));
+    pReplace = pElem->pRare->pReplacement;
+    pConfigure = pReplace->pConfigureCmd;
+    pReplace->iOffset = 0;
 
     if (pConfigure) {
         Tcl_Interp *interp = pTree->interp;
@@ -3751,8 +3756,8 @@ doConfigureCmd (HtmlTree *pTree, HtmlElementNode *pElem, int iContaining)
         Tcl_DecrRefCount(pScript);
 
         pRes = Tcl_GetObjResult(interp);
-        pElem->pReplacement->iOffset = 0;
-        Tcl_GetIntFromObj(0, pRes, &pElem->pReplacement->iOffset);
+        pReplace->iOffset = 0;
+        Tcl_GetIntFromObj(0, pRes, &pReplace->iOffset);
     }
 }
 
@@ -456,45 +456,365 @@ HtmlLiContent (HtmlTree *pTree, HtmlNode *pNode, int tag)
  * build process. It contains the HtmlMarkupMap constant array, declared as:
  *
  * HtmlTokenMap HtmlMarkupMap[] = {...};
+ *
+ * and the HtmlMarkupHash and HtmlMarkupSlot arrays that make up the
+ * perfect hash table used by HtmlHashLookup().
  */
 #include "htmltokens.c"
 
-#ifdef TEST
-
-/* 
-** Compute the longest and average collision chain length for the
-** markup hash table
-*/
-static void
-HtmlHashStats(void * htmlPtr)
+/*************************** Begin Fast Scanner Code *************************/
+/*
+ * The tokenizer spends most of its time searching the document text for
+ * one of a small number of interesting byte sequences:
+ *
+ *     HtmlScanChar()      - The next occurence of a single byte. Used to
+ *                           find the '<' that ends a run of text and the
+ *                           start of the end-tag of a script block.
+ *     HtmlScanComment()   - The "-->" that terminates an HTML comment.
+ *     HtmlScanEscape()    - The next '&' character (or byte with the high
+ *                           bit set) in a string passed to
+ *                           HtmlTranslateEscapes().
+ *     HtmlScanWord()      - The end of a run of printable ASCII characters
+ *                           (the next byte <= 0x20 or >= 0x80). Used by
+ *                           HtmlTextNew() to find the end of each word.
+ *     HtmlScanSpaces()    - The end of a run of space (0x20) characters.
+ *
+ * Each of these returns the offset of the sequence in buffer z, or n if
+ * it does not occur in the first n bytes of z. None of them read beyond
+ * z[n-1].
+ *
+ * There are three implementations of each - a portable one that examines
+ * one byte at a time, and versions that use SSE2 and AVX2 instructions
+ * to examine 16 or 32 bytes at a time. The vector versions are only
+ * compiled when building with gcc (or clang) for an x86 target. The
+ * fastest implementation supported by the CPU is chosen the first time
+ * any of the HtmlScanXXX() functions is called. The [::tkhtml::scanner]
+ * command may be used to override the choice (this is useful for
+ * benchmarking - see tools/parsebench.tcl).
+ */
+typedef struct HtmlScanner HtmlScanner;
+struct HtmlScanner {
+    const char *zName;
+    int (*xChar)(const char *, int, int);
+    int (*xComment)(const char *, int);
+    int (*xEscape)(const char *, int);
+    int (*xWord)(const char *, int);
+    int (*xSpaces)(const char *, int);
+    int (*xSupported)(void);
+};
+
+static int
+scanCharPortable (const char *z, int n, int c)
 {
     int i;
-    int sum = 0;
-    int max = 0;
-    int cnt;
-    int notempty = 0;
-    struct sgMap *p;
-
-    for (i = 0; i < HTML_MARKUP_COUNT; i++) {
-        cnt = 0;
-        p = apMap[i];
-        if (p)
-            notempty++;
-        while (p) {
-            cnt++;
-            p = p->pCollide;
+    for (i = 0; i < n && z[i] != c; i++);
+    return i;
+}
+static int
+scanCommentPortable (const char *z, int n)
+{
+    int i;
+    for (i = 0; i < (n - 2); i++) {
+        if (z[i] == '-' && z[i + 1] == '-' && z[i + 2] == '>') {
+            return i;
         }
-        sum += cnt;
-        if (cnt > max)
-            max = cnt;
+    }
+    return n;
+}
+static int
+scanEscapePortable (const char *z, int n)
+{
+    int i;
+    for (i = 0; i < n && z[i] != '&' && !(z[i] & 0x80); i++);
+    return i;
+}
+static int
+scanWordPortable (const char *z, int n)
+{
+    int i;
+    for (i = 0; i < n && (unsigned char)(z[i] - 0x21) < 0x5F; i++);
+    return i;
+}
+static int
+scanSpacesPortable (const char *z, int n)
+{
+    int i;
+    for (i = 0; i < n && z[i] == ' '; i++);
+    return i;
+}
+static int
+scanSupportedPortable (void)
+{
+    return 1;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HTML_SCAN_VECTOR
+
+/* The vector implementations use unaligned loads and never read past
+ * z[n-1]. The final block of less than 16 (or 32) bytes is handed to the
+ * portable version of each function.
+ */
+__attribute__((target("sse2"))) static int
+scanCharSse2 (const char *z, int n, int c)
+{
+    const __m128i vc = _mm_set1_epi8((char)c);
+    int i;
+    for (i = 0; (i + 16) <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&z[i]);
+        int m = _mm_movemask_epi8(_mm_cmpeq_epi8(v, vc));
+        if (m) return i + __builtin_ctz(m);
+    }
+    return i + scanCharPortable(&z[i], n - i, c);
+}
+__attribute__((target("sse2"))) static int
+scanCommentSse2 (const char *z, int n)
+{
+    const __m128i vDash = _mm_set1_epi8('-');
+    const __m128i vGt = _mm_set1_epi8('>');
+    int i;
+    for (i = 0; (i + 18) <= n; i += 16) {
+        __m128i v0 = _mm_loadu_si128((const __m128i *)&z[i]);
+        __m128i v1 = _mm_loadu_si128((const __m128i *)&z[i + 1]);
+        __m128i v2 = _mm_loadu_si128((const __m128i *)&z[i + 2]);
+        __m128i m = _mm_and_si128(
+            _mm_and_si128(_mm_cmpeq_epi8(v0, vDash), _mm_cmpeq_epi8(v1,vDash)),
+            _mm_cmpeq_epi8(v2, vGt)
+        );
+        int mask = _mm_movemask_epi8(m);
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + scanCommentPortable(&z[i], n - i);
+}
+__attribute__((target("sse2"))) static int
+scanEscapeSse2 (const char *z, int n)
+{
+    const __m128i vAmp = _mm_set1_epi8('&');
+    int i;
+    for (i = 0; (i + 16) <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&z[i]);
+        int m = _mm_movemask_epi8(v)|_mm_movemask_epi8(_mm_cmpeq_epi8(v,vAmp));
+        if (m) return i + __builtin_ctz(m);
+    }
+    return i + scanEscapePortable(&z[i], n - i);
+}
+__attribute__((target("sse2"))) static int
+scanWordSse2 (const char *z, int n)
+{
+    /* A signed comparison against 0x21 matches both the bytes <= 0x20 and
+     * those with the high bit set (which are negative).
+     */
+    const __m128i v21 = _mm_set1_epi8(0x21);
+    int i;
+    for (i = 0; (i + 16) <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&z[i]);
+        int m = _mm_movemask_epi8(_mm_cmplt_epi8(v, v21));
+        if (m) return i + __builtin_ctz(m);
+    }
+    return i + scanWordPortable(&z[i], n - i);
+}
+__attribute__((target("sse2"))) static int
+scanSpacesSse2 (const char *z, int n)
+{
+    const __m128i vSpace = _mm_set1_epi8(' ');
+    int i;
+    for (i = 0; (i + 16) <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&z[i]);
+        int m = _mm_movemask_epi8(_mm_cmpeq_epi8(v, vSpace)) ^ 0xFFFF;
+        if (m) return i + __builtin_ctz(m);
+    }
+    return i + scanSpacesPortable(&z[i], n - i);
+}
+static int
+scanSupportedSse2 (void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+}
 
+__attribute__((target("avx2"))) static int
+scanCharAvx2 (const char *z, int n, int c)
+{
+    const __m256i vc = _mm256_set1_epi8((char)c);
+    int i;
+    for (i = 0; (i + 32) <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&z[i]);
+        unsigned int m = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, vc));
+        if (m) return i + __builtin_ctz(m);
+    }
+    return i + scanCharPortable(&z[i], n - i, c);
+}
+__attribute__((target("avx2"))) static int
+scanCommentAvx2 (const char *z, int n)
+{
+    const __m256i vDash = _mm256_set1_epi8('-');
+    const __m256i vGt = _mm256_set1_epi8('>');
+    int i;
+    for (i = 0; (i + 34) <= n; i += 32) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i *)&z[i]);
+        __m256i v1 = _mm256_loadu_si256((const __m256i *)&z[i + 1]);
+        __m256i v2 = _mm256_loadu_si256((const __m256i *)&z[i + 2]);
+        __m256i m = _mm256_and_si256(_mm256_and_si256(
+                _mm256_cmpeq_epi8(v0, vDash), _mm256_cmpeq_epi8(v1, vDash)
+            ), _mm256_cmpeq_epi8(v2, vGt)
+        );
+        unsigned int mask = _mm256_movemask_epi8(m);
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + scanCommentPortable(&z[i], n - i);
+}
+__attribute__((target("avx2"))) static int
+scanEscapeAvx2 (const char *z, int n)
+{
+    const __m256i vAmp = _mm256_set1_epi8('&');
+    int i;
+    for (i = 0; (i + 32) <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&z[i]);
+        unsigned int m = _mm256_movemask_epi8(v) |
+                         _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, vAmp));
+        if (m) return i + __builtin_ctz(m);
+    }
+    return i + scanEscapePortable(&z[i], n - i);
+}
+__attribute__((target("avx2"))) static int
+scanWordAvx2 (const char *z, int n)
+{
+    const __m256i v21 = _mm256_set1_epi8(0x21);
+    int i;
+    for (i = 0; (i + 32) <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&z[i]);
+        unsigned int m = _mm256_movemask_epi8(_mm256_cmpgt_epi8(v21, v));
+        if (m) return i + __builtin_ctz(m);
+    }
+    return i + scanWordPortable(&z[i], n - i);
+}
+__attribute__((target("avx2"))) static int
+scanSpacesAvx2 (const char *z, int n)
+{
+    const __m256i vSpace = _mm256_set1_epi8(' ');
+    int i;
+    for (i = 0; (i + 32) <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&z[i]);
+        unsigned int m = ~_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, vSpace));
+        if (m) return i + __builtin_ctz(m);
     }
-    printf("longest chain=%d  avg=%g  slots=%d  empty=%d (%g%%)\n",
-           max, (double) sum / (double) notempty, i, i - notempty,
-           100.0 * (i - notempty) / (double) i);
+    return i + scanSpacesPortable(&z[i], n - i);
+}
+static int
+scanSupportedAvx2 (void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
 }
 #endif
 
+/* Array of available scanners, fastest first. The last entry is always
+ * the portable implementation.
+ */
+static HtmlScanner aScanner[] = {
+#ifdef HTML_SCAN_VECTOR
+    {"avx2", scanCharAvx2, scanCommentAvx2, scanEscapeAvx2,
+        scanWordAvx2, scanSpacesAvx2, scanSupportedAvx2},
+    {"sse2", scanCharSse2, scanCommentSse2, scanEscapeSse2,
+        scanWordSse2, scanSpacesSse2, scanSupportedSse2},
+#endif
+    {"portable", scanCharPortable, scanCommentPortable, scanEscapePortable,
+        scanWordPortable, scanSpacesPortable, scanSupportedPortable}
+};
+static HtmlScanner *pScanner = 0;
+
+static HtmlScanner *
+getScanner (void)
+{
+    if (!pScanner) {
+        HtmlScanner *p = aScanner;
+        while (!p->xSupported()) p++;
+        pScanner = p;
+    }
+    return pScanner;
+}
+
+int
+HtmlScanChar (const char *z, int n, int c)
+{
+    return getScanner()->xChar(z, n, c);
+}
+int
+HtmlScanComment (const char *z, int n)
+{
+    return getScanner()->xComment(z, n);
+}
+int
+HtmlScanEscape (const char *z, int n)
+{
+    return getScanner()->xEscape(z, n);
+}
+int
+HtmlScanWord (const char *z, int n)
+{
+    return getScanner()->xWord(z, n);
+}
+int
+HtmlScanSpaces (const char *z, int n)
+{
+    return getScanner()->xSpaces(z, n);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlScannerCmd --
+ *
+ *     ::tkhtml::scanner ?NAME?
+ *
+ *     Query or set the implementation used by the HtmlScanXXX() functions.
+ *     NAME may be one of "avx2", "sse2" or "portable". It is an error to
+ *     select an implementation the CPU does not support.
+ *
+ * Results:
+ *     The name of the current implementation.
+ *
+ * Side effects:
+ *     May change the implementation used by all widgets in the process.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+HtmlScannerCmd (
+    ClientData clientData,             /* Unused */
+    Tcl_Interp *interp,                /* Current interpreter. */
+    int objc,                          /* Number of arguments. */
+    Tcl_Obj *CONST objv[]              /* Argument strings. */
+    )
+{
+    HtmlScanner *p = getScanner();
+
+    if (objc > 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "?NAME?");
+        return TCL_ERROR;
+    }
+
+    if (objc == 2) {
+        const char *zArg = Tcl_GetString(objv[1]);
+        int nScanner = sizeof(aScanner) / sizeof(aScanner[0]);
+        int ii;
+        for (ii = 0; ii < nScanner; ii++) {
+            if (0 == strcmp(zArg, aScanner[ii].zName)) break;
+        }
+        if (ii == nScanner || !aScanner[ii].xSupported()) {
+            Tcl_AppendResult(interp, "unsupported scanner: \"", zArg, "\"", 0);
+            return TCL_ERROR;
+        }
+        pScanner = p = &aScanner[ii];
+    }
+
+    Tcl_SetResult(interp, (char *)p->zName, TCL_STATIC);
+    return TCL_OK;
+}
+
+/**************************** End Fast Scanner Code ***************************/
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -543,9 +863,18 @@ getScriptHandler(
  *     No account is given to quotation marks within the body of the
  *     script block.
  *
+ *     The search begins at byte *piScan of z. If the end of the script
+ *     block is found, *piScan is set to the offset of the first byte
+ *     following the end tag. Otherwise, it is set to the offset at which
+ *     the search should resume once more text has been appended to the
+ *     document (bytes before this offset have already been examined).
+ *
  * Results:
+ *     The number of bytes of script text, or -1 if the end of the block
+ *     is not present in z.
  *
  * Side effects:
+ *     None.
  *
  *---------------------------------------------------------------------------
  */
@@ -553,33 +882,155 @@ static int
 findEndOfScript (
     int eTag,                 /* Tag type for this block (i.e. Html_Script) */
     char const *z,            /* Input string */
-    int *pN                  /* IN/OUT: Current index in z */
+    int nLen,                 /* Number of bytes in z */
+    int iScript,              /* Index in z of the start of the script text */
+    int *piScan               /* IN/OUT: Current index in z */
 )
 {
     char zEnd[64];
     int nEnd;
+    int nSearch;
     int ii;
-    int nLen = (strlen(&z[*pN]) + *pN);
 
     /* Figure out the string we are looking for as an end tag */
     sprintf(zEnd, "</%s", HtmlMarkupName(eTag));
     nEnd = strlen(zEnd);
+    nSearch = nLen - nEnd - 1;
 
-    for (ii = *pN; ii < (nLen - nEnd - 1); ii++) {
+    for (ii = *piScan; ii < nSearch; ii++) {
+        ii += HtmlScanChar(&z[ii], nSearch - ii, '<');
         if (
+            ii < nSearch &&
             strnicmp(&z[ii], zEnd, nEnd) == 0 &&
             (z[ii+nEnd] == '>' || ISSPACE(z[ii+nEnd]))
         ) {
-            int nScript = ii - (*pN);
-            ii += (nEnd + 1);
-            *pN = ii;
-            return nScript;
+            *piScan = ii + nEnd + 1;
+            return ii - iScript;
         }
     }
 
+    *piScan = MAX(*piScan, nSearch);
     return -1;
 }
 
+/*
+ * Values for HtmlTokenizer.eTagState. These record the position of the
+ * tokenizer within a markup tag, so that scanTagEnd() may resume an
+ * incomplete scan where it left off.
+ */
+#define TAGSCAN_NAME      0       /* Within the tag name */
+#define TAGSCAN_ATTR      1       /* Between attributes, or within a name */
+#define TAGSCAN_EQUALS    2       /* After an '=', before the value */
+#define TAGSCAN_QUOTED    3       /* Within a quoted attribute value */
+#define TAGSCAN_UNQUOTED  4       /* Within an unquoted attribute value */
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * scanTagEnd --
+ *
+ *     Search for the '>' character that terminates the markup tag starting
+ *     at z[0] (z[0] is always '<'). The search begins at byte
+ *     pTok->iScan of z, with the tokenizer in state pTok->eTagState. If
+ *     pTok->iScan is 0, the scan starts at the beginning of the tag.
+ *
+ *     The rules used to find the end of the tag are the same as those
+ *     used by HtmlTokenize() to break the tag into a name and attributes
+ *     - the only '>' characters that do not terminate a tag are those
+ *     within quoted attribute values.
+ *
+ * Results:
+ *     The offset of the terminating '>' within z, or -1 if the tag is 
+ *     incomplete. In the latter case pTok->iScan and pTok->eTagState are
+ *     updated so that the scan may be resumed when more input arrives.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+scanTagEnd (HtmlTokenizer *pTok, const char *z, int nZ)
+{
+    int eTagState = pTok->eTagState;
+    int cQuote = pTok->cQuote;
+    int ii = pTok->iScan;
+
+    if (ii == 0) {
+        /* The first byte of the tag name (or the first byte after the
+         * '/' of a closing tag) is always consumed as part of the name.
+         * This means at least 3 bytes are needed to tell if this is an 
+         * opening or closing tag.
+         */
+        if (nZ < 3) return -1;
+        ii = ((z[1] == '/') ? 3 : 2);
+        eTagState = TAGSCAN_NAME;
+    }
+
+    for ( ; ii < nZ; ii++) {
+        int c = z[ii];
+        switch (eTagState) {
+            case TAGSCAN_NAME:
+                if (c == '>') return ii;
+                if (ISSPACE(c) || c == '/') eTagState = TAGSCAN_ATTR;
+                break;
+            case TAGSCAN_ATTR:
+                if (c == '>') return ii;
+                if (c == '=') eTagState = TAGSCAN_EQUALS;
+                break;
+            case TAGSCAN_EQUALS:
+                if (c == '>') return ii;
+                if (c == '\'' || c == '"') {
+                    cQuote = c;
+                    eTagState = TAGSCAN_QUOTED;
+                } else if (!ISSPACE(c)) {
+                    eTagState = TAGSCAN_UNQUOTED;
+                }
+                break;
+            case TAGSCAN_QUOTED:
+                if (c == cQuote) eTagState = TAGSCAN_ATTR;
+                break;
+            case TAGSCAN_UNQUOTED:
+                if (c == '>') return ii;
+                if (ISSPACE(c)) eTagState = TAGSCAN_ATTR;
+                break;
+        }
+    }
+
+    pTok->eTagState = eTagState;
+    pTok->cQuote = cQuote;
+    pTok->iScan = ii;
+    return -1;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * matchPrefix --
+ *
+ *     Check if the nZ byte buffer z begins with nul-terminated string
+ *     zPrefix.
+ *
+ * Results:
+ *     1 if z begins with zPrefix, 0 if it does not, or -1 if the buffer is
+ *     too short to tell (i.e. all nZ bytes of z match zPrefix).
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+matchPrefix (const char *z, int nZ, const char *zPrefix)
+{
+    int ii;
+    for (ii = 0; zPrefix[ii]; ii++) {
+        if (ii == nZ) return -1;
+        if (z[ii] != zPrefix[ii]) return 0;
+    }
+    return 1;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -632,6 +1083,287 @@ executeScript(
     return rc;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * docBufferText --
+ *
+ *     Return a pointer to the contiguous, nul-terminated text of the 
+ *     document stored in gap buffer p. If the gap is not already at the
+ *     end of the buffer, it is moved there. *pnByte is set to the number
+ *     of bytes of text.
+ *
+ *     The returned pointer is valid until the next call to 
+ *     docBufferInsert() or HtmlTreeClear().
+ *
+ * Results:
+ *     Pointer to document text.
+ *
+ * Side effects:
+ *     May move the gap.
+ *
+ *---------------------------------------------------------------------------
+ */
+static char *
+docBufferText (HtmlDocBuffer *p, int *pnByte)
+{
+    if (!p->z) {
+        *pnByte = 0;
+        return "";
+    }
+    if (p->iGap != p->nByte) {
+        char *zTail = &p->z[p->iGap + p->nGap];
+        memmove(&p->z[p->iGap], zTail, p->nByte - p->iGap);
+        p->iGap = p->nByte;
+    }
+    p->z[p->nByte] = '\0';
+    *pnByte = p->nByte;
+    return p->z;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * docBufferInsert --
+ *
+ *     Insert n bytes of text z at byte offset iInsert of the document 
+ *     stored in gap buffer p. 
+ *
+ *     The gap is moved to iInsert (if it is not already there) and the 
+ *     new text copied into it. So a series of inserts at consecutive 
+ *     positions, as made by a document.write() loop, costs time 
+ *     proportional to the number of bytes inserted, plus at most one 
+ *     move of the text following the insertion point.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     May reallocate p->z, invalidating any pointer returned by an 
+ *     earlier call to docBufferText().
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+docBufferInsert (HtmlDocBuffer *p, int iInsert, const char *z, int n)
+{
+    assert(iInsert >= 0 && iInsert <= p->nByte);
+
+    /* Grow the buffer if the gap is too small. One byte is always 
+     * reserved past the end of the text for the nul-terminator added
+     * by docBufferText(). 
+     */
+    if (p->nGap < n + 1) {
+        int nTail = p->nByte - p->iGap;
+        int nAlloc = MAX(p->nAlloc * 2, p->nByte + n + 1);
+        nAlloc = MAX(nAlloc, 1024);
+        p->z = HtmlRealloc("HtmlDocBuffer.z", p->z, nAlloc);
+        memmove(&p->z[nAlloc - nTail], &p->z[p->iGap + p->nGap], nTail);
+        p->nGap = nAlloc - p->nByte;
+        p->nAlloc = nAlloc;
+    }
+
+    /* Move the gap to the insertion point. */
+    if (iInsert < p->iGap) {
+        int nMove = p->iGap - iInsert;
+        memmove(&p->z[iInsert + p->nGap], &p->z[iInsert], nMove);
+    } else if (iInsert > p->iGap) {
+        int nMove = iInsert - p->iGap;
+        memmove(&p->z[p->iGap], &p->z[p->iGap + p->nGap], nMove);
+    }
+    p->iGap = iInsert;
+
+    memcpy(&p->z[p->iGap], z, n);
+    p->iGap += n;
+    p->nGap -= n;
+    p->nByte += n;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * utf8CountChars --
+ *
+ *     Return the number of UTF-8 characters that begin within the n bytes
+ *     of text at z. i.e. the number of bytes that are not continuation 
+ *     bytes (10xxxxxx).
+ *
+ * Results:
+ *     Number of characters.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+utf8CountChars (const char *z, int n)
+{
+    int i;
+    int nChar = 0;
+    for (i = 0; i < n; i++) {
+        nChar += ((z[i] & 0xC0) != 0x80);
+    }
+    return nChar;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * utf8IndexExtend --
+ *
+ *     Add checkpoints to index p until it covers byte offset iByte of
+ *     string z. Or, if iChar is not negative, until it either covers 
+ *     the n byte string z or contains a checkpoint past character offset
+ *     iChar.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     May reallocate p->aChar.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+utf8IndexExtend (HtmlUtf8Index *p, const char *z, int iByte, int n, int iChar)
+{
+    if (p->nCheck == 0) {
+        p->nAlloc = 16;
+        p->aChar = (int *)HtmlAlloc("HtmlUtf8Index.aChar", 16 * sizeof(int));
+        p->aChar[0] = 0;
+        p->nCheck = 1;
+    }
+    while (1) {
+        int iNext = p->nCheck * HTML_UTF8_INDEX_STRIDE;
+        int nChar = p->aChar[p->nCheck - 1];
+        if (iChar < 0) {
+            if (iNext > iByte) break;
+        } else {
+            if (iNext > n || nChar > iChar) break;
+        }
+        if (p->nCheck == p->nAlloc) {
+            p->nAlloc = p->nAlloc * 2;
+            p->aChar = (int *)HtmlRealloc(
+                "HtmlUtf8Index.aChar", p->aChar, p->nAlloc * sizeof(int)
+            );
+        }
+        nChar += utf8CountChars(
+            &z[iNext - HTML_UTF8_INDEX_STRIDE], HTML_UTF8_INDEX_STRIDE
+        );
+        p->aChar[p->nCheck++] = nChar;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlUtf8CharOffset --
+ * HtmlUtf8ByteOffset --
+ *
+ *     Convert a byte offset within the n byte UTF-8 string z to a 
+ *     character offset, or vice versa, using (and extending as required)
+ *     the checkpoint index p. 
+ *
+ *     Finding the nearest checkpoint takes O(1) time for a byte offset 
+ *     and O(log n) for a character offset. At most HTML_UTF8_INDEX_STRIDE
+ *     bytes of the string are then scanned. Each part of the string is
+ *     only scanned once to build the index, however many conversions are
+ *     made.
+ *
+ *     A negative byte offset, or one greater than n, is treated as n. A
+ *     character offset past the end of the string is converted to n.
+ *
+ * Results:
+ *     The converted offset.
+ *
+ * Side effects:
+ *     May extend index p.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+HtmlUtf8CharOffset (HtmlUtf8Index *p, const char *z, int n, int iByte)
+{
+    int iCheck;
+    if (iByte < 0 || iByte > n) iByte = n;
+    utf8IndexExtend(p, z, iByte, n, -1);
+    iCheck = iByte / HTML_UTF8_INDEX_STRIDE;
+    return p->aChar[iCheck] + utf8CountChars(
+        &z[iCheck * HTML_UTF8_INDEX_STRIDE], 
+        iByte - iCheck * HTML_UTF8_INDEX_STRIDE
+    );
+}
+int
+HtmlUtf8ByteOffset (HtmlUtf8Index *p, const char *z, int n, int iChar)
+{
+    int iLo;
+    int iHi;
+    int i;
+    int nChar;
+
+    if (iChar <= 0) return 0;
+    utf8IndexExtend(p, z, 0, n, iChar);
+
+    /* Binary search for the last checkpoint at or before iChar. */
+    iLo = 0;
+    iHi = p->nCheck - 1;
+    while (iLo < iHi) {
+        int iMid = (iLo + iHi + 1) / 2;
+        if (p->aChar[iMid] <= iChar) {
+            iLo = iMid;
+        } else {
+            iHi = iMid - 1;
+        }
+    }
+
+    /* Scan forward from the checkpoint. A checkpoint may fall part way 
+     * through a character, so skip any leading continuation bytes. */
+    nChar = p->aChar[iLo];
+    for (i = iLo * HTML_UTF8_INDEX_STRIDE; i < n; i++) {
+        if ((z[i] & 0xC0) != 0x80) {
+            if (nChar == iChar) break;
+            nChar++;
+        }
+    }
+    return i;
+}
+
+void
+HtmlUtf8IndexClear (HtmlUtf8Index *p)
+{
+    if (p->aChar) {
+        HtmlFree(p->aChar);
+    }
+    memset(p, 0, sizeof(HtmlUtf8Index));
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlDocumentCharOffset --
+ *
+ *     Return the character offset corresponding to byte offset iByte of 
+ *     the document text (HtmlTree.document). iByte must not be greater
+ *     than the offset of the token currently being processed by the 
+ *     tokenizer.
+ *
+ * Results:
+ *     Character offset.
+ *
+ * Side effects:
+ *     May extend HtmlTree.documentIndex.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+HtmlDocumentCharOffset (HtmlTree *pTree, int iByte)
+{
+    int nZ;
+    const char *z = docBufferText(&pTree->document, &nZ);
+    return HtmlUtf8CharOffset(&pTree->documentIndex, z, nZ, iByte);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -650,9 +1382,17 @@ executeScript(
  *     with script handlers are built into the tree..
  *
  *     If zText is NULL, then the input text is in the Tcl_Obj* at
- *     HtmlTree.pDocument, starting at byte HtmlTree.nParsed. These
+ *     HtmlTree.document, starting at byte HtmlTree.nParsed. These
  *     two variables may be modified by this function.
  *
+ *     The tokenizer is a state machine. If the end of the input is reached
+ *     part way through a token (a run of text, a comment, a markup tag or
+ *     the body of a script block), the state required to resume scanning
+ *     the token is stored in HtmlTree.tokenizer and HtmlTree.nParsed is
+ *     left pointing to the first byte of the token. The next call picks up
+ *     where this one left off, so that each byte of a large partial token
+ *     is only examined once no matter how many chunks it arrives in.
+ *
  * Results:
  *
  * Side effects:
@@ -670,6 +1410,7 @@ HtmlTokenize (
 )
 {
     char *z;                     /* The input HTML text */
+    int nZ;                      /* Number of bytes in z */
     int c;                       /* The next character of input */
     int n;                       /* Number of bytes processed so far */
     int i, j;                    /* Loop counters */
@@ -679,30 +1420,76 @@ HtmlTokenize (
     char *argv[mxARG];           /* Pointers to each markup argument. */
     int arglen[mxARG];           /* Length of each markup argument */
 
-    /* True if a leading line-break should be trimmed if the next node
-     * is a text node.
+    /* Tokenizer state. For an [$html parse] command this is the persistent
+     * state stored in the HtmlTree structure. A fragment is always parsed
+     * in a single call, so a temporary structure is used instead.
+     */
+    HtmlTokenizer sFragment;
+    HtmlTokenizer *pTok;
+
+    /* Nodes created by [$html parse] are allocated from the widget arena.
+     * Fragment nodes may be deleted at any time, so they use the heap.
      */
-    int isTrimStart = 0;
+    HtmlArena *pArena = (zText ? 0 : &pTree->arena);
 
     if (zText) {
         /* This is an [$html fragment] command */
         n = 0;
         z = (char *)zText;
+        nZ = strlen(z);
+        memset(&sFragment, 0, sizeof(HtmlTokenizer));
+        pTok = &sFragment;
     } else {
         /* This is an [$html parse] command */
         n = pTree->nParsed;
-        z = Tcl_GetString(pTree->pDocument);
+        z = docBufferText(&pTree->document, &nZ);
+        pTok = &pTree->tokenizer;
     }
 
-    while ((c = z[n]) != 0) {
+    while (1) {
+        /* A node-handler callback may have appended text to the document
+         * using [$html parse], reallocating the buffer. So refresh z and
+         * nZ before each token.
+         */
+        if (!zText) {
+            z = docBufferText(&pTree->document, &nZ);
+        }
+        if ((c = z[n]) == 0) break;
         /* assert(n <= strlen(z)); */
-        
-        /* TEXT, HTML Comment, TAG (opening or closing) */
+
+        /* If no token is in progress, figure out what kind of token 
+         * starts at z[n]: TEXT, HTML Comment, CDATA section or TAG 
+         * (opening or closing). If there is not enough input to tell 
+         * (i.e. the document ends with "<!-"), bail out until more input
+         * arrives.
+         */
+        if (pTok->eState == HTML_TOKEN_NONE) {
+            int eComment;
+            int eCdata = 0;
+            if (c != '<') {
+                pTok->eState = HTML_TOKEN_TEXT;
+            } else if ((eComment = matchPrefix(&z[n], nZ-n, "<!--")) != 0) {
+                if (eComment < 0) goto incomplete;
+                pTok->eState = HTML_TOKEN_COMMENT;
+            } else if (
+                pTree->options.parsemode == HTML_PARSEMODE_XML && 
+                (eCdata = matchPrefix(&z[n], nZ - n, "<![CDATA[")) != 0
+            ) {
+                if (eCdata < 0) goto incomplete;
+                pTok->eState = HTML_TOKEN_CDATA;
+            } else {
+                pTok->eState = HTML_TOKEN_TAG;
+            }
+            pTok->iScan = 0;
+        }
 
         /* A text (or whitespace) node */
-        if (c != '<' && c != 0) {
+        if (pTok->eState == HTML_TOKEN_TEXT) {
             int isTrimEnd = 0;
-            for (i = 0; (c = z[n + i]) != 0 && c != '<'; i++);
+            i = pTok->iScan;
+            i += HtmlScanChar(&z[n + i], nZ - n - i, '<');
+            c = z[n + i];
+            pTok->iScan = i;
 
             /* If the next tag is a </PRE>, then skip the final newline
              * of this text node by setting isTrimEnd to true. TODO: It
@@ -712,14 +1499,15 @@ HtmlTokenize (
             if (c == '<') {
                 int iTmp = n+i+1;
                 while (ISSPACE(z[iTmp])) iTmp++;
+                if( !z[iTmp] && !isFinal ) goto incomplete;
                 if (z[iTmp] == '/') {
                     int iTmp2;
                     iTmp++;
                     while (ISSPACE(z[iTmp])) iTmp++;
-                    if( !z[iTmp] ) goto incomplete;
+                    if( !z[iTmp] && !isFinal ) goto incomplete;
                     iTmp2 = iTmp;
                     while (ISALPHA(z[iTmp2])) iTmp2++;
-                    if( !z[iTmp2] ) goto incomplete;
+                    if( !z[iTmp2] && !isFinal ) goto incomplete;
                     if( 0==strnicmp(&z[iTmp], "pre", iTmp2-iTmp) ){
                         isTrimEnd = 1;
                     }
@@ -727,53 +1515,55 @@ HtmlTokenize (
             }
 
             if (c || isFinal) {
-                int ts = isTrimStart;
-                HtmlTextNode *pTextNode = HtmlTextNew(i, &z[n], isTrimEnd, ts);
+                int ts = pTok->isTrimStart;
+                HtmlTextNode *pTextNode;
+                pTextNode = HtmlTextNew(pArena, i, &z[n], isTrimEnd, ts);
+                pTok->eState = HTML_TOKEN_NONE;
+                pTok->isTrimStart = 0;
                 xAddText(pTree, pTextNode, n);
                 n += i;
             } else {
                 goto incomplete;
             }
-            isTrimStart = 0;
         }
 
         /* An HTML comment. Just skip it. Tkhtml uses the non-SGML (i.e.
          * defacto standard) version of HTML comments - they begin with
          * "<!--" and end with "-->".
          */
-        else if (strncmp(&z[n], "<!--", 4) == 0) {
-            for (i = 4; z[n + i]; i++) {
-                if (z[n + i] == '-' && strncmp(&z[n + i], "-->", 3) == 0) {
-                    break;
-                }
-            }
+        else if (pTok->eState == HTML_TOKEN_COMMENT) {
+            i = MAX(4, pTok->iScan);
+            i += HtmlScanComment(&z[n + i], nZ - n - i);
             if (z[n + i] == 0) {
+                /* Resume the search 2 bytes from the end of the input, in
+                 * case the "-->" is split across two chunks. */
+                pTok->iScan = MAX(4, i - 2);
                 goto incomplete;
             }
             n += i + 3;
-            isTrimStart = 0;
+            pTok->eState = HTML_TOKEN_NONE;
+            pTok->isTrimStart = 0;
         }
 
-        else if (
-            pTree->options.parsemode == HTML_PARSEMODE_XML && 
-            0 == strncmp(&z[n], "<![CDATA[", 9)
-        ) {
+        else if (pTok->eState == HTML_TOKEN_CDATA) {
             const char *zData = &z[n+9];
             int nData;
-            for (i = 9; z[n + i]; i++) {
+            for (i = MAX(9, pTok->iScan); z[n + i]; i++) {
                 if (z[n + i] == ']' && strncmp(&z[n + i], "]]>", 3) == 0) {
                     break;
                 }
             }
             if (z[n + i] == 0) {
+                pTok->iScan = MAX(9, i - 2);
                 goto incomplete;
             }
             n += i + 3;
+            pTok->eState = HTML_TOKEN_NONE;
 
             nData = i - 9;
-            xAddText(pTree, HtmlTextNew(nData, zData, 0, 0), 0);
+            xAddText(pTree, HtmlTextNew(pArena, nData, zData, 0, 0), 0);
 
-            isTrimStart = 0;
+            pTok->isTrimStart = 0;
         }
 
         /* A markup tag (i.e "<p>" or <p color="red"> or </p>). We parse 
@@ -784,8 +1574,12 @@ HtmlTokenize (
          * The first element of the vector is the markup tag name (i.e. "p" 
          * or "/p"). Each attribute consumes two elements of the vector, 
          * the attribute name and the value.
+         *
+         * Before the tag is parsed, scanTagEnd() is used to make sure the
+         * whole tag is present. So once parsing begins, it always runs
+         * to completion.
          */
-        else {
+        else if (pTok->eState == HTML_TOKEN_TAG) {
             /* At this point, &z[n] points to the "<" character that opens
              * a markup tag. Variable 'i' is used to record the current
              * position, relative to &z[n], while parsing the tags name
@@ -799,6 +1593,11 @@ HtmlTokenize (
             const char *zAtom = 0;
             int eType = 0;
 
+            if (scanTagEnd(pTok, &z[n], nZ - n) < 0) {
+                goto incomplete;
+            }
+            pTok->eState = HTML_TOKEN_NONE;
+
             argc = 1;
             argv[0] = &z[n + 1];
             assert( c=='<' );
@@ -940,19 +1739,15 @@ HtmlTokenize (
              * HtmlHashLookup(). It would be easy enough to fix 
              * HtmlHashLookup() to understand a length argument.
              */
-            HtmlHashInit(0, 0);
             c = argv[0][arglen[0]];
             argv[0][arglen[0]] = 0;
             pMap = HtmlHashLookup(0, argv[0]);
             if (pMap == 0) {
-                Tcl_HashEntry *pEntry;
-                int dummy;
                 if (pTree->options.parsemode != HTML_PARSEMODE_XML){
                     argv[0][arglen[0]] = c;
                     continue;
                 }
-                pEntry = Tcl_CreateHashEntry(&pTree->aAtom, argv[0], &dummy);
-                zAtom = Tcl_GetHashKey(&pTree->aAtom, pEntry);
+                zAtom = HtmlTreeAtom(pTree, argv[0]);
                 eType = 0;
             } else {
                 zAtom = pMap->zName;
@@ -964,106 +1759,159 @@ HtmlTokenize (
                 /* Closing tag (i.e. "</p>"). */
                 xAddClosing(pTree, eType, zAtom, nStartScript);
             } else {
-
-                char *zScript = 0;
-                int nScript = 0;
-
                 HtmlAttributes *pAttr;
-                Tcl_Obj *pScript = 0;
                 const char **zArgs = (const char **)(&argv[1]);
-                pAttr = HtmlAttributesNew(argc - 1, zArgs, &arglen[1], 1);
+                pAttr = HtmlAttributesNew(
+                    pTree, pArena, argc - 1, zArgs, &arglen[1], 1
+                );
 
-
-                /* Unless a fragment is being parsed, search for a 
+                /* Unless a fragment is being parsed, check for a 
                  * script-handler for this element. Script handlers are
                  * never fired from within [$html fragment] commands.
+                 *
+                 * If there is a script handler, or this is an element
+                 * with PCDATA content (i.e. <textarea>), the tokenizer
+                 * switches to HTML_TOKEN_SCRIPT state to search for the 
+                 * end of the block. In that state the parsed opening tag 
+                 * is stored in the tokenizer state. n is set back to the
+                 * start of the opening tag so that nParsed is not advanced
+                 * past it until the whole block has been seen.
                  */
-                if (!zText) {
-                    pScript = getScriptHandler(pTree, eType);
+                if (
+                    (!zText && getScriptHandler(pTree, eType)) || 
+                    (pMap && pMap->flags & HTMLTAG_PCDATA)
+                ) {
+                    pTok->eState = HTML_TOKEN_SCRIPT;
+                    pTok->iScan = n - nStartScript;
+                    pTok->iScript = n - nStartScript;
+                    pTok->eType = eType;
+                    pTok->zAtom = zAtom;
+                    pTok->pAttr = pAttr;
+                    n = nStartScript;
+                    continue;
                 }
 
-                if (pScript || (pMap && pMap->flags & HTMLTAG_PCDATA)) {
-                    zScript = &z[n];
-                    nScript = findEndOfScript(eType, z, &n);
-                    if (nScript < 0) {
-                        n = nStartScript;
-                        HtmlFree(pAttr);
-                        goto incomplete;
-                    }
+                /* No special handler for this markup. Just append 
+                 * it to the list of all tokens. 
+                 */
+                assert(nStartScript >= 0);
+                xAddElement(pTree, eType, zAtom, pAttr, nStartScript);
+                if( pTree->eWriteState==HTML_WRITE_INHANDLERRESET ){
+                    goto incomplete;
                 }
+                if (eType == Html_PRE) {
+                    pTok->isTrimStart = 1;
+                }
+                if (isSelfClosing) {
+                    xAddClosing(pTree, eType, zAtom, n);
+                }
+            }
+        }
 
-                if (!pScript) {
+        /* The body of a script block or an element with PCDATA content. 
+         * The opening tag has already been parsed, pTok->iScript is the
+         * offset of the first byte of the block content relative to
+         * the start of the opening tag (z[n]).
+         */
+        else {
+            int nStartScript = n;
+            int iScan = n + pTok->iScan;
+            int iScript = n + pTok->iScript;
+            char *zScript;
+            int nScript;
+            int eType = pTok->eType;
+            const char *zAtom = pTok->zAtom;
+            HtmlAttributes *pAttr;
+            Tcl_Obj *pScript = 0;
+
+            assert(pTok->eState == HTML_TOKEN_SCRIPT);
+            nScript = findEndOfScript(eType, z, nZ, iScript, &iScan);
+            if (nScript < 0) {
+                pTok->iScan = iScan - n;
+                goto incomplete;
+            }
+            n = iScan;
+            zScript = &z[iScript];
 
-                    /* No special handler for this markup. Just append 
-                     * it to the list of all tokens. 
-                     */
-                    assert(nStartScript >= 0);
-                    xAddElement(pTree, eType, zAtom, pAttr, nStartScript);
-                    if( pTree->eWriteState==HTML_WRITE_INHANDLERRESET ){
-                        goto incomplete;
-                    }
-                    if (zScript) {
-                        HtmlTextNode *pTextNode;
-                        pTextNode = HtmlTextNew(nScript, zScript, 1, 1);
-                        xAddText(pTree, pTextNode, n);
-                        xAddClosing(pTree, eType, zAtom, n);
-                    } else {
-                        if (eType == Html_PRE) {
-                            isTrimStart = 1;
-                        }
-                        if (isSelfClosing) {
-                            xAddClosing(pTree, eType, zAtom, n);
-                        }
-                    }
+            pAttr = pTok->pAttr;
+            pTok->pAttr = 0;
+            pTok->eState = HTML_TOKEN_NONE;
 
-                } else {
-                    /* If pScript is not NULL, then we are parsing a node that
-                     * tkhtml treats as a "script". Essentially this means we
-                     * will pass the entire text of the node to some user
-                     * callback for processing and take no further action. So
-                     * we just search through the text until we encounter
-                     * </script>, </noscript> or whatever closing tag matches
-                     * the tag that opened the script node.
-                     */
-                    int rc;
-                    HtmlCallbackRestyle(pTree, pTree->state.pCurrent);
-
-                    assert(pTree->eWriteState == HTML_WRITE_NONE);
-                    pTree->eWriteState = HTML_WRITE_INHANDLER;
-                    pTree->iWriteInsert = n;
-                    rc = executeScript(pTree, pScript, pAttr, zScript, nScript);
-
-                    assert(
-                        pTree->eWriteState == HTML_WRITE_INHANDLER || 
-                        pTree->eWriteState == HTML_WRITE_INHANDLERWAIT ||
-                        pTree->eWriteState == HTML_WRITE_INHANDLERRESET
-                    );
-                    switch (pTree->eWriteState) {
-                        case HTML_WRITE_INHANDLER:
-                            pTree->eWriteState = HTML_WRITE_NONE;
-                            break;
-                        case HTML_WRITE_INHANDLERWAIT:
-                            pTree->eWriteState = HTML_WRITE_WAIT;
-                            break;
-                        case HTML_WRITE_INHANDLERRESET:
-                            pTree->eWriteState = HTML_WRITE_NONE;
-                            return 0;
-                    }
-                    z = Tcl_GetString(pTree->pDocument);
+            if (!zText) {
+                pScript = getScriptHandler(pTree, eType);
+            }
 
-                    HtmlFree(pAttr);
-                    isTrimStart = 0;
+            if (!pScript) {
+                HtmlTextNode *pTextNode;
 
-                    if (pTree->eWriteState == HTML_WRITE_WAIT) {
-                        goto incomplete;
-                    }
+                /* No special handler for this markup. Just append 
+                 * it to the list of all tokens. 
+                 */
+                assert(nStartScript >= 0);
+                xAddElement(pTree, eType, zAtom, pAttr, nStartScript);
+                if( pTree->eWriteState==HTML_WRITE_INHANDLERRESET ){
+                    goto incomplete;
+                }
+                if (!zText) {
+                    z = docBufferText(&pTree->document, &nZ);
+                    zScript = &z[iScript];
+                }
+                pTextNode = HtmlTextNew(pArena, nScript, zScript, 1, 1);
+                xAddText(pTree, pTextNode, n);
+                xAddClosing(pTree, eType, zAtom, n);
+            } else {
+                /* If pScript is not NULL, then we are parsing a node that
+                 * tkhtml treats as a "script". Essentially this means we
+                 * will pass the entire text of the node to some user
+                 * callback for processing and take no further action. So
+                 * we just search through the text until we encounter
+                 * </script>, </noscript> or whatever closing tag matches
+                 * the tag that opened the script node.
+                 */
+                int rc;
+                HtmlCallbackRestyle(pTree, pTree->state.pCurrent);
+
+                assert(pTree->eWriteState == HTML_WRITE_NONE);
+                pTree->eWriteState = HTML_WRITE_INHANDLER;
+                pTree->iWriteInsert = n;
+                rc = executeScript(pTree, pScript, pAttr, zScript, nScript);
+
+                assert(
+                    pTree->eWriteState == HTML_WRITE_INHANDLER || 
+                    pTree->eWriteState == HTML_WRITE_INHANDLERWAIT ||
+                    pTree->eWriteState == HTML_WRITE_INHANDLERRESET
+                );
+                switch (pTree->eWriteState) {
+                    case HTML_WRITE_INHANDLER:
+                        pTree->eWriteState = HTML_WRITE_NONE;
+                        break;
+                    case HTML_WRITE_INHANDLERWAIT:
+                        pTree->eWriteState = HTML_WRITE_WAIT;
+                        break;
+                    case HTML_WRITE_INHANDLERRESET:
+                        /* pAttr was allocated from the arena, which has
+                         * already been released by HtmlTreeClear(). */
+                        pTree->eWriteState = HTML_WRITE_NONE;
+                        return 0;
+                }
+                z = docBufferText(&pTree->document, &nZ);
+
+                HtmlArenaFree(pArena, pAttr);
+                pTok->isTrimStart = 0;
+
+                if (pTree->eWriteState == HTML_WRITE_WAIT) {
+                    goto incomplete;
                 }
             }
         }
     }
 
   incomplete:
-    if (!zText && pTree->eWriteState != HTML_WRITE_INHANDLERRESET) {
+    if (zText) {
+        if (sFragment.pAttr) {
+            HtmlFree(sFragment.pAttr);
+        }
+    } else if (pTree->eWriteState != HTML_WRITE_INHANDLERRESET) {
         pTree->nParsed = n;
     }
     return n;
@@ -1092,6 +1940,9 @@ tokenizeWrapper (
     if (pTree->isParseFinished && pTree->eWriteState==HTML_WRITE_NONE) {
         HtmlFinishNodeHandlers(pTree);
     }
+    if (pTree->eWriteState == HTML_WRITE_NONE) {
+        HtmlFlushHandlerBatches(pTree);
+    }
 
     if (pTree->eWriteState != HTML_WRITE_INHANDLERRESET) {
         pCurrent = pTree->state.pCurrent;
@@ -1138,14 +1989,7 @@ HtmlTokenizerAppend (HtmlTree *pTree, const char *zText, int nText, int isFinal)
     int n = nText;
     /* Tcl_DString utf8; */
 
-    if (!pTree->pDocument) {
-        pTree->pDocument = Tcl_NewObj();
-        Tcl_IncrRefCount(pTree->pDocument);
-        assert(!Tcl_IsShared(pTree->pDocument));
-    }
-
-    assert(!Tcl_IsShared(pTree->pDocument));
-    Tcl_AppendToObj(pTree->pDocument, z, n);
+    docBufferInsert(&pTree->document, pTree->document.nByte, z, n);
 
     if (pTree->eWriteState == HTML_WRITE_NONE) {
         tokenizeWrapper(pTree, isFinal, 
@@ -1165,6 +2009,10 @@ HtmlTokenizerAppend (HtmlTree *pTree, const char *zText, int nText, int isFinal)
  *     Return a pointer to its value, or the given default
  *     value if it doesn't appear.
  *
+ *     Attribute names are atoms (see HtmlTreeAtom()), so if zTag is
+ *     itself an atom the comparison is a pointer comparison. Otherwise
+ *     names are compared without regard to case, as atoms are.
+ *
  * Results:
  *     None.
  *
@@ -1179,7 +2027,8 @@ HtmlMarkupArg (HtmlAttributes *pAttr, const char *zTag, char *zDefault)
     int i;
     if (pAttr) {
         for (i = 0; i < pAttr->nAttr; i++) {
-            if (strcmp(pAttr->a[i].zName, zTag) == 0) {
+            const char *zName = pAttr->a[i].zName;
+            if (zName == zTag || stricmp(zName, zTag) == 0) {
                 return pAttr->a[i].zValue;
             }
         }
@@ -1233,11 +2082,8 @@ HtmlWriteWait (HtmlTree *pTree)
 int 
 HtmlWriteText(HtmlTree *pTree, Tcl_Obj *pText)
 {
-    int iInsert = pTree->iWriteInsert;
-  
-    Tcl_Obj *pDocument = pTree->pDocument;
-    Tcl_Obj *pHead;
-    Tcl_Obj *pTail;
+    const char *zText;
+    int nText;
 
     if (pTree->eWriteState == HTML_WRITE_NONE) {
         char *zErr = "Cannot call [write text] here";
@@ -1245,16 +2091,9 @@ HtmlWriteText(HtmlTree *pTree, Tcl_Obj *pText)
         return TCL_ERROR;
     }
 
-    pHead = Tcl_NewStringObj(Tcl_GetString(pDocument), iInsert);
-    pTail = Tcl_NewStringObj(&(Tcl_GetString(pDocument)[iInsert]), -1);
-
-    Tcl_IncrRefCount(pHead);
-    Tcl_AppendObjToObj(pHead, pText);
-    Tcl_GetStringFromObj(pHead, &pTree->iWriteInsert);
-    Tcl_AppendObjToObj(pHead, pTail);
-
-    Tcl_DecrRefCount(pDocument);
-    pTree->pDocument = pHead;
+    zText = Tcl_GetStringFromObj(pText, &nText);
+    docBufferInsert(&pTree->document, pTree->iWriteInsert, zText, nText);
+    pTree->iWriteInsert += nText;
  
     return TCL_OK;
 }
@@ -1833,9 +1833,9 @@ getPrototypeCreator (HtmlTree *pTree, unsigned int *pMask, int *piCopyBytes)
 
     if (0 == pTree->pPrototypeCreator) {
         HtmlComputedValuesCreator *p;
-        static CssProperty Black   = {CSS_CONST_BLACK, {"black"}};
-        static CssProperty Medium  = {CSS_CONST_MEDIUM, {"medium"}};
-        static CssProperty Trans   = {CSS_CONST_TRANSPARENT, {"transparent"}};
+        static CssProperty Black   = {CSS_CONST_BLACK, 0, {"black"}};
+        static CssProperty Medium  = {CSS_CONST_MEDIUM, 0, {"medium"}};
+        static CssProperty Trans   = {CSS_CONST_TRANSPARENT, 0, {"transparent"}};
         HtmlComputedValues *pValues;
         char *values;
     
@@ -1953,6 +1953,7 @@ HtmlComputedValuesInit (
      */
     pPrototype = getPrototypeCreator(pTree, &iCopyMask, &iCopyBytes);
     memcpy(p, pPrototype, sizeof(HtmlComputedValuesCreator));
+    p->isNodeDependent = 0;
     p->pTree = pTree;
     p->pParent = pParent;
     p->pNode = pNode;
@@ -2195,8 +2196,12 @@ HtmlComputedValuesSet (HtmlComputedValuesCreator *p, int eProp, CssProperty *pPr
         return 0;
     }
 
-    /* Special case - a Tcl script to evaluate */
+    /* Special case - a Tcl script to evaluate. The result may depend on
+     * anything about the node, so the computed values may not be shared
+     * with any other node (see HtmlCssStyleSheetApply()).
+     */
     if (pProp->eType == CSS_TYPE_TCL) {
+        p->isNodeDependent = 1;
         return propertyValuesTclScript(p, eProp, pProp->v.zVal);
     }
 
@@ -2937,11 +2942,24 @@ HtmlComputedValuesSetupTables (HtmlTree *pTree)
     Tcl_InitCustomHashTable(&pTree->aFontFamilies, TCL_CUSTOM_TYPE_KEYS, pType);
     Tcl_Eval(interp, "font families");
     Tcl_ListObjGetElements(NULL, Tcl_GetObjResult(interp), &nFamily, &apFamily);
+    pTree->iFontFamilies = 0;
     for (ii = 0; ii < nFamily; ii++) {
+        const char *zFamily = Tcl_GetString(apFamily[ii]);
         Tcl_HashEntry *pEntry = Tcl_CreateHashEntry(
-            &pTree->aFontFamilies, Tcl_GetString(apFamily[ii]), &dummy
+            &pTree->aFontFamilies, zFamily, &dummy
         );
         Tcl_SetHashValue(pEntry, 0);
+
+        /* Checksum the list of families. Stylesheet rules parsed by one
+         * widget are only shared with another if both have the same 
+         * font families (see ruleSetKey() in css.c).
+         */
+        for ( ; *zFamily; zFamily++) {
+            pTree->iFontFamilies = (pTree->iFontFamilies << 3) + 
+                pTree->iFontFamilies + (unsigned char)(*zFamily);
+        }
+        pTree->iFontFamilies = (pTree->iFontFamilies << 3) + 
+            pTree->iFontFamilies;
        
         /* Note that sometimes the [font families] command returns a list
          * containing duplicate elements. Therefore we cannot "assert(dummy)".
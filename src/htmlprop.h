@@ -330,6 +330,8 @@ struct HtmlComputedValuesCreator {
 
     CssProperty *pContent;
     char **pzContent;
+
+    int isNodeDependent;             /* True if a tcl() value was used */
 };
 
 /*
@@ -47,8 +47,8 @@ HtmlDelScrollbars (HtmlTree *pTree, HtmlNode *pNode)
 {
     HtmlElementNode *pElem = (HtmlElementNode *)pNode;
 
-    if (!HtmlNodeIsText(pNode) && pElem->pScrollbar) {
-        HtmlNodeScrollbars *p = pElem->pScrollbar;
+    if (!HtmlNodeIsText(pNode) && HtmlElemRare(pElem, pScrollbar)) {
+        HtmlNodeScrollbars *p = pElem->pRare->pScrollbar;
         if (p->vertical.win) {
 	    /* Remove any entry from the HtmlTree.pMapped list. */
             if (&p->vertical == pTree->pMapped) {
@@ -82,7 +82,7 @@ HtmlDelScrollbars (HtmlTree *pTree, HtmlNode *pNode)
             Tcl_DecrRefCount(p->horizontal.pReplace);
         }
         HtmlFree(p);
-        pElem->pScrollbar = 0;
+        pElem->pRare->pScrollbar = 0;
     }
 }
 
@@ -543,6 +543,11 @@ struct StyleApply {
   /* True if the whole tree is being restyled. */
   int isRoot;
 
+  /* True if elements that match the keys of rules recently added to the
+   * stylesheet are to be restyled (see HtmlCssInvalidationTest()).
+   */
+  int isPartial;
+
   StyleCounter **apCounter;
   int nCounter;
   int nCounterAlloc;
@@ -558,9 +563,12 @@ styleApply (HtmlTree *pTree, HtmlNode *pNode, StyleApply *p)
 {
     int i;
     int doStyle;
+    int isInvalid = 0;
     int nCounterStartScope;
     int redrawmode = 0;
     HtmlElementNode *pElem = HtmlNodeAsElement(pNode);
+    HtmlNodeReplacement *pReplace;
+    HtmlNode *pGenerated;
 
     /* Text nodes do not have an associated style. */
     if (!pElem) return;
@@ -569,18 +577,38 @@ styleApply (HtmlTree *pTree, HtmlNode *pNode, StyleApply *p)
         p->doStyle = 1;
     }
 
+    /* If rules have been added to the stylesheet that may match this
+     * element, restyle it and its descendants (but not, as for pRestyle,
+     * its right-siblings).
+     */
+    if (!p->doStyle && p->isPartial && HtmlCssInvalidationTest(pTree, pNode)) {
+        p->doStyle = 1;
+        isInvalid = 1;
+    }
+
     if (p->doStyle) {
         redrawmode = styleNode(pTree, pNode, (ClientData) ((size_t) p->isRoot));
 
         /* If there has been a style-callback configured (-stylecmd option to
          * the [nodeHandle replace] command) for this node, invoke it now.
          */
-        if (pElem->pReplacement && pElem->pReplacement->pStyleCmd) {
-            Tcl_Obj *pCmd = pElem->pReplacement->pStyleCmd;
+        pReplace = HtmlElemRare(pElem, pReplacement);
+        if (pReplace && pReplace->pStyleCmd) {
+            Tcl_Obj *pCmd = pReplace->pStyleCmd;
             int rc = Tcl_EvalObjEx(pTree->interp, pCmd, TCL_EVAL_GLOBAL);
             if (rc != TCL_OK) {
                 Tcl_BackgroundError(pTree->interp);
             }
+
+            /* The script may have modified or deleted elements in the
+             * style-sharing list. Start a new one. Elements matched by
+             * the parallel match phase may also have been modified, so
+             * discard its results.
+             */
+            HtmlCssStyleShareFree(pTree->pStyleShare);
+            pTree->pStyleShare = HtmlCssStyleShareNew();
+            HtmlCssMatchBatchFree(pTree->pMatchBatch);
+            pTree->pMatchBatch = 0;
         }
     }
 
@@ -590,42 +618,49 @@ styleApply (HtmlTree *pTree, HtmlNode *pNode, StyleApply *p)
 
     if (p->doStyle || p->doContent) {
         /* Destroy current generated content */
-        if (pElem->pBefore || pElem->pAfter) {
+        if (HtmlElemRare(pElem, pBefore) || HtmlElemRare(pElem, pAfter)) {
             HtmlNodeClearGenerated(pTree, pElem);
             redrawmode = MAX(redrawmode, 2);
         }
 
         /* Generate :before content */
         HtmlCssStyleGenerateContent(pTree, pElem, 1);
-        if (pElem->pBefore) {
-            ((HtmlElementNode *)(pElem->pBefore))->pStack = pElem->pStack;
-            pElem->pBefore->pParent = pNode;
-            pElem->pBefore->iNode = -1;
+        pGenerated = HtmlElemRare(pElem, pBefore);
+        if (pGenerated) {
+            ((HtmlElementNode *)pGenerated)->pStack = pElem->pStack;
+            pGenerated->pParent = pNode;
+            pGenerated->iNode = -1;
         }
-    } else if (pElem->pBefore) {
-        HtmlStyleHandleCounters(pTree, HtmlNodeComputedValues(pElem->pBefore));
+    } else if ((pGenerated = HtmlElemRare(pElem, pBefore))) {
+        HtmlStyleHandleCounters(pTree, HtmlNodeComputedValues(pGenerated));
     }
 
     doStyle = p->doStyle;
+    HtmlCssAncestorFilterPush(pTree->pAncestorFilter, pNode);
     for (i = 0; i < HtmlNodeNumChildren(pNode); i++) {
         styleApply(pTree, HtmlNodeChild(pNode, i), p);
     }
+    HtmlCssAncestorFilterPop(pTree->pAncestorFilter);
     p->doStyle = doStyle;
 
     if (p->doStyle || p->doContent) {
         /* Generate :after content */
         HtmlCssStyleGenerateContent(pTree, pElem, 0);
-        if (pElem->pAfter) {
-            ((HtmlElementNode *)(pElem->pAfter))->pStack = pElem->pStack;
-            pElem->pAfter->pParent = pNode;
-            pElem->pAfter->iNode = -1;
+        pGenerated = HtmlElemRare(pElem, pAfter);
+        if (pGenerated) {
+            ((HtmlElementNode *)pGenerated)->pStack = pElem->pStack;
+            pGenerated->pParent = pNode;
+            pGenerated->iNode = -1;
         }
 
-        if (pElem->pBefore || pElem->pAfter) {
+        if (HtmlElemRare(pElem, pBefore) || HtmlElemRare(pElem, pAfter)) {
             redrawmode = MAX(redrawmode, 2);
         }
-    } else if(pElem->pAfter) {
-        HtmlStyleHandleCounters(pTree, HtmlNodeComputedValues(pElem->pAfter));
+    } else if ((pGenerated = HtmlElemRare(pElem, pAfter))) {
+        HtmlStyleHandleCounters(pTree, HtmlNodeComputedValues(pGenerated));
+    }
+    if (isInvalid) {
+        p->doStyle = 0;
     }
 
     for (i = p->nCounterStartScope; i < p->nCounter; i++) {
@@ -809,12 +844,24 @@ HtmlStyleApply (HtmlTree *pTree, HtmlNode *pNode)
     memset(&sApply, 0, sizeof(StyleApply));
     sApply.pRestyle = pNode;
     sApply.isRoot = isRoot;
+    sApply.isPartial = (!isRoot && HtmlCssInvalidationIsPartial(pTree));
+    HtmlCssInvalidationBegin(pTree);
 
     assert(pTree->pStyleApply == 0);
     pTree->pStyleApply = (void *)&sApply;
+    pTree->pAncestorFilter = HtmlCssAncestorFilterNew();
+    pTree->pStyleShare = HtmlCssStyleShareNew();
+    pTree->pMatchBatch = (isRoot ? HtmlCssMatchBatchNew(pTree) : 0);
     styleApply(pTree, pTree->pRoot, &sApply);
+    HtmlCssAncestorFilterFree(pTree->pAncestorFilter);
+    HtmlCssStyleShareFree(pTree->pStyleShare);
+    HtmlCssMatchBatchFree(pTree->pMatchBatch);
+    pTree->pAncestorFilter = 0;
+    pTree->pStyleShare = 0;
+    pTree->pMatchBatch = 0;
     pTree->pStyleApply = 0;
     pTree->isFixed = sApply.isFixed;
+    HtmlCssInvalidationClear(pTree);
     HtmlFree(sApply.apCounter);
     return TCL_OK;
 }
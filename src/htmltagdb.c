@@ -54,39 +54,47 @@ static const char rcsid[] = "$Id: htmltagdb.c,v 1.11 2007/11/11 11:00:48 danielk
 
 extern HtmlTokenMap HtmlMarkupMap[];
 
-
-/* The hash table for HTML markup names.
-**
-** If an HTML markup name hashes to H, then apMap[H] will point to
-** a linked list of sgMap structure, one of which will describe the
-** the particular markup (if it exists.)
-*/
-static HtmlTokenMap *apMap[HTML_MARKUP_HASH_SIZE];
-
-/* Hash a markup name
-**
-** HTML markup is case insensitive, so this function will give the
-** same hash regardless of the case of the markup name.
-**
-** The value returned is an integer between 0 and HTML_MARKUP_HASH_SIZE-1,
-** inclusive.
+/* The perfect hash table for HTML markup names. Both arrays are generated
+** along with HtmlMarkupMap[] by tokenlist.txt. See HtmlHashLookup().
 */
-static int 
-HtmlHash (void *htmlPtr, const char *zName)
+extern const int HtmlMarkupHash[];
+extern const unsigned char HtmlMarkupSlot[];
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlPerfectHash --
+ *
+ *     Compute the 32-bit FNV-1a hash of the first n bytes of string z,
+ *     using iSeed as the offset basis (or the standard FNV basis if iSeed
+ *     is 0). If isFold is true, ASCII upper-case characters are hashed as
+ *     if they were lower-case.
+ *
+ *     This is the hash function used by the perfect hash tables generated
+ *     at build time for tag names and named character references. It
+ *     must match the [phash_fnv] procedure in mkperfecthash.tcl.
+ *
+ * Results:
+ *     Hash value.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+unsigned int
+HtmlPerfectHash (unsigned int iSeed, const char *z, int n, int isFold)
 {
-    int h = 0;
-    char c;
-    while ((c = *zName) != 0) {
-        if (isupper(c)) {
-            c = tolower(c);
+    unsigned int h = (iSeed ? iSeed : 0x811C9DC5);
+    int i;
+    for (i = 0; i < n; i++) {
+        unsigned char c = (unsigned char)z[i];
+        if (isFold && c >= 'A' && c <= 'Z') {
+            c += ('a' - 'A');
         }
-        h = h << 5 ^ h ^ c;
-        zName++;
-    }
-    if (h < 0) {
-        h = -h;
+        h = ((h ^ c) * 0x01000193) & 0xFFFFFFFF;
     }
-    return h % HTML_MARKUP_HASH_SIZE;
+    return h;
 }
 
 /*
@@ -132,8 +140,7 @@ HtmlMarkup (int markup)
             "text",
             Html_Text,
             HTMLTAG_INLINE,
-            textContent,
-            0
+            textContent
         };
         return &textmapentry;
     } else if (markup > 0) {
@@ -209,15 +216,16 @@ HtmlMarkupName(int markup)
  *
  * HtmlHashLookup --
  *
- *     Look up an HTML tag name in the hash-table.
+ *     Look up an HTML tag name in the hash-table. The table is a perfect
+ *     hash generated at build time (see tokenlist.txt), so at most one
+ *     string comparison is required.
  *
  * Results: 
  *     Return the corresponding HtmlTokenMap if the tag name is recognized,
  *     or NULL otherwise.
  *
  * Side effects:
- *     May initialise the hash table from the autogenerated array
- *     in htmltokens.c (generated from tokenlist.txt).
+ *     None.
  *
  *---------------------------------------------------------------------------
  */
@@ -227,50 +235,36 @@ HtmlHashLookup (
     const char *zType          /* Null terminated tag name. eg. "br" */
 )
 {
-    HtmlTokenMap *pMap;         /* For searching the markup name hash table */
-    int h;                      /* The hash on zType */
-    char buf[256];
-    HtmlHashInit(htmlPtr, 0);
-
-    h = HtmlHash(htmlPtr, zType);
-    for (pMap = apMap[h]; pMap; pMap = pMap->pCollide) {
-        if (stricmp(pMap->zName, zType) == 0) {
-            return pMap;
-        }
+    HtmlTokenMap *pMap;         /* Candidate entry in HtmlMarkupMap */
+    int nType = strlen(zType);
+    int d;                      /* Displacement for first-level hash */
+    int iSlot;                  /* Slot zType hashes to */
+
+    d = HtmlMarkupHash[
+        HtmlPerfectHash(0, zType, nType, 1) % HTML_MARKUP_HASH_SIZE
+    ];
+    if (d < 0) {
+        iSlot = -1 - d;
+    } else {
+        iSlot = HtmlPerfectHash(d, zType, nType, 1) % HTML_MARKUP_HASH_SIZE;
     }
-    strncpy(buf, zType, 255);
-    buf[255] = 0;
-
-    return NULL;
-}
-
-/* Initialize the escape sequence hash table
-*/
-void 
-HtmlHashInit (void *htmlPtr, int start)
-{
-    static int isInit = 0;
-
-    int i;         /* For looping thru the list of markup names */
-    int h;         /* The hash on a markup name */
-
-    if (isInit) return;
 
-    for (i = start; i < HTML_MARKUP_COUNT; i++) {
-        h = HtmlHash(htmlPtr, HtmlMarkupMap[i].zName);
-        HtmlMarkupMap[i].pCollide = apMap[h];
-        apMap[h] = &HtmlMarkupMap[i];
+    pMap = &HtmlMarkupMap[HtmlMarkupSlot[iSlot]];
+    if (stricmp(pMap->zName, zType) == 0) {
+        return pMap;
     }
-#ifdef TEST
-    HtmlHashStats(htmlPtr);
-#endif
-
-    isInit = 1;
+    return NULL;
 }
 
-
 HtmlAttributes *
-HtmlAttributesNew (int argc, char const **argv, int *arglen, int doEscape)
+HtmlAttributesNew (
+    HtmlTree *pTree,             /* Tree to intern attribute names in */
+    HtmlArena *pArena,           /* Arena to allocate from (or NULL) */
+    int argc,                    /* Number of names and values in argv */
+    char const **argv,           /* Attribute names and values */
+    int *arglen,                 /* Length of each string in argv */
+    int doEscape                 /* True to translate html escapes */
+)
 {
     HtmlAttributes *pMarkup = 0;
 
@@ -280,28 +274,36 @@ HtmlAttributesNew (int argc, char const **argv, int *arglen, int doEscape)
         char *zBuf;
 
         int nAttr = argc / 2;
+        int nName = 0;              /* Largest attribute name in bytes */
 
         nByte = sizeof(HtmlAttributes);
-        for (j = 0; j < argc; j++) {
-            nByte += arglen[j] + 1;
+        for (j = 0; j < nAttr * 2; j += 2) {
+            nName = MAX(nName, arglen[j]);
+            nByte += arglen[j+1] + 1;
         }
-        nByte += sizeof(struct HtmlAttribute) * (argc - 1);
+        nByte += sizeof(struct HtmlAttribute) * (argc - 1) + nName;
 
-        pMarkup = (HtmlAttributes *)HtmlAlloc("HtmlAttributes", nByte);
+        pMarkup = (HtmlAttributes *)HtmlArenaAlloc(
+            pArena, "HtmlAttributes", nByte
+        );
         pMarkup->nAttr = nAttr;
         zBuf = (char *)(&pMarkup->a[nAttr]);
 
         for (j=0; j < nAttr; j++) {
             int idx = (j * 2);
 
-            pMarkup->a[j].zName = zBuf;
             memcpy(zBuf, argv[idx], arglen[idx]);
             zBuf[arglen[idx]] = '\0';
             if (doEscape) {
                 HtmlTranslateEscapes(zBuf);
                 ToLower(zBuf);
             }
-            zBuf += (arglen[idx] + 1);
+
+            /* Attribute names are interned so that they may be compared
+             * by pointer. The name is only copied into zBuf so that it
+             * can be translated; the space is then reused for the value.
+             */
+            pMarkup->a[j].zName = (char *)HtmlTreeAtom(pTree, zBuf);
 
             pMarkup->a[j].zValue = zBuf;
             memcpy(zBuf, argv[idx+1], arglen[idx+1]);
@@ -314,6 +316,54 @@ HtmlAttributesNew (int argc, char const **argv, int *arglen, int doEscape)
     return pMarkup;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlAttributesCopy --
+ *
+ *     Return a copy of the attributes structure pAttr, which must have
+ *     been allocated by HtmlAttributesNew(). The copy is allocated from 
+ *     arena pArena (or the heap if pArena is NULL). Attribute names are
+ *     atoms and so are shared with the original.
+ *
+ * Results:
+ *     Pointer to the new structure, or NULL if pAttr is NULL.
+ *
+ * Side effects:
+ *     Allocates memory.
+ *
+ *---------------------------------------------------------------------------
+ */
+HtmlAttributes *
+HtmlAttributesCopy (HtmlArena *pArena, HtmlAttributes *pAttr)
+{
+    HtmlAttributes *pCopy = 0;
+
+    if (pAttr) {
+        char *zStart = (char *)pAttr;
+        char *zEnd = (char *)(&pAttr->a[pAttr->nAttr]);
+        int j;
+
+        /* The values are stored one after another following the array
+         * of HtmlAttribute structures. The last one ends the allocation.
+         */
+        for (j = 0; j < pAttr->nAttr; j++) {
+            char *zValue = pAttr->a[j].zValue;
+            zEnd = MAX(zEnd, &zValue[strlen(zValue) + 1]);
+        }
+
+        pCopy = (HtmlAttributes *)HtmlArenaAlloc(
+            pArena, "HtmlAttributes", zEnd - zStart
+        );
+        memcpy(pCopy, pAttr, zEnd - zStart);
+        for (j = 0; j < pAttr->nAttr; j++) {
+            pCopy->a[j].zValue = &((char *)pCopy)[pAttr->a[j].zValue - zStart];
+        }
+    }
+
+    return pCopy;
+}
+
 /*
 ** Convert a markup name into a type integer
 */
@@ -78,7 +78,13 @@ allocCmd(
     Tcl_Obj *CONST objv[]              /* Argument strings. */ 
     )
 {
-    return Rt_AllocCommand(0, interp, objc, objv);
+    Tcl_Obj *pRet;
+    Rt_AllocCommand(0, interp, objc, objv);
+    pRet = Tcl_DuplicateObj(Tcl_GetObjResult(interp));
+    HtmlArenaAllocCmd(0, interp, objc, objv);
+    Tcl_ListObjAppendList(0, pRet, Tcl_GetObjResult(interp));
+    Tcl_SetObjResult(interp, pRet);
+    return TCL_OK;
 }
 static int 
 heapdebugCmd(
@@ -416,7 +422,7 @@ static void runLayoutEngine(ClientData clientData);
 INSTRUMENTED(runDynamicStyleEngine, HTML_INSTRUMENT_DYNAMIC_STYLE_ENGINE)
 {
     HtmlTree *pTree = (HtmlTree *)clientData;
-    assert(pTree->cb.pDynamic);
+    assert(pTree->cb.nDynamic > 0);
     HtmlCssCheckDynamic(pTree);
 }
 
@@ -427,7 +433,7 @@ INSTRUMENTED(runStyleEngine, HTML_INSTRUMENT_STYLE_ENGINE)
 
     pTree->cb.pRestyle = 0;
     assert(pTree->cb.pSnapshot);
-    assert(pRestyle);
+    assert(pRestyle || HtmlCssInvalidationIsPartial(pTree));
 
     HtmlStyleApply(pTree, pRestyle);
     HtmlRestackNodes(pTree);
@@ -499,13 +505,13 @@ INSTRUMENTED(callbackHandler, HTML_INSTRUMENT_CALLBACK)
     HtmlCheckRestylePoint(pTree);
 
     HtmlLog(pTree, "CALLBACK", 
-        "flags=( %s%s%s%s%s) pDynamic=%s pRestyle=%s scroll=(+%d+%d) ",
+        "flags=( %s%s%s%s%s) nDynamic=%d pRestyle=%s scroll=(+%d+%d) ",
         (p->flags & HTML_DYNAMIC ? "Dynamic " : ""),
         (p->flags & HTML_RESTYLE ? "Style " : ""),
         (p->flags & HTML_LAYOUT ? "Layout " : ""),
         (p->flags & HTML_DAMAGE ? "Damage " : ""),
         (p->flags & HTML_SCROLL ? "Scroll " : ""),
-        (p->pDynamic?Tcl_GetString(HtmlNodeCommand(pTree,p->pDynamic)):"N/A"),
+        p->nDynamic,
         (p->pRestyle?Tcl_GetString(HtmlNodeCommand(pTree,p->pRestyle)):"N/A"),
          p->iScrollX, p->iScrollY
     );
@@ -613,7 +619,17 @@ INSTRUMENTED(callbackHandler, HTML_INSTRUMENT_CALLBACK)
         Tcl_DoWhenIdle(callbackHandler, (ClientData)pTree);
     }
 
-    offscreen = MAX(0, 
+    /* If a tcl() property script added rules to the stylesheet or
+     * requested a restyle while the style engine was running, the
+     * HTML_RESTYLE flag was cleared above. Schedule another pass.
+     */
+    if (HtmlCssInvalidationIsPartial(pTree)) {
+        HtmlCallbackRestyleSheet(pTree);
+    } else if (pTree->cb.pRestyle) {
+        HtmlCallbackRestyle(pTree, pTree->cb.pRestyle);
+    }
+
+    offscreen = MAX(0,
         MIN(pTree->canvas.bottom - Tk_Height(pTree->tkwin), pTree->iScrollY)
     );
     if (offscreen != pTree->iScrollY) {
@@ -754,7 +770,7 @@ snapshotZero (HtmlTree *pTree)
  *     Next widget idle-callback, recalculate style information for the
  *     sub-tree rooted at pNode. This function is a no-op if (pNode==0).
  *     If pNode is the root of the document, then the list of dynamic
- *     conditions (HtmlNode.pDynamic) that apply to each node is also
+ *     conditions (HtmlElementRare.pDynamic) that apply to each node is also
  *     recalculated.
  *
  * Results:
@@ -789,15 +805,57 @@ HtmlCallbackRestyle (HtmlTree *pTree, HtmlNode *pNode)
     HtmlCssSearchInvalidateCache(pTree);
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlCallbackRestyleSheet --
+ *
+ *     This is called after rules are added to the stylesheet. Next widget
+ *     idle-callback, recalculate style information for the elements that
+ *     may be matched by the new rules and their descendants. If the new 
+ *     rules cannot be limited to a set of elements in this way (see
+ *     HtmlCssInvalidationIsPartial()), restyle the whole document.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     May modify HtmlTree.cb and/or register for an idle callback with
+ *     the Tcl event loop.
+ *
+ *---------------------------------------------------------------------------
+ */
+void 
+HtmlCallbackRestyleSheet (HtmlTree *pTree)
+{
+    if (!HtmlCssInvalidationIsPartial(pTree)) {
+        HtmlCallbackRestyle(pTree, pTree->pRoot);
+        return;
+    }
+
+    snapshotLayout(pTree);
+    if (!pTree->cb.flags) {
+        Tcl_DoWhenIdle(callbackHandler, (ClientData)pTree);
+    }
+    pTree->cb.flags |= HTML_RESTYLE;
+    HtmlTextInvalidate(pTree);
+    HtmlCssSearchInvalidateCache(pTree);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
  * HtmlCallbackDynamic --
  *
- *     Next widget idle-callback, check if any dynamic CSS conditions
- *     attached to nodes that are part of the sub-tree rooted at pNode
- *     have changed. If so, restyle the affected nodes.  This function
- *     is a no-op if (pNode==0).
+ *     This is called when the dynamic flags of pNode are modified. Next
+ *     widget idle-callback, check if any dynamic CSS conditions that may
+ *     depend on pNode have changed. If so, restyle the affected nodes.
+ *     This function is a no-op if (pNode==0).
+ *
+ *     Each modified node is added to the HtmlCallback.apDynamic list, so
+ *     that HtmlCssCheckDynamic() need only check the sub-trees rooted at
+ *     the modified nodes, not the sub-tree rooted at their common 
+ *     ancestor.
  *
  * Results:
  *     None.
@@ -811,12 +869,70 @@ HtmlCallbackRestyle (HtmlTree *pTree, HtmlNode *pNode)
 void 
 HtmlCallbackDynamic (HtmlTree *pTree, HtmlNode *pNode)
 {
-    if (pNode) {
-        if (upgradeRestylePoint(&pTree->cb.pDynamic, pNode)) {
-            if (!pTree->cb.flags) {
-                Tcl_DoWhenIdle(callbackHandler, (ClientData)pTree);
-            }
-            pTree->cb.flags |= HTML_DYNAMIC;
+    HtmlCallback *p = &pTree->cb;
+    HtmlNode *pA;
+    int ii;
+
+    if (!pNode) return;
+
+    /* Do nothing if pNode is part of an orphan tree */
+    for (pA = pNode; pA; pA = HtmlNodeParent(pA)) {
+        if (pA->iNode == HTML_NODE_ORPHAN) return;
+    }
+
+    for (ii = 0; ii < p->nDynamic; ii++) {
+        if (p->apDynamic[ii] == pNode) return;
+    }
+
+    /* If a large number of nodes have been modified, check the whole
+     * document instead of each modified node. 
+     */
+    if (p->nDynamic >= HTML_MAX_DYNAMIC) {
+        p->nDynamic = 0;
+        pNode = pTree->pRoot;
+    }
+
+    if (p->nDynamic == p->nDynamicAlloc) {
+        int nByte;
+        p->nDynamicAlloc += 8;
+        nByte = p->nDynamicAlloc * sizeof(HtmlNode *);
+        p->apDynamic = (HtmlNode **)HtmlRealloc(
+            "HtmlCallback.apDynamic", p->apDynamic, nByte
+        );
+    }
+    p->apDynamic[p->nDynamic++] = pNode;
+
+    if (!p->flags) {
+        Tcl_DoWhenIdle(callbackHandler, (ClientData)pTree);
+    }
+    p->flags |= HTML_DYNAMIC;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlCallbackDynamicCancel --
+ *
+ *     Remove pNode from the list of nodes with modified dynamic flags
+ *     (HtmlCallback.apDynamic). This is called when pNode is deleted.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     May modify HtmlTree.cb.
+ *
+ *---------------------------------------------------------------------------
+ */
+void 
+HtmlCallbackDynamicCancel (HtmlTree *pTree, HtmlNode *pNode)
+{
+    HtmlCallback *p = &pTree->cb;
+    int ii;
+    for (ii = 0; ii < p->nDynamic; ii++) {
+        if (p->apDynamic[ii] == pNode) {
+            p->apDynamic[ii] = p->apDynamic[--p->nDynamic];
+            break;
         }
     }
 }
@@ -1018,6 +1134,39 @@ cleanupHandlerTable(Tcl_HashTable *pHash)
     Tcl_DeleteHashTable(pHash);
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * cleanupBatchTable --
+ *
+ *      This function is called to delete the contents of one of the
+ *      HtmlTree.aNodeBatch or aParseBatch tables. It is called as the 
+ *      tree is being deleted.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void 
+cleanupBatchTable(HtmlTree *pTree, Tcl_HashTable *pHash)
+{
+    Tcl_HashEntry *pEntry;
+    Tcl_HashSearch search;
+
+    for (
+        pEntry = Tcl_FirstHashEntry(pHash, &search); 
+        pEntry; 
+        pEntry = Tcl_NextHashEntry(&search)
+    ) {
+        HtmlHandlerBatchFree(pTree, (HtmlHandlerBatch *)Tcl_GetHashValue(pEntry));
+    }
+    Tcl_DeleteHashTable(pHash);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -1040,11 +1189,17 @@ deleteWidget(ClientData clientData)
     HtmlTree *pTree = (HtmlTree *)clientData;
     HtmlTreeClear(pTree);
 
-    /* Delete the contents of the three "handler" hash tables */
+    /* Delete the [fragment] template cache */
+    HtmlFragmentCacheTrim(pTree, 0);
+    Tcl_DeleteHashTable(&pTree->fragmentCache.aTemplate);
+
+    /* Delete the contents of the "handler" hash tables */
     cleanupHandlerTable(&pTree->aNodeHandler);
     cleanupHandlerTable(&pTree->aAttributeHandler);
     cleanupHandlerTable(&pTree->aParseHandler);
     cleanupHandlerTable(&pTree->aScriptHandler);
+    cleanupBatchTable(pTree, &pTree->aNodeBatch);
+    cleanupBatchTable(pTree, &pTree->aParseBatch);
 
     /* Clear any widget tags */
     HtmlTagCleanupTree(pTree);
@@ -1069,6 +1224,8 @@ deleteWidget(ClientData clientData)
         pTree->cb.pDamage = pDamage->pNext;
         HtmlFree(pDamage);
     }
+    HtmlFree(pTree->cb.apDynamic);
+    pTree->cb.apDynamic = 0;
 
     /* Atoms table */
     Tcl_DeleteHashTable(&pTree->aAtom);
@@ -1306,6 +1463,9 @@ configureCmd(
     #define DOUBLE(v, s1, s2, s3, f) \
         {TK_OPTION_DOUBLE, "-" #v, s1, s2, s3, -1, \
          Tk_Offset(HtmlOptions, v), 0, 0, f}
+    #define INT(v, s1, s2, s3, f) \
+        {TK_OPTION_INT, "-" #v, s1, s2, s3, -1, \
+         Tk_Offset(HtmlOptions, v), 0, 0, f}
     
     /* Option table definition for the html widget. */
     static Tk_OptionSpec htmlOptionSpec[] = {
@@ -1324,6 +1484,7 @@ DOUBLE  (fontscale, "fontScale", "FontScale", "1.0", F_MASK),
 OBJ     (fonttable, "fontTable", "FontTable", "8 9 10 11 13 15 17", FT_MASK),
 BOOLEAN (forcefontmetrics, "forceFontMetrics", "ForceFontMetrics", "1", F_MASK),
 BOOLEAN (forcewidth, "forceWidth", "ForceWidth", "0", L_MASK),
+INT     (fragmentcache, "fragmentCache", "FragmentCache", "0", 0),
 BOOLEAN (imagecache, "imageCache", "ImageCache", "1", S_MASK),
 BOOLEAN (imagepixmapify, "imagePixmapify", "ImagePixmapify", "0", 0),
 STRING  (imagecmd, "imageCmd", "ImageCmd", ""),
@@ -1344,6 +1505,7 @@ STRING  (timercmd, "timerCmd", "TimerCmd", ""),
     #undef PIXELS
     #undef STRING
     #undef BOOLEAN
+    #undef INT
 
     HtmlTree *pTree = (HtmlTree *)clientData;
     char *pOptions = (char *)&pTree->options;
@@ -1437,6 +1599,9 @@ STRING  (timercmd, "timerCmd", "TimerCmd", ""),
             HtmlCallbackLayout(pTree, pTree->pRoot);
         }
 
+        /* Discard [fragment] templates if -fragmentcache was reduced */
+        HtmlFragmentCacheTrim(pTree, pTree->options.fragmentcache);
+
         if (rc != TCL_OK) {
             assert(!init);
             Tk_RestoreSavedOptions(&saved);
@@ -1539,7 +1704,6 @@ resetCmd(
     HtmlCallbackDamage(pTree, 0, 0, Tk_Width(win), Tk_Height(win));
     doLoadDefaultStyle(pTree);
     pTree->isParseFinished = 0;
-    pTree->isSequenceOk = 1;
     if (pTree->eWriteState == HTML_WRITE_WAIT || 
         pTree->eWriteState == HTML_WRITE_NONE
     ) {
@@ -1684,7 +1848,7 @@ parseCmd(
         while (pTree->eWriteState == HTML_WRITE_INHANDLERRESET && nCount<100) {
             assert(pTree->nParsed == 0);
             pTree->eWriteState = HTML_WRITE_NONE;
-            if (pTree->pDocument) {
+            if (pTree->document.z) {
                 HtmlTokenizerAppend(pTree, "", 0, pTree->isParseFinished);
             }
             nCount++;
@@ -1783,6 +1947,113 @@ fragmentCmd(
     return TCL_OK;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * fragmentcacheCmd --
+ *
+ *         $widget _fragmentcache ?-reset?
+ *
+ *     Return a key-value list describing the state of the [fragment]
+ *     template cache (see the -fragmentcache option). The keys are 
+ *     "templates", "hits" and "misses". If the -reset option is passed,
+ *     the hit and miss counters are set to zero after they are read.
+ * 
+ * Results:
+ *     Standard Tcl result.
+ *
+ * Side effects:
+ *     May reset counters.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int 
+fragmentcacheCmd(
+    ClientData clientData,             /* The HTML widget */
+    Tcl_Interp *interp,                /* The interpreter */
+    int objc,                          /* Number of arguments */
+    Tcl_Obj *const *objv               /* List of all arguments */
+    )
+{
+    HtmlTree *pTree = (HtmlTree *)clientData;
+    HtmlFragmentCache *pCache = &pTree->fragmentCache;
+    Tcl_Obj *pRet;
+
+    if (objc > 3 || (objc == 3 && strcmp(Tcl_GetString(objv[2]), "-reset"))) {
+        Tcl_WrongNumArgs(interp, 2, objv, "?-reset?");
+        return TCL_ERROR;
+    }
+
+    pRet = Tcl_NewObj();
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj("templates", -1));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewIntObj(pCache->nTemplate));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj("hits", -1));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewIntObj(pCache->nHit));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj("misses", -1));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewIntObj(pCache->nMiss));
+    Tcl_SetObjResult(interp, pRet);
+
+    if (objc == 3) {
+        pCache->nHit = 0;
+        pCache->nMiss = 0;
+    }
+    return TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * stylestatsCmd --
+ *
+ *         $widget _stylestats ?-reset?
+ *
+ *     Return a key-value list of the style engine counters stored in
+ *     HtmlTree.styleStats. The keys are "styled", "shared" and "cached". If the
+ *     -reset option is passed, the counters are set to zero after they 
+ *     are read.
+ * 
+ * Results:
+ *     Standard Tcl result.
+ *
+ * Side effects:
+ *     May reset counters.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int 
+stylestatsCmd(
+    ClientData clientData,             /* The HTML widget */
+    Tcl_Interp *interp,                /* The interpreter */
+    int objc,                          /* Number of arguments */
+    Tcl_Obj *const *objv               /* List of all arguments */
+    )
+{
+    HtmlTree *pTree = (HtmlTree *)clientData;
+    HtmlStyleStats *pStats = &pTree->styleStats;
+    Tcl_Obj *pRet;
+
+    if (objc > 3 || (objc == 3 && strcmp(Tcl_GetString(objv[2]), "-reset"))) {
+        Tcl_WrongNumArgs(interp, 2, objv, "?-reset?");
+        return TCL_ERROR;
+    }
+
+    pRet = Tcl_NewObj();
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj("styled", -1));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewIntObj(pStats->nStyled));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj("shared", -1));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewIntObj(pStats->nShared));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj("cached", -1));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewIntObj(pStats->nCached));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj("batched", -1));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewIntObj(pStats->nBatched));
+    Tcl_SetObjResult(interp, pRet);
+
+    if (objc == 3) {
+        memset(pStats, 0, sizeof(HtmlStyleStats));
+    }
+    return TCL_OK;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -2013,7 +2284,11 @@ writeCmd(
  *
  * handlerCmd --
  *
- *     $widget handler [node|attribute|script|parse] TAG SCRIPT
+ *     $widget handler [node|attribute|script|parse] ?-batch? TAG SCRIPT
+ *
+ *     The -batch option may only be used with node and parse handlers.
+ *     A tag may have either a batched or a regular handler of each type,
+ *     not both. Configuring one replaces the other.
  *
  * Results:
  *     None.
@@ -2035,9 +2310,11 @@ handlerCmd(
     Tcl_Obj *pScript;
     Tcl_HashEntry *pEntry;
     Tcl_HashTable *pHash = 0;
+    Tcl_HashTable *pBatchHash = 0;
     int newentry;
     HtmlTree *pTree = (HtmlTree *)clientData;
     char *zTag;
+    int isBatch = 0;
 
     enum HandlerType {
       HANDLER_ATTRIBUTE,
@@ -2058,8 +2335,10 @@ handlerCmd(
     };
     int iChoice;
 
-    if (objc!=5) {
-        Tcl_WrongNumArgs(interp, 3, objv, "TAG SCRIPT");
+    if (objc == 6 && 0 == strcmp(Tcl_GetString(objv[3]), "-batch")) {
+        isBatch = 1;
+    } else if (objc != 5) {
+        Tcl_WrongNumArgs(interp, 3, objv, "?-batch? TAG SCRIPT");
         return TCL_ERROR;
     }
 
@@ -2069,7 +2348,7 @@ handlerCmd(
         return TCL_ERROR;
     }
 
-    zTag = Tcl_GetString(objv[3]);
+    zTag = Tcl_GetString(objv[3 + isBatch]);
     tag = HtmlNameToType(0, zTag);
     if (tag==Html_Unknown) {
         Tcl_AppendResult(interp, "Unknown tag type: ", zTag, 0);
@@ -2082,9 +2361,11 @@ handlerCmd(
             break;
         case HANDLER_NODE:
             pHash = &pTree->aNodeHandler;
+            pBatchHash = &pTree->aNodeBatch;
             break;
         case HANDLER_PARSE:
             pHash = &pTree->aParseHandler;
+            pBatchHash = &pTree->aParseBatch;
             break;
         case HANDLER_SCRIPT:
             pHash = &pTree->aScriptHandler;
@@ -2098,13 +2379,53 @@ handlerCmd(
     }
 
     assert(pHash);
-    pScript = objv[4];
+    pScript = objv[4 + isBatch];
 
-    if (Tcl_GetCharLength(pScript) == 0) {
+    if (isBatch && !pBatchHash) {
+        Tcl_AppendResult(interp, 
+            "-batch is only supported by node and parse handlers", 0
+        );
+        return TCL_ERROR;
+    }
+
+    /* Remove any existing handler of the other kind (batched or regular)
+     * for this tag. If a batched handler is being reconfigured, keep its
+     * pending arguments. 
+     */
+    if (isBatch || Tcl_GetCharLength(pScript) == 0) {
         pEntry = Tcl_FindHashEntry(pHash, (char *)((size_t) tag));
         if (pEntry) {
+            Tcl_DecrRefCount((Tcl_Obj *)Tcl_GetHashValue(pEntry));
+            Tcl_DeleteHashEntry(pEntry);
+        }
+    }
+    if (pBatchHash && (!isBatch || Tcl_GetCharLength(pScript) == 0)) {
+        pEntry = Tcl_FindHashEntry(pBatchHash, (char *)((size_t) tag));
+        if (pEntry) {
+            HtmlHandlerBatchFree(pTree, 
+                (HtmlHandlerBatch *)Tcl_GetHashValue(pEntry)
+            );
             Tcl_DeleteHashEntry(pEntry);
         }
+    }
+
+    if (Tcl_GetCharLength(pScript) == 0) {
+        /* Handler deleted (see above). */
+    } else if (isBatch) {
+        HtmlHandlerBatch *p;
+        pEntry = Tcl_CreateHashEntry(
+            pBatchHash, (char*)((size_t) tag), &newentry
+        );
+        if (newentry) {
+            p = HtmlNew(HtmlHandlerBatch);
+            p->isNodeHandler = (iChoice == HANDLER_NODE);
+            Tcl_SetHashValue(pEntry, (ClientData)p);
+        } else {
+            p = (HtmlHandlerBatch *)Tcl_GetHashValue(pEntry);
+            Tcl_DecrRefCount(p->pScript);
+        }
+        Tcl_IncrRefCount(pScript);
+        p->pScript = pScript;
     } else {
         pEntry = Tcl_CreateHashEntry(pHash,(char*)((size_t) tag),&newentry);
         if (!newentry) {
@@ -2192,7 +2513,7 @@ styleCmd(
     SwprocCleanup(apObj, sizeof(apObj)/sizeof(Tcl_Obj *));
 
     if (rc == TCL_OK) {
-        HtmlCallbackRestyle(pTree, pTree->pRoot);
+        HtmlCallbackRestyleSheet(pTree);
     }
     return rc;
 }
@@ -2394,6 +2715,7 @@ delayCmd(
  *
  * imageCmd --
  * nodeCmd --
+ * dumpCmd --
  * primitivesCmd --
  *
  *     New versions of gcc don't allow pointers to non-local functions to
@@ -2432,6 +2754,16 @@ nodeCmd(
     return HtmlLayoutNode(clientData, interp, objc, objv);
 }
 static int 
+dumpCmd(
+    ClientData clientData,             /* The HTML widget data structure */
+    Tcl_Interp *interp,                /* Current interpreter. */
+    int objc,                          /* Number of arguments. */
+    Tcl_Obj *CONST objv[]              /* Argument strings. */ 
+    )
+{
+    return HtmlTreeDump(clientData, interp, objc, objv);
+}
+static int 
 primitivesCmd(
     ClientData clientData,             /* The HTML widget data structure */
     Tcl_Interp *interp,                /* Current interpreter. */
@@ -2566,6 +2898,7 @@ int widgetCmd(
         {"bbox",         bboxCmd},
         {"cget",         cgetCmd},
         {"configure",    configureCmd},
+        {"dump",         dumpCmd},
         {"fragment",     fragmentCmd},
         {"handler",      handlerCmd},
         {"image",        imageCmd},
@@ -2586,11 +2919,13 @@ int widgetCmd(
          */
         {"_delay",       delayCmd},
         {"_force",       forceCmd},
+        {"_fragmentcache", fragmentcacheCmd},
         {"_images",      imagesCmd},
         {"_primitives",  primitivesCmd},
         {"_relayout",    relayoutCmd},
         {"_styleconfig", styleconfigCmd},
         {"_stylereport", stylereportCmd},
+        {"_stylestats",  stylestatsCmd},
 #ifndef NDEBUG
         {"_hashstats",  hashstatsCmd},
 #endif
@@ -2665,12 +3000,17 @@ newWidget(
     Tcl_InitHashTable(&pTree->aScriptHandler, TCL_ONE_WORD_KEYS);
     Tcl_InitHashTable(&pTree->aNodeHandler, TCL_ONE_WORD_KEYS);
     Tcl_InitHashTable(&pTree->aAttributeHandler, TCL_ONE_WORD_KEYS);
+    Tcl_InitHashTable(&pTree->aNodeBatch, TCL_ONE_WORD_KEYS);
+    Tcl_InitHashTable(&pTree->aParseBatch, TCL_ONE_WORD_KEYS);
     Tcl_InitHashTable(&pTree->aOrphan, TCL_ONE_WORD_KEYS);
+    Tcl_InitHashTable(&pTree->fragmentCache.aTemplate, TCL_STRING_KEYS);
     Tcl_InitHashTable(&pTree->aTag, TCL_STRING_KEYS);
     pTree->cmd = Tcl_CreateObjCommand(interp,zCmd,widgetCmd,pTree,widgetCmdDel);
 
     pType = HtmlCaseInsenstiveHashType();
     Tcl_InitCustomHashTable(&pTree->aAtom, TCL_CUSTOM_TYPE_KEYS, pType);
+    pTree->zAtomId = HtmlTreeAtom(pTree, "id");
+    pTree->zAtomClass = HtmlTreeAtom(pTree, "class");
 
     HtmlCssSearchInit(pTree);
 
@@ -2705,7 +3045,6 @@ newWidget(
 
     /* Load the default style-sheet, ready for the first document. */
     doLoadDefaultStyle(pTree);
-    pTree->isSequenceOk = 1;
 
 #ifdef TKHTML_ENABLE_PROFILE
     if (1) {
@@ -2832,6 +3171,46 @@ htmlUriCmd(
     return HtmlCreateUri(clientData, interp, objc, objv);
 }
 
+/*
+ * Each of the [::tkhtml::byteoffset] and [::tkhtml::charoffset] commands
+ * keeps an offset index for the most recent STRING argument. Callers tend
+ * to convert many offsets within a single string (i.e. the text of a 
+ * node or a stylesheet), so this avoids counting characters from the 
+ * start of the string for each conversion. A reference to the string
+ * object is held so that it cannot be modified while the index is in 
+ * use.
+ */
+typedef struct OffsetCache OffsetCache;
+struct OffsetCache {
+    Tcl_Obj *pString;           /* String index is for (or NULL) */
+    HtmlUtf8Index index;        /* Offset index for pString */
+};
+
+static char *
+offsetCacheString (OffsetCache *p, Tcl_Obj *pString, int *pnString)
+{
+    if (p->pString != pString) {
+        if (p->pString) {
+            Tcl_DecrRefCount(p->pString);
+        }
+        HtmlUtf8IndexClear(&p->index);
+        p->pString = pString;
+        Tcl_IncrRefCount(pString);
+    }
+    return Tcl_GetStringFromObj(pString, pnString);
+}
+
+static void
+offsetCacheDelete (ClientData clientData)
+{
+    OffsetCache *p = (OffsetCache *)clientData;
+    if (p->pString) {
+        Tcl_DecrRefCount(p->pString);
+    }
+    HtmlUtf8IndexClear(&p->index);
+    HtmlFree(p);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -2850,15 +3229,17 @@ htmlUriCmd(
  */
 static int 
 htmlByteOffsetCmd(
-    ClientData clientData,
+    ClientData clientData,             /* Pointer to OffsetCache */
     Tcl_Interp *interp,                /* Current interpreter. */
     int objc,                          /* Number of arguments. */
     Tcl_Obj *CONST objv[]              /* Argument strings. */ 
     )
 {
+    OffsetCache *pCache = (OffsetCache *)clientData;
     int iCharOffset;
     int iRet;
     char *zArg;
+    int nArg;
 
     if (objc != 3) {
         Tcl_WrongNumArgs(interp, 1, objv, "STRING CHAR-OFFSET");
@@ -2866,23 +3247,25 @@ htmlByteOffsetCmd(
     }
 
     if (Tcl_GetIntFromObj(interp, objv[2], &iCharOffset)) return TCL_ERROR;
-    zArg = Tcl_GetString(objv[1]);
+    zArg = offsetCacheString(pCache, objv[1], &nArg);
 
-    iRet = (Tcl_UtfAtIndex(zArg, iCharOffset) - zArg);
+    iRet = HtmlUtf8ByteOffset(&pCache->index, zArg, nArg, iCharOffset);
     Tcl_SetObjResult(interp, Tcl_NewIntObj(iRet));
     return TCL_OK;
 }
 static int 
 htmlCharOffsetCmd(
-    ClientData clientData,
+    ClientData clientData,             /* Pointer to OffsetCache */
     Tcl_Interp *interp,                /* Current interpreter. */
     int objc,                          /* Number of arguments. */
     Tcl_Obj *CONST objv[]              /* Argument strings. */ 
     )
 {
+    OffsetCache *pCache = (OffsetCache *)clientData;
     int iByteOffset;
     int iRet;
     char *zArg;
+    int nArg;
 
     if (objc != 3) {
         Tcl_WrongNumArgs(interp, 1, objv, "STRING BYTE-OFFSET");
@@ -2890,9 +3273,9 @@ htmlCharOffsetCmd(
     }
 
     if (Tcl_GetIntFromObj(interp, objv[2], &iByteOffset)) return TCL_ERROR;
-    zArg = Tcl_GetString(objv[1]);
+    zArg = offsetCacheString(pCache, objv[1], &nArg);
 
-    iRet = Tcl_NumUtfChars(zArg, iByteOffset);
+    iRet = HtmlUtf8CharOffset(&pCache->index, zArg, nArg, iByteOffset);
     Tcl_SetObjResult(interp, Tcl_NewIntObj(iRet));
     return TCL_OK;
 }
@@ -2952,6 +3335,9 @@ DLL_EXPORT int Tkhtml_Init(Tcl_Interp *interp)
     Tcl_CreateObjCommand(interp, "html", newWidget, 0, 0);
 
     Tcl_CreateObjCommand(interp, "::tkhtml::htmlstyle",  htmlstyleCmd, 0, 0);
+    Tcl_CreateObjCommand(interp, "::tkhtml::stylecache",
+        HtmlCssStyleCacheCmd, 0, 0
+    );
     Tcl_CreateObjCommand(interp, "::tkhtml::version",    htmlVersionCmd, 0, 0);
 
     Tcl_CreateObjCommand(interp, "::tkhtml::decode",     htmlDecodeCmd, 0, 0);
@@ -2960,12 +3346,21 @@ DLL_EXPORT int Tkhtml_Init(Tcl_Interp *interp)
 
     Tcl_CreateObjCommand(interp, "::tkhtml::uri", htmlUriCmd, 0, 0);
 
-    Tcl_CreateObjCommand(interp, "::tkhtml::byteoffset", htmlByteOffsetCmd,0,0);
-    Tcl_CreateObjCommand(interp, "::tkhtml::charoffset", htmlCharOffsetCmd,0,0);
+    Tcl_CreateObjCommand(interp, "::tkhtml::byteoffset", htmlByteOffsetCmd,
+        (ClientData)HtmlNew(OffsetCache), offsetCacheDelete
+    );
+    Tcl_CreateObjCommand(interp, "::tkhtml::charoffset", htmlCharOffsetCmd,
+        (ClientData)HtmlNew(OffsetCache), offsetCacheDelete
+    );
+
+    Tcl_CreateObjCommand(interp, "::tkhtml::scanner", HtmlScannerCmd, 0, 0);
+    Tcl_CreateObjCommand(interp, "::tkhtml::lookup", HtmlLookupCmd, 0, 0);
 
 #ifndef NDEBUG
     Tcl_CreateObjCommand(interp, "::tkhtml::htmlalloc", allocCmd, 0, 0);
     Tcl_CreateObjCommand(interp, "::tkhtml::heapdebug", heapdebugCmd, 0, 0);
+#else
+    Tcl_CreateObjCommand(interp, "::tkhtml::htmlalloc", HtmlArenaAllocCmd,0,0);
 #endif
 
     SwprocInit(interp);
@@ -54,6 +54,10 @@
  *     HtmlTranslateEscapes()
  *         Translates Html escapes (i.e. "&nbsp;").
  *
+ *     HtmlLookupCmd()
+ *         Implementation of [::tkhtml::lookup] (tag and escape lookup
+ *         benchmark).
+ *
  *     HtmlTagAddRemoveCmd()
  *         Implementation of [pathName tag add] and [pathName tag remove]
  *
@@ -94,368 +98,41 @@
 ** structure
 */
 struct sgEsc {
-    char *zName;              /* The name of this escape sequence. ex: "amp" */
+    const char *zName;        /* The name of this escape sequence. ex: "amp" */
     char value[8];            /* The value for this sequence. ex: "&" */
-    struct sgEsc *pNext;      /* Next sequence with the same hash on zName */
-};
-
-/* The following is a table of all escape sequences.  Add new sequences
-** by adding entries to this table.
-*/
-static struct sgEsc esc_sequences[] = {
-    {"nbsp", "\xC2\xA0", 0},            /* Unicode code-point 160 */
-    {"iexcl", "\xC2\xA1", 0},           /* Unicode code-point 161 */
-    {"cent", "\xC2\xA2", 0},            /* Unicode code-point 162 */
-    {"pound", "\xC2\xA3", 0},           /* Unicode code-point 163 */
-    {"curren", "\xC2\xA4", 0},          /* Unicode code-point 164 */
-    {"yen", "\xC2\xA5", 0},             /* Unicode code-point 165 */
-    {"brvbar", "\xC2\xA6", 0},          /* Unicode code-point 166 */
-    {"sect", "\xC2\xA7", 0},            /* Unicode code-point 167 */
-    {"uml", "\xC2\xA8", 0},             /* Unicode code-point 168 */
-    {"copy", "\xC2\xA9", 0},            /* Unicode code-point 169 */
-    {"ordf", "\xC2\xAA", 0},            /* Unicode code-point 170 */
-    {"laquo", "\xC2\xAB", 0},           /* Unicode code-point 171 */
-    {"not", "\xC2\xAC", 0},             /* Unicode code-point 172 */
-    {"shy", "\xC2\xAD", 0},             /* Unicode code-point 173 */
-    {"reg", "\xC2\xAE", 0},             /* Unicode code-point 174 */
-    {"macr", "\xC2\xAF", 0},            /* Unicode code-point 175 */
-    {"deg", "\xC2\xB0", 0},             /* Unicode code-point 176 */
-    {"plusmn", "\xC2\xB1", 0},          /* Unicode code-point 177 */
-    {"sup2", "\xC2\xB2", 0},            /* Unicode code-point 178 */
-    {"sup3", "\xC2\xB3", 0},            /* Unicode code-point 179 */
-    {"acute", "\xC2\xB4", 0},           /* Unicode code-point 180 */
-    {"micro", "\xC2\xB5", 0},           /* Unicode code-point 181 */
-    {"para", "\xC2\xB6", 0},            /* Unicode code-point 182 */
-    {"middot", "\xC2\xB7", 0},          /* Unicode code-point 183 */
-    {"cedil", "\xC2\xB8", 0},           /* Unicode code-point 184 */
-    {"sup1", "\xC2\xB9", 0},            /* Unicode code-point 185 */
-    {"ordm", "\xC2\xBA", 0},            /* Unicode code-point 186 */
-    {"raquo", "\xC2\xBB", 0},           /* Unicode code-point 187 */
-    {"frac14", "\xC2\xBC", 0},          /* Unicode code-point 188 */
-    {"frac12", "\xC2\xBD", 0},          /* Unicode code-point 189 */
-    {"frac34", "\xC2\xBE", 0},          /* Unicode code-point 190 */
-    {"iquest", "\xC2\xBF", 0},          /* Unicode code-point 191 */
-    {"Agrave", "\xC3\x80", 0},          /* Unicode code-point 192 */
-    {"Aacute", "\xC3\x81", 0},          /* Unicode code-point 193 */
-    {"Acirc", "\xC3\x82", 0},           /* Unicode code-point 194 */
-    {"Atilde", "\xC3\x83", 0},          /* Unicode code-point 195 */
-    {"Auml", "\xC3\x84", 0},            /* Unicode code-point 196 */
-    {"Aring", "\xC3\x85", 0},           /* Unicode code-point 197 */
-    {"AElig", "\xC3\x86", 0},           /* Unicode code-point 198 */
-    {"Ccedil", "\xC3\x87", 0},          /* Unicode code-point 199 */
-    {"Egrave", "\xC3\x88", 0},          /* Unicode code-point 200 */
-    {"Eacute", "\xC3\x89", 0},          /* Unicode code-point 201 */
-    {"Ecirc", "\xC3\x8A", 0},           /* Unicode code-point 202 */
-    {"Euml", "\xC3\x8B", 0},            /* Unicode code-point 203 */
-    {"Igrave", "\xC3\x8C", 0},          /* Unicode code-point 204 */
-    {"Iacute", "\xC3\x8D", 0},          /* Unicode code-point 205 */
-    {"Icirc", "\xC3\x8E", 0},           /* Unicode code-point 206 */
-    {"Iuml", "\xC3\x8F", 0},            /* Unicode code-point 207 */
-    {"ETH", "\xC3\x90", 0},             /* Unicode code-point 208 */
-    {"Ntilde", "\xC3\x91", 0},          /* Unicode code-point 209 */
-    {"Ograve", "\xC3\x92", 0},          /* Unicode code-point 210 */
-    {"Oacute", "\xC3\x93", 0},          /* Unicode code-point 211 */
-    {"Ocirc", "\xC3\x94", 0},           /* Unicode code-point 212 */
-    {"Otilde", "\xC3\x95", 0},          /* Unicode code-point 213 */
-    {"Ouml", "\xC3\x96", 0},            /* Unicode code-point 214 */
-    {"times", "\xC3\x97", 0},           /* Unicode code-point 215 */
-    {"Oslash", "\xC3\x98", 0},          /* Unicode code-point 216 */
-    {"Ugrave", "\xC3\x99", 0},          /* Unicode code-point 217 */
-    {"Uacute", "\xC3\x9A", 0},          /* Unicode code-point 218 */
-    {"Ucirc", "\xC3\x9B", 0},           /* Unicode code-point 219 */
-    {"Uuml", "\xC3\x9C", 0},            /* Unicode code-point 220 */
-    {"Yacute", "\xC3\x9D", 0},          /* Unicode code-point 221 */
-    {"THORN", "\xC3\x9E", 0},           /* Unicode code-point 222 */
-    {"szlig", "\xC3\x9F", 0},           /* Unicode code-point 223 */
-    {"agrave", "\xC3\xA0", 0},          /* Unicode code-point 224 */
-    {"aacute", "\xC3\xA1", 0},          /* Unicode code-point 225 */
-    {"acirc", "\xC3\xA2", 0},           /* Unicode code-point 226 */
-    {"atilde", "\xC3\xA3", 0},          /* Unicode code-point 227 */
-    {"auml", "\xC3\xA4", 0},            /* Unicode code-point 228 */
-    {"aring", "\xC3\xA5", 0},           /* Unicode code-point 229 */
-    {"aelig", "\xC3\xA6", 0},           /* Unicode code-point 230 */
-    {"ccedil", "\xC3\xA7", 0},          /* Unicode code-point 231 */
-    {"egrave", "\xC3\xA8", 0},          /* Unicode code-point 232 */
-    {"eacute", "\xC3\xA9", 0},          /* Unicode code-point 233 */
-    {"ecirc", "\xC3\xAA", 0},           /* Unicode code-point 234 */
-    {"euml", "\xC3\xAB", 0},            /* Unicode code-point 235 */
-    {"igrave", "\xC3\xAC", 0},          /* Unicode code-point 236 */
-    {"iacute", "\xC3\xAD", 0},          /* Unicode code-point 237 */
-    {"icirc", "\xC3\xAE", 0},           /* Unicode code-point 238 */
-    {"iuml", "\xC3\xAF", 0},            /* Unicode code-point 239 */
-    {"eth", "\xC3\xB0", 0},             /* Unicode code-point 240 */
-    {"ntilde", "\xC3\xB1", 0},          /* Unicode code-point 241 */
-    {"ograve", "\xC3\xB2", 0},          /* Unicode code-point 242 */
-    {"oacute", "\xC3\xB3", 0},          /* Unicode code-point 243 */
-    {"ocirc", "\xC3\xB4", 0},           /* Unicode code-point 244 */
-    {"otilde", "\xC3\xB5", 0},          /* Unicode code-point 245 */
-    {"ouml", "\xC3\xB6", 0},            /* Unicode code-point 246 */
-    {"divide", "\xC3\xB7", 0},          /* Unicode code-point 247 */
-    {"oslash", "\xC3\xB8", 0},          /* Unicode code-point 248 */
-    {"ugrave", "\xC3\xB9", 0},          /* Unicode code-point 249 */
-    {"uacute", "\xC3\xBA", 0},          /* Unicode code-point 250 */
-    {"ucirc", "\xC3\xBB", 0},           /* Unicode code-point 251 */
-    {"uuml", "\xC3\xBC", 0},            /* Unicode code-point 252 */
-    {"yacute", "\xC3\xBD", 0},          /* Unicode code-point 253 */
-    {"thorn", "\xC3\xBE", 0},           /* Unicode code-point 254 */
-    {"yuml", "\xC3\xBF", 0},            /* Unicode code-point 255 */
-    {"quot", "\x22", 0},                /* Unicode code-point 34 */
-    {"amp", "\x26", 0},                 /* Unicode code-point 38 */
-    {"lt", "\x3C", 0},                  /* Unicode code-point 60 */
-    {"gt", "\x3E", 0},                  /* Unicode code-point 62 */
-    {"OElig", "\xC5\x92", 0},           /* Unicode code-point 338 */
-    {"oelig", "\xC5\x93", 0},           /* Unicode code-point 339 */
-    {"Scaron", "\xC5\xA0", 0},          /* Unicode code-point 352 */
-    {"scaron", "\xC5\xA1", 0},          /* Unicode code-point 353 */
-    {"Yuml", "\xC5\xB8", 0},            /* Unicode code-point 376 */
-    {"circ", "\xCB\x86", 0},            /* Unicode code-point 710 */
-    {"tilde", "\xCB\x9C", 0},           /* Unicode code-point 732 */
-    {"ensp", "\xE2\x80\x82", 0},        /* Unicode code-point 8194 */
-    {"emsp", "\xE2\x80\x83", 0},        /* Unicode code-point 8195 */
-    {"thinsp", "\xE2\x80\x89", 0},      /* Unicode code-point 8201 */
-    {"zwnj", "\xE2\x80\x8C", 0},        /* Unicode code-point 8204 */
-    {"zwj", "\xE2\x80\x8D", 0},         /* Unicode code-point 8205 */
-    {"lrm", "\xE2\x80\x8E", 0},         /* Unicode code-point 8206 */
-    {"rlm", "\xE2\x80\x8F", 0},         /* Unicode code-point 8207 */
-    {"ndash", "\xE2\x80\x93", 0},       /* Unicode code-point 8211 */
-    {"mdash", "\xE2\x80\x94", 0},       /* Unicode code-point 8212 */
-    {"lsquo", "\xE2\x80\x98", 0},       /* Unicode code-point 8216 */
-    {"rsquo", "\xE2\x80\x99", 0},       /* Unicode code-point 8217 */
-    {"sbquo", "\xE2\x80\x9A", 0},       /* Unicode code-point 8218 */
-    {"ldquo", "\xE2\x80\x9C", 0},       /* Unicode code-point 8220 */
-    {"rdquo", "\xE2\x80\x9D", 0},       /* Unicode code-point 8221 */
-    {"bdquo", "\xE2\x80\x9E", 0},       /* Unicode code-point 8222 */
-    {"dagger", "\xE2\x80\xA0", 0},      /* Unicode code-point 8224 */
-    {"Dagger", "\xE2\x80\xA1", 0},      /* Unicode code-point 8225 */
-    {"permil", "\xE2\x80\xB0", 0},      /* Unicode code-point 8240 */
-    {"lsaquo", "\xE2\x80\xB9", 0},      /* Unicode code-point 8249 */
-    {"rsaquo", "\xE2\x80\xBA", 0},      /* Unicode code-point 8250 */
-    {"euro", "\xE2\x82\xAC", 0},        /* Unicode code-point 8364 */
-    {"fnof", "\xC6\x92", 0},            /* Unicode code-point 402 */
-    {"Alpha", "\xCE\x91", 0},           /* Unicode code-point 913 */
-    {"Beta", "\xCE\x92", 0},            /* Unicode code-point 914 */
-    {"Gamma", "\xCE\x93", 0},           /* Unicode code-point 915 */
-    {"Delta", "\xCE\x94", 0},           /* Unicode code-point 916 */
-    {"Epsilon", "\xCE\x95", 0},         /* Unicode code-point 917 */
-    {"Zeta", "\xCE\x96", 0},            /* Unicode code-point 918 */
-    {"Eta", "\xCE\x97", 0},             /* Unicode code-point 919 */
-    {"Theta", "\xCE\x98", 0},           /* Unicode code-point 920 */
-    {"Iota", "\xCE\x99", 0},            /* Unicode code-point 921 */
-    {"Kappa", "\xCE\x9A", 0},           /* Unicode code-point 922 */
-    {"Lambda", "\xCE\x9B", 0},          /* Unicode code-point 923 */
-    {"Mu", "\xCE\x9C", 0},              /* Unicode code-point 924 */
-    {"Nu", "\xCE\x9D", 0},              /* Unicode code-point 925 */
-    {"Xi", "\xCE\x9E", 0},              /* Unicode code-point 926 */
-    {"Omicron", "\xCE\x9F", 0},         /* Unicode code-point 927 */
-    {"Pi", "\xCE\xA0", 0},              /* Unicode code-point 928 */
-    {"Rho", "\xCE\xA1", 0},             /* Unicode code-point 929 */
-    {"Sigma", "\xCE\xA3", 0},           /* Unicode code-point 931 */
-    {"Tau", "\xCE\xA4", 0},             /* Unicode code-point 932 */
-    {"Upsilon", "\xCE\xA5", 0},         /* Unicode code-point 933 */
-    {"Phi", "\xCE\xA6", 0},             /* Unicode code-point 934 */
-    {"Chi", "\xCE\xA7", 0},             /* Unicode code-point 935 */
-    {"Psi", "\xCE\xA8", 0},             /* Unicode code-point 936 */
-    {"Omega", "\xCE\xA9", 0},           /* Unicode code-point 937 */
-    {"alpha", "\xCE\xB1", 0},           /* Unicode code-point 945 */
-    {"beta", "\xCE\xB2", 0},            /* Unicode code-point 946 */
-    {"gamma", "\xCE\xB3", 0},           /* Unicode code-point 947 */
-    {"delta", "\xCE\xB4", 0},           /* Unicode code-point 948 */
-    {"epsilon", "\xCE\xB5", 0},         /* Unicode code-point 949 */
-    {"zeta", "\xCE\xB6", 0},            /* Unicode code-point 950 */
-    {"eta", "\xCE\xB7", 0},             /* Unicode code-point 951 */
-    {"theta", "\xCE\xB8", 0},           /* Unicode code-point 952 */
-    {"iota", "\xCE\xB9", 0},            /* Unicode code-point 953 */
-    {"kappa", "\xCE\xBA", 0},           /* Unicode code-point 954 */
-    {"lambda", "\xCE\xBB", 0},          /* Unicode code-point 955 */
-    {"mu", "\xCE\xBC", 0},              /* Unicode code-point 956 */
-    {"nu", "\xCE\xBD", 0},              /* Unicode code-point 957 */
-    {"xi", "\xCE\xBE", 0},              /* Unicode code-point 958 */
-    {"omicron", "\xCE\xBF", 0},         /* Unicode code-point 959 */
-    {"pi", "\xCF\x80", 0},              /* Unicode code-point 960 */
-    {"rho", "\xCF\x81", 0},             /* Unicode code-point 961 */
-    {"sigmaf", "\xCF\x82", 0},          /* Unicode code-point 962 */
-    {"sigma", "\xCF\x83", 0},           /* Unicode code-point 963 */
-    {"tau", "\xCF\x84", 0},             /* Unicode code-point 964 */
-    {"upsilon", "\xCF\x85", 0},         /* Unicode code-point 965 */
-    {"phi", "\xCF\x86", 0},             /* Unicode code-point 966 */
-    {"chi", "\xCF\x87", 0},             /* Unicode code-point 967 */
-    {"psi", "\xCF\x88", 0},             /* Unicode code-point 968 */
-    {"omega", "\xCF\x89", 0},           /* Unicode code-point 969 */
-    {"thetasym", "\xCF\x91", 0},        /* Unicode code-point 977 */
-    {"upsih", "\xCF\x92", 0},           /* Unicode code-point 978 */
-    {"piv", "\xCF\x96", 0},             /* Unicode code-point 982 */
-    {"bull", "\xE2\x80\xA2", 0},        /* Unicode code-point 8226 */
-    {"hellip", "\xE2\x80\xA6", 0},      /* Unicode code-point 8230 */
-    {"prime", "\xE2\x80\xB2", 0},       /* Unicode code-point 8242 */
-    {"Prime", "\xE2\x80\xB3", 0},       /* Unicode code-point 8243 */
-    {"oline", "\xE2\x80\xBE", 0},       /* Unicode code-point 8254 */
-    {"frasl", "\xE2\x81\x84", 0},       /* Unicode code-point 8260 */
-    {"weierp", "\xE2\x84\x98", 0},      /* Unicode code-point 8472 */
-    {"image", "\xE2\x84\x91", 0},       /* Unicode code-point 8465 */
-    {"real", "\xE2\x84\x9C", 0},        /* Unicode code-point 8476 */
-    {"trade", "\xE2\x84\xA2", 0},       /* Unicode code-point 8482 */
-    {"alefsym", "\xE2\x84\xB5", 0},     /* Unicode code-point 8501 */
-    {"larr", "\xE2\x86\x90", 0},        /* Unicode code-point 8592 */
-    {"uarr", "\xE2\x86\x91", 0},        /* Unicode code-point 8593 */
-    {"rarr", "\xE2\x86\x92", 0},        /* Unicode code-point 8594 */
-    {"darr", "\xE2\x86\x93", 0},        /* Unicode code-point 8595 */
-    {"harr", "\xE2\x86\x94", 0},        /* Unicode code-point 8596 */
-    {"crarr", "\xE2\x86\xB5", 0},       /* Unicode code-point 8629 */
-    {"lArr", "\xE2\x87\x90", 0},        /* Unicode code-point 8656 */
-    {"uArr", "\xE2\x87\x91", 0},        /* Unicode code-point 8657 */
-    {"rArr", "\xE2\x87\x92", 0},        /* Unicode code-point 8658 */
-    {"dArr", "\xE2\x87\x93", 0},        /* Unicode code-point 8659 */
-    {"hArr", "\xE2\x87\x94", 0},        /* Unicode code-point 8660 */
-    {"forall", "\xE2\x88\x80", 0},      /* Unicode code-point 8704 */
-    {"part", "\xE2\x88\x82", 0},        /* Unicode code-point 8706 */
-    {"exist", "\xE2\x88\x83", 0},       /* Unicode code-point 8707 */
-    {"empty", "\xE2\x88\x85", 0},       /* Unicode code-point 8709 */
-    {"nabla", "\xE2\x88\x87", 0},       /* Unicode code-point 8711 */
-    {"isin", "\xE2\x88\x88", 0},        /* Unicode code-point 8712 */
-    {"notin", "\xE2\x88\x89", 0},       /* Unicode code-point 8713 */
-    {"ni", "\xE2\x88\x8B", 0},          /* Unicode code-point 8715 */
-    {"prod", "\xE2\x88\x8F", 0},        /* Unicode code-point 8719 */
-    {"sum", "\xE2\x88\x91", 0},         /* Unicode code-point 8721 */
-    {"minus", "\xE2\x88\x92", 0},       /* Unicode code-point 8722 */
-    {"lowast", "\xE2\x88\x97", 0},      /* Unicode code-point 8727 */
-    {"radic", "\xE2\x88\x9A", 0},       /* Unicode code-point 8730 */
-    {"prop", "\xE2\x88\x9D", 0},        /* Unicode code-point 8733 */
-    {"infin", "\xE2\x88\x9E", 0},       /* Unicode code-point 8734 */
-    {"ang", "\xE2\x88\xA0", 0},         /* Unicode code-point 8736 */
-    {"and", "\xE2\x88\xA7", 0},         /* Unicode code-point 8743 */
-    {"or", "\xE2\x88\xA8", 0},          /* Unicode code-point 8744 */
-    {"cap", "\xE2\x88\xA9", 0},         /* Unicode code-point 8745 */
-    {"cup", "\xE2\x88\xAA", 0},         /* Unicode code-point 8746 */
-    {"int", "\xE2\x88\xAB", 0},         /* Unicode code-point 8747 */
-    {"there4", "\xE2\x88\xB4", 0},      /* Unicode code-point 8756 */
-    {"sim", "\xE2\x88\xBC", 0},         /* Unicode code-point 8764 */
-    {"cong", "\xE2\x89\x85", 0},        /* Unicode code-point 8773 */
-    {"asymp", "\xE2\x89\x88", 0},       /* Unicode code-point 8776 */
-    {"ne", "\xE2\x89\xA0", 0},          /* Unicode code-point 8800 */
-    {"equiv", "\xE2\x89\xA1", 0},       /* Unicode code-point 8801 */
-    {"le", "\xE2\x89\xA4", 0},          /* Unicode code-point 8804 */
-    {"ge", "\xE2\x89\xA5", 0},          /* Unicode code-point 8805 */
-    {"sub", "\xE2\x8A\x82", 0},         /* Unicode code-point 8834 */
-    {"sup", "\xE2\x8A\x83", 0},         /* Unicode code-point 8835 */
-    {"nsub", "\xE2\x8A\x84", 0},        /* Unicode code-point 8836 */
-    {"sube", "\xE2\x8A\x86", 0},        /* Unicode code-point 8838 */
-    {"supe", "\xE2\x8A\x87", 0},        /* Unicode code-point 8839 */
-    {"oplus", "\xE2\x8A\x95", 0},       /* Unicode code-point 8853 */
-    {"otimes", "\xE2\x8A\x97", 0},      /* Unicode code-point 8855 */
-    {"perp", "\xE2\x8A\xA5", 0},        /* Unicode code-point 8869 */
-    {"sdot", "\xE2\x8B\x85", 0},        /* Unicode code-point 8901 */
-    {"lceil", "\xE2\x8C\x88", 0},       /* Unicode code-point 8968 */
-    {"rceil", "\xE2\x8C\x89", 0},       /* Unicode code-point 8969 */
-    {"lfloor", "\xE2\x8C\x8A", 0},      /* Unicode code-point 8970 */
-    {"rfloor", "\xE2\x8C\x8B", 0},      /* Unicode code-point 8971 */
-    {"lang", "\xE2\x8C\xA9", 0},        /* Unicode code-point 9001 */
-    {"rang", "\xE2\x8C\xAA", 0},        /* Unicode code-point 9002 */
-    {"loz", "\xE2\x97\x8A", 0},         /* Unicode code-point 9674 */
-    {"spades", "\xE2\x99\xA0", 0},      /* Unicode code-point 9824 */
-    {"clubs", "\xE2\x99\xA3", 0},       /* Unicode code-point 9827 */
-    {"hearts", "\xE2\x99\xA5", 0},      /* Unicode code-point 9829 */
-    {"diams", "\xE2\x99\xA6", 0},       /* Unicode code-point 9830 */
-  
-    /* Non-standard. But very common. */
-    {"quote", "\"", 0},
-    {"apos", "'", 0},
+    int isLegacy;             /* True if the trailing ';' may be omitted */
 };
 
-/* The size of the handler hash table.  For best results this should
-** be a prime number which is about the same size as the number of
-** escape sequences known to the system. */
-#define ESC_HASH_SIZE (sizeof(esc_sequences)/sizeof(esc_sequences[0])+7)
-
-/* The hash table 
-**
-** If the name of an escape sequences hashes to the value H, then
-** apEscHash[H] will point to a linked list of Esc structures, one of
-** which will be the Esc structure for that escape sequence.
+/* htmlentities.c is generated from source file entitylist.txt during the
+** build process. It contains the table of all escape sequences, 
+** esc_sequences[], and the perfect hash table aEscHash[] used to search
+** it. To add new sequences, add entries to entitylist.txt.
 */
-static struct sgEsc *apEscHash[ESC_HASH_SIZE];
+#include "htmlentities.c"
 
-/* Hash a escape sequence name.  The value returned is an integer
-** between 0 and ESC_HASH_SIZE-1, inclusive.
+/* Look up the escape sequence named by the nName bytes at zName. Return
+** a pointer to the sgEsc structure if found, or NULL otherwise. Escape
+** sequence names are case-sensitive.
 */
-static int 
-EscHash (const char *zName)
+static const struct sgEsc *
+EscLookup (const char *zName, int nName)
 {
-    int h = 0;                         /* The hash value to be returned */
-    char c;                            /* The next character in the name
-                                        * being hashed */
+    const struct sgEsc *p;
+    int d;
+    int iSlot;
 
-    while ((c = *zName) != 0) {
-        h = h << 5 ^ h ^ c;
-        zName++;
-    }
-    if (h < 0) {
-        h = -h;
-    }
-    else {
-    }
-    return h % ESC_HASH_SIZE;
-}
-
-#ifdef TEST
-
-/* 
-** Compute the longest and average collision chain length for the
-** escape sequence hash table
-*/
-static void
-EscHashStats(void)
-{
-    int i;
-    int sum = 0;
-    int max = 0;
-    int cnt;
-    int notempty = 0;
-    struct sgEsc *p;
-
-    for (i = 0; i < sizeof(esc_sequences) / sizeof(esc_sequences[0]); i++) {
-        cnt = 0;
-        p = apEscHash[i];
-        if (p)
-            notempty++;
-        while (p) {
-            cnt++;
-            p = p->pNext;
-        }
-        sum += cnt;
-        if (cnt > max)
-            max = cnt;
+    d = aEscHash[HtmlPerfectHash(0, zName, nName, 0) % ESC_HASH_SIZE];
+    if (d < 0) {
+        iSlot = -1 - d;
+    } else {
+        iSlot = HtmlPerfectHash(d, zName, nName, 0) % ESC_HASH_SIZE;
     }
-    printf("Longest chain=%d  avg=%g  slots=%d  empty=%d (%g%%)\n",
-           max, (double) sum / (double) notempty, i, i - notempty,
-           100.0 * (i - notempty) / (double) i);
-}
-#endif
-
-/* Initialize the escape sequence hash table
-*/
-static void 
-EscInit (void)
-{
-    int i;                             /* For looping thru the list of escape 
-                                        * sequences */
-    int h;                             /* The hash on a sequence */
 
-    for (i = 0; i < sizeof(esc_sequences) / sizeof(esc_sequences[i]); i++) {
-
-/* #ifdef TCL_UTF_MAX */
-#if 0
-        {
-            int c = esc_sequences[i].value[0];
-            Tcl_UniCharToUtf(c, esc_sequences[i].value);
-        }
-#endif
-        h = EscHash(esc_sequences[i].zName);
-        esc_sequences[i].pNext = apEscHash[h];
-        apEscHash[h] = &esc_sequences[i];
+    p = &esc_sequences[iSlot];
+    if (strncmp(p->zName, zName, nName) || p->zName[nName]) {
+        return 0;
     }
-#ifdef TEST
-    EscHashStats();
-#endif
+    return p;
 }
 
 /*
@@ -609,17 +286,29 @@ HtmlTranslateEscapes (char *z)
                                         * in z[] */
     int to;                            /* Write characters into this position 
                                         * in z[] */
-    int h;                             /* A hash on the escape sequence */
-    struct sgEsc *p;                   /* For looping down the escape
-                                        * sequence collision chain */
-    static int isInit = 0;             /* True after initialization */
+    const struct sgEsc *p;             /* Escape sequence found */
+
+    int nZ;                            /* Length of z in bytes */
 
     from = to = 0;
-    if (!isInit) {
-        EscInit();
-        isInit = 1;
-    }
+    nZ = strlen(z);
     while (z[from]) {
+        /* Skip over (or copy down, if some escape sequences have already
+         * been translated) the run of plain 7-bit ASCII characters up until
+         * the next '&' or non-ASCII byte. Since the translated string is 
+         * never longer than the original, nZ-from remains the number of 
+         * unprocessed bytes.
+         */
+        int nRun = HtmlScanEscape(&z[from], nZ - from);
+        if (nRun > 0) {
+            if (to != from) {
+                memmove(&z[to], &z[from], nRun);
+            }
+            to += nRun;
+            from += nRun;
+            continue;
+        }
+
         if (z[from] == '&') {
             if (z[from + 1] == '#') {
                 int i = from + 2;
@@ -661,14 +350,8 @@ HtmlTranslateEscapes (char *z)
                     i++;
                 }
                 c = z[i];
-                z[i] = 0;
-                h = EscHash(&z[from + 1]);
-                p = apEscHash[h];
-                while (p && strcmp(p->zName, &z[from + 1]) != 0) {
-                    p = p->pNext;
-                }
-                z[i] = c;
-                if (p) {
+                p = EscLookup(&z[from + 1], i - from - 1);
+                if (p && (c == ';' || p->isLegacy)) {
                     int j;
                     for (j = 0; p->value[j]; j++) {
                         z[to++] = p->value[j];
@@ -719,6 +402,86 @@ HtmlTranslateEscapes (char *z)
     z[to] = 0;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlLookupCmd --
+ *
+ *     ::tkhtml::lookup tag|entity NAMES ?COUNT?
+ *
+ *     Look up each element of list NAMES in either the table of tag names
+ *     (see HtmlHashLookup()) or the table of named character references
+ *     (see EscLookup()), COUNT times over (default 1). This is used by
+ *     tools/lookupbench.tcl to measure the cost of the lookups in
+ *     isolation from the rest of the parser.
+ *
+ * Results:
+ *     The number of elements of NAMES found in the table.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+HtmlLookupCmd (
+    ClientData clientData,             /* Unused */
+    Tcl_Interp *interp,                /* Current interpreter. */
+    int objc,                          /* Number of arguments. */
+    Tcl_Obj *CONST objv[]              /* Argument strings. */
+    )
+{
+    static const char *azTable[] = {"tag", "entity", 0};
+    int iTable;
+    int nCount = 1;
+    int nName;
+    Tcl_Obj **apName;
+    const char **azName;
+    int *anName;
+    int nFound = 0;
+    int ii;
+    int jj;
+
+    if (objc != 3 && objc != 4) {
+        Tcl_WrongNumArgs(interp, 1, objv, "tag|entity NAMES ?COUNT?");
+        return TCL_ERROR;
+    }
+    if (
+        Tcl_GetIndexFromObj(interp, objv[1], azTable, "table", 0, &iTable) ||
+        Tcl_ListObjGetElements(interp, objv[2], &nName, &apName) ||
+        (objc == 4 && Tcl_GetIntFromObj(interp, objv[3], &nCount))
+    ) {
+        return TCL_ERROR;
+    }
+
+    /* Convert the list to an array of strings up front, so that only
+     * the lookups themselves are timed by the caller.
+     */
+    azName = (const char **)HtmlAlloc("temp", nName * sizeof(char *) + 1);
+    anName = (int *)HtmlAlloc("temp", nName * sizeof(int) + 1);
+    for (ii = 0; ii < nName; ii++) {
+        azName[ii] = Tcl_GetStringFromObj(apName[ii], &anName[ii]);
+    }
+
+    for (jj = 0; jj < nCount; jj++) {
+        nFound = 0;
+        if (iTable == 0) {
+            for (ii = 0; ii < nName; ii++) {
+                if (HtmlHashLookup(0, azName[ii])) nFound++;
+            }
+        } else {
+            for (ii = 0; ii < nName; ii++) {
+                if (EscLookup(azName[ii], anName[ii])) nFound++;
+            }
+        }
+    }
+
+    HtmlFree(azName);
+    HtmlFree(anName);
+    Tcl_SetObjResult(interp, Tcl_NewIntObj(nFound));
+    return TCL_OK;
+}
+
 static HtmlWidgetTag *
 getWidgetTag (HtmlTree *pTree, const char *zTag, int *pIsNew)
 {
@@ -1348,7 +1111,7 @@ initHtmlText_Elem (HtmlTree *pTree, HtmlElementNode *pElem, HtmlTextInit *pInit)
      */
     if (
         (eDisplay == CSS_CONST_NONE) ||
-        (pElem->pReplacement && pElem->pReplacement->win)
+        (HtmlElemRare(pElem, pReplacement) && pElem->pRare->pReplacement->win)
     ) {
         return;
     }
@@ -1799,6 +1562,12 @@ static Tcl_UniChar utf8Read(
  *     zEnd points to 1 byte passed the end of the buffer - reading *zEnd
  *     would be a seg-fault.
  *
+ *     Runs of printable ASCII characters are skipped using HtmlScanWord(),
+ *     which examines 16 or 32 bytes at a time where the CPU supports it.
+ *     Only ASCII control characters and multi-byte UTF-8 characters (which
+ *     may be CJK characters, each of which is a token of its own) are
+ *     examined individually.
+ *
  * Results:
  *     Length of token at zToken in bytes.
  *
@@ -1810,17 +1579,30 @@ static Tcl_UniChar utf8Read(
 static int 
 tokenLength (const unsigned char *zToken, const unsigned char *zEnd)
 {
-    Tcl_UniChar iChar = 0;
     const unsigned char *zCsr = zToken;
-    const unsigned char *zNext = zCsr;
 
-    iChar = utf8Read(zCsr, zEnd, &zNext);
-    while (iChar && (iChar >= 256 || !ISSPACE(iChar)) && !ISCJK(iChar)){
-      zCsr = zNext;
-      iChar = utf8Read(zCsr, zEnd, &zNext);
+    while (1) {
+        Tcl_UniChar iChar;
+        const unsigned char *zNext;
+
+        zCsr += HtmlScanWord((const char *)zCsr, zEnd - zCsr);
+        if (zCsr == zEnd) break;
+
+        if (*zCsr < 0x80) {
+            if (ISSPACE(*zCsr)) break;
+            zCsr++;
+            continue;
+        }
+
+        iChar = utf8Read(zCsr, zEnd, &zNext);
+        if (!iChar || (iChar < 256 && ISSPACE(iChar)) || ISCJK(iChar)) {
+            if (zCsr == zToken) zCsr = zNext;
+            break;
+        }
+        zCsr = zNext;
     }
 
-    return ((zCsr==zToken)?zNext:zCsr)-zToken;
+    return zCsr - zToken;
 }
 
 /*
@@ -1829,35 +1611,38 @@ tokenLength (const unsigned char *zToken, const unsigned char *zEnd)
  * populateTextNode --
  * 
  *     This function is called to tokenize a block of document text into 
- *     an HtmlTextNode structure. It is a helper function for HtmlTextNew().
+ *     an array of HtmlTextToken structures. It is a helper function for 
+ *     HtmlTextSet().
  *
- *     This function is designed to be called twice for each block of text
- *     parsed to an HtmlTextNode. The first time, it determines the space
- *     (number of tokens and number of bytes of text) required for the
- *     the new HtmlTextNode. The caller then allocates this space and
- *     calls the function a second time to populate the new structure.
+ *     The text is tokenized in a single pass. The caller supplies an array aToken[]
+ *     large enough for the worst case (n+1 tokens - every token, except
+ *     LONGTEXT, consumes at least one byte of input and three LONGTEXT 
+ *     tokens consume at least 256). The text stored in HtmlTextNode.zText
+ *     is never longer than the input consumed to produce it, so it is 
+ *     written over the start of buffer z as the input is tokenized.
  *
  * Results:
- *     None.
+ *     The number of tokens written to aToken[], including the END token.
  *
  * Side effects:
+ *     The first *pnText bytes of buffer z are overwritten with the text
+ *     for HtmlTextNode.zText.
  *
  *---------------------------------------------------------------------------
  */
-static void 
+static int 
 populateTextNode (
     int n,                     /* Length of input text */
-    char const *z,             /* Input text */
-    HtmlTextNode *pText,       /* OUT: The structure to populate (or NULL) */
-    int *pnToken,              /* OUT: Number of tokens required (or used) */
-    int *pnText               /* OUT: Bytes of text required (or used) */
+    char *z,                   /* Input text. Overwritten with output text */
+    HtmlTextToken *aToken,     /* OUT: Array of at least n+1 tokens */
+    int *pnText                /* OUT: Bytes of text written to z */
 )
 {
     char const *zCsr = z;
     char const *zStop = &z[n];
 
-    /* A running count of the number of tokens and bytes of text storage
-     * required to store the parsed form of the input text.
+    /* A running count of the number of tokens and bytes of text written
+     * so far.
      */
     int nToken = 0;
     int nText = 0;
@@ -1881,6 +1666,22 @@ populateTextNode (
             }
 
             do {
+                if (zCsr[0] == ' ' && &zCsr[1] < zStop && zCsr[1] == ' ') {
+                    /* A run of two or more space characters. Consume as 
+                     * much of it as will fit in this token at once. The
+                     * adjustment to iCol is the same as would be made by
+                     * the one-at-a-time loop below.
+                     */
+                    int nMax = zStop - zCsr;
+                    int k;
+                    if (nMax > (255 - 8) - nSpace) nMax = (255 - 8) - nSpace;
+                    k = HtmlScanSpaces(zCsr, nMax);
+                    iCol += k * nSpace + (k * (k + 1)) / 2;
+                    nSpace += k;
+                    zCsr += k;
+                    continue;
+                }
+
                 /* If a tab character, this is equivalent to adding between
                  * one and eight spaces, depending on the current value of
                  * variable iCol (see comments above variable declaration). 
@@ -1911,10 +1712,8 @@ populateTextNode (
             }
 
             assert(nSpace <= 255);
-            if (pText) {
-                pText->aToken[nToken].n = nSpace;
-                pText->aToken[nToken].eType = eType;
-            }
+            aToken[nToken].n = nSpace;
+            aToken[nToken].eType = eType;
             nToken++;
 
             /* If the previous token was text, add a single space character
@@ -1922,10 +1721,7 @@ populateTextNode (
              * to the text buffer.
              */
             if (isPrevTokenText) {
-                if (pText) {
-                    pText->zText[nText] = ' ';
-                }
-                nText++;
+                z[nText++] = ' ';
                 isPrevTokenText = 0;
             }
         } else {
@@ -1942,25 +1738,22 @@ populateTextNode (
             zCsr = &zCsr[nThisText];
 
             if (nThisText > 255) {
-                if (pText) {
-                    pText->aToken[nToken].eType = HTML_TEXT_TOKEN_LONGTEXT;
-                    pText->aToken[nToken+1].eType = HTML_TEXT_TOKEN_LONGTEXT;
-                    pText->aToken[nToken+2].eType = HTML_TEXT_TOKEN_LONGTEXT;
-                    pText->aToken[nToken].n = ((nThisText >> 16) & 0x000000FF);
-                    pText->aToken[nToken+1].n = ((nThisText >> 8) & 0x000000FF);
-                    pText->aToken[nToken+2].n = (nThisText & 0x000000FF);
-                    memcpy(&pText->zText[nText], zStart, nThisText);
-                }
+                aToken[nToken].eType = HTML_TEXT_TOKEN_LONGTEXT;
+                aToken[nToken+1].eType = HTML_TEXT_TOKEN_LONGTEXT;
+                aToken[nToken+2].eType = HTML_TEXT_TOKEN_LONGTEXT;
+                aToken[nToken].n = ((nThisText >> 16) & 0x000000FF);
+                aToken[nToken+1].n = ((nThisText >> 8) & 0x000000FF);
+                aToken[nToken+2].n = (nThisText & 0x000000FF);
                 nToken += 3;
             } else {
-                if (pText) {
-                    pText->aToken[nToken].eType = HTML_TEXT_TOKEN_TEXT;
-                    pText->aToken[nToken].n = nThisText;
-                    memcpy(&pText->zText[nText], zStart, nThisText);
-                }
+                aToken[nToken].eType = HTML_TEXT_TOKEN_TEXT;
+                aToken[nToken].n = nThisText;
                 nToken++;
             }
 
+            if (&z[nText] != zStart) {
+                memmove(&z[nText], zStart, nThisText);
+            }
             nText += nThisText;
             isPrevTokenText = 1;
             iCol += nThisText;
@@ -1968,19 +1761,27 @@ populateTextNode (
     }
 
     /* Add the terminator token */
-    if (pText) {
-        pText->aToken[nToken].eType = HTML_TEXT_TOKEN_END;
-    }
+    aToken[nToken].eType = HTML_TEXT_TOKEN_END;
+    aToken[nToken].n = 0;
     nToken++;
 
-    if (pnToken) *pnToken = nToken;
-    if (pnText) *pnText = nText;
+    assert(nToken <= n + 1);
+    *pnText = nText;
+    return nToken;
 }
 
 void 
-HtmlTextSet (HtmlTextNode *pText, int n, const char *z, int isTrimEnd, int isTrimStart)
+HtmlTextSet (
+    HtmlArena *pArena,           /* Arena to allocate from (or NULL) */
+    HtmlTextNode *pText,         /* Text node to populate */
+    int n,                       /* Length of text z in bytes */
+    const char *z,               /* Text (may contain html escapes) */
+    int isTrimEnd,               /* True to trim a trailing newline */
+    int isTrimStart              /* True to trim a leading newline */
+)
 {
     char *z2;
+    HtmlTextToken *aToken;
     HtmlTextToken *pFinal;
 
     int nText = 0;
@@ -1988,34 +1789,40 @@ HtmlTextSet (HtmlTextNode *pText, int n, const char *z, int isTrimEnd, int isTri
     int nAlloc;                /* Number of bytes allocated */
 
     if (pText->aToken) {
-        HtmlFree(pText->aToken);
+        HtmlArenaFree(pArena, pText->aToken);
     }
 
     /* Make a temporary copy of the text and translate any embedded html 
-     * escape characters (i.e. "&nbsp;"). Todo: Avoid this copy by changing
-     * populateTextNode() so that it deals with escapes.
+     * escape characters (i.e. "&nbsp;"). The same allocation is used for
+     * the worst-case sized token array passed to populateTextNode(). 
+     * Todo: Avoid this copy by changing populateTextNode() so that it 
+     * deals with escapes.
      */
-    z2 = (char *)HtmlAlloc("temp", n + 1);
+    z2 = (char *)HtmlAlloc("temp", n + 1 + (n + 1) * sizeof(HtmlTextToken));
+    aToken = (HtmlTextToken *)&z2[n + 1];
     memcpy(z2, z, n);
     z2[n] = '\0';
     HtmlTranslateEscapes(z2);
 
-    /* Figure out how much space is required for this HtmlTextNode. */
-    populateTextNode(strlen(z2), z2, 0, &nToken, &nText);
+    /* Tokenize the text. */
+    nToken = populateTextNode(strlen(z2), z2, aToken, &nText);
     assert(nText >= 0 && nToken > 0);
 
-    /* Allocate space for HtmlTextNode.aToken and HtmlTextNode.zText */
+    /* Allocate space for HtmlTextNode.aToken and HtmlTextNode.zText,
+     * trimmed to the size actually used, and copy in the results.
+     */
     nAlloc = nText + (nToken * sizeof(HtmlTextToken));
-    pText->aToken = (HtmlTextToken *)HtmlClearAlloc("TextNode.aToken", nAlloc);
+    pText->aToken = (HtmlTextToken *)HtmlArenaAlloc(
+        pArena, "TextNode.aToken", nAlloc
+    );
+    memcpy(pText->aToken, aToken, nToken * sizeof(HtmlTextToken));
     if (nText > 0) {
         pText->zText = (char *)&pText->aToken[nToken];
+        memcpy(pText->zText, z2, nText);
     } else {
         /* If the node is all white-space, set HtmlTextNode.zText to NULL */
         pText->zText = 0;
     }
-
-    /* Populate the HtmlTextNode.aToken and zText arrays. */
-    populateTextNode(strlen(z2), z2, pText, 0, 0);
     HtmlFree(z2);
 
     assert(pText->aToken[nToken-1].eType == HTML_TEXT_TOKEN_END);
@@ -2061,17 +1868,93 @@ HtmlTextSet (HtmlTextNode *pText, int n, const char *z, int isTrimEnd, int isTri
 }
 
 HtmlTextNode *
-HtmlTextNew (int n, const char *z, int isTrimEnd, int isTrimStart)
+HtmlTextNew (
+    HtmlArena *pArena, 
+    int n, 
+    const char *z, 
+    int isTrimEnd, 
+    int isTrimStart
+)
 {
     HtmlTextNode *pText;
 
     /* Allocate space for the HtmlTextNode. */ 
-    pText = HtmlNew(HtmlTextNode);
+    pText = HtmlArenaNew(pArena, HtmlTextNode);
 
-    HtmlTextSet(pText, n, z, isTrimEnd, isTrimStart);
+    HtmlTextSet(pArena, pText, n, z, isTrimEnd, isTrimStart);
     return pText;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlTextClone --
+ *
+ *     Allocate a new text node from arena pArena (or the heap if pArena
+ *     is NULL) with the same tokens and text as pText. The tree fields 
+ *     of the new node (HtmlNode.pParent etc.) are zeroed, except for
+ *     HtmlNode.eTag. Widget tags are not copied.
+ *
+ * Results:
+ *     Pointer to the new text node.
+ *
+ * Side effects:
+ *     Allocates memory.
+ *
+ *---------------------------------------------------------------------------
+ */
+HtmlTextNode *
+HtmlTextClone (HtmlArena *pArena, HtmlTextNode *pText)
+{
+    HtmlTextNode *pNew;
+    HtmlTextToken *aToken = pText->aToken;
+    int nToken;
+    int nText = 0;
+    int nAlloc;
+
+    /* Count the tokens (including the END token) and bytes of text. The
+     * text follows the token array in the same allocation (see 
+     * HtmlTextSet()), but the array may have been trimmed after the
+     * text pointer was set, so copy everything up to the end of the text.
+     * As in populateTextNode(), a text token is followed by a single 
+     * separator byte only if the next token is white-space.
+     */
+    for (nToken = 0; aToken[nToken].eType != HTML_TEXT_TOKEN_END; nToken++) {
+        int eType = aToken[nToken].eType;
+        if (eType == HTML_TEXT_TOKEN_TEXT) {
+            nText += aToken[nToken].n;
+        } else if (eType == HTML_TEXT_TOKEN_LONGTEXT) {
+            nText += (aToken[nToken].n << 16) + 
+                     (aToken[nToken+1].n << 8) + aToken[nToken+2].n;
+            nToken += 2;
+        }
+        if ((eType == HTML_TEXT_TOKEN_TEXT || eType == HTML_TEXT_TOKEN_LONGTEXT)
+         && (aToken[nToken+1].eType == HTML_TEXT_TOKEN_SPACE ||
+             aToken[nToken+1].eType == HTML_TEXT_TOKEN_NEWLINE)
+        ) {
+            nText++;
+        }
+    }
+    nToken++;
+
+    if (pText->zText) {
+        nAlloc = (pText->zText - (char *)aToken) + nText;
+    } else {
+        nAlloc = nToken * sizeof(HtmlTextToken);
+    }
+
+    pNew = HtmlArenaNew(pArena, HtmlTextNode);
+    pNew->node.eTag = pText->node.eTag;
+    pNew->aToken = (HtmlTextToken *)HtmlArenaAlloc(
+        pArena, "TextNode.aToken", nAlloc
+    );
+    memcpy(pNew->aToken, aToken, nAlloc);
+    if (pText->zText) {
+        pNew->zText = &((char *)pNew->aToken)[pText->zText - (char *)aToken];
+    }
+    return pNew;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
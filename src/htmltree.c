@@ -48,6 +48,27 @@ struct HtmlFragmentContext {
   HtmlNode *pRoot;
   HtmlElementNode *pCurrent;
   Tcl_Obj *pNodeList;
+  HtmlFragmentTemplate *pTemplate;     /* Template being built, or NULL */
+};
+
+/*
+ * A parsed [fragment] template. See the comments above struct 
+ * HtmlFragmentCache in html.h. The sub-trees in apRoot[] are never 
+ * visible to scripts - they have no node commands, are not in the
+ * HtmlTree.aOrphan table and node-handlers are not invoked for them.
+ *
+ * The mode and parsemode options affect the tokenizer, so they are
+ * stored along with each template. A template is only reused if the
+ * options have not changed since it was built.
+ */
+struct HtmlFragmentTemplate {
+  Tcl_HashEntry *pEntry;               /* Entry in HtmlFragmentCache */
+  int eMode;                           /* Value of -mode when built */
+  int eParseMode;                      /* Value of -parsemode when built */
+  int nRoot;                           /* Number of sub-trees in apRoot */
+  HtmlNode **apRoot;                   /* Root of each sub-tree */
+  HtmlFragmentTemplate *pNext;         /* Next (less recently used) */
+  HtmlFragmentTemplate *pPrev;         /* Previous (more recently used) */
 };
 
 /*
@@ -75,6 +96,283 @@ struct HtmlFragmentContext {
 
 static void treeCloseFosterTree(HtmlTree *);
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Arena allocator.
+ *
+ *     The nodes, attributes and text created by the [$html parse] command
+ *     live until the next [$html reset] (or until the widget is 
+ *     destroyed). Instead of allocating and freeing each one separately,
+ *     they are carved out of large blocks owned by the widget 
+ *     (HtmlTree.arena), and the blocks are freed all at once by 
+ *     HtmlTreeClear().
+ *
+ *     Nodes created by other means (generated content, [$html fragment])
+ *     may be deleted at any time, so they use the heap. HtmlArenaFree() 
+ *     checks whether or not a pointer belongs to the arena. If so it is a
+ *     no-op - the memory is reclaimed when the arena is released.
+ *
+ *     Block sizes start at ARENA_MIN_BLOCK bytes and double each time a 
+ *     new block is required, up to ARENA_MAX_BLOCK. Large allocations 
+ *     are given blocks of their own. To find the block (if any) that a
+ *     pointer belongs to, HtmlArenaFree() does a binary search of the 
+ *     array of blocks sorted by address (HtmlArena.apBlock), so that 
+ *     freeing each node of a large document in HtmlTreeClear() costs 
+ *     O(log N) in the number of blocks, not O(N).
+ *---------------------------------------------------------------------------
+ */
+#define ARENA_MIN_BLOCK (16 * 1024)
+#define ARENA_MAX_BLOCK (4 * 1024 * 1024)
+
+/* Round n up to the next multiple of 8 bytes. */
+#define ARENA_ROUND(n) (((n) + 7) & ~7)
+
+struct HtmlArenaBlock {
+    HtmlArenaBlock *pNext;     /* Next (older) block in list */
+    int nByte;                 /* Size of block, excluding this header */
+    int iPad;                  /* Keep data 8-byte aligned */
+};
+#define ARENA_DATA(pBlock) ((char *)&(pBlock)[1])
+
+/* 
+ * Counters reported by [::tkhtml::htmlalloc]. See HtmlArenaAllocCmd(). 
+ */
+static int nArenaAlloc = 0;        /* Allocations made from arenas */
+static int nArenaHeapAlloc = 0;    /* Allocations made on the slow path */
+static int nArenaBlock = 0;        /* Number of arena blocks allocated */
+static int nArenaBlockByte = 0;    /* Bytes in arena blocks allocated */
+
+/*
+ * Add newly allocated block pBlock to the HtmlArena.apBlock array of
+ * pArena, keeping the array sorted by address.
+ */
+static void
+arenaBlockInsert (HtmlArena *pArena, HtmlArenaBlock *pBlock)
+{
+    int iLo = 0;
+    int iHi = pArena->nBlock;
+
+    while (iLo < iHi) {
+        int iMid = (iLo + iHi) / 2;
+        if (pArena->apBlock[iMid] < pBlock) {
+            iLo = iMid + 1;
+        } else {
+            iHi = iMid;
+        }
+    }
+
+    pArena->apBlock = (HtmlArenaBlock **)HtmlRealloc("HtmlArena.apBlock",
+        (char *)pArena->apBlock, (pArena->nBlock+1) * sizeof(HtmlArenaBlock *)
+    );
+    memmove(&pArena->apBlock[iLo + 1], &pArena->apBlock[iLo], 
+        (pArena->nBlock - iLo) * sizeof(HtmlArenaBlock *)
+    );
+    pArena->apBlock[iLo] = pBlock;
+    pArena->nBlock++;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlArenaAlloc --
+ *
+ *     Allocate n bytes from arena pArena, or from the heap if pArena 
+ *     is NULL. The returned memory is 8-byte aligned.
+ *
+ * Results:
+ *     Pointer to allocated memory.
+ *
+ * Side effects:
+ *     May allocate a new arena block.
+ *
+ *---------------------------------------------------------------------------
+ */
+char *
+HtmlArenaAlloc (HtmlArena *pArena, const char *zTopic, int n)
+{
+    char *zRet;
+
+    if (!pArena) {
+        nArenaHeapAlloc++;
+        return (char *)HtmlAlloc(zTopic, n);
+    }
+
+    n = ARENA_ROUND(MAX(n, 1));
+    if ((pArena->zEnd - pArena->zFree) < n) {
+        HtmlArenaBlock *pBlock;
+        int nByte = ARENA_MIN_BLOCK;
+        if (pArena->pBlock) {
+            nByte = MIN(pArena->pBlock->nByte * 2, ARENA_MAX_BLOCK);
+        }
+
+        if (n > nByte / 4) {
+            /* A large allocation (i.e. a big text node). Give it a block
+             * of its own and link it in behind the current block, so that
+             * the free space in the current block is not wasted.
+             */
+            pBlock = (HtmlArenaBlock *)HtmlAlloc(
+                "HtmlArenaBlock", sizeof(HtmlArenaBlock) + n
+            );
+            pBlock->nByte = n;
+            if (pArena->pBlock) {
+                pBlock->pNext = pArena->pBlock->pNext;
+                pArena->pBlock->pNext = pBlock;
+            } else {
+                pBlock->pNext = 0;
+                pArena->pBlock = pBlock;
+                pArena->zFree = pArena->zEnd = &ARENA_DATA(pBlock)[n];
+            }
+            arenaBlockInsert(pArena, pBlock);
+            nArenaBlock++;
+            nArenaBlockByte += n;
+            nArenaAlloc++;
+            return ARENA_DATA(pBlock);
+        }
+
+        pBlock = (HtmlArenaBlock *)HtmlAlloc(
+            "HtmlArenaBlock", sizeof(HtmlArenaBlock) + nByte
+        );
+        pBlock->nByte = nByte;
+        pBlock->pNext = pArena->pBlock;
+        pArena->pBlock = pBlock;
+        pArena->zFree = ARENA_DATA(pBlock);
+        pArena->zEnd = &ARENA_DATA(pBlock)[nByte];
+        arenaBlockInsert(pArena, pBlock);
+        nArenaBlock++;
+        nArenaBlockByte += nByte;
+    }
+
+    zRet = pArena->zFree;
+    pArena->zFree += n;
+    nArenaAlloc++;
+    return zRet;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlArenaFree --
+ *
+ *     Free memory allocated by HtmlArenaAlloc() or HtmlAlloc(). If p
+ *     belongs to arena pArena this is a no-op.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     May free p.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+HtmlArenaFree (HtmlArena *pArena, void *p)
+{
+    if (p) {
+        /* Find the block with the highest address not greater than p.
+         * If p lies within it, p belongs to the arena.
+         */
+        int iLo = 0;
+        int iHi = (pArena ? pArena->nBlock : 0);
+        while (iLo < iHi) {
+            int iMid = (iLo + iHi) / 2;
+            if ((char *)pArena->apBlock[iMid] <= (char *)p) {
+                iLo = iMid + 1;
+            } else {
+                iHi = iMid;
+            }
+        }
+        if (iLo > 0) {
+            HtmlArenaBlock *pBlock = pArena->apBlock[iLo - 1];
+            char *zData = ARENA_DATA(pBlock);
+            if ((char *)p >= zData && (char *)p < &zData[pBlock->nByte]) {
+                return;
+            }
+        }
+        HtmlFree(p);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlArenaRelease --
+ *
+ *     Free all blocks owned by arena pArena. Any pointers into the arena
+ *     are invalidated.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     Frees memory. Resets *pArena to an empty arena.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+HtmlArenaRelease (HtmlArena *pArena)
+{
+    HtmlArenaBlock *pBlock = pArena->pBlock;
+    while (pBlock) {
+        HtmlArenaBlock *pNext = pBlock->pNext;
+        nArenaBlock--;
+        nArenaBlockByte -= pBlock->nByte;
+        HtmlFree(pBlock);
+        pBlock = pNext;
+    }
+    HtmlFree(pArena->apBlock);
+    memset(pArena, 0, sizeof(HtmlArena));
+}
+
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlArenaAllocCmd --
+ *
+ *         ::tkhtml::htmlalloc
+ *
+ *     Return a key-value list (suitable for passing to [array set]) of 
+ *     the arena allocator statistics for all widgets in the process:
+ *
+ *         "arena allocations"     Objects allocated from arenas.
+ *         "heap allocations"      Objects allocated on the slow path.
+ *         "arena blocks"          Arena blocks currently allocated.
+ *         "arena bytes"           Total size of those blocks.
+ *
+ *     The first two are cumulative. Comparing them before and after 
+ *     parsing a document shows how many separate heap allocations 
+ *     were avoided.
+ *
+ * Results:
+ *     Always TCL_OK.
+ *
+ * Side effects:
+ *     Sets the interpreter result.
+ *
+ *---------------------------------------------------------------------------
+ */
+int 
+HtmlArenaAllocCmd (
+    ClientData clientData,
+    Tcl_Interp *interp, 
+    int objc,
+    Tcl_Obj * const objv[]
+)
+{
+    Tcl_Obj *pRet = Tcl_NewObj();
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj("arena allocations",-1));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewIntObj(nArenaAlloc));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj("heap allocations",-1));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewIntObj(nArenaHeapAlloc));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj("arena blocks", -1));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewIntObj(nArenaBlock));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewStringObj("arena bytes", -1));
+    Tcl_ListObjAppendElement(0, pRet, Tcl_NewIntObj(nArenaBlockByte));
+    Tcl_SetObjResult(interp, pRet);
+    return TCL_OK;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -176,9 +474,9 @@ geomRequestProc(
 static void 
 clearReplacement (HtmlTree *pTree, HtmlElementNode *pElem)
 {
-    HtmlNodeReplacement *p = pElem->pReplacement;
-    pElem->pReplacement = 0;
+    HtmlNodeReplacement *p = HtmlElemRare(pElem, pReplacement);
     if (p) {
+        pElem->pRare->pReplacement = 0;
 
         /* Cancel any idle callback scheduled by geomRequestProc() */
         Tcl_CancelIdleCall(geomRequestProcCb, (ClientData)pElem);
@@ -224,11 +522,10 @@ HtmlNodeClearStyle (HtmlTree *pTree, HtmlElementNode *pElem)
         HtmlComputedValuesRelease(pTree, pElem->pPropertyValues);
         HtmlComputedValuesRelease(pTree, pElem->pPreviousValues);
         HtmlCssInlineFree(pElem->pStyle);
-        HtmlCssFreeDynamics(pElem);
+        HtmlCssFreeDynamics(pElem);     /* Also clears pRare->pDynamic */
         pElem->pStyle = 0;
         pElem->pPropertyValues = 0;
         pElem->pPreviousValues = 0;
-        pElem->pDynamic = 0;
         HtmlDelStackingInfo(pTree, pElem);
     }
     return 0;
@@ -281,15 +578,17 @@ freeNode (HtmlTree *pTree, HtmlNode *pNode)
         if (!HtmlNodeIsText(pNode)) {
             /* Do HtmlElementNode specific destruction */
             HtmlElementNode *pElem = (HtmlElementNode *)pNode;
-            HtmlFree(pElem->pAttributes);
+            HtmlArenaFree(&pTree->arena, pElem->pAttributes);
+            HtmlArenaFree(&pTree->arena, (void *)pElem->azClass);
 
             /* Delete the computed values caches. */
             HtmlNodeClearStyle(pTree, pElem);
             HtmlCssFreeDynamics(pElem);
+            HtmlCallbackDynamicCancel(pTree, pNode);
 
-            if (pElem->pOverride) {
-                Tcl_DecrRefCount(pElem->pOverride);
-                pElem->pOverride = 0;
+            if (HtmlElemRare(pElem, pOverride)) {
+                Tcl_DecrRefCount(pElem->pRare->pOverride);
+                pElem->pRare->pOverride = 0;
             }
 
             /* Delete the descendant nodes. */
@@ -306,7 +605,7 @@ freeNode (HtmlTree *pTree, HtmlNode *pNode)
             HtmlTextNode *pTextNode = HtmlNodeAsText(pNode);
             assert(pTextNode);
             HtmlTagCleanupNode(pTextNode);
-            HtmlFree(pTextNode->aToken);
+            HtmlArenaFree(&pTree->arena, pTextNode->aToken);
         }
 
         /* Delete the computed values caches. */
@@ -314,21 +613,55 @@ freeNode (HtmlTree *pTree, HtmlNode *pNode)
 
         HtmlNodeDeleteCommand(pTree, pNode);
 
-        HtmlFree(pNode);
+        if (!HtmlNodeIsText(pNode)) {
+            HtmlFree(((HtmlElementNode *)pNode)->pRare);
+        }
+
+        HtmlArenaFree(&pTree->arena, pNode);
     }
 }
 
 int 
 HtmlNodeClearGenerated (HtmlTree *pTree, HtmlElementNode *pElem)
 {
-    assert(!pElem->pBefore || !HtmlNodeIsText(pElem->pBefore));
-    freeNode(pTree, pElem->pBefore);
-    freeNode(pTree, pElem->pAfter);
-    pElem->pBefore = 0;
-    pElem->pAfter = 0;
+    HtmlElementRare *pRare = pElem->pRare;
+    if (pRare) {
+        assert(!pRare->pBefore || !HtmlNodeIsText(pRare->pBefore));
+        freeNode(pTree, pRare->pBefore);
+        freeNode(pTree, pRare->pAfter);
+        pRare->pBefore = 0;
+        pRare->pAfter = 0;
+    }
     return 0;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlElemRareGet --
+ *
+ *     Return the HtmlElementRare structure for element pElem, allocating
+ *     it first if it does not already exist. This should only be called
+ *     when a field of the structure is about to be set to a non-NULL 
+ *     value, so that most elements never allocate one.
+ *
+ * Results:
+ *     Pointer to the (possibly new) HtmlElementRare structure.
+ *
+ * Side effects:
+ *     May allocate memory. It is freed along with the node by freeNode().
+ *
+ *---------------------------------------------------------------------------
+ */
+HtmlElementRare *
+HtmlElemRareGet (HtmlElementNode *pElem)
+{
+    if (!pElem->pRare) {
+        pElem->pRare = HtmlNew(HtmlElementRare);
+    }
+    return pElem->pRare;
+}
+
 static Tcl_Obj *
 nodeGetPreText(HtmlTextNode *pTextNode)
 {
@@ -387,23 +720,19 @@ nodeGetPreText(HtmlTextNode *pTextNode)
 static int 
 nodeRemoveChild (HtmlElementNode *pElem, HtmlNode *pChild)
 {
-    int eSeen = 0;
     int ii;
+    int iChild = HtmlNodeIndexOfChild((HtmlNode *)pElem, pChild);
 
-    for (ii = 0; ii < pElem->nChild; ii++) {
-        if (eSeen) {
-            pElem->apChildren[ii - 1] = pElem->apChildren[ii];
-        }
-        if (pElem->apChildren[ii] == pChild) {
-            assert(pChild->pParent == (HtmlNode *)pElem);
-            pChild->pParent = 0;
-            eSeen = 1;
-        }
+    if (iChild < 0) {
+        return 0;
     }
-    if (eSeen) {
-        pElem->nChild--;
+    pChild->pParent = 0;
+    pElem->nChild--;
+    for (ii = iChild; ii < pElem->nChild; ii++) {
+        pElem->apChildren[ii] = pElem->apChildren[ii + 1];
+        pElem->apChildren[ii]->iChild = ii;
     }
-    return eSeen;
+    return 1;
 }
 
 /*
@@ -441,6 +770,39 @@ HtmlElementNormalize (HtmlElementNode *pElem)
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * batchAppend --
+ *
+ *     Append argument pArg to the list of pending arguments for batched
+ *     handler p. If the list was empty, link p onto the end of the 
+ *     HtmlTree.apBatchPending list. Arguments for the nodes of a fragment
+ *     are kept apart from those for the nodes of the document.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+batchAppend (HtmlTree *pTree, HtmlHandlerBatch *p, Tcl_Obj *pArg)
+{
+    int i = (pTree->pFragment ? 1 : 0);
+    if (!p->apArgs[i]) {
+        HtmlHandlerBatch **pp = &pTree->apBatchPending[i];
+        while (*pp) pp = &(*pp)->apNext[i];
+        *pp = p;
+        p->apNext[i] = 0;
+        p->apArgs[i] = Tcl_NewObj();
+        Tcl_IncrRefCount(p->apArgs[i]);
+    }
+    Tcl_ListObjAppendElement(0, p->apArgs[i], pArg);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -521,6 +883,13 @@ nodeHandlerCallbacks (HtmlTree *pTree, HtmlNode *pNode)
         if (!isFragment && pTree->eWriteState == HTML_PARSE_NODEHANDLER){
             pTree->eWriteState = HTML_WRITE_NONE;
         }
+    } else {
+        /* Or queue the node for a batched node-handler, if one exists. */
+        pEntry = Tcl_FindHashEntry(&pTree->aNodeBatch, (char *)((size_t)eTag));
+        if (pEntry) {
+            HtmlHandlerBatch *p = (HtmlHandlerBatch *)Tcl_GetHashValue(pEntry);
+            batchAppend(pTree, p, HtmlNodeCommand(pTree, pNode));
+        }
     }
     return 0;
 }
@@ -551,8 +920,122 @@ HtmlFinishNodeHandlers (HtmlTree *pTree)
         nodeHandlerCallbacks(pTree, p);
     }
     pTree->state.pCurrent = 0;
+    HtmlFlushHandlerBatches(pTree);
 }   
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlFlushHandlerBatches --
+ *
+ *     Invoke each batched node or parse handler that has accumulated 
+ *     arguments since the last call to this function. The list of 
+ *     accumulated arguments (node handles for a node handler, or node 
+ *     handle and offset pairs for a parse handler) is appended to the
+ *     handler script as a single argument. Within each list the arguments
+ *     are in document order. The handlers are invoked in the order in
+ *     which they received their first argument.
+ *
+ *     While a fragment is being parsed, only the batches for the nodes
+ *     of the fragment are flushed. Those for the document remain pending.
+ *
+ *     Batched node handlers are invoked in the same write-state as 
+ *     regular node handlers (see nodeHandlerCallbacks()). If one calls
+ *     the [reset] method of the widget, any remaining batches are 
+ *     discarded along with the document.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     Evaluates arbitrary Tcl scripts.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+HtmlFlushHandlerBatches (HtmlTree *pTree)
+{
+    Tcl_Interp *interp = pTree->interp;
+    int isFragment = (pTree->pFragment?1:0);
+
+    while (pTree->apBatchPending[isFragment]) {
+        HtmlHandlerBatch *p = pTree->apBatchPending[isFragment];
+        int isNodeHandler = p->isNodeHandler;
+        Tcl_Obj *pEval;
+        int rc;
+
+        /* Detach the pending arguments from the batch before evaluating
+         * the script, as the script may add nodes to the document, 
+         * reconfigure the handler or reset the widget.
+         */
+        pTree->apBatchPending[isFragment] = p->apNext[isFragment];
+        p->apNext[isFragment] = 0;
+        pEval = Tcl_DuplicateObj(p->pScript);
+        Tcl_IncrRefCount(pEval);
+        Tcl_ListObjAppendElement(0, pEval, p->apArgs[isFragment]);
+        Tcl_DecrRefCount(p->apArgs[isFragment]);
+        p->apArgs[isFragment] = 0;
+
+        if (isNodeHandler && !isFragment) {
+            assert(pTree->eWriteState == HTML_WRITE_NONE);
+            pTree->eWriteState = HTML_PARSE_NODEHANDLER;
+        }
+        rc = Tcl_EvalObjEx(interp, pEval, TCL_EVAL_DIRECT|TCL_EVAL_GLOBAL);
+        if (rc != TCL_OK && isNodeHandler) {
+            Tcl_BackgroundError(interp);
+        }
+        Tcl_DecrRefCount(pEval);
+
+        if (!isFragment && pTree->eWriteState == HTML_PARSE_NODEHANDLER) {
+            pTree->eWriteState = HTML_WRITE_NONE;
+        }
+        if (pTree->eWriteState == HTML_WRITE_INHANDLERRESET) {
+            break;
+        }
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlHandlerBatchFree --
+ *
+ *     Free a batched handler structure, discarding any pending arguments.
+ *     Pass NULL as the second argument to discard the pending arguments
+ *     of all batched handlers (without freeing them).
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+HtmlHandlerBatchFree (HtmlTree *pTree, HtmlHandlerBatch *pBatch)
+{
+    int i;
+    for (i = 0; i < 2; i++) {
+        HtmlHandlerBatch **pp = &pTree->apBatchPending[i];
+        while (*pp) {
+            HtmlHandlerBatch *p = *pp;
+            if (pBatch && p != pBatch) {
+                pp = &p->apNext[i];
+                continue;
+            }
+            *pp = p->apNext[i];
+            p->apNext[i] = 0;
+            Tcl_DecrRefCount(p->apArgs[i]);
+            p->apArgs[i] = 0;
+        }
+    }
+    if (pBatch) {
+        Tcl_DecrRefCount(pBatch->pScript);
+        HtmlFree(pBatch);
+    }
+}
+
 int 
 HtmlNodeIsOrphan (HtmlNode *pNode)
 {
@@ -605,20 +1088,70 @@ nodeDeorphanize (HtmlTree *pTree, HtmlNode *pNode)
     Tcl_DeleteHashEntry(pEntry);
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlNodeIndexOfChild --
+ *
+ *     Return the index of pChild in the apChildren[] array of pParent,
+ *     using the index cached in HtmlNode.iChild. Generated :before and
+ *     :after nodes are not children of their parent in this sense.
+ *
+ * Results:
+ *     Index of pChild, or -1 if pChild is not a child of pParent.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
 int 
 HtmlNodeIndexOfChild (HtmlNode *pParent, HtmlNode *pChild)
 {
-    int ii;
-    for (ii = 0; ii < HtmlNodeNumChildren(pParent); ii++) {
-        if (HtmlNodeChild(pParent, ii) == pChild) return ii;
+    int ii = pChild->iChild;
+    if (
+        pChild->pParent == pParent && 
+        ii < HtmlNodeNumChildren(pParent) &&
+        HtmlNodeChild(pParent, ii) == pChild
+    ) {
+        return ii;
     }
     return -1;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * nodeGrowChildren --
+ *
+ *     Make sure the HtmlElementNode.apChildren[] array of pElem has room 
+ *     for at least one more entry. The array is doubled in size each 
+ *     time it is extended, so that appending N children requires only
+ *     O(log N) reallocations.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     May reallocate pElem->apChildren.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+nodeGrowChildren (HtmlElementNode *pElem)
+{
+    if (pElem->nChild >= pElem->nChildAlloc) {
+        int nAlloc = MAX(1, pElem->nChildAlloc * 2);
+        pElem->apChildren = (HtmlNode **)HtmlRealloc("HtmlNode.apChildren", 
+            (char *)pElem->apChildren, nAlloc * sizeof(HtmlNode *)
+        );
+        pElem->nChildAlloc = nAlloc;
+    }
+}
+
 static void 
 nodeInsertChild (HtmlTree *pTree, HtmlElementNode *pElem, HtmlNode *pBefore, HtmlNode *pAfter, HtmlNode *pChild)
 {
-    int n;                  /* Number of bytes to alloc for pNode->apChildren */
     int ii;
     int iBefore;
 
@@ -658,16 +1191,15 @@ nodeInsertChild (HtmlTree *pTree, HtmlElementNode *pElem, HtmlNode *pBefore, Htm
 
     /* Extend the size of the HtmlElementNode.apChildren[] array */
     assert(pElem);
+    nodeGrowChildren(pElem);
     pElem->nChild++;
-    n = (pElem->nChild) * sizeof(HtmlNode*);
-    pElem->apChildren = (HtmlNode **)HtmlRealloc(
-        "HtmlNode.apChildren", (char *)pElem->apChildren, n
-    );
 
     for (ii = (pElem->nChild - 1); ii > iBefore; ii--) {
         pElem->apChildren[ii] = pElem->apChildren[ii - 1];
+        pElem->apChildren[ii]->iChild = ii;
     }
     pElem->apChildren[iBefore] = pChild;
+    pChild->iChild = iBefore;
 
     /* Link pChild into the new parent node */
     pChild->pParent = (HtmlNode *)pElem;
@@ -675,7 +1207,286 @@ nodeInsertChild (HtmlTree *pTree, HtmlElementNode *pElem, HtmlNode *pBefore, Htm
 
 
 /*
- *---------------------------------------------------------------------------
+ * Document order labels.
+ *
+ * The HtmlNode.iNode value of each node in the document tree (not an
+ * orphan or generated node) is a non-negative label. If node A comes 
+ * before node B in document order (a pre-order traversal of the tree),
+ * then A's label is less than B's. Labels are not dense - the parser
+ * allocates them ORDER_GAP apart so that nodes inserted later by
+ * [$node insert] can usually be labelled without changing any other 
+ * node's label. See nodeOrderLink() for details.
+ */
+#define ORDER_GAP 64
+
+/* Return the last node in document order in the sub-tree rooted at p. */
+static HtmlNode *
+orderLastDescendant (HtmlNode *p)
+{
+    int n;
+    while ((n = HtmlNodeNumChildren(p)) > 0) {
+        p = HtmlNodeChild(p, n - 1);
+    }
+    return p;
+}
+
+/* Return the number of nodes in the sub-tree rooted at p. */
+static int
+orderCount (HtmlNode *p)
+{
+    int n = 1;
+    int ii;
+    for (ii = 0; ii < HtmlNodeNumChildren(p); ii++) {
+        n += orderCount(HtmlNodeChild(p, ii));
+    }
+    return n;
+}
+
+/* Label the nodes in the sub-tree rooted at p in document order. Each
+ * node is labelled iStep more than the previous one, starting with 
+ * (*piLabel + iStep). Before returning, *piLabel is set to the last
+ * label assigned.
+ */
+static void
+orderAssign (HtmlNode *p, int *piLabel, int iStep)
+{
+    int ii;
+    *piLabel += iStep;
+    p->iNode = *piLabel;
+    for (ii = 0; ii < HtmlNodeNumChildren(p); ii++) {
+        orderAssign(HtmlNodeChild(p, ii), piLabel, iStep);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * nodeOrderLink --
+ *
+ *     This function is called after the sub-tree rooted at pNode has been
+ *     linked into the document tree, either by the parser or by a 
+ *     [$node insert] command. It assigns a document order label (see
+ *     above) to each node in the sub-tree. If pNode is part of an orphan
+ *     tree this is a no-op - the nodes are labelled if and when the 
+ *     orphan tree is inserted into the document.
+ *
+ *     The sub-tree is labelled using the labels between those of the 
+ *     nodes that precede and follow it in document order. If there are
+ *     not enough free labels, a "window" of adjacent nodes is relabelled
+ *     along with it. The window starts as the sub-tree alone and grows 
+ *     by doubling the run of siblings it contains in each direction,
+ *     then by moving up to the parent node once all siblings are 
+ *     included. The nodes in the window are spread evenly across the 
+ *     labels available to it. A window is used once they can be spread
+ *     at least (nRound + 2) apart, where nRound is the number of times 
+ *     the window has been expanded (or at least 1 apart if nRound is 0).
+ *     Requiring larger windows to be sparser means that relabelling a 
+ *     large window leaves free labels in each smaller window within it,
+ *     so that the cost of relabelling is amortized over many inserts.
+ *     A window that extends to the end of the document may always be
+ *     relabelled ORDER_GAP apart.
+ *
+ *     In the common case of a node appended to the end of the document
+ *     (i.e. by the parser) the window is just the new node and this is
+ *     O(depth of the tree).
+ *
+ *     If labels would overflow, the entire tree is relabelled.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     Sets HtmlNode.iNode for pNode, its descendants and possibly other
+ *     nodes of the document tree.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+nodeOrderLink (HtmlTree *pTree, HtmlNode *pNode)
+{
+    HtmlNode *pParent = HtmlNodeParent(pNode);
+    HtmlNode *p;
+    int iFirst;                  /* Window is children iFirst..iLast ... */
+    int iLast;                   /* ... of pParent (and their sub-trees) */
+    int nNode;                   /* Number of nodes in window */
+    int nRound = 0;              /* Number of times window has grown */
+
+    /* Do nothing if pNode is not part of the document tree */
+    for (p = pNode; HtmlNodeParent(p); p = HtmlNodeParent(p));
+    if (p != pTree->pRoot || !pParent) return;
+
+    iFirst = iLast = HtmlNodeIndexOfChild(pParent, pNode);
+    nNode = orderCount(pNode);
+
+    while (1) {
+        int nChild = HtmlNodeNumChildren(pParent);
+        int iLo;                 /* Label of node preceding window */
+        int iHi = 0;             /* Label of node following window */
+        int isHi = 0;            /* True if iHi is valid */
+        int iLabel;
+        int iStep;
+        int ii;
+
+        if (iFirst > 0) {
+            iLo = orderLastDescendant(HtmlNodeChild(pParent, iFirst-1))->iNode;
+        } else {
+            iLo = pParent->iNode;
+        }
+
+        if (iLast < nChild - 1) {
+            iHi = HtmlNodeChild(pParent, iLast + 1)->iNode;
+            isHi = 1;
+        } else {
+            for (p = pParent; HtmlNodeParent(p); p = HtmlNodeParent(p)) {
+                HtmlNode *pUp = HtmlNodeParent(p);
+                int iNext = HtmlNodeIndexOfChild(pUp, p) + 1;
+                if (iNext < HtmlNodeNumChildren(pUp)) {
+                    iHi = HtmlNodeChild(pUp, iNext)->iNode;
+                    isHi = 1;
+                    break;
+                }
+            }
+        }
+
+        if (!isHi) {
+            /* The window extends to the end of the document. */
+            iStep = ORDER_GAP;
+            if ((double)iLo + (double)iStep * (nNode + 1) >= (double)INT_MAX) {
+                int nTotal = orderCount(pTree->pRoot);
+                iStep = MIN(ORDER_GAP, (INT_MAX - 1) / (nTotal + 1));
+                iLabel = -1 * iStep;
+                orderAssign(pTree->pRoot, &iLabel, iStep);
+                return;
+            }
+        } else {
+            iStep = (iHi - iLo) / (nNode + 1);
+            if (iStep < (nRound ? nRound + 2 : 1)) {
+                iStep = 0;
+            }
+        }
+
+        if (iStep > 0) {
+            iLabel = iLo;
+            for (ii = iFirst; ii <= iLast; ii++) {
+                orderAssign(HtmlNodeChild(pParent, ii), &iLabel, iStep);
+            }
+            return;
+        }
+
+        /* Grow the window and try again. If the window already contains
+         * all children of pParent, replace it with pParent itself.
+         */
+        nRound++;
+        if (iFirst == 0 && iLast == nChild - 1) {
+            HtmlNode *pUp = HtmlNodeParent(pParent);
+            assert(pUp);
+            iFirst = iLast = HtmlNodeIndexOfChild(pUp, pParent);
+            nNode++;
+            pParent = pUp;
+        } else {
+            int nRun = iLast - iFirst + 1;
+            int iNewFirst = MAX(0, iFirst - nRun);
+            int iNewLast = MIN(nChild - 1, iLast + nRun);
+            for (ii = iNewFirst; ii < iFirst; ii++) {
+                nNode += orderCount(HtmlNodeChild(pParent, ii));
+            }
+            for (ii = iLast + 1; ii <= iNewLast; ii++) {
+                nNode += orderCount(HtmlNodeChild(pParent, ii));
+            }
+            iFirst = iNewFirst;
+            iLast = iNewLast;
+        }
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * nodeSetAttributes --
+ *
+ *     Set the attributes of element node pElem to pAttr and refresh the
+ *     cached "id" and "class" values stored in HtmlElementNode.zId and
+ *     HtmlElementNode.azClass. Any previous class array is freed, but
+ *     not the previous attributes structure.
+ *
+ *     The class attribute is split into a single allocation (taken from
+ *     pArena, or the heap if pArena is NULL) containing the array of
+ *     pointers followed by a nul-terminated copy of each class name.
+ *     This way the style engine need not parse the attribute each time
+ *     the node is restyled.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     May allocate memory.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+nodeSetAttributes (
+    HtmlTree *pTree,
+    HtmlArena *pArena,
+    HtmlElementNode *pElem,
+    HtmlAttributes *pAttr
+)
+{
+    const char *zClass = 0;
+    int ii;
+
+    HtmlArenaFree(&pTree->arena, (void *)pElem->azClass);
+    pElem->pAttributes = pAttr;
+    pElem->zId = 0;
+    pElem->nClass = 0;
+    pElem->azClass = 0;
+
+    for (ii = 0; pAttr && ii < pAttr->nAttr; ii++) {
+        const char *zName = pAttr->a[ii].zName;
+        if (zName == pTree->zAtomId && !pElem->zId) {
+            pElem->zId = pAttr->a[ii].zValue;
+        } else if (zName == pTree->zAtomClass && !zClass) {
+            zClass = pAttr->a[ii].zValue;
+        }
+    }
+
+    if (zClass) {
+        const char *zCsr;
+        int nClass = 0;
+        int nByte = strlen(zClass);
+        int n;
+
+        for (zCsr = zClass;
+             (zCsr = HtmlCssGetNextListItem(zCsr, strlen(zCsr), &n));
+             zCsr += n
+        ) {
+            nClass++;
+        }
+
+        if (nClass > 0) {
+            char *zBuf;
+            const char **azClass = (const char **)HtmlArenaAlloc(pArena,
+                "HtmlElementNode.azClass", 
+                nClass * sizeof(char *) + nByte + nClass
+            );
+            zBuf = (char *)&azClass[nClass];
+            nClass = 0;
+            for (zCsr = zClass;
+                 (zCsr = HtmlCssGetNextListItem(zCsr, strlen(zCsr), &n));
+                 zCsr += n
+            ) {
+                memcpy(zBuf, zCsr, n);
+                zBuf[n] = '\0';
+                azClass[nClass++] = zBuf;
+                zBuf += (n + 1);
+            }
+            pElem->nClass = nClass;
+            pElem->azClass = azClass;
+        }
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
  *
  * HtmlNodeAddChild --
  *
@@ -697,34 +1508,32 @@ nodeInsertChild (HtmlTree *pTree, HtmlElementNode *pElem, HtmlNode *pBefore, Htm
  */
 int 
 HtmlNodeAddChild (
+    HtmlTree *pTree,
     HtmlElementNode *pElem,
     int eTag,
     const char *zTag,               /* Atom for tag name */
     HtmlAttributes *pAttributes
 )
 {
-    int n;                  /* Number of bytes to alloc for pNode->apChildren */
     int r;                  /* Return value */
     HtmlElementNode *pNew;  /* New child node */
 
     assert(pElem);
     
+    nodeGrowChildren(pElem);
     r = pElem->nChild++;
-    n = (r+1) * sizeof(HtmlNode*);
-    pElem->apChildren = (HtmlNode **)HtmlRealloc(
-        "HtmlNode.apChildren", (char *)pElem->apChildren, n
-    );
 
     if (!zTag) {
         zTag = HtmlTypeToName(0, eTag);
     }
     assert(zTag);
 
-    pNew = HtmlNew(HtmlElementNode);
-    pNew->pAttributes = pAttributes;
+    pNew = HtmlArenaNew(&pTree->arena, HtmlElementNode);
+    nodeSetAttributes(pTree, &pTree->arena, pNew, pAttributes);
     pNew->node.pParent = (HtmlNode *)pElem;
     pNew->node.eTag = eTag;
     pNew->node.zTag = zTag;
+    pNew->node.iChild = r;
     pElem->apChildren[r] = (HtmlNode *)pNew;
 
     assert(r < pElem->nChild);
@@ -734,7 +1543,6 @@ HtmlNodeAddChild (
 int 
 HtmlNodeAddTextChild (HtmlNode *pNode, HtmlTextNode *pTextNode)
 {
-    int n;             /* Number of bytes to alloc for pNode->apChildren */
     int r;             /* Return value */
     HtmlNode *pNew;    /* New child node */
 
@@ -743,16 +1551,14 @@ HtmlNodeAddTextChild (HtmlNode *pNode, HtmlTextNode *pTextNode)
     assert(pElem);
     assert(pTextNode);
     
+    nodeGrowChildren(pElem);
     r = pElem->nChild++;
-    n = (r+1) * sizeof(HtmlNode*);
-    pElem->apChildren = (HtmlNode **)HtmlRealloc(
-        "HtmlNode.apChildren", (char *)pElem->apChildren, n
-    );
 
     pNew = (HtmlNode *)pTextNode;
     memset(pNew, 0, sizeof(HtmlNode));
     pNew->pParent = pNode;
     pNew->eTag = Html_Text;
+    pNew->iChild = r;
     pElem->apChildren[r] = pNew;
 
     assert(r < pElem->nChild);
@@ -777,7 +1583,12 @@ HtmlNodeAddTextChild (HtmlNode *pNode, HtmlTextNode *pTextNode)
  *---------------------------------------------------------------------------
  */
 static void 
-setNodeAttribute (HtmlNode *pNode, const char *zAttrName, const char *zAttrVal)
+setNodeAttribute (
+    HtmlTree *pTree,
+    HtmlNode *pNode, 
+    const char *zAttrName, 
+    const char *zAttrVal
+)
 {
     #define MAX_NUM_ATTRIBUTES 100
     char const *azPtr[MAX_NUM_ATTRIBUTES * 2];
@@ -795,7 +1606,7 @@ setNodeAttribute (HtmlNode *pNode, const char *zAttrName, const char *zAttrVal)
 
     for (i = 0; pAttr && i < pAttr->nAttr && i < MAX_NUM_ATTRIBUTES; i++) {
         azPtr[i*2] = pAttr->a[i].zName;
-        if (0 != strcmp(pAttr->a[i].zName, zAttrName)) {
+        if (0 != stricmp(pAttr->a[i].zName, zAttrName)) {
             azPtr[i*2+1] = pAttr->a[i].zValue;
         } else {
             azPtr[i*2+1] = zAttrVal;
@@ -814,26 +1625,29 @@ setNodeAttribute (HtmlNode *pNode, const char *zAttrName, const char *zAttrVal)
         aLen[i] = strlen(azPtr[i]);
     }
 
-    pElem->pAttributes = HtmlAttributesNew(nArgs, azPtr, aLen, 0);
-    HtmlFree(pAttr);
+    nodeSetAttributes(pTree, 0, pElem, 
+        HtmlAttributesNew(pTree, 0, nArgs, azPtr, aLen, 0)
+    );
+    HtmlArenaFree(&pTree->arena, pAttr);
 
     /* If this was a call to set the "style" attribute, discard the
      * compiled version at version HtmlElementNode.pStyle.
      */
-    if (strcmp(HTML_INLINE_STYLE_ATTR, zAttrName) == 0) {
+    if (stricmp(HTML_INLINE_STYLE_ATTR, zAttrName) == 0) {
         HtmlCssInlineFree(pElem->pStyle);
         pElem->pStyle = 0;
     }
 }
 
 static void 
-mergeAttributes (HtmlNode *pNode, HtmlAttributes *pAttr)
+mergeAttributes (HtmlTree *pTree, HtmlNode *pNode, HtmlAttributes *pAttr)
 {
     int ii;
     for (ii = 0; pAttr && ii < pAttr->nAttr; ii++) {
-        setNodeAttribute(pNode, pAttr->a[ii].zName, pAttr->a[ii].zValue);
+        const char *zName = pAttr->a[ii].zName;
+        setNodeAttribute(pTree, pNode, zName, pAttr->a[ii].zValue);
     }
-    HtmlFree(pAttr);
+    HtmlArenaFree(&pTree->arena, pAttr);
 }
 
 static int 
@@ -884,11 +1698,22 @@ doParseHandler (HtmlTree *pTree, int eType, HtmlNode *pNode, int iOffset)
             Tcl_ListObjAppendElement(0, pScript, Tcl_NewStringObj("", -1));
         }
         Tcl_ListObjAppendElement(
-            0, pScript, Tcl_NewIntObj(iOffset + pTree->nParsed)
+            0, pScript, Tcl_NewIntObj(HtmlDocumentCharOffset(pTree, iOffset))
         );
 
         rc = Tcl_EvalObjEx(pTree->interp, pScript, TCL_EVAL_GLOBAL);
         Tcl_DecrRefCount(pScript);
+    } else {
+        pEntry = Tcl_FindHashEntry(&pTree->aParseBatch, (char *)((size_t)eType));
+        if (pEntry) {
+            HtmlHandlerBatch *p = (HtmlHandlerBatch *)Tcl_GetHashValue(pEntry);
+            batchAppend(pTree, p, 
+                pNode ? HtmlNodeCommand(pTree, pNode) : Tcl_NewObj()
+            );
+            batchAppend(pTree, p, 
+                Tcl_NewIntObj(HtmlDocumentCharOffset(pTree, iOffset))
+            );
+        }
     }
 
     return rc;
@@ -934,14 +1759,20 @@ HtmlInitTree (HtmlTree *pTree)
          */
         HtmlElementNode *pRoot;
 
-        pRoot = HtmlNew(HtmlElementNode);
+        pRoot = HtmlArenaNew(&pTree->arena, HtmlElementNode);
         pRoot->node.eTag = Html_HTML;
         pRoot->node.zTag = HtmlTypeToName(pTree, Html_HTML);
         pTree->pRoot = (HtmlNode *)pRoot;
+        pRoot->node.iNode = 0;
 
-
-        HtmlNodeAddChild(pRoot, Html_HEAD, HtmlTypeToName(pTree, Html_HEAD), 0);
-        HtmlNodeAddChild(pRoot, Html_BODY, HtmlTypeToName(pTree, Html_BODY), 0);
+        HtmlNodeAddChild(pTree, pRoot, 
+            Html_HEAD, HtmlTypeToName(pTree, Html_HEAD), 0
+        );
+        nodeOrderLink(pTree, HtmlNodeChild(pTree->pRoot, 0));
+        HtmlNodeAddChild(pTree, pRoot, 
+            Html_BODY, HtmlTypeToName(pTree, Html_BODY), 0
+        );
+        nodeOrderLink(pTree, HtmlNodeChild(pTree->pRoot, 1));
         HtmlCallbackRestyle(pTree, (HtmlNode *)pRoot);
     }
 
@@ -1039,11 +1870,13 @@ treeAddFosterElement (
     }
 
     if (pFoster) {
-        int n = HtmlNodeAddChild((HtmlElementNode *)pFoster, eTag, zTag, pAttr);
+        HtmlElementNode *pF = (HtmlElementNode *)pFoster;
+        int n = HtmlNodeAddChild(pTree, pF, eTag, zTag, pAttr);
         pNew = HtmlNodeChild(pFoster, n);
     } else {
-        pNew = (HtmlNode *)HtmlNew(HtmlElementNode);
-        ((HtmlElementNode *)pNew)->pAttributes = pAttr;
+        pNew = (HtmlNode *)HtmlArenaNew(&pTree->arena, HtmlElementNode);
+        HtmlElementNode *pE = (HtmlElementNode *)pNew;
+        nodeSetAttributes(pTree, &pTree->arena, pE, pAttr);
         pNew->eTag = eTag;
         if (!zTag) {
             zTag = HtmlTypeToName(0, eTag);
@@ -1052,7 +1885,7 @@ treeAddFosterElement (
         nodeInsertChild(pTree, (HtmlElementNode *)pFosterParent,pBefore,0,pNew);
     }
 
-    pNew->iNode = pTree->iNextNode++;
+    nodeOrderLink(pTree, pNew);
     if (HtmlMarkupFlags(eTag) & HTMLTAG_EMPTY) {
         nodeHandlerCallbacks(pTree, pNew);
         pTree->state.pFoster = HtmlNodeParent(pNew);
@@ -1113,7 +1946,7 @@ treeAddTableComponent (HtmlTree *pTree, int eTag, HtmlAttributes *pAttr)
         ) break;
     }
     if (!pParent) {
-        HtmlFree(pAttr);
+        HtmlArenaFree(&pTree->arena, pAttr);
         return pParent;
     }
     eParentTag = HtmlNodeTagType(pParent);
@@ -1135,24 +1968,26 @@ treeAddTableComponent (HtmlTree *pTree, int eTag, HtmlAttributes *pAttr)
         eParentTag == Html_TABLE && 
         (eTag == Html_TR || eTag == Html_TD || eTag == Html_TH)
     ) {
-        int n2 = HtmlNodeAddChild((HtmlElementNode *)pParent, Html_TBODY, 0, 0);
+        HtmlElementNode *pP = (HtmlElementNode *)pParent;
+        int n2 = HtmlNodeAddChild(pTree, pP, Html_TBODY, 0, 0);
         pParent = HtmlNodeChild(pParent, n2);
-        pParent->iNode = pTree->iNextNode++;
+        nodeOrderLink(pTree, pParent);
         eParentTag = Html_TBODY;
     }
 
     /* See if we need to add an implicit <TR> node */
     if (eParentTag != Html_TR && (eTag == Html_TD || eTag == Html_TH)) {
-        int n2 = HtmlNodeAddChild((HtmlElementNode *)pParent, Html_TR, 0, 0);
+        HtmlElementNode *pP = (HtmlElementNode *)pParent;
+        int n2 = HtmlNodeAddChild(pTree, pP, Html_TR, 0, 0);
         pParent = HtmlNodeChild(pParent, n2);
-        pParent->iNode = pTree->iNextNode++;
+        nodeOrderLink(pTree, pParent);
         eParentTag = Html_TR;
     }
     
     /* Add the new node to pParent */
-    n = HtmlNodeAddChild((HtmlElementNode *)pParent, eTag, 0, pAttr);
+    n = HtmlNodeAddChild(pTree, (HtmlElementNode *)pParent, eTag, 0, pAttr);
     pNew = HtmlNodeChild(pParent, n);
-    pNew->iNode = pTree->iNextNode++;
+    nodeOrderLink(pTree, pNew);
     pTree->state.pCurrent = pNew;
 
     /* Return a pointer to the node just added */
@@ -1219,17 +2054,17 @@ HtmlTreeAddElement (HtmlTree *pTree, int eType, const char *zType, HtmlAttribute
     switch (eType) {
         case Html_HTML:
             pParsed = pTree->pRoot;
-            mergeAttributes(pParsed, pAttr);
+            mergeAttributes(pTree, pParsed, pAttr);
             HtmlCallbackRestyle(pTree, pParsed);
             break;
         case Html_HEAD:
             pParsed = pHeadNode;
-            mergeAttributes(pParsed, pAttr);
+            mergeAttributes(pTree, pParsed, pAttr);
             HtmlCallbackRestyle(pTree, pParsed);
             break;
         case Html_BODY:
             pParsed = pBodyNode;
-            mergeAttributes(pParsed, pAttr);
+            mergeAttributes(pTree, pParsed, pAttr);
             HtmlCallbackRestyle(pTree, pParsed);
             break;
 
@@ -1242,10 +2077,10 @@ HtmlTreeAddElement (HtmlTree *pTree, int eType, const char *zType, HtmlAttribute
          * section.
          */
         case Html_TITLE: {
-            int n = HtmlNodeAddChild(pHeadElem, eType, 0, pAttr);
+            int n = HtmlNodeAddChild(pTree, pHeadElem, eType, 0, pAttr);
             HtmlNode *p = HtmlNodeChild(pHeadNode, n);
             pTree->state.isCdataInHead = 1;
-            p->iNode = pTree->iNextNode++;
+            nodeOrderLink(pTree, p);
             pParsed = p;
             HtmlCallbackRestyle(pTree, pParsed);
             break;
@@ -1255,9 +2090,9 @@ HtmlTreeAddElement (HtmlTree *pTree, int eType, const char *zType, HtmlAttribute
         case Html_META:
         case Html_LINK:
         case Html_BASE: {
-            int n = HtmlNodeAddChild(pHeadElem, eType, 0, pAttr);
+            int n = HtmlNodeAddChild(pTree, pHeadElem, eType, 0, pAttr);
             HtmlNode *p = HtmlNodeChild(pHeadNode, n);
-            p->iNode = pTree->iNextNode++;
+            nodeOrderLink(pTree, p);
             nodeHandlerCallbacks(pTree, p);
             if (pTree->eWriteState != HTML_WRITE_INHANDLERRESET) {
                 pParsed = p;
@@ -1305,9 +2140,9 @@ HtmlTreeAddElement (HtmlTree *pTree, int eType, const char *zType, HtmlAttribute
 
                 pC = HtmlNodeAsElement(pCurrent);
                 assert(!HtmlNodeIsText(pTree->state.pCurrent));
-                N = HtmlNodeAddChild(pC, eType, zType, pAttr);
+                N = HtmlNodeAddChild(pTree, pC, eType, zType, pAttr);
                 pCurrent = HtmlNodeChild(pCurrent, N);
-                pCurrent->iNode = pTree->iNextNode++;
+                nodeOrderLink(pTree, pCurrent);
                 pParsed = pCurrent;
 
                 assert(!isTableType || eType == Html_FORM);
@@ -1359,7 +2194,7 @@ HtmlTreeAddText (HtmlTree *pTree, HtmlTextNode *pTextNode, int iOffset)
         HtmlNode *pTitle = HtmlNodeChild(pHeadNode, nChild);
 
         HtmlNodeAddTextChild(pTitle, pTextNode);
-        pTextNode->node.iNode = pTree->iNextNode++;
+        nodeOrderLink(pTree, &pTextNode->node);
         pTree->state.isCdataInHead = 0;
         nodeHandlerCallbacks(pTree, pTitle);
     } else if (
@@ -1368,11 +2203,11 @@ HtmlTreeAddText (HtmlTree *pTree, HtmlTextNode *pTextNode, int iOffset)
         eCurrentType == Html_TR
     ) {
         treeAddFosterText(pTree, pTextNode);
-        pTextNode->node.iNode = pTree->iNextNode++;
+        nodeOrderLink(pTree, &pTextNode->node);
         pTextNode->node.eTag = Html_Text;
     } else {
         HtmlNodeAddTextChild(pCurrent, pTextNode);
-        pTextNode->node.iNode = pTree->iNextNode++;
+        nodeOrderLink(pTree, &pTextNode->node);
     }
 
     assert(pTextNode->node.eTag == Html_Text);
@@ -1564,7 +2399,7 @@ HtmlNode *
 HtmlNodeBefore (HtmlNode *pNode)
 {
     if (!HtmlNodeIsText(pNode)) {
-        return ((HtmlElementNode *)pNode)->pBefore;
+        return HtmlElemRare((HtmlElementNode *)pNode, pBefore);
     }
     return 0;
 }
@@ -1601,7 +2436,7 @@ HtmlNode *
 HtmlNodeAfter (HtmlNode *pNode)
 {
     if (!HtmlNodeIsText(pNode)) {
-        return ((HtmlElementNode *)pNode)->pAfter;
+        return HtmlElemRare((HtmlElementNode *)pNode, pAfter);
     }
     return 0;
 }
@@ -1669,15 +2504,12 @@ CONST char * HtmlNodeTagName(HtmlNode *pNode)
 HtmlNode *
 HtmlNodeRightSibling (HtmlNode *pNode)
 {
-    HtmlElementNode *pParent = (HtmlElementNode *)pNode->pParent;
+    HtmlNode *pParent = pNode->pParent;
     if( pParent ){
-        int i;
-        for (i=0; i < pParent->nChild - 1; i++) {
-            if (pNode == pParent->apChildren[i]) {
-                return pParent->apChildren[i+1];
-            }
+        int i = HtmlNodeIndexOfChild(pParent, pNode);
+        if (i >= 0 && i + 1 < HtmlNodeNumChildren(pParent)) {
+            return HtmlNodeChild(pParent, i + 1);
         }
-        assert(pNode == pParent->apChildren[pParent->nChild - 1]);
     }
     return 0;
 }
@@ -1700,15 +2532,12 @@ HtmlNodeRightSibling (HtmlNode *pNode)
 HtmlNode *
 HtmlNodeLeftSibling (HtmlNode *pNode)
 {
-    HtmlElementNode *pParent = (HtmlElementNode *)pNode->pParent;
+    HtmlNode *pParent = pNode->pParent;
     if( pParent ){
-        int i;
-        for (i = 1; i < pParent->nChild; i++) {
-            if (pNode == pParent->apChildren[i]) {
-                return pParent->apChildren[i-1];
-            }
+        int i = HtmlNodeIndexOfChild(pParent, pNode);
+        if (i > 0) {
+            return HtmlNodeChild(pParent, i - 1);
         }
-        assert(pNode == pParent->apChildren[0]);
     }
     return 0;
 }
@@ -1740,6 +2569,62 @@ char CONST *HtmlNodeAttr(
     return 0;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlTreeAtom --
+ *
+ *     Return the atom for string zString, adding it to the HtmlTree.aAtom
+ *     table if it is not already present. Atoms are compared without
+ *     regard to case, so "ID" and "id" map to the same atom. Pointers to
+ *     atoms remain valid until the document is cleared (see 
+ *     HtmlTreeClear()) or the widget is destroyed.
+ *
+ * Results:
+ *     Pointer to the nul-terminated atom string.
+ *
+ * Side effects:
+ *     May add an entry to the atom table.
+ *
+ *---------------------------------------------------------------------------
+ */
+const char *
+HtmlTreeAtom (HtmlTree *pTree, const char *zString)
+{
+    int isNew;
+    Tcl_HashEntry *pEntry;
+    pEntry = Tcl_CreateHashEntry(&pTree->aAtom, zString, &isNew);
+    return (const char *)Tcl_GetHashKey(&pTree->aAtom, pEntry);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlTreeAtomFind --
+ *
+ *     Return the atom for string zString if it is already present in the
+ *     HtmlTree.aAtom table. Unlike HtmlTreeAtom(), a new atom is never
+ *     created.
+ *
+ * Results:
+ *     Pointer to the nul-terminated atom string, or NULL.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+const char *
+HtmlTreeAtomFind (HtmlTree *pTree, const char *zString)
+{
+    Tcl_HashEntry *pEntry;
+    pEntry = Tcl_FindHashEntry(&pTree->aAtom, zString);
+    if (!pEntry) {
+        return 0;
+    }
+    return (const char *)Tcl_GetHashKey(&pTree->aAtom, pEntry);
+}
+
 static int 
 markWindowAsClipped(
     HtmlTree *pTree,
@@ -1747,7 +2632,7 @@ markWindowAsClipped(
     ClientData clientData)
 {
     if (!HtmlNodeIsText(pNode)) {
-        HtmlNodeReplacement *p = ((HtmlElementNode *)pNode)->pReplacement;
+        HtmlNodeReplacement *p = HtmlElemRare((HtmlElementNode *)pNode, pReplacement);
         if (p) {
             p->clipped = 1;
         }
@@ -1798,21 +2683,23 @@ nodeViewCmd(
     int x, y, w, h;
 
     HtmlElementNode *pElem = (HtmlElementNode *)pNode;
+    HtmlNodeScrollbars *pScroll;
 
-    if (HtmlNodeIsText(pNode) || !pElem->pScrollbar) {
+    if (HtmlNodeIsText(pNode) || !HtmlElemRare(pElem, pScrollbar)) {
         return TCL_ERROR;
     }
+    pScroll = pElem->pRare->pScrollbar;
 
     pTree = pNode->pNodeCmd->pTree;
     if (isVertical) {
-        iNew = pElem->pScrollbar->iVertical;
-        iMax = pElem->pScrollbar->iVerticalMax;
-        iSize = pElem->pScrollbar->iHeight;
+        iNew = pScroll->iVertical;
+        iMax = pScroll->iVerticalMax;
+        iSize = pScroll->iHeight;
         iIncr = pTree->options.yscrollincrement;
     } else {
-        iNew = pElem->pScrollbar->iHorizontal;
-        iMax = pElem->pScrollbar->iHorizontalMax;
-        iSize = pElem->pScrollbar->iWidth;
+        iNew = pScroll->iHorizontal;
+        iMax = pScroll->iHorizontalMax;
+        iSize = pScroll->iWidth;
         iIncr = pTree->options.xscrollincrement;
     }
 
@@ -1837,9 +2724,9 @@ nodeViewCmd(
     iNew = MAX(0, iNew);
     iNew = MIN(iNew, iMax - iSize);
     if (isVertical) {
-        pElem->pScrollbar->iVertical = iNew;
+        pScroll->iVertical = iNew;
     } else {
-        pElem->pScrollbar->iHorizontal = iNew;
+        pScroll->iHorizontal = iNew;
     }
 
     /* Invoke the scrollbar callbacks (i.e. [$scrollbar set]) to update
@@ -2037,11 +2924,11 @@ nodeInsertCmd(
                     nodeDeorphanize(pTree, pChild);
                 }
                 nodeInsertChild(pTree, pElem, pBefore, pAfter, pChild);
+                nodeOrderLink(pTree, pChild);
             }
         }
     }
 
-    pTree->isSequenceOk = 0;
     HtmlCheckRestylePoint(pTree);
 
     return TCL_OK;
@@ -2058,6 +2945,40 @@ nodeGetStyle (HtmlTree *pTree, HtmlNode *p)
     return pElem->pStyle;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * nodeTextLength --
+ *
+ *     Return the number of bytes of pTextNode->zText that make up the
+ *     value returned by [$node text]. Trailing white-space is excluded.
+ *
+ * Results:
+ *     Number of bytes.
+ *
+ * Side effects:
+ *     None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+nodeTextLength (HtmlTextNode *pTextNode)
+{
+    HtmlTextIter sIter;
+    int nByte = 0;
+    for (
+        HtmlTextIterFirst(pTextNode, &sIter);
+        HtmlTextIterIsValid(&sIter);
+        HtmlTextIterNext(&sIter)
+    ) {
+        if (HtmlTextIterType(&sIter) == HTML_TEXT_TOKEN_TEXT) {
+            nByte = (HtmlTextIterData(&sIter) - pTextNode->zText);
+            nByte += HtmlTextIterLength(&sIter);
+        }
+    }
+    return nByte;
+}
+
 /*
  */
 /*
@@ -2087,7 +3008,6 @@ nodeTextCommand(
 {
     HtmlTree *pTree = pNode->pNodeCmd->pTree;
     Tcl_Obj *pRet = 0;
-    int nByte = 0;
 
     enum NODE_TEXT_enum {
         NODE_TEXT_GET,
@@ -2153,11 +3073,16 @@ nodeTextCommand(
 
         /* Set the node to contain the new text */
         zNew = Tcl_GetStringFromObj(objv[3], &nNew);
-        HtmlTextSet(pOrig, nNew, zNew, 0, 0);
+        HtmlArenaFree(&pTree->arena, pOrig->aToken);
+        pOrig->aToken = 0;
+        HtmlTextSet(0, pOrig, nNew, zNew, 0, 0);
 
     } else if (eChoice == NODE_TEXT_PRE) {
         pRet = nodeGetPreText(HtmlNodeAsText(pNode));
         Tcl_IncrRefCount(pRet);
+    } else if (eChoice == NODE_TEXT_GET) {
+        pRet = Tcl_NewStringObj(pTextNode->zText, nodeTextLength(pTextNode));
+        Tcl_IncrRefCount(pRet);
     } else {
         HtmlTextIter sIter;
 
@@ -2173,45 +3098,33 @@ nodeTextCommand(
             int nData = HtmlTextIterLength(&sIter);
             char const * zData = HtmlTextIterData(&sIter);
     
-            if (eChoice == NODE_TEXT_TOKENS) {
-                char *zType = 0;
-                Tcl_Obj *p = Tcl_NewObj();
-                Tcl_Obj *pObj = 0;
-    
-                switch (eType) {
-                    case HTML_TEXT_TOKEN_TEXT:
-                        zType = "text";
-                        pObj = Tcl_NewStringObj(zData, nData);
-                        break;
-                    case HTML_TEXT_TOKEN_SPACE:
-                        zType = "space";
-                        pObj = Tcl_NewIntObj(nData);
-                        break;
-                    case HTML_TEXT_TOKEN_NEWLINE:
-                        zType = "newline";
-                        pObj = Tcl_NewIntObj(nData);
-                        break;
-                }
-                assert(zType);
-                Tcl_ListObjAppendElement(
-                    0, p, Tcl_NewStringObj(zType, -1)
-                );
-                Tcl_ListObjAppendElement(0, p, pObj);
-                Tcl_ListObjAppendElement(0, pRet, p);
-            } else {
-                assert(eChoice == NODE_TEXT_GET);
-                if (eType == HTML_TEXT_TOKEN_TEXT) {
-                    nByte = (HtmlTextIterData(&sIter) - pTextNode->zText);
-                    nByte += HtmlTextIterLength(&sIter);
-                }
+            char *zType = 0;
+            Tcl_Obj *p = Tcl_NewObj();
+            Tcl_Obj *pObj = 0;
+
+            switch (eType) {
+                case HTML_TEXT_TOKEN_TEXT:
+                    zType = "text";
+                    pObj = Tcl_NewStringObj(zData, nData);
+                    break;
+                case HTML_TEXT_TOKEN_SPACE:
+                    zType = "space";
+                    pObj = Tcl_NewIntObj(nData);
+                    break;
+                case HTML_TEXT_TOKEN_NEWLINE:
+                    zType = "newline";
+                    pObj = Tcl_NewIntObj(nData);
+                    break;
             }
+            assert(zType);
+            Tcl_ListObjAppendElement(
+                0, p, Tcl_NewStringObj(zType, -1)
+            );
+            Tcl_ListObjAppendElement(0, p, pObj);
+            Tcl_ListObjAppendElement(0, pRet, p);
         }
     }
 
-    if (eChoice == NODE_TEXT_GET) {
-        Tcl_SetStringObj(pRet, pTextNode->zText, nByte);
-    }
-
     if( pRet ){
         Tcl_SetObjResult(interp, pRet);
         Tcl_DecrRefCount(pRet);
@@ -2361,8 +3274,25 @@ nodeCommand(
                 if (rc != TCL_OK) {
                     return rc;
                 }
-                setNodeAttribute(pNode, zAttrName, zAttrVal);
-                HtmlCallbackRestyle(pTree, pNode);
+                setNodeAttribute(pTree, pNode, zAttrName, zAttrVal);
+
+                /* Only restyle if the attribute is one the stylesheet
+                 * refers to. Otherwise the only attributes read from
+                 * the markup by the layout engine are "colspan" and 
+                 * "rowspan" (see htmltable.c), so relayout for those
+                 * alone. The [search] cache is invalidated regardless,
+                 * as a search selector may test any attribute.
+                 */
+                if (HtmlCssAttrIsSignificant(pTree, pNode, zAttrName)) {
+                    HtmlCallbackRestyle(pTree, pNode);
+                } else {
+                    if (0 == stricmp(zAttrName, "colspan") ||
+                        0 == stricmp(zAttrName, "rowspan")
+                    ) {
+                        HtmlCallbackLayout(pTree, pNode);
+                    }
+                    HtmlCssSearchInvalidateCache(pTree);
+                }
             }
 
             if (zAttrName) {
@@ -2507,12 +3437,12 @@ node_attr_usage:
                 HtmlElementNode *pElem = HtmlNodeAsElement(pNode);
                 char *zArg0 = Tcl_GetString(aArg[0]);
                 if (0 == strcmp(zArg0, "-before")) {
-                    p = pElem ? pElem->pBefore : 0;
+                    p = pElem ? HtmlElemRare(pElem, pBefore) : 0;
                     aArg = &aArg[1];
                     nArg--;
                 }
                 else if (0 == strcmp(zArg0, "-after")) {
-                    p = pElem ? pElem->pAfter : 0;
+                    p = pElem ? HtmlElemRare(pElem, pAfter) : 0;
                     aArg = &aArg[1];
                     nArg--;
                 }
@@ -2607,7 +3537,9 @@ node_attr_usage:
         	 * pNode->pReplacement to point at the new structure. 
                  */
                 clearReplacement(pTree, pElem);
-                pElem->pReplacement = pReplace;
+                if (pReplace) {
+                    HtmlElemRareGet(pElem)->pReplacement = pReplace;
+                }
 
                 /* Run the layout engine. */
                 HtmlCallbackLayout(pTree, pNode);
@@ -2616,9 +3548,9 @@ node_attr_usage:
             /* The result of this command is the name of the current
              * replacement object (or an empty string).
              */
-            if (pElem->pReplacement) {
-                assert(pElem->pReplacement->pReplace);
-                Tcl_SetObjResult(interp, pElem->pReplacement->pReplace);
+            if (HtmlElemRare(pElem, pReplacement)) {
+                assert(pElem->pRare->pReplacement->pReplace);
+                Tcl_SetObjResult(interp, pElem->pRare->pReplacement->pReplace);
             }
             break;
         }
@@ -2733,16 +3665,17 @@ node_attr_usage:
             }
 
             if (objc == 3) {
-                if (pElem->pOverride) {
-                    Tcl_DecrRefCount(pElem->pOverride);
+                HtmlElementRare *pRare = HtmlElemRareGet(pElem);
+                if (pRare->pOverride) {
+                    Tcl_DecrRefCount(pRare->pOverride);
                 }
-                pElem->pOverride = objv[2];
-                Tcl_IncrRefCount(pElem->pOverride);
+                pRare->pOverride = objv[2];
+                Tcl_IncrRefCount(pRare->pOverride);
             }
 
             Tcl_ResetResult(interp);
-            if (pElem->pOverride) {
-                Tcl_SetObjResult(interp, pElem->pOverride);
+            if (HtmlElemRare(pElem, pOverride)) {
+                Tcl_SetObjResult(interp, pElem->pRare->pOverride);
             }
             HtmlCallbackRestyle(pTree, pNode);
             return TCL_OK;
@@ -2847,6 +3780,205 @@ HtmlNodeCommand(HtmlTree *pTree, HtmlNode *pNode)
     return pNodeCmd->pCommand;
 }
 
+/*
+ * Context used by HtmlTreeDump() while walking the tree.
+ */
+typedef struct DumpContext DumpContext;
+struct DumpContext {
+    Tcl_Obj *pRet;                 /* List under construction */
+    int nAttr;                     /* Size of apAttr, or -1 for all attrs */
+    Tcl_Obj **apAttr;              /* Attribute names from -attrs */
+    int doHandles;                 /* True to append node-handles */
+    Tcl_HashTable aTag;            /* Map from atom zTag to shared Tcl_Obj */
+    Tcl_Obj *pEmpty;               /* Shared "" object for text nodes */
+};
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * dumpCb --
+ *
+ *     HtmlWalkTree() callback for HtmlTreeDump(). Append the record for
+ *     node pNode to the list at DumpContext.pRet.
+ *
+ * Results:
+ *     HTML_WALK_DESCEND.
+ *
+ * Side effects:
+ *     May create a node-handle for pNode, if -handles was specified.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+dumpCb (HtmlTree *pTree, HtmlNode *pNode, ClientData clientData)
+{
+    DumpContext *p = (DumpContext *)clientData;
+    Tcl_Obj *pTag;
+    Tcl_Obj *pData;
+
+    if (HtmlNodeIsText(pNode)) {
+        HtmlTextNode *pTextNode = (HtmlTextNode *)pNode;
+        pTag = p->pEmpty;
+        pData = Tcl_NewStringObj(pTextNode->zText,nodeTextLength(pTextNode));
+    } else {
+        HtmlElementNode *pElem = (HtmlElementNode *)pNode;
+        Tcl_HashEntry *pEntry;
+        int isNew;
+        int i;
+
+        pEntry = Tcl_CreateHashEntry(&p->aTag, pNode->zTag, &isNew);
+        if (isNew) {
+            pTag = Tcl_NewStringObj(HtmlNodeTagName(pNode), -1);
+            Tcl_IncrRefCount(pTag);
+            Tcl_SetHashValue(pEntry, pTag);
+        }
+        pTag = (Tcl_Obj *)Tcl_GetHashValue(pEntry);
+
+        pData = Tcl_NewObj();
+        if (p->nAttr < 0) {
+            HtmlAttributes *pAttr = pElem->pAttributes;
+            for (i = 0; pAttr && i < pAttr->nAttr; i++) {
+                Tcl_ListObjAppendElement(0, pData, 
+                    Tcl_NewStringObj(pAttr->a[i].zName, -1)
+                );
+                Tcl_ListObjAppendElement(0, pData, 
+                    Tcl_NewStringObj(pAttr->a[i].zValue, -1)
+                );
+            }
+        } else {
+            for (i = 0; i < p->nAttr; i++) {
+                const char *zVal;
+                zVal = HtmlNodeAttr(pNode, Tcl_GetString(p->apAttr[i]));
+                if (zVal) {
+                    Tcl_ListObjAppendElement(0, pData, p->apAttr[i]);
+                    Tcl_ListObjAppendElement(0, pData, 
+                        Tcl_NewStringObj(zVal, -1)
+                    );
+                }
+            }
+        }
+    }
+
+    Tcl_ListObjAppendElement(0, p->pRet, pTag);
+    Tcl_ListObjAppendElement(0, p->pRet, 
+        Tcl_NewIntObj(HtmlNodeNumChildren(pNode))
+    );
+    Tcl_ListObjAppendElement(0, p->pRet, pData);
+    if (p->doHandles) {
+        Tcl_ListObjAppendElement(0, p->pRet, HtmlNodeCommand(pTree, pNode));
+    }
+    return HTML_WALK_DESCEND;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlTreeDump --
+ *
+ *     $html dump ?-root NODE? ?-attrs ATTR-LIST? ?-handles BOOLEAN?
+ *
+ *     Return the sub-tree rooted at NODE (default the document root) as
+ *     a flat list. Nodes appear in document (preorder) order, each as 
+ *     three consecutive elements:
+ *
+ *         TAG NCHILD DATA
+ *
+ *     TAG is the tag name of an element, or an empty string for a text
+ *     node. NCHILD is the number of children, which allows the caller to
+ *     rebuild the tree structure. For elements DATA is a list of 
+ *     attribute names and values (restricted to the attributes named by
+ *     -attrs, if specified). For text nodes it is the same value 
+ *     returned by [$node text].
+ *
+ *     Node-handles are not created unless -handles is true, in which
+ *     case each record has a fourth element, the node-handle.
+ *
+ * Results:
+ *     Tcl result (i.e. TCL_OK, TCL_ERROR).
+ *
+ * Side effects:
+ *     May create node-handles.
+ *
+ *---------------------------------------------------------------------------
+ */
+int 
+HtmlTreeDump (
+    ClientData clientData,             /* The HTML widget data structure */
+    Tcl_Interp *interp,                /* Current interpreter. */
+    int objc,                          /* Number of arguments. */
+    Tcl_Obj *CONST objv[]              /* Argument strings. */ 
+    )
+{
+    HtmlTree *pTree = (HtmlTree *)clientData;
+    HtmlNode *pRoot;
+    DumpContext sContext;
+    Tcl_HashSearch sSearch;
+    Tcl_HashEntry *pEntry;
+    int ii;
+
+    static const char *azOpt[] = {"-root", "-attrs", "-handles", 0};
+
+    HtmlInitTree(pTree);
+    pRoot = pTree->pRoot;
+    memset(&sContext, 0, sizeof(DumpContext));
+    sContext.nAttr = -1;
+
+    if (objc % 2) {
+        Tcl_WrongNumArgs(interp, 2, objv, 
+            "?-root NODE? ?-attrs ATTR-LIST? ?-handles BOOLEAN?"
+        );
+        return TCL_ERROR;
+    }
+    for (ii = 2; ii < objc; ii += 2) {
+        int iOpt;
+        if (Tcl_GetIndexFromObj(interp, objv[ii], azOpt, "option", 0, &iOpt)) {
+            return TCL_ERROR;
+        }
+        switch (iOpt) {
+            case 0:
+                pRoot = HtmlNodeGetPointer(pTree, Tcl_GetString(objv[ii+1]));
+                if (!pRoot) return TCL_ERROR;
+                break;
+            case 1:
+                if (Tcl_ListObjGetElements(interp, 
+                    objv[ii+1], &sContext.nAttr, &sContext.apAttr)
+                ) {
+                    return TCL_ERROR;
+                }
+                break;
+            case 2:
+                if (Tcl_GetBooleanFromObj(
+                    interp, objv[ii+1], &sContext.doHandles)
+                ) {
+                    return TCL_ERROR;
+                }
+                break;
+        }
+    }
+
+    sContext.pRet = Tcl_NewObj();
+    sContext.pEmpty = Tcl_NewObj();
+    Tcl_IncrRefCount(sContext.pEmpty);
+    Tcl_InitHashTable(&sContext.aTag, TCL_ONE_WORD_KEYS);
+
+    if (pRoot) {
+        HtmlWalkTree(pTree, pRoot, dumpCb, (ClientData)&sContext);
+    }
+
+    for (
+        pEntry = Tcl_FirstHashEntry(&sContext.aTag, &sSearch);
+        pEntry;
+        pEntry = Tcl_NextHashEntry(&sSearch)
+    ) {
+        Tcl_DecrRefCount((Tcl_Obj *)Tcl_GetHashValue(pEntry));
+    }
+    Tcl_DeleteHashTable(&sContext.aTag);
+    Tcl_DecrRefCount(sContext.pEmpty);
+
+    Tcl_SetObjResult(interp, sContext.pRet);
+    return TCL_OK;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -2868,8 +4000,8 @@ HtmlNodeScrollbarDoCallback (HtmlTree *pTree, HtmlNode *pNode)
 {
     HtmlElementNode *pElem = (HtmlElementNode *)pNode;
 
-    if (!HtmlNodeIsText(pNode) && pElem->pScrollbar) {
-        HtmlNodeScrollbars *p = pElem->pScrollbar;
+    if (!HtmlNodeIsText(pNode) && HtmlElemRare(pElem, pScrollbar)) {
+        HtmlNodeScrollbars *p = pElem->pRare->pScrollbar;
         char zTmp[256];
         if (p->vertical.win) {
             snprintf(zTmp, 255, "%s set %f %f", 
@@ -2928,6 +4060,11 @@ HtmlTreeClear (HtmlTree *pTree)
     /* Free the contents of the search-cache */
     HtmlCssSearchInvalidateCache(pTree);
 
+    /* Discard arguments queued for batched handlers. They refer to nodes
+     * that are about to be deleted.
+     */
+    HtmlHandlerBatchFree(pTree, 0);
+
     /* Free the tree representation - pTree->pRoot */
     freeNode(pTree, pTree->pRoot);
     pTree->pRoot = 0;
@@ -2951,26 +4088,48 @@ HtmlTreeClear (HtmlTree *pTree)
     HtmlTextInvalidate(pTree);
 
     /* Free the plain text representation */
-    if (pTree->pDocument) {
-        Tcl_DecrRefCount(pTree->pDocument);
+    if (pTree->document.z) {
+        HtmlFree(pTree->document.z);
     }
+    memset(&pTree->document, 0, sizeof(HtmlDocBuffer));
+    HtmlUtf8IndexClear(&pTree->documentIndex);
     pTree->nParsed = 0;
-    pTree->pDocument = 0;
+
+    /* Discard any partially tokenized token */
+    HtmlArenaFree(&pTree->arena, pTree->tokenizer.pAttr);
+    memset(&pTree->tokenizer, 0, sizeof(HtmlTokenizer));
+
+    /* All nodes have been freed, so release the memory used by nodes,
+     * attributes and text created by the [parse] command. 
+     */
+    HtmlArenaRelease(&pTree->arena);
 
     /* Free the stylesheets */
     HtmlCssStyleSheetFree(pTree->pStyle);
     pTree->pStyle = 0;
 
+    /* Free the [fragment] templates and empty the atom table. With the
+     * nodes and stylesheets gone, nothing else refers to an atom. 
+     * Otherwise each attribute or XML tag name ever parsed or set by a
+     * script would be kept until the widget is destroyed.
+     */
+    HtmlFragmentCacheTrim(pTree, 0);
+    Tcl_DeleteHashTable(&pTree->aAtom);
+    Tcl_InitCustomHashTable(
+        &pTree->aAtom, TCL_CUSTOM_TYPE_KEYS, HtmlCaseInsenstiveHashType()
+    );
+    pTree->zAtomId = HtmlTreeAtom(pTree, "id");
+    pTree->zAtomClass = HtmlTreeAtom(pTree, "class");
+
     /* Set the scroll position to top-left and clear the selection */
     pTree->iScrollX = 0;
     pTree->iScrollY = 0;
 
     /* Deschedule any dynamic, style or layout callback. */
-    pTree->cb.pDynamic = 0;
+    pTree->cb.nDynamic = 0;
     pTree->cb.pRestyle = 0;
     pTree->cb.flags &= ~(HTML_DYNAMIC|HTML_RESTYLE|HTML_LAYOUT);
 
-    pTree->iNextNode = 0;
     return TCL_OK;
 }
 
@@ -3016,8 +4175,17 @@ fragmentOrphan (HtmlTree *pTree)
 {
     HtmlFragmentContext *pFragment = pTree->pFragment;
     HtmlNode *pOrphan = pFragment->pRoot;
+    HtmlFragmentTemplate *pTemplate = pFragment->pTemplate;
 
-    if (pOrphan) {
+    if (pOrphan && pTemplate) {
+        int n = (pTemplate->nRoot + 1) * sizeof(HtmlNode *);
+        pTemplate->apRoot = (HtmlNode **)HtmlRealloc(
+            "HtmlFragmentTemplate.apRoot", (char *)pTemplate->apRoot, n
+        );
+        pTemplate->apRoot[pTemplate->nRoot++] = pOrphan;
+        pFragment->pRoot = 0;
+        pFragment->pCurrent = 0;
+    } else if (pOrphan) {
         Tcl_Obj *pCmd = HtmlNodeCommand(pTree, pOrphan);
         Tcl_ListObjAppendElement(0, pFragment->pNodeList, pCmd);
         nodeOrphanize(pTree, pOrphan);
@@ -3028,6 +4196,31 @@ fragmentOrphan (HtmlTree *pTree)
     assert(!pFragment->pRoot && !pFragment->pCurrent);
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * fragmentNodeHandler --
+ *
+ *     Invoke the node-handler callback for fragment node pNode, unless 
+ *     the fragment is being parsed into a template. In that case the
+ *     callbacks are invoked for each copy of the template instead.
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     May invoke a node-handler script.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+fragmentNodeHandler (HtmlTree *pTree, HtmlNode *pNode)
+{
+    if (!pTree->pFragment->pTemplate) {
+        nodeHandlerCallbacks(pTree, pNode);
+    }
+}
+
 static void 
 fragmentAddText (HtmlTree *pTree, HtmlTextNode *pTextNode, int iOffset)
 {
@@ -3080,7 +4273,7 @@ fragmentAddElement (
         HtmlNode *pC = &pFragment->pCurrent->node;
         HtmlNode *pParentC = HtmlNodeParent(pC);
         assert(pC);
-        nodeHandlerCallbacks(pTree, pC);
+        fragmentNodeHandler(pTree, pC);
         pFragment->pCurrent = (HtmlElementNode *)pParentC;
     }
     if (!pFragment->pCurrent) {
@@ -3088,7 +4281,7 @@ fragmentAddElement (
     }
 
     pElem = HtmlNew(HtmlElementNode);
-    pElem->pAttributes = pAttributes;
+    nodeSetAttributes(pTree, 0, pElem, pAttributes);
     pElem->node.eTag = eType;
     if (!zType) {
         zType = HtmlTypeToName(0, eType);
@@ -3105,7 +4298,7 @@ fragmentAddElement (
     pFragment->pCurrent = pElem;
 
     if (HtmlMarkup(eType)->flags & HTMLTAG_EMPTY) {
-        nodeHandlerCallbacks(pTree, pFragment->pCurrent);
+        fragmentNodeHandler(pTree, &pFragment->pCurrent->node);
         pFragment->pCurrent = (HtmlElementNode *)HtmlNodeParent(pElem);
     }
     if (!pFragment->pCurrent) {
@@ -3122,7 +4315,7 @@ fragmentAddClosingTag (HtmlTree *pTree, int eType, const char *zType, int iOffse
     explicitCloseCount(p->pCurrent, eType, zType, &nClose);
     for (ii = 0; ii < nClose; ii++) {
         assert(p->pCurrent);
-        nodeHandlerCallbacks(pTree, p->pCurrent);
+        fragmentNodeHandler(pTree, &p->pCurrent->node);
         p->pCurrent = (HtmlElementNode *)HtmlNodeParent(p->pCurrent);
     }
     if (!p->pCurrent) {
@@ -3130,76 +4323,352 @@ fragmentAddClosingTag (HtmlTree *pTree, int eType, const char *zType, int iOffse
     }
 }
 
-void 
-HtmlParseFragment (HtmlTree *pTree, const char *zHtml)
+/*
+ *---------------------------------------------------------------------------
+ *
+ * fragmentTokenize --
+ *
+ *     Run the tokenizer and tree-builder over the markup zHtml using the
+ *     fragment context pContext, which must have been initialized by the
+ *     caller. When this function returns each sub-tree has been passed to
+ *     fragmentOrphan().
+ *
+ * Results:
+ *     None.
+ *
+ * Side effects:
+ *     Builds sub-trees. Unless a template is being built, may invoke
+ *     node-handler scripts.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+fragmentTokenize (
+    HtmlTree *pTree, 
+    HtmlFragmentContext *pContext, 
+    const char *zHtml
+)
 {
-    HtmlFragmentContext sContext;
-
     assert(!pTree->pFragment);
-    sContext.pRoot = 0;
-    sContext.pCurrent = 0;
-    sContext.pNodeList = Tcl_NewObj();
-
-    pTree->pFragment = &sContext;
+    pTree->pFragment = pContext;
     HtmlTokenize(pTree, zHtml, 1,
         fragmentAddText, fragmentAddElement, fragmentAddClosingTag
     );
 
-    while (sContext.pCurrent) {
-        HtmlNode *pParent = HtmlNodeParent(sContext.pCurrent); 
-        nodeHandlerCallbacks(pTree, sContext.pCurrent);
-        sContext.pCurrent = (HtmlElementNode *)pParent;
+    while (pContext->pCurrent) {
+        HtmlNode *pParent = HtmlNodeParent(pContext->pCurrent); 
+        fragmentNodeHandler(pTree, &pContext->pCurrent->node);
+        pContext->pCurrent = (HtmlElementNode *)pParent;
     }
+    HtmlFlushHandlerBatches(pTree);
 
     fragmentOrphan(pTree);
     pTree->pFragment = 0;
-    Tcl_SetObjResult(pTree->interp, sContext.pNodeList);
 }
 
 /*
  *---------------------------------------------------------------------------
  *
- * sequenceCb --
+ * fragmentCloneNode --
+ *
+ *     Return a deep copy of template node pNode and its descendants. The
+ *     tag, attributes and text of each node are copied. Style, layout and
+ *     other state is not - the copy is as the tree-builder would have
+ *     created it.
+ *
+ * Results:
+ *     Pointer to the new node.
+ *
+ * Side effects:
+ *     Allocates memory.
+ *
+ *---------------------------------------------------------------------------
+ */
+static HtmlNode *
+fragmentCloneNode (HtmlTree *pTree, HtmlNode *pNode)
+{
+    HtmlElementNode *pElem;
+    HtmlElementNode *pNew;
+    int ii;
+
+    if (HtmlNodeIsText(pNode)) {
+        return (HtmlNode *)HtmlTextClone(0, HtmlNodeAsText(pNode));
+    }
+
+    pElem = HtmlNodeAsElement(pNode);
+    pNew = HtmlNew(HtmlElementNode);
+    pNew->node.eTag = pElem->node.eTag;
+    pNew->node.zTag = pElem->node.zTag;
+    nodeSetAttributes(pTree, 0, pNew, HtmlAttributesCopy(0, pElem->pAttributes));
+
+    if (pElem->nChild > 0) {
+        pNew->apChildren = (HtmlNode **)HtmlAlloc(
+            "HtmlNode.apChildren", pElem->nChild * sizeof(HtmlNode *)
+        );
+        for (ii = 0; ii < pElem->nChild; ii++) {
+            HtmlNode *pChild = fragmentCloneNode(pTree, pElem->apChildren[ii]);
+            pChild->pParent = (HtmlNode *)pNew;
+            pChild->iChild = ii;
+            pNew->apChildren[ii] = pChild;
+        }
+        pNew->nChild = pElem->nChild;
+        pNew->nChildAlloc = pElem->nChild;
+    }
+
+    return (HtmlNode *)pNew;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * fragmentCloneCallbacks --
  *
- *     This is an HtmlWalkTree() callback function (the tree iteration
- *     is started from with HtmlSequenceNodes()).
+ *     Invoke node-handler callbacks for each element in the copy of a
+ *     template rooted at pNode. The callbacks are invoked in the same 
+ *     order as the tree-builder would invoke them, i.e. each node after
+ *     its descendants.
  *
  * Results:
+ *     None.
  *
  * Side effects:
+ *     May invoke node-handler scripts.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+fragmentCloneCallbacks (HtmlTree *pTree, HtmlNode *pNode)
+{
+    if (!HtmlNodeIsText(pNode)) {
+        int ii;
+        for (ii = 0; ii < HtmlNodeNumChildren(pNode); ii++) {
+            fragmentCloneCallbacks(pTree, HtmlNodeChild(pNode, ii));
+        }
+        nodeHandlerCallbacks(pTree, pNode);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * fragmentTemplateFree --
+ *
+ *     Remove template pTemplate from the fragment cache and free it,
+ *     along with its sub-trees.
+ *
+ * Results:
  *     None.
  *
+ * Side effects:
+ *     Frees memory.
+ *
  *---------------------------------------------------------------------------
  */
-static int 
-sequenceCb(
-    HtmlTree *pTree,
-    HtmlNode *pNode,
-    ClientData clientData)
+static void
+fragmentTemplateFree (HtmlTree *pTree, HtmlFragmentTemplate *pTemplate)
 {
-    pNode->iNode = pTree->iNextNode++;
-    return HTML_WALK_DESCEND;
+    HtmlFragmentCache *pCache = &pTree->fragmentCache;
+    int ii;
+
+    if (pTemplate->pPrev) {
+        pTemplate->pPrev->pNext = pTemplate->pNext;
+    } else {
+        pCache->pFirst = pTemplate->pNext;
+    }
+    if (pTemplate->pNext) {
+        pTemplate->pNext->pPrev = pTemplate->pPrev;
+    } else {
+        pCache->pLast = pTemplate->pPrev;
+    }
+    Tcl_DeleteHashEntry(pTemplate->pEntry);
+    pCache->nTemplate--;
+
+    for (ii = 0; ii < pTemplate->nRoot; ii++) {
+        freeNode(pTree, pTemplate->apRoot[ii]);
+    }
+    HtmlFree(pTemplate->apRoot);
+    HtmlFree(pTemplate);
 }
 
 /*
  *---------------------------------------------------------------------------
  *
- * HtmlSequenceNodes --
+ * HtmlFragmentCacheTrim --
+ *
+ *     Discard the least recently used [fragment] templates until no more
+ *     than nMax remain in the cache.
  *
  * Results:
+ *     None.
  *
  * Side effects:
+ *     Frees memory.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+HtmlFragmentCacheTrim (HtmlTree *pTree, int nMax)
+{
+    HtmlFragmentCache *pCache = &pTree->fragmentCache;
+    while (pCache->nTemplate > MAX(nMax, 0)) {
+        fragmentTemplateFree(pTree, pCache->pLast);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * fragmentTemplate --
+ *
+ *     Return the cached template for markup zHtml, parsing it into a new
+ *     template if necessary. The returned template is moved to the 
+ *     start of the most-recently-used list.
+ *
+ * Results:
+ *     Pointer to template.
+ *
+ * Side effects:
+ *     May parse zHtml and evict the least recently used template.
+ *
+ *---------------------------------------------------------------------------
+ */
+static HtmlFragmentTemplate *
+fragmentTemplate (HtmlTree *pTree, const char *zHtml)
+{
+    HtmlFragmentCache *pCache = &pTree->fragmentCache;
+    HtmlFragmentTemplate *pTemplate = 0;
+    Tcl_HashEntry *pEntry;
+
+    pEntry = Tcl_FindHashEntry(&pCache->aTemplate, zHtml);
+    if (pEntry) {
+        pTemplate = (HtmlFragmentTemplate *)Tcl_GetHashValue(pEntry);
+        if (
+            pTemplate->eMode != pTree->options.mode ||
+            pTemplate->eParseMode != pTree->options.parsemode
+        ) {
+            fragmentTemplateFree(pTree, pTemplate);
+            pTemplate = 0;
+        }
+    }
+
+    if (pTemplate) {
+        pCache->nHit++;
+
+        /* Unlink the template so that it can be relinked at the start
+         * of the list below. 
+         */
+        if (pTemplate->pPrev) {
+            pTemplate->pPrev->pNext = pTemplate->pNext;
+        } else {
+            pCache->pFirst = pTemplate->pNext;
+        }
+        if (pTemplate->pNext) {
+            pTemplate->pNext->pPrev = pTemplate->pPrev;
+        } else {
+            pCache->pLast = pTemplate->pPrev;
+        }
+    } else {
+        HtmlFragmentContext sContext;
+        int isNew;
+
+        pCache->nMiss++;
+        pTemplate = HtmlNew(HtmlFragmentTemplate);
+        pTemplate->eMode = pTree->options.mode;
+        pTemplate->eParseMode = pTree->options.parsemode;
+
+        sContext.pRoot = 0;
+        sContext.pCurrent = 0;
+        sContext.pNodeList = 0;
+        sContext.pTemplate = pTemplate;
+        fragmentTokenize(pTree, &sContext, zHtml);
+
+        pEntry = Tcl_CreateHashEntry(&pCache->aTemplate, zHtml, &isNew);
+        assert(isNew);
+        Tcl_SetHashValue(pEntry, pTemplate);
+        pTemplate->pEntry = pEntry;
+        pCache->nTemplate++;
+    }
+
+    pTemplate->pPrev = 0;
+    pTemplate->pNext = pCache->pFirst;
+    if (pCache->pFirst) {
+        pCache->pFirst->pPrev = pTemplate;
+    } else {
+        pCache->pLast = pTemplate;
+    }
+    pCache->pFirst = pTemplate;
+
+    HtmlFragmentCacheTrim(pTree, pTree->options.fragmentcache);
+    return pTemplate;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HtmlParseFragment --
+ *
+ *     Parse the markup zHtml into orphan sub-trees and set the 
+ *     interpreter result to a list of node commands, one for the root
+ *     of each sub-tree. This is the implementation of the
+ *     [$widget fragment] command.
+ *
+ *     If the -fragmentcache option is greater than zero, the sub-trees
+ *     are copied from a cached template (see fragmentTemplate()). Node
+ *     handlers are then invoked for the copies once they are complete,
+ *     instead of as each node is closed by the tree-builder.
+ *
+ * Results:
  *     None.
  *
+ * Side effects:
+ *     Creates orphan nodes. May invoke node-handler scripts.
+ *
  *---------------------------------------------------------------------------
  */
 void 
-HtmlSequenceNodes (HtmlTree *pTree)
+HtmlParseFragment (HtmlTree *pTree, const char *zHtml)
 {
-    if (!pTree->isSequenceOk) {
-        pTree->iNextNode = 0;
-        HtmlWalkTree(pTree, 0, sequenceCb, 0);
-        pTree->isSequenceOk = 1;
+    HtmlFragmentContext sContext;
+
+    assert(!pTree->pFragment);
+    sContext.pRoot = 0;
+    sContext.pCurrent = 0;
+    sContext.pNodeList = Tcl_NewObj();
+    sContext.pTemplate = 0;
+
+    if (pTree->options.fragmentcache > 0) {
+        HtmlFragmentTemplate *pTemplate = fragmentTemplate(pTree, zHtml);
+        HtmlNode **apRoot;
+        int nRoot = pTemplate->nRoot;
+        int ii;
+
+        /* Copy all the sub-trees before invoking any node-handlers. A
+         * handler script might reconfigure the widget and so free the
+         * template.
+         */
+        apRoot = (HtmlNode **)HtmlAlloc(
+            "HtmlParseFragment.apRoot", (nRoot + 1) * sizeof(HtmlNode *)
+        );
+        for (ii = 0; ii < nRoot; ii++) {
+            apRoot[ii] = fragmentCloneNode(pTree, pTemplate->apRoot[ii]);
+            if (!HtmlNodeIsText(apRoot[ii])) {
+                apRoot[ii]->iNode = HTML_NODE_ORPHAN;
+            }
+        }
+
+        pTree->pFragment = &sContext;
+        for (ii = 0; ii < nRoot; ii++) {
+            sContext.pRoot = apRoot[ii];
+            fragmentCloneCallbacks(pTree, apRoot[ii]);
+            fragmentOrphan(pTree);
+        }
+        HtmlFlushHandlerBatches(pTree);
+        pTree->pFragment = 0;
+        HtmlFree(apRoot);
+    } else {
+        fragmentTokenize(pTree, &sContext, zHtml);
     }
+
+    Tcl_SetObjResult(pTree->interp, sContext.pNodeList);
 }
 
@@ -0,0 +1,139 @@
+#
+# mkperfecthash.tcl --
+#
+#     This file is sourced by the scripts that generate C code for the
+#     tables of tag names (tokenlist.txt) and named character references
+#     (entitylist.txt). Procedure [perfect_hash] builds a collision-free
+#     hash function for a fixed set of keys at build time.
+#
+#     The scheme used is "hash and displace". Each key is first hashed
+#     with seed 0 to select a bucket. For each bucket, the generator
+#     searches for a displacement value d such that hashing each key in
+#     the bucket with seed d sends all of them to distinct, unused slots.
+#     Buckets that contain only a single key are instead assigned a free
+#     slot directly, which is recorded as a negative displacement. The
+#     C code that looks up a string zName of length n is:
+#
+#         h = HtmlPerfectHash(0, zName, n, isFold);
+#         d = aHash[h % N];
+#         if (d < 0) iSlot = -1 - d;
+#         else       iSlot = HtmlPerfectHash(d, zName, n, isFold) % N;
+#
+#     followed by a single comparison against the key stored in slot
+#     iSlot. The hash function itself is FNV-1a, with the seed (if it is
+#     not 0) used as the offset basis. If the isFold flag is set, ASCII
+#     upper-case characters are folded to lower-case before hashing. The
+#     C version is HtmlPerfectHash() in htmltagdb.c. The two versions
+#     must be kept in sync.
+#
+
+#-------------------------------------------------------------------------
+# phash_fnv --
+#
+#         phash_fnv SEED BYTES
+#
+#     Return the 32-bit FNV-1a hash of the list of byte values BYTES,
+#     using SEED as the offset basis (or the standard FNV basis if SEED
+#     is 0).
+#
+proc phash_fnv {seed bytes} {
+    set h [expr {$seed ? $seed : 0x811C9DC5}]
+    foreach c $bytes {
+        set h [expr {(($h ^ $c) * 0x01000193) & 0xFFFFFFFF}]
+    }
+    return $h
+}
+
+#-------------------------------------------------------------------------
+# perfect_hash --
+#
+#         perfect_hash KEYS ISFOLD
+#
+#     Build a perfect hash function for the list of distinct strings
+#     KEYS. If ISFOLD is true, the keys are hashed without regard to
+#     the case of ASCII characters (and must be distinct when compared
+#     in the same way).
+#
+#     A list of two elements is returned. The first is the list of
+#     displacement values (the aHash[] array in the C code). The second
+#     is a list of indexes into KEYS, such that element i of the list
+#     is the index of the key that hashes to slot i. Both lists have
+#     the same number of elements as KEYS.
+#
+proc perfect_hash {keys isFold} {
+    set n [llength $keys]
+
+    # Sort the keys into buckets using the seed 0 hash.
+    set ii 0
+    foreach k $keys {
+        if {$isFold} {set k [string tolower $k]}
+        binary scan $k cu* bytes
+        set aBytes($ii) $bytes
+        lappend aBucket([expr {[phash_fnv 0 $bytes] % $n}]) $ii
+        incr ii
+    }
+
+    # Start with an empty table. Element i of $slots is set to the
+    # index of the key assigned to slot i, or -1 if the slot is free.
+    set slots [lrepeat $n -1]
+    set aHash [lrepeat $n 0]
+
+    # Order the buckets from largest to smallest.
+    set order [list]
+    foreach b [array names aBucket] {
+        lappend order [list $b [llength $aBucket($b)]]
+    }
+    set order [lsort -integer -decreasing -index 1 $order]
+
+    # Find a displacement for each bucket that contains more than one key.
+    foreach pair $order {
+        foreach {b nKey} $pair {}
+        if {$nKey < 2} break
+        for {set d 1} {1} {incr d} {
+            set used [list]
+            foreach k $aBucket($b) {
+                set s [expr {[phash_fnv $d $aBytes($k)] % $n}]
+                if {[lindex $slots $s] >= 0 || [lsearch -exact $used $s] >= 0} {
+                    break
+                }
+                lappend used $s
+            }
+            if {[llength $used] == $nKey} break
+        }
+        foreach k $aBucket($b) s $used {
+            lset slots $s $k
+        }
+        lset aHash $b $d
+    }
+
+    # Assign each remaining single-key bucket a free slot directly.
+    set s 0
+    foreach pair $order {
+        foreach {b nKey} $pair {}
+        if {$nKey != 1} continue
+        while {[lindex $slots $s] >= 0} {incr s}
+        lset slots $s [lindex $aBucket($b) 0]
+        lset aHash $b [expr {-1 - $s}]
+    }
+
+    return [list $aHash $slots]
+}
+
+#-------------------------------------------------------------------------
+# perfect_hash_format --
+#
+#         perfect_hash_format LIST
+#
+#     Format a list of integers as the body of a C array initializer,
+#     ten values to a line.
+#
+proc perfect_hash_format {list} {
+    set ret ""
+    set ii 0
+    foreach v $list {
+        if {($ii % 10) == 0} {append ret "\n   "}
+        append ret [format " %6s" "$v,"]
+        incr ii
+    }
+    return $ret
+}
@@ -0,0 +1,114 @@
+#
+# hoverbench.tcl --
+#
+#     Measure the cost of moving the mouse pointer over a document that
+#     uses :hover rules (a "hover storm").
+#
+#     Usage:
+#
+#         wish hoverbench.tcl ?-sections N? ?-links N?
+#
+#     A document containing N sections (default 20), each with a list of
+#     N links (default 100), is generated along with a stylesheet that
+#     uses :hover on the links, the list items and the sections. The
+#     pointer is then moved over each link in turn. As the hv3 browser
+#     does, the hover flag is set on the element under the pointer and
+#     all its ancestors, and cleared on elements that are no longer
+#     hovered. After each move the widget callbacks are run to completion
+#     with [.h _force].
+#
+#     The total time and the average time per move are reported.
+#
+
+package require Tk
+package require Tkhtml
+
+proc usage {} {
+  puts stderr "Usage: $::argv0 ?-sections N? ?-links N?"
+  exit 1
+}
+
+proc hover_document {nSection nLink} {
+  set doc "<html><body>"
+  for {set ii 0} {$ii < $nSection} {incr ii} {
+    append doc "<div class=sec><h2>Section $ii</h2><ul>"
+    for {set jj 0} {$jj < $nLink} {incr jj} {
+      append doc "<li><a href=\"#$jj\">link $jj</a> <span>text</span></li>"
+    }
+    append doc "</ul><p>Paragraph <b>bold</b> <i>italic</i></p></div>"
+  }
+  append doc "</body></html>"
+  return $doc
+}
+
+set hover_css {
+  a:hover { color: red }
+  li:hover a { text-decoration: underline }
+  .sec:hover h2 { color: blue }
+}
+
+proc find_links {node} {
+  set ret [list]
+  if {[$node tag] eq "a"} {lappend ret $node}
+  foreach child [$node children] {
+    eval lappend ret [find_links $child]
+  }
+  return $ret
+}
+
+# Move the (simulated) pointer from the node $from to the node $to.
+#
+proc hover_move {from to} {
+  array set chain [list]
+  for {set n $to} {$n ne ""} {set n [$n parent]} {
+    set chain($n) 1
+  }
+  for {set n $from} {$n ne "" && ![info exists chain($n)]} {set n [$n parent]} {
+    $n dynamic clear hover
+  }
+  for {set n $to} {$n ne "" && ![info exists ::hovered($n)]} {set n [$n parent]} {
+    $n dynamic set hover
+  }
+  array unset ::hovered
+  array set ::hovered [array get chain]
+}
+
+proc main {} {
+  set nSection 20
+  set nLink 100
+  for {set ii 0} {$ii < [llength $::argv]} {incr ii} {
+    set arg [lindex $::argv $ii]
+    incr ii
+    if {$ii == [llength $::argv]} usage
+    switch -- $arg {
+      -sections { set nSection [lindex $::argv $ii] }
+      -links    { set nLink [lindex $::argv $ii] }
+      default   usage
+    }
+  }
+
+  html .h
+  .h parse -final [hover_document $nSection $nLink]
+  .h style -id author.0001 $::hover_css
+  .h _force
+
+  set links [find_links [.h node]]
+  set prev ""
+  set t [lindex [time {
+    foreach link $links {
+      hover_move $prev $link
+      .h _force
+      set prev $link
+    }
+  }] 0]
+
+  set n [llength $links]
+  puts [format "moves:         %10d" $n]
+  puts [format "total:         %10d us" $t]
+  puts [format "per move:      %10.1f us" [expr {double($t) / $n}]]
+
+  destroy .h
+}
+
+main
+exit 0
@@ -0,0 +1,106 @@
+#
+# lookupbench.tcl --
+#
+#     Measure the cost of looking up tag names and named character
+#     references (entities) in the tables used by the tokenizer.
+#
+#     Usage:
+#
+#         wish lookupbench.tcl ?-iterations N? ?FILE ...?
+#
+#     If files are specified, the tag and entity names that appear in them
+#     are extracted in document order (including names that are not in
+#     either table), so that the lookups are performed with a realistic
+#     frequency distribution. Otherwise a built-in sample of common names
+#     is used. The lookups are performed in C by [::tkhtml::lookup], and
+#     the best time per lookup over all iterations is reported in ns.
+#
+
+package require Tk
+package require Tkhtml
+
+proc usage {} {
+  puts stderr "Usage: $::argv0 ?-iterations N? ?FILE ...?"
+  exit 1
+}
+
+proc synthetic_names {} {
+  set tags [list]
+  foreach {name weight} {
+    td 40 tr 12 a 20 div 15 span 15 p 10 br 8 img 6 li 8 ul 2 table 2
+    TD 4 TR 2 FONT 3 b 4 i 3 input 2 option 3 script 1 meta 1 link 1
+    h1 1 h2 1 body 1 html 1 head 1 title 1 form 1 tbody 2 th 2 center 1
+    svg 1 article 1 section 1 nav 1 blink 1
+  } {
+    for {set ii 0} {$ii < $weight} {incr ii} {lappend tags $name}
+  }
+  set entities [list]
+  foreach {name weight} {
+    nbsp 40 amp 30 lt 10 gt 10 quot 8 copy 3 mdash 3 ndash 2 raquo 2
+    laquo 1 eacute 2 hellip 2 middot 1 reg 1 trade 1 rarr 1 Aacute 1
+    nbspx 1 unknown 1
+  } {
+    for {set ii 0} {$ii < $weight} {incr ii} {lappend entities $name}
+  }
+  list $tags $entities
+}
+
+proc document_names {doc} {
+  set tags [regexp -all -inline {<(?:/?)([A-Za-z][A-Za-z0-9]*)} $doc]
+  set entities [regexp -all -inline {&([A-Za-z][A-Za-z0-9]*);?} $doc]
+  set t [list]
+  foreach {m name} $tags {lappend t $name}
+  set e [list]
+  foreach {m name} $entities {lappend e $name}
+  list $t $e
+}
+
+proc lookup_time {table names nIter} {
+  set n [llength $names]
+  if {$n == 0} {return [list 0 0.0]}
+  set nCount [expr {1 + 2000000 / $n}]
+  set best ""
+  for {set ii 0} {$ii < $nIter} {incr ii} {
+    set t [lindex [time {set nFound [::tkhtml::lookup $table $names $nCount]}] 0]
+    if {$best eq "" || $t < $best} {set best $t}
+  }
+  list $nFound [expr {($best * 1000.0) / ($n * $nCount)}]
+}
+
+proc main {} {
+  set nIter 5
+  set files [list]
+  for {set ii 0} {$ii < [llength $::argv]} {incr ii} {
+    set arg [lindex $::argv $ii]
+    if {$arg eq "-iterations"} {
+      incr ii
+      if {$ii == [llength $::argv]} usage
+      set nIter [lindex $::argv $ii]
+    } else {
+      lappend files $arg
+    }
+  }
+
+  set sets [list]
+  if {[llength $files] == 0} {
+    lappend sets "(synthetic)" [synthetic_names]
+  }
+  foreach f $files {
+    set fd [open $f]
+    lappend sets $f [document_names [read $fd]]
+    close $fd
+  }
+
+  foreach {name lists} $sets {
+    puts $name
+    foreach table {tag entity} names $lists {
+      foreach {nFound ns} [lookup_time $table $names $nIter] {}
+      puts [format "    %-8s %8d names %8d found %8.2f ns/lookup" \
+          $table [llength $names] $nFound $ns
+      ]
+    }
+  }
+}
+
+main
+exit 0
@@ -0,0 +1,122 @@
+#
+# parsebench.tcl --
+#
+#     Measure the throughput of the Tkhtml tokenizer and tree-builder.
+#
+#     Usage:
+#
+#         wish parsebench.tcl ?-iterations N? ?-chunk BYTES? ?FILE ...?
+#
+#     If no files are specified, a synthetic document of roughly 4MB
+#     (similar to a large generated report - tables, comments, entities
+#     and long runs of text) is used. Each document is parsed with every
+#     scanner implementation supported by the CPU (see [::tkhtml::scanner])
+#     and the best time for each is reported in MB/s. Styling and layout
+#     are not included in the measurement.
+#
+#     If the -chunk option is specified, each document is passed to the
+#     widget in pieces of BYTES bytes (one [.h parse] command per piece),
+#     as it would be when arriving over a slow network connection.
+#
+
+package require Tk
+package require Tkhtml
+
+proc usage {} {
+  puts stderr "Usage: $::argv0 ?-iterations N? ?-chunk BYTES? ?FILE ...?"
+  exit 1
+}
+
+proc synthetic_document {} {
+  set row {
+    <tr class="row"><td>&nbsp;</td><td align="right">12,345.67</td>
+    <td>Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do
+    eiusmod tempor incididunt ut labore et dolore magna aliqua &amp; more.
+    </td></tr>
+    <!-- Generated row. This comment is long enough to be worth searching
+         for the end of with something faster than a byte-by-byte loop -->
+  }
+  set doc "<html><body><h1>Report</h1><table>"
+  while {[string length $doc] < 4000000} {
+    append doc $row
+  }
+  append doc "</table><pre>\nDone.\n</pre></body></html>"
+  return $doc
+}
+
+proc parse_chunked {doc nChunk} {
+  set n [string length $doc]
+  for {set ii 0} {$ii < $n} {incr ii $nChunk} {
+    .h parse [string range $doc $ii [expr {$ii + $nChunk - 1}]]
+  }
+  .h parse -final ""
+}
+
+proc parse_time {doc nIter nChunk} {
+  set best ""
+  for {set ii 0} {$ii < $nIter} {incr ii} {
+    .h reset
+    if {$nChunk > 0} {
+      set t [lindex [time {parse_chunked $doc $nChunk}] 0]
+    } else {
+      set t [lindex [time {.h parse -final $doc}] 0]
+    }
+    if {$best eq "" || $t < $best} {set best $t}
+  }
+  .h reset
+  return $best
+}
+
+proc main {} {
+  set nIter 5
+  set nChunk 0
+  set files [list]
+  for {set ii 0} {$ii < [llength $::argv]} {incr ii} {
+    set arg [lindex $::argv $ii]
+    if {$arg eq "-iterations"} {
+      incr ii
+      if {$ii == [llength $::argv]} usage
+      set nIter [lindex $::argv $ii]
+    } elseif {$arg eq "-chunk"} {
+      incr ii
+      if {$ii == [llength $::argv]} usage
+      set nChunk [lindex $::argv $ii]
+    } else {
+      lappend files $arg
+    }
+  }
+
+  set docs [list]
+  if {[llength $files] == 0} {
+    lappend docs "(synthetic)" [synthetic_document]
+  }
+  foreach f $files {
+    set fd [open $f]
+    lappend docs $f [read $fd]
+    close $fd
+  }
+
+  html .h
+  set default [::tkhtml::scanner]
+  set scanners [list]
+  foreach s {portable sse2 avx2} {
+    if {![catch {::tkhtml::scanner $s}]} {lappend scanners $s}
+  }
+
+  foreach {name doc} $docs {
+    set nByte [string bytelength $doc]
+    puts [format "%s (%.2f MB)" $name [expr {$nByte / 1048576.0}]]
+    foreach s $scanners {
+      ::tkhtml::scanner $s
+      set us [parse_time $doc $nIter $nChunk]
+      set mbs [expr {($nByte / 1048576.0) / ($us / 1000000.0)}]
+      puts [format "    %-10s %10d us %10.2f MB/s" $s $us $mbs]
+    }
+  }
+
+  ::tkhtml::scanner $default
+  destroy .h
+}
+
+main
+exit 0
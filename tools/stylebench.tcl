@@ -0,0 +1,137 @@
+#
+# stylebench.tcl --
+#
+#     Measure the time taken to recalculate the computed styles of every
+#     node in a document.
+#
+#     Usage:
+#
+#         wish stylebench.tcl ?-iterations N? ?HTML-FILE ?CSS-FILE ...??
+#
+#     If no files are specified, a synthetic "utility class" stylesheet
+#     (several thousand single-class rules) and a document in which each
+#     element carries a dozen or more of those classes are generated. This
+#     is the case in which many per-class rule lists must be merged for
+#     each node. Otherwise the named document is loaded along with any
+#     named stylesheets (as author stylesheets).
+#
+#     Two times are reported, each the best over all iterations: the time
+#     taken to lay out the document again without restyling it, and the
+#     time taken to restyle and lay it out. The difference between them
+#     is the cost of style calculation. The number of interned property
+#     values and style attributes, and the memory saved by sharing them,
+#     are also reported.
+#
+
+package require Tk
+package require Tkhtml
+
+proc usage {} {
+  puts stderr "Usage: $::argv0 ?-iterations N? ?HTML-FILE ?CSS-FILE ...??"
+  exit 1
+}
+
+proc synthetic_stylesheet {} {
+  set css ""
+  foreach p {m p mt mb ml mr pt pb pl pr} {
+    for {set ii 0} {$ii < 100} {incr ii} {
+      append css ".$p-$ii { margin-left: ${ii}px }\n"
+    }
+  }
+  foreach c {red green blue gray black white orange purple} {
+    for {set ii 1} {$ii <= 100} {incr ii} {
+      append css ".text-$c-$ii { color: $c }\n"
+      append css ".bg-$c-$ii { background-color: $c }\n"
+    }
+  }
+  for {set ii 0} {$ii < 400} {incr ii} {
+    append css ".w-$ii { width: ${ii}px }\n"
+  }
+  append css "div { display: block }\n"
+  append css "#main div.p-1 { padding: 1px }\n"
+  return $css
+}
+
+proc synthetic_document {} {
+  set pre {m p mt mb ml mr pt pb pl pr}
+  set col {red green blue gray black white orange purple}
+  set doc "<html><body><div id=main>"
+  for {set ii 0} {$ii < 10000} {incr ii} {
+    set cls [list]
+    foreach p $pre {
+      lappend cls $p-[expr {($ii * 7 + [string length $p]) % 100}]
+    }
+    set c [lindex $col [expr {$ii % 8}]]
+    lappend cls text-$c-[expr {$ii % 100 + 1}] bg-$c-[expr {$ii % 97 + 1}]
+    lappend cls w-[expr {$ii % 400}]
+    append doc "<div class=\"$cls\">Item $ii</div>\n"
+  }
+  append doc "</div></body></html>"
+  return $doc
+}
+
+proc best_time {script nIter} {
+  set best ""
+  for {set ii 0} {$ii < $nIter} {incr ii} {
+    set t [lindex [time $script] 0]
+    if {$best eq "" || $t < $best} {set best $t}
+  }
+  return $best
+}
+
+proc main {} {
+  set nIter 5
+  set files [list]
+  for {set ii 0} {$ii < [llength $::argv]} {incr ii} {
+    set arg [lindex $::argv $ii]
+    if {$arg eq "-iterations"} {
+      incr ii
+      if {$ii == [llength $::argv]} usage
+      set nIter [lindex $::argv $ii]
+    } else {
+      lappend files $arg
+    }
+  }
+
+  set sheets [list]
+  if {[llength $files] == 0} {
+    set doc [synthetic_document]
+    lappend sheets [synthetic_stylesheet]
+  } else {
+    set fd [open [lindex $files 0]]
+    set doc [read $fd]
+    close $fd
+    foreach f [lrange $files 1 end] {
+      set fd [open $f]
+      lappend sheets [read $fd]
+      close $fd
+    }
+  }
+
+  html .h
+  .h parse -final $doc
+  set ii 0
+  foreach css $sheets {
+    .h style -id author.[format %04d [incr ii]] $css
+  }
+  .h _force
+
+  set root [.h node]
+  set layout [best_time {.h _relayout -layout $root ; .h _force} $nIter]
+  set style  [best_time {.h _relayout -style $root ; .h _force} $nIter]
+  puts [format "layout only:      %10d us" $layout]
+  puts [format "restyle + layout: %10d us" $style]
+  puts [format "style:            %10d us" [expr {$style - $layout}]]
+
+  array set cache [::tkhtml::stylecache]
+  puts [format "interned values:  %10d (%d refs)" $cache(values) $cache(valuerefs)]
+  puts [format "inline styles:    %10d (%d refs)" \
+      $cache(inlinestyles) $cache(inlinerefs)
+  ]
+  puts [format "bytes saved:      %10d" $cache(bytessaved)]
+
+  destroy .h
+}
+
+main
+exit 0